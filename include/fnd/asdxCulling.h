@@ -0,0 +1,153 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxCulling.h
+// Desc : Frustum Culling.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <fnd/asdxMath.h>
+#include <fnd/asdxThreadPool.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingBox structure
+///////////////////////////////////////////////////////////////////////////////
+struct BoundingBox
+{
+    Vector3     Min;    //!< 最小座標.
+    Vector3     Max;    //!< 最大座標.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BoundingSphere structure
+///////////////////////////////////////////////////////////////////////////////
+struct BoundingSphere
+{
+    Vector3     Center; //!< 中心座標.
+    float       Radius; //!< 半径.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumCuller class
+///////////////////////////////////////////////////////////////////////////////
+class FrustumCuller
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    FrustumCuller();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ビュー行列と射影行列から視錐台を設定します.
+    //!
+    //! @param[in]      view        ビュー行列です.
+    //! @param[in]      proj        射影行列です.
+    //-------------------------------------------------------------------------
+    void SetFrustum(const Matrix& view, const Matrix& proj);
+
+    //-------------------------------------------------------------------------
+    //! @brief      カリングに用いる平面を設定します.
+    //!
+    //! @param[in]      planes      正規化済みの平面です. 法線は内側を向いている必要があります.
+    //! @param[in]      count       平面数です. 最大で SHADOW_PLANE_COUNT 個まで設定できます.
+    //-------------------------------------------------------------------------
+    void SetPlanes(const Vector4* planes, uint32_t count);
+
+    //-------------------------------------------------------------------------
+    //! @brief      平面を取得します.
+    //-------------------------------------------------------------------------
+    const Vector4* GetPlanes() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      平面数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetPlaneCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バウンディングボックスの可視判定を行います.
+    //!
+    //! @param[in]      pBoxes      バウンディングボックスの配列です.
+    //! @param[in]      count       バウンディングボックス数です.
+    //! @param[out]     pMask       可視マスクの格納先です. (count + 31) / 32 個の要素が必要です.
+    //!                             i 番目が可視の場合 pMask[i / 32] の (i % 32) ビット目が立ちます.
+    //! @param[in]      pThreadPool 並列処理に用いるスレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+    //-------------------------------------------------------------------------
+    void Test(const BoundingBox* pBoxes, uint32_t count, uint32_t* pMask, IThreadPool* pThreadPool = nullptr) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バウンディングスフィアの可視判定を行います.
+    //!
+    //! @param[in]      pSpheres    バウンディングスフィアの配列です.
+    //! @param[in]      count       バウンディングスフィア数です.
+    //! @param[out]     pMask       可視マスクの格納先です. (count + 31) / 32 個の要素が必要です.
+    //! @param[in]      pThreadPool 並列処理に用いるスレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+    //-------------------------------------------------------------------------
+    void Test(const BoundingSphere* pSpheres, uint32_t count, uint32_t* pMask, IThreadPool* pThreadPool = nullptr) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バウンディングボックスをカリングし，可視なものの番号を詰めて格納します.
+    //!
+    //! @param[in]      pBoxes      バウンディングボックスの配列です.
+    //! @param[in]      count       バウンディングボックス数です.
+    //! @param[out]     pIndices    可視なものの番号の格納先です. count 個の要素が必要です.
+    //! @param[in]      pThreadPool 並列処理に用いるスレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+    //! @return     可視なものの数を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Cull(const BoundingBox* pBoxes, uint32_t count, uint32_t* pIndices, IThreadPool* pThreadPool = nullptr) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バウンディングスフィアをカリングし，可視なものの番号を詰めて格納します.
+    //!
+    //! @param[in]      pSpheres    バウンディングスフィアの配列です.
+    //! @param[in]      count       バウンディングスフィア数です.
+    //! @param[out]     pIndices    可視なものの番号の格納先です. count 個の要素が必要です.
+    //! @param[in]      pThreadPool 並列処理に用いるスレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+    //! @return     可視なものの数を返却します.
+    //-------------------------------------------------------------------------
+    uint32_t Cull(const BoundingSphere* pSpheres, uint32_t count, uint32_t* pIndices, IThreadPool* pThreadPool = nullptr) const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    Vector4     m_Planes[SHADOW_PLANE_COUNT];   //!< 平面.
+    uint32_t    m_PlaneCount;                   //!< 平面数.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      可視マスクから可視なものの番号を詰めて格納します.
+//!
+//! @param[in]      pMask       可視マスクです.
+//! @param[in]      count       判定したオブジェクト数です.
+//! @param[out]     pIndices    番号の格納先です.
+//! @return     格納した番号の数を返却します.
+//-----------------------------------------------------------------------------
+uint32_t CompactVisibleIndices(const uint32_t* pMask, uint32_t count, uint32_t* pIndices);
+
+} // namespace asdx
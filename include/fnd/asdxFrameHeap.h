@@ -9,6 +9,9 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <new>
 
 
 namespace asdx {
@@ -27,7 +30,8 @@ public:
     //=========================================================================
     // public variables.
     //=========================================================================
-    /* NOTHING */
+    static const size_t DEFAULT_ALIGNMENT   = 16;           //!< ftHg̃ACgł.
+    static const size_t DEFAULT_PAGE_SIZE   = 64 * 1024;    //!< ftHg̃Xbhy[WTCYł.
 
     //=========================================================================
     // public methods.
@@ -46,11 +50,15 @@ public:
     //-------------------------------------------------------------------------
     //! @brief      s܂.
     //!
-    //! @param[in]      size        mۃTCY.
+    //! @param[in]      size        1t[̃mۃTCY.
+    //! @param[in]      frameCount  obt@Ot[.
+    //! @param[in]      pageSize    Xbhɐ؂oy[WTCY.
+    //! @note       eXbh̃y[W̖gp͑XbhgȂ߁C
+    //!             size ɂ͊mۂ鑍ʂɉ pageSize * mۂXbh x̗]TĂ.
     //! @retval true    ɐ.
     //! @retval false   Ɏs.
     //-------------------------------------------------------------------------
-    bool Init(size_t size);
+    bool Init(size_t size, uint32_t frameCount = 1, size_t pageSize = DEFAULT_PAGE_SIZE);
 
     //-------------------------------------------------------------------------
     //! @brief      Is܂.
@@ -58,7 +66,10 @@ public:
     void Term();
 
     //-------------------------------------------------------------------------
-    //! @brief      obt@擪ɃItZbgZbg܂.
+    //! @brief      ̃t[ɐ؂ւC̃t[̃obt@Zbg܂.
+    //!
+    //! @note       O (frameCount - 1) t[̃͗LȂ܂܎c܂.
+    //!             Xbh Alloc() ĂȂԂɌĂяoĂ.
     //-------------------------------------------------------------------------
     void Reset();
 
@@ -66,25 +77,51 @@ public:
     //! @brief      mۂ܂.
     //!
     //! @param[in]      size        mۂ郁TCY.
+    //! @param[in]      alignment   ACg(2ׂ̂).
     //! @return     mۂւ̃|C^ԋp܂.
     //!             mۂɎsꍇ nullptr ԋp܂.
+    //! @note       Xbh瓯ɌĂяo\ł.
     //-------------------------------------------------------------------------
-    void* Alloc(size_t size);
+    void* Alloc(size_t size, size_t alignment = DEFAULT_ALIGNMENT);
 
     //-------------------------------------------------------------------------
     //! @brief      TCY擾܂.
     //!
-    //! @return     TCYԋp܂.
+    //! @return     1t[̃TCYԋp܂.
     //-------------------------------------------------------------------------
     size_t GetSize() const;
 
     //-------------------------------------------------------------------------
     //! @brief      p\ȃTCY擾܂.
     //!
-    //! @return     p\ȃTCYԋp܂.
+    //! @return     ݂̃t[ŗp\ȃTCYԋp܂.
     //-------------------------------------------------------------------------
     size_t GetRestSize() const;
 
+    //-------------------------------------------------------------------------
+    //! @brief      gpς݃TCY擾܂.
+    //!
+    //! @return     ݂̃t[ŃXbhɊ蓖čς݂̃TCYԋp܂.
+    //-------------------------------------------------------------------------
+    size_t GetUsedSize() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      őgpTCY擾܂.
+    //!
+    //! @return     ܂ResetHighWaterMark()ȍ~1t[̍őgpʂԋp܂.
+    //-------------------------------------------------------------------------
+    size_t GetHighWaterMark() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      őgpTCYZbg܂.
+    //-------------------------------------------------------------------------
+    void ResetHighWaterMark();
+
+    //-------------------------------------------------------------------------
+    //! @brief      mۂɎs񐔂擾܂.
+    //-------------------------------------------------------------------------
+    uint32_t GetFailedCount() const;
+
     //-------------------------------------------------------------------------
     //! @brief      mۂ܂.
     //!
@@ -94,22 +131,54 @@ public:
     template<typename T>
     T* Alloc()
     {
-        const auto buf = Alloc(sizeof(T));
+        const auto buf = Alloc(sizeof(T), alignof(T));
+        if (buf == nullptr)
+        { return nullptr; }
+
         return new(buf) T();
     }
 
 private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Frame structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        uint8_t*                pBuffer = nullptr;  //!< obt@ł.
+        std::atomic<size_t>     Offset;             //!< obt@擪̃ItZbgł.
+    };
+
     //=========================================================================
     // private variables.
     //=========================================================================
-    size_t      m_Size;         //!< obt@TCYł.
-    uint8_t*    m_pBuffer;      //!< obt@ł.
-    size_t      m_Offset;       //!< obt@擪̃ItZbgł.
+    size_t                  m_Size;             //!< 1t[̃obt@TCYł.
+    size_t                  m_PageSize;         //!< Xbhy[WTCYł.
+    uint32_t                m_FrameCount;       //!< t[ł.
+    uint32_t                m_FrameIndex;       //!< ݂̃t[ԍł.
+    Frame*                  m_pFrames;          //!< t[obt@ł.
+    std::atomic<uint64_t>   m_Epoch;            //!< XbhLbV̗LɎgԍł.
+    std::atomic<size_t>     m_HighWaterMark;    //!< őgpʂł.
+    std::atomic<uint32_t>   m_FailedCount;      //!< mێs񐔂ł.
 
     //=========================================================================
     // private methods.
     //=========================================================================
-    /* NOTHING */
+
+    //-------------------------------------------------------------------------
+    //! @brief      ݂̃t[璼ڐ؂o܂.
+    //-------------------------------------------------------------------------
+    uint8_t* AllocFromFrame(size_t size, size_t alignment);
+
+    //-------------------------------------------------------------------------
+    //! @brief      y[W̖݂̃t[̐擪ʒuł΁Cgpԋp܂.
+    //!
+    //! @retval true    ԋpɐ.
+    //! @retval false   ̃Xbh납؂oς݂̂ߕԋpłȂ.
+    //-------------------------------------------------------------------------
+    bool ReturnToFrame(uint8_t* pCurr, uint8_t* pEnd);
+
+    FrameHeap       (const FrameHeap&) = delete;
+    void operator = (const FrameHeap&) = delete;
 };
 
 } // namespace asdx
\ No newline at end of file
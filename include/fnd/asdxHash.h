@@ -51,4 +51,153 @@ inline uint32_t CalcHash(const char* buffer)
     return hash;
 }
 
+namespace detail {
+
+//-----------------------------------------------------------------------------
+// 64bitハッシュ用の定数です.
+//-----------------------------------------------------------------------------
+static const uint64_t kHashPrime64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kHashPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kHashPrime64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t kHashPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t kHashPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+//-----------------------------------------------------------------------------
+//      左ローテートします.
+//-----------------------------------------------------------------------------
+inline uint64_t RotateLeft64(uint64_t value, uint32_t shift)
+{ return (value << shift) | (value >> (64 - shift)); }
+
+//-----------------------------------------------------------------------------
+//      アライメントを問わず64bit値を読み取ります.
+//-----------------------------------------------------------------------------
+inline uint64_t Read64(const uint8_t* ptr)
+{
+    uint64_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      アライメントを問わず32bit値を読み取ります.
+//-----------------------------------------------------------------------------
+inline uint32_t Read32(const uint8_t* ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      レーンに8byteを取り込みます.
+//-----------------------------------------------------------------------------
+inline uint64_t HashRound64(uint64_t acc, uint64_t input)
+{
+    acc += input * kHashPrime64_2;
+    acc  = RotateLeft64(acc, 31);
+    return acc * kHashPrime64_1;
+}
+
+//-----------------------------------------------------------------------------
+//      レーンの値を集約値に合成します.
+//-----------------------------------------------------------------------------
+inline uint64_t HashMerge64(uint64_t acc, uint64_t lane)
+{
+    acc ^= HashRound64(0, lane);
+    return acc * kHashPrime64_1 + kHashPrime64_4;
+}
+
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+//! @brief      64bitハッシュ値を計算します.
+//!
+//! @param[in]      buffer      バッファ.
+//! @param[in]      size        バッファサイズ.
+//! @param[in]      seed        シード値. 別のハッシュ値を渡すと連結したデータのキーとして使えます.
+//! @return     ハッシュ値を返却します.
+//! @note       xxHash64 と同じアルゴリズムです. 4レーン並列に 8byte 単位で処理するため，
+//!             大きなファイル全体のハッシュにも使えます.
+//-----------------------------------------------------------------------------
+inline uint64_t CalcHash64(const void* buffer, size_t size, uint64_t seed = 0)
+{
+    using namespace detail;
+
+    auto ptr = static_cast<const uint8_t*>(buffer);
+    auto end = ptr + size;
+    uint64_t hash;
+
+    if (size >= 32)
+    {
+        auto limit = end - 32;
+        uint64_t v1 = seed + kHashPrime64_1 + kHashPrime64_2;
+        uint64_t v2 = seed + kHashPrime64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kHashPrime64_1;
+
+        do
+        {
+            v1 = HashRound64(v1, Read64(ptr +  0));
+            v2 = HashRound64(v2, Read64(ptr +  8));
+            v3 = HashRound64(v3, Read64(ptr + 16));
+            v4 = HashRound64(v4, Read64(ptr + 24));
+            ptr += 32;
+        }
+        while (ptr <= limit);
+
+        hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) + RotateLeft64(v4, 18);
+        hash = HashMerge64(hash, v1);
+        hash = HashMerge64(hash, v2);
+        hash = HashMerge64(hash, v3);
+        hash = HashMerge64(hash, v4);
+    }
+    else
+    {
+        hash = seed + kHashPrime64_5;
+    }
+
+    hash += uint64_t(size);
+
+    while (ptr + 8 <= end)
+    {
+        hash ^= HashRound64(0, Read64(ptr));
+        hash  = RotateLeft64(hash, 27) * kHashPrime64_1 + kHashPrime64_4;
+        ptr  += 8;
+    }
+
+    if (ptr + 4 <= end)
+    {
+        hash ^= uint64_t(Read32(ptr)) * kHashPrime64_1;
+        hash  = RotateLeft64(hash, 23) * kHashPrime64_2 + kHashPrime64_3;
+        ptr  += 4;
+    }
+
+    while (ptr < end)
+    {
+        hash ^= uint64_t(*ptr) * kHashPrime64_5;
+        hash  = RotateLeft64(hash, 11) * kHashPrime64_1;
+        ptr++;
+    }
+
+    // 最終的な撹拌.
+    hash ^= hash >> 33;
+    hash *= kHashPrime64_2;
+    hash ^= hash >> 29;
+    hash *= kHashPrime64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      終端文字までの文字列の64bitハッシュ値を計算します.
+//!
+//! @param[in]      buffer      文字列.
+//! @param[in]      seed        シード値.
+//! @return     ハッシュ値を返却します.
+//! @note       CalcHash64(const void*, size_t) と引数が紛れないよう名前を分けています.
+//-----------------------------------------------------------------------------
+inline uint64_t CalcHash64String(const char* buffer, uint64_t seed = 0)
+{ return CalcHash64(buffer, strlen(buffer), seed); }
+
 } // namespace asdx
@@ -0,0 +1,232 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxJobGraph.h
+// Desc : Job Graph.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <fnd/asdxThreadPool.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class JobGraph;
+class Job;
+
+using JobFunction = std::function<void(JobGraph* graph, Job* job)>;
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Job class
+///////////////////////////////////////////////////////////////////////////////
+class Job : public IRunnable
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    friend class JobGraph;
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    Job();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~Job();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブを実行します.
+    //-------------------------------------------------------------------------
+    void Run() override;
+
+    //-------------------------------------------------------------------------
+    //! @brief      タグを取得します.
+    //-------------------------------------------------------------------------
+    const char* GetTag() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      親ジョブを取得します.
+    //-------------------------------------------------------------------------
+    Job* GetParent() const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    char                    m_Tag[64]           = {};
+    JobGraph*               m_pGraph            = nullptr;  //!< 所属グラフ.
+    Job*                    m_pParent           = nullptr;  //!< 親ジョブ.
+    JobFunction             m_Function          = nullptr;  //!< 実行関数.
+    std::vector<Job*>       m_Successors;                   //!< 後続ジョブ.
+    uint32_t                m_DependencyCount   = 0;        //!< 先行ジョブ数.
+    std::atomic<uint32_t>   m_PendingDeps;                  //!< 未完了の先行ジョブ数.
+    std::atomic<uint32_t>   m_PendingWork;                  //!< 自身と未完了の子ジョブ数.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      自身または子ジョブの完了を通知します.
+    //-------------------------------------------------------------------------
+    void Finish();
+
+    Job             (const Job&) = delete;
+    void operator = (const Job&) = delete;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// JobGraph class
+///////////////////////////////////////////////////////////////////////////////
+class JobGraph
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    friend class Job;
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    JobGraph();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~JobGraph();
+
+    //-------------------------------------------------------------------------
+    //! @brief      初期化処理を行います.
+    //!
+    //! @param[in]      pThreadPool     ジョブを実行するスレッドプールです.
+    //! @param[in]      maxJobCount     子ジョブを含む最大ジョブ数です.
+    //! @retval true    初期化に成功.
+    //! @retval false   初期化に失敗.
+    //-------------------------------------------------------------------------
+    bool Init(IThreadPool* pThreadPool, uint32_t maxJobCount);
+
+    //-------------------------------------------------------------------------
+    //! @brief      終了処理を行います.
+    //-------------------------------------------------------------------------
+    void Term();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブを追加します.
+    //!
+    //! @param[in]      tag         デバッグ用のタグです.
+    //! @param[in]      function    実行関数です.
+    //! @return     追加したジョブを返却します. 失敗した場合は nullptr を返却します.
+    //! @note       Execute() 実行中に呼び出してはいけません.
+    //-------------------------------------------------------------------------
+    Job* AddJob(const char* tag, JobFunction function);
+
+    //-------------------------------------------------------------------------
+    //! @brief      依存関係を追加します.
+    //!
+    //! @param[in]      before      先に実行されるジョブです.
+    //! @param[in]      after       before の完了後に実行されるジョブです.
+    //! @note       Execute() 実行中に呼び出してはいけません.
+    //-------------------------------------------------------------------------
+    void AddDependency(Job* before, Job* after);
+
+    //-------------------------------------------------------------------------
+    //! @brief      子ジョブを生成し，実行を開始します.
+    //!
+    //! @param[in]      parent      親ジョブです.
+    //! @param[in]      tag         デバッグ用のタグです.
+    //! @param[in]      function    実行関数です.
+    //! @return     生成したジョブを返却します. 失敗した場合は nullptr を返却します.
+    //! @note       親ジョブの実行関数内から呼び出します.
+    //!             親ジョブの後続ジョブは子ジョブがすべて完了するまで実行されません.
+    //-------------------------------------------------------------------------
+    Job* Spawn(Job* parent, const char* tag, JobFunction function);
+
+    //-------------------------------------------------------------------------
+    //! @brief      先行ジョブを持たないジョブから実行を開始します.
+    //!
+    //! @note       前回の実行で生成された子ジョブは破棄されます.
+    //-------------------------------------------------------------------------
+    void Execute();
+
+    //-------------------------------------------------------------------------
+    //! @brief      すべてのジョブの完了を待機します.
+    //-------------------------------------------------------------------------
+    void Wait();
+
+    //-------------------------------------------------------------------------
+    //! @brief      すべてのジョブと依存関係を削除します.
+    //-------------------------------------------------------------------------
+    void Reset();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブ数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetJobCount() const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    IThreadPool*            m_pThreadPool   = nullptr;
+    Job*                    m_pJobs         = nullptr;  //!< ジョブプール.
+    uint32_t                m_MaxJobCount   = 0;
+    uint32_t                m_StaticCount   = 0;        //!< AddJob() で追加されたジョブ数.
+    std::atomic<uint32_t>   m_JobCount;                 //!< 子ジョブを含む使用中のジョブ数.
+    JobCounter              m_Counter;                  //!< 実行中ジョブのカウンター.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブプールから確保します.
+    //-------------------------------------------------------------------------
+    Job* Alloc(const char* tag, JobFunction function);
+
+    //-------------------------------------------------------------------------
+    //! @brief      前回の実行で生成された子ジョブを破棄します.
+    //-------------------------------------------------------------------------
+    void TrimSpawnedJobs();
+
+    //-------------------------------------------------------------------------
+    //! @brief      スレッドプールにジョブを積みます.
+    //-------------------------------------------------------------------------
+    void Submit(Job* job);
+
+    JobGraph        (const JobGraph&) = delete;
+    void operator = (const JobGraph&) = delete;
+};
+
+} // namespace asdx
@@ -0,0 +1,103 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.h
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+class MappedFile
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    MappedFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~MappedFile();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを読み取り専用でメモリにマップします.
+    //!
+    //! @param[in]      path        ファイルパスです.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //-------------------------------------------------------------------------
+    bool OpenA(const char* path);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを読み取り専用でメモリにマップします.
+    //!
+    //! @param[in]      path        ファイルパスです.
+    //! @retval true    マップに成功.
+    //! @retval false   マップに失敗.
+    //-------------------------------------------------------------------------
+    bool OpenW(const wchar_t* path);
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップを解除し，ファイルを閉じます.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      マップされたデータの先頭を取得します.
+    //!
+    //! @note       サイズ 0 のファイルの場合は nullptr を返却します.
+    //-------------------------------------------------------------------------
+    const uint8_t* GetData() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルサイズを取得します.
+    //-------------------------------------------------------------------------
+    size_t GetSize() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルが開かれているかどうかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsOpen() const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    void*       m_hFile;    //!< ファイルハンドル.
+    void*       m_hMapping; //!< ファイルマッピングハンドル.
+    uint8_t*    m_pData;    //!< マップされたデータ.
+    size_t      m_Size;     //!< ファイルサイズ.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    MappedFile      (const MappedFile&) = delete;
+    void operator = (const MappedFile&) = delete;
+};
+
+} // namespace asdx
@@ -9,6 +9,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdint>
+#include <cstddef>
 #include <cmath>
 #include <complex>
 #include <cfloat>
@@ -17,6 +18,39 @@
 #include <climits>
 
 
+//-----------------------------------------------------------------------------
+// SIMD Settings
+//-----------------------------------------------------------------------------
+// ASDX_ENABLE_MATH_SIMD を定義すると，Matrix と Vector4 の一部の演算および配列演算が
+// コンパイラのターゲットに応じた SIMD 命令 (AVX2 / SSE2 / NEON) で処理されます.
+// SIMD 版の関数 (detail::MultiplySimd() など) は定義に関わらず利用できるので，
+// 定義していない場合もスカラー版との比較に使えます.
+#if defined(__AVX2__)
+    #define ASDX_MATH_AVX2      (1)
+    #define ASDX_MATH_SSE2      (1)
+#elif defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define ASDX_MATH_SSE2      (1)
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    #define ASDX_MATH_NEON      (1)
+#endif
+
+#if defined(ASDX_ENABLE_MATH_SIMD) && (defined(ASDX_MATH_SSE2) || defined(ASDX_MATH_NEON))
+    #define ASDX_MATH_SIMD          (1)
+#endif
+
+#if defined(ASDX_MATH_AVX2)
+    #include <immintrin.h>
+#elif defined(ASDX_MATH_SSE2)
+    #include <emmintrin.h>
+#elif defined(ASDX_MATH_NEON)
+    #if defined(_M_ARM64)
+        #include <arm64_neon.h>
+    #else
+        #include <arm_neon.h>
+    #endif
+#endif
+
+
 namespace asdx {
 
 //-----------------------------------------------------------------------------
@@ -289,6 +323,29 @@ half     ToHalf( float value );
 //-----------------------------------------------------------------------------
 float     ToFloat( half value );
 
+//-----------------------------------------------------------------------------
+//! @brief      float型の配列をhalf型の配列に一括変換します.
+//!
+//! @param [in]     pSrc        変換元の配列.
+//! @param [out]    pDst        変換結果の格納先.
+//! @param [in]     count       要素数.
+//! @note       最近接偶数丸めで変換します. half型で表現できない大きさの値(無限大を含む)は
+//!             ±65504 に飽和し，NaN は NaN のまま変換されます.
+//!             F16C 命令が使用できる環境では F16C 命令で変換します.
+//-----------------------------------------------------------------------------
+void ConvertF32ToF16( const float* pSrc, half* pDst, size_t count );
+
+//-----------------------------------------------------------------------------
+//! @brief      half型の配列をfloat型の配列に一括変換します.
+//!
+//! @param [in]     pSrc        変換元の配列.
+//! @param [out]    pDst        変換結果の格納先.
+//! @param [in]     count       要素数.
+//! @note       IEEE 754 に従って変換するため，無限大と NaN はそのまま変換されます.
+//!             F16C 命令が使用できる環境では F16C 命令で変換します.
+//-----------------------------------------------------------------------------
+void ConvertF16ToF32( const half* pSrc, float* pDst, size_t count );
+
 //-----------------------------------------------------------------------------
 //! @brief      線形補間を行います.
 //!
@@ -1625,6 +1682,87 @@ public:
     //-------------------------------------------------------------------------
     static void    TransformCoord( const Vector3& coord, const Matrix& matrix, Vector3& result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力ベクトル間のバイト数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換されたベクトルの格納先.
+    //! @param [in]     outputStride    出力ベクトル間のバイト数.
+    //! @param [in]     count           ベクトル数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    TransformArray( const Vector3* pInput, size_t inputStride, const Matrix& matrix, Vector3* pOutput, size_t outputStride, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，成分毎に分離されたベクトル配列を変換します.
+    //!
+    //! @param [in]     pX          入力ベクトルのX成分配列.
+    //! @param [in]     pY          入力ベクトルのY成分配列.
+    //! @param [in]     pZ          入力ベクトルのZ成分配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutX       変換されたベクトルのX成分の格納先.
+    //! @param [out]    pOutY       変換されたベクトルのY成分の格納先.
+    //! @param [out]    pOutZ       変換されたベクトルのZ成分の格納先.
+    //! @param [in]     count       ベクトル数.
+    //-------------------------------------------------------------------------
+    static void    TransformArray( const float* pX, const float* pY, const float* pZ, const Matrix& matrix, float* pOutX, float* pOutY, float* pOutZ, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，法線ベクトル配列を変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力ベクトル間のバイト数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換された法線ベクトルの格納先.
+    //! @param [in]     outputStride    出力ベクトル間のバイト数.
+    //! @param [in]     count           ベクトル数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    TransformNormalArray( const Vector3* pInput, size_t inputStride, const Matrix& matrix, Vector3* pOutput, size_t outputStride, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，成分毎に分離された法線ベクトル配列を変換します.
+    //!
+    //! @param [in]     pX          入力ベクトルのX成分配列.
+    //! @param [in]     pY          入力ベクトルのY成分配列.
+    //! @param [in]     pZ          入力ベクトルのZ成分配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutX       変換された法線ベクトルのX成分の格納先.
+    //! @param [out]    pOutY       変換された法線ベクトルのY成分の格納先.
+    //! @param [out]    pOutZ       変換された法線ベクトルのZ成分の格納先.
+    //! @param [in]     count       ベクトル数.
+    //-------------------------------------------------------------------------
+    static void    TransformNormalArray( const float* pX, const float* pY, const float* pZ, const Matrix& matrix, float* pOutX, float* pOutY, float* pOutZ, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いてベクトル配列を変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力ベクトル間のバイト数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         行列変換後，w=1に射影されたベクトルの格納先.
+    //! @param [in]     outputStride    出力ベクトル間のバイト数.
+    //! @param [in]     count           ベクトル数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    TransformCoordArray( const Vector3* pInput, size_t inputStride, const Matrix& matrix, Vector3* pOutput, size_t outputStride, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて成分毎に分離されたベクトル配列を変換し，変換結果をw=1に射影します.
+    //!
+    //! @param [in]     pX          入力ベクトルのX成分配列.
+    //! @param [in]     pY          入力ベクトルのY成分配列.
+    //! @param [in]     pZ          入力ベクトルのZ成分配列.
+    //! @param [in]     matrix      変換行列.
+    //! @param [out]    pOutX       射影されたベクトルのX成分の格納先.
+    //! @param [out]    pOutY       射影されたベクトルのY成分の格納先.
+    //! @param [out]    pOutZ       射影されたベクトルのZ成分の格納先.
+    //! @param [in]     count       ベクトル数.
+    //-------------------------------------------------------------------------
+    static void    TransformCoordArray( const float* pX, const float* pY, const float* pZ, const Matrix& matrix, float* pOutX, float* pOutY, float* pOutZ, size_t count );
+
     //-------------------------------------------------------------------------
     //! @brief      スカラー3重積を計算します.
     //!
@@ -2244,6 +2382,19 @@ public:
     //-------------------------------------------------------------------------
     static void    Transform( const Vector4& position, const Matrix& matrix, Vector4 &result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      指定された行列を用いて，ベクトル配列を変換します.
+    //!
+    //! @param [in]     pInput          入力ベクトル配列.
+    //! @param [in]     inputStride     入力ベクトル間のバイト数.
+    //! @param [in]     matrix          変換行列.
+    //! @param [out]    pOutput         変換されたベクトルの格納先.
+    //! @param [in]     outputStride    出力ベクトル間のバイト数.
+    //! @param [in]     count           ベクトル数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    TransformArray( const Vector4* pInput, size_t inputStride, const Matrix& matrix, Vector4* pOutput, size_t outputStride, size_t count );
+
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -2585,6 +2736,28 @@ public:
     //-------------------------------------------------------------------------
     static void    MultiplyTranspose( const Matrix& a, const Matrix& b, Matrix &result );
 
+    //-------------------------------------------------------------------------
+    //! @brief      行列配列の各要素に同じ行列を乗算します.
+    //!
+    //! @param [in]     pInput      入力行列配列.
+    //! @param [in]     matrix      右から乗算する行列.
+    //! @param [out]    pOutput     乗算結果の格納先.
+    //! @param [in]     count       行列数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    MultiplyArray( const Matrix* pInput, const Matrix& matrix, Matrix* pOutput, size_t count );
+
+    //-------------------------------------------------------------------------
+    //! @brief      行列配列同士を要素毎に乗算します.
+    //!
+    //! @param [in]     pA          入力行列配列.
+    //! @param [in]     pB          右から乗算する行列配列.
+    //! @param [out]    pOutput     乗算結果の格納先.
+    //! @param [in]     count       行列数.
+    //! @note       入力と出力は同じ領域を指定できます.
+    //-------------------------------------------------------------------------
+    static void    MultiplyArray( const Matrix* pA, const Matrix* pB, Matrix* pOutput, size_t count );
+
     //-------------------------------------------------------------------------
     //! @brief      逆行列を求めます.
     //!
@@ -4122,6 +4295,22 @@ uint16_t EncodeSnorm2(const Vector2& value);
 //-----------------------------------------------------------------------------
 Vector2 DecodeSnorm2(uint16_t value);
 
+//-----------------------------------------------------------------------------
+//! @brief      単位ベクトルを八面体マッピングで2次元に変換します.
+//!
+//! @param[in]      value       単位ベクトル.
+//! @return     [-1, 1] の範囲の2次元ベクトルを返却します.
+//-----------------------------------------------------------------------------
+Vector2 EncodeOctahedral(const Vector3& value);
+
+//-----------------------------------------------------------------------------
+//! @brief      八面体マッピングされた2次元ベクトルを単位ベクトルに展開します.
+//!
+//! @param[in]      value       [-1, 1] の範囲の2次元ベクトル.
+//! @return     展開した単位ベクトルを返却します.
+//-----------------------------------------------------------------------------
+Vector3 DecodeOctahedral(const Vector2& value);
+
 } // namespace asdx
 
 //-----------------------------------------------------------------------------
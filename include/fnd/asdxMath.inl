@@ -7,6 +7,565 @@
 
 namespace asdx {
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Detail Functions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+// TRANSFORM_MODE enum
+///////////////////////////////////////////////////////////////////////////////
+enum TRANSFORM_MODE
+{
+    TRANSFORM_POSITION  = 0,    //!< w=1 として変換.
+    TRANSFORM_NORMAL    = 1,    //!< w=0 として変換.
+    TRANSFORM_COORD     = 2,    //!< w=1 として変換し，w=1 に射影.
+};
+
+#if defined(ASDX_MATH_SSE2)
+using SimdFloat4 = __m128;
+
+//-----------------------------------------------------------------------------
+//      4要素を読み込みます.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 LoadFloat4Simd( const float* p )
+{ return _mm_loadu_ps( p ); }
+
+//-----------------------------------------------------------------------------
+//      3要素を読み込みます(w=0).
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 LoadFloat3Simd( const float* p )
+{
+    auto xy = _mm_castpd_ps( _mm_load_sd( reinterpret_cast<const double*>( p ) ) );
+    auto z  = _mm_load_ss( p + 2 );
+    return _mm_movelh_ps( xy, z );
+}
+
+//-----------------------------------------------------------------------------
+//      4要素を書き込みます.
+//-----------------------------------------------------------------------------
+inline
+void StoreFloat4Simd( float* p, SimdFloat4 v )
+{ _mm_storeu_ps( p, v ); }
+
+//-----------------------------------------------------------------------------
+//      3要素を書き込みます.
+//-----------------------------------------------------------------------------
+inline
+void StoreFloat3Simd( float* p, SimdFloat4 v )
+{
+    _mm_store_sd( reinterpret_cast<double*>( p ), _mm_castps_pd( v ) );
+    _mm_store_ss( p + 2, _mm_movehl_ps( v, v ) );
+}
+
+//-----------------------------------------------------------------------------
+//      スカラー値を全レーンに展開します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 ReplicateSimd( float value )
+{ return _mm_set1_ps( value ); }
+
+//-----------------------------------------------------------------------------
+//      指定レーンの値を全レーンに展開します.
+//-----------------------------------------------------------------------------
+template<int Lane> inline
+SimdFloat4 SplatSimd( SimdFloat4 v )
+{ return _mm_shuffle_ps( v, v, _MM_SHUFFLE(Lane, Lane, Lane, Lane) ); }
+
+//-----------------------------------------------------------------------------
+//      加算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 AddSimd( SimdFloat4 a, SimdFloat4 b )
+{ return _mm_add_ps( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      乗算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 MulSimd( SimdFloat4 a, SimdFloat4 b )
+{ return _mm_mul_ps( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      除算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 DivSimd( SimdFloat4 a, SimdFloat4 b )
+{ return _mm_div_ps( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      行ベクトルと行列を乗算します.
+//-----------------------------------------------------------------------------
+inline
+__m128 TransformRowSimd( __m128 v, __m128 r0, __m128 r1, __m128 r2, __m128 r3 )
+{
+    // スカラー版と同じ順序で加算するため，FMAは使用しない.
+    auto result = _mm_mul_ps( SplatSimd<0>( v ), r0 );
+    result = _mm_add_ps( result, _mm_mul_ps( SplatSimd<1>( v ), r1 ) );
+    result = _mm_add_ps( result, _mm_mul_ps( SplatSimd<2>( v ), r2 ) );
+    result = _mm_add_ps( result, _mm_mul_ps( SplatSimd<3>( v ), r3 ) );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      4次元ベクトルを行列で変換します.
+//-----------------------------------------------------------------------------
+inline
+void TransformSimd( const float* v, const float* m, float* result )
+{
+    auto r = TransformRowSimd(
+        _mm_loadu_ps( v ),
+        _mm_loadu_ps( m + 0 ),
+        _mm_loadu_ps( m + 4 ),
+        _mm_loadu_ps( m + 8 ),
+        _mm_loadu_ps( m + 12 ) );
+    _mm_storeu_ps( result, r );
+}
+
+//-----------------------------------------------------------------------------
+//      行列同士を乗算します.
+//-----------------------------------------------------------------------------
+inline
+void MultiplySimd( const float* a, const float* b, float* result, bool transpose )
+{
+#if defined(ASDX_MATH_AVX2)
+    // 2行ずつ処理する.
+    auto b0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 0 ) );
+    auto b1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 4 ) );
+    auto b2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 8 ) );
+    auto b3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( b + 12 ) );
+
+    auto a01 = _mm256_loadu_ps( a + 0 );
+    auto a23 = _mm256_loadu_ps( a + 8 );
+
+    auto r01 = _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x00 ), b0 );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0x55 ), b1 ) );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xaa ), b2 ) );
+    r01 = _mm256_add_ps( r01, _mm256_mul_ps( _mm256_shuffle_ps( a01, a01, 0xff ), b3 ) );
+
+    auto r23 = _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x00 ), b0 );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0x55 ), b1 ) );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xaa ), b2 ) );
+    r23 = _mm256_add_ps( r23, _mm256_mul_ps( _mm256_shuffle_ps( a23, a23, 0xff ), b3 ) );
+
+    if ( !transpose )
+    {
+        _mm256_storeu_ps( result + 0, r01 );
+        _mm256_storeu_ps( result + 8, r23 );
+        return;
+    }
+
+    auto r0 = _mm256_castps256_ps128( r01 );
+    auto r1 = _mm256_extractf128_ps( r01, 1 );
+    auto r2 = _mm256_castps256_ps128( r23 );
+    auto r3 = _mm256_extractf128_ps( r23, 1 );
+#else
+    auto b0 = _mm_loadu_ps( b + 0 );
+    auto b1 = _mm_loadu_ps( b + 4 );
+    auto b2 = _mm_loadu_ps( b + 8 );
+    auto b3 = _mm_loadu_ps( b + 12 );
+
+    // 結果が a または b と同じ領域でも良いように，全て読み込んでから書き込む.
+    auto r0 = TransformRowSimd( _mm_loadu_ps( a + 0 ),  b0, b1, b2, b3 );
+    auto r1 = TransformRowSimd( _mm_loadu_ps( a + 4 ),  b0, b1, b2, b3 );
+    auto r2 = TransformRowSimd( _mm_loadu_ps( a + 8 ),  b0, b1, b2, b3 );
+    auto r3 = TransformRowSimd( _mm_loadu_ps( a + 12 ), b0, b1, b2, b3 );
+#endif
+
+    if ( transpose )
+    { _MM_TRANSPOSE4_PS( r0, r1, r2, r3 ); }
+
+    _mm_storeu_ps( result + 0,  r0 );
+    _mm_storeu_ps( result + 4,  r1 );
+    _mm_storeu_ps( result + 8,  r2 );
+    _mm_storeu_ps( result + 12, r3 );
+}
+
+//-----------------------------------------------------------------------------
+//      2x2行列同士を乗算します.
+//-----------------------------------------------------------------------------
+inline
+__m128 Mat2MulSimd( __m128 a, __m128 b )
+{
+    return _mm_add_ps(
+        _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(3, 0, 3, 0) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+}
+
+//-----------------------------------------------------------------------------
+//      2x2行列の余因子行列と2x2行列を乗算します.
+//-----------------------------------------------------------------------------
+inline
+__m128 Mat2AdjMulSimd( __m128 a, __m128 b )
+{
+    return _mm_sub_ps(
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(0, 0, 3, 3) ), b ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 2, 1, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 0, 3, 2) ) ) );
+}
+
+//-----------------------------------------------------------------------------
+//      2x2行列と2x2行列の余因子行列を乗算します.
+//-----------------------------------------------------------------------------
+inline
+__m128 Mat2MulAdjSimd( __m128 a, __m128 b )
+{
+    return _mm_sub_ps(
+        _mm_mul_ps( a, _mm_shuffle_ps( b, b, _MM_SHUFFLE(0, 3, 0, 3) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( a, a, _MM_SHUFFLE(2, 3, 0, 1) ), _mm_shuffle_ps( b, b, _MM_SHUFFLE(1, 2, 1, 2) ) ) );
+}
+
+//-----------------------------------------------------------------------------
+//      逆行列を求めます.
+//-----------------------------------------------------------------------------
+inline
+void InvertSimd( const float* m, float* result )
+{
+    // 2x2 のブロック行列に分割して求める.
+    auto m0 = _mm_loadu_ps( m + 0 );
+    auto m1 = _mm_loadu_ps( m + 4 );
+    auto m2 = _mm_loadu_ps( m + 8 );
+    auto m3 = _mm_loadu_ps( m + 12 );
+
+    auto A = _mm_movelh_ps( m0, m1 );
+    auto B = _mm_movehl_ps( m1, m0 );
+    auto C = _mm_movelh_ps( m2, m3 );
+    auto D = _mm_movehl_ps( m3, m2 );
+
+    // ( |A|, |B|, |C|, |D| )
+    auto detSub = _mm_sub_ps(
+        _mm_mul_ps( _mm_shuffle_ps( m0, m2, _MM_SHUFFLE(2, 0, 2, 0) ), _mm_shuffle_ps( m1, m3, _MM_SHUFFLE(3, 1, 3, 1) ) ),
+        _mm_mul_ps( _mm_shuffle_ps( m0, m2, _MM_SHUFFLE(3, 1, 3, 1) ), _mm_shuffle_ps( m1, m3, _MM_SHUFFLE(2, 0, 2, 0) ) ) );
+    auto detA = SplatSimd<0>( detSub );
+    auto detB = SplatSimd<1>( detSub );
+    auto detC = SplatSimd<2>( detSub );
+    auto detD = SplatSimd<3>( detSub );
+
+    auto D_C = Mat2AdjMulSimd( D, C );
+    auto A_B = Mat2AdjMulSimd( A, B );
+    auto X_  = _mm_sub_ps( _mm_mul_ps( detD, A ), Mat2MulSimd( B, D_C ) );
+    auto W_  = _mm_sub_ps( _mm_mul_ps( detA, D ), Mat2MulSimd( C, A_B ) );
+    auto Y_  = _mm_sub_ps( _mm_mul_ps( detB, C ), Mat2MulAdjSimd( D, A_B ) );
+    auto Z_  = _mm_sub_ps( _mm_mul_ps( detC, B ), Mat2MulAdjSimd( A, D_C ) );
+
+    // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+    auto tr = _mm_mul_ps( A_B, _mm_shuffle_ps( D_C, D_C, _MM_SHUFFLE(3, 1, 2, 0) ) );
+    tr = _mm_add_ps( tr, _mm_shuffle_ps( tr, tr, _MM_SHUFFLE(2, 3, 0, 1) ) );
+    tr = _mm_add_ps( tr, _mm_shuffle_ps( tr, tr, _MM_SHUFFLE(1, 0, 3, 2) ) );
+
+    auto det = _mm_add_ps( _mm_mul_ps( detA, detD ), _mm_mul_ps( detB, detC ) );
+    det = _mm_sub_ps( det, tr );
+    assert( _mm_cvtss_f32( det ) != 0.0f );
+
+    auto rcp = _mm_div_ps( _mm_setr_ps( 1.0f, -1.0f, -1.0f, 1.0f ), det );
+    X_ = _mm_mul_ps( X_, rcp );
+    Y_ = _mm_mul_ps( Y_, rcp );
+    Z_ = _mm_mul_ps( Z_, rcp );
+    W_ = _mm_mul_ps( W_, rcp );
+
+    _mm_storeu_ps( result + 0,  _mm_shuffle_ps( X_, Y_, _MM_SHUFFLE(1, 3, 1, 3) ) );
+    _mm_storeu_ps( result + 4,  _mm_shuffle_ps( X_, Y_, _MM_SHUFFLE(0, 2, 0, 2) ) );
+    _mm_storeu_ps( result + 8,  _mm_shuffle_ps( Z_, W_, _MM_SHUFFLE(1, 3, 1, 3) ) );
+    _mm_storeu_ps( result + 12, _mm_shuffle_ps( Z_, W_, _MM_SHUFFLE(0, 2, 0, 2) ) );
+}
+
+#elif defined(ASDX_MATH_NEON)
+using SimdFloat4 = float32x4_t;
+
+//-----------------------------------------------------------------------------
+//      4要素を読み込みます.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 LoadFloat4Simd( const float* p )
+{ return vld1q_f32( p ); }
+
+//-----------------------------------------------------------------------------
+//      3要素を読み込みます(w=0).
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 LoadFloat3Simd( const float* p )
+{ return vcombine_f32( vld1_f32( p ), vld1_lane_f32( p + 2, vdup_n_f32( 0.0f ), 0 ) ); }
+
+//-----------------------------------------------------------------------------
+//      4要素を書き込みます.
+//-----------------------------------------------------------------------------
+inline
+void StoreFloat4Simd( float* p, SimdFloat4 v )
+{ vst1q_f32( p, v ); }
+
+//-----------------------------------------------------------------------------
+//      3要素を書き込みます.
+//-----------------------------------------------------------------------------
+inline
+void StoreFloat3Simd( float* p, SimdFloat4 v )
+{
+    vst1_f32( p, vget_low_f32( v ) );
+    vst1q_lane_f32( p + 2, v, 2 );
+}
+
+//-----------------------------------------------------------------------------
+//      スカラー値を全レーンに展開します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 ReplicateSimd( float value )
+{ return vdupq_n_f32( value ); }
+
+//-----------------------------------------------------------------------------
+//      指定レーンの値を全レーンに展開します.
+//-----------------------------------------------------------------------------
+template<int Lane> inline
+SimdFloat4 SplatSimd( SimdFloat4 v )
+{ return vdupq_laneq_f32( v, Lane ); }
+
+//-----------------------------------------------------------------------------
+//      加算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 AddSimd( SimdFloat4 a, SimdFloat4 b )
+{ return vaddq_f32( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      乗算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 MulSimd( SimdFloat4 a, SimdFloat4 b )
+{ return vmulq_f32( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      除算します.
+//-----------------------------------------------------------------------------
+inline
+SimdFloat4 DivSimd( SimdFloat4 a, SimdFloat4 b )
+{ return vdivq_f32( a, b ); }
+
+//-----------------------------------------------------------------------------
+//      行ベクトルと行列を乗算します.
+//-----------------------------------------------------------------------------
+inline
+float32x4_t TransformRowSimd( float32x4_t v, float32x4_t r0, float32x4_t r1, float32x4_t r2, float32x4_t r3 )
+{
+    // スカラー版と同じ順序で加算するため，積和命令は使用しない.
+    auto lo = vget_low_f32( v );
+    auto hi = vget_high_f32( v );
+    auto result = vmulq_lane_f32( r0, lo, 0 );
+    result = vaddq_f32( result, vmulq_lane_f32( r1, lo, 1 ) );
+    result = vaddq_f32( result, vmulq_lane_f32( r2, hi, 0 ) );
+    result = vaddq_f32( result, vmulq_lane_f32( r3, hi, 1 ) );
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      4次元ベクトルを行列で変換します.
+//-----------------------------------------------------------------------------
+inline
+void TransformSimd( const float* v, const float* m, float* result )
+{
+    auto r = TransformRowSimd(
+        vld1q_f32( v ),
+        vld1q_f32( m + 0 ),
+        vld1q_f32( m + 4 ),
+        vld1q_f32( m + 8 ),
+        vld1q_f32( m + 12 ) );
+    vst1q_f32( result, r );
+}
+
+//-----------------------------------------------------------------------------
+//      行列同士を乗算します.
+//-----------------------------------------------------------------------------
+inline
+void MultiplySimd( const float* a, const float* b, float* result, bool transpose )
+{
+    auto b0 = vld1q_f32( b + 0 );
+    auto b1 = vld1q_f32( b + 4 );
+    auto b2 = vld1q_f32( b + 8 );
+    auto b3 = vld1q_f32( b + 12 );
+
+    // 結果が a または b と同じ領域でも良いように，全て読み込んでから書き込む.
+    float32x4x4_t r;
+    r.val[0] = TransformRowSimd( vld1q_f32( a + 0 ),  b0, b1, b2, b3 );
+    r.val[1] = TransformRowSimd( vld1q_f32( a + 4 ),  b0, b1, b2, b3 );
+    r.val[2] = TransformRowSimd( vld1q_f32( a + 8 ),  b0, b1, b2, b3 );
+    r.val[3] = TransformRowSimd( vld1q_f32( a + 12 ), b0, b1, b2, b3 );
+
+    if ( transpose )
+    {
+        // インターリーブして書き込むと転置になる.
+        vst4q_f32( result, r );
+        return;
+    }
+
+    vst1q_f32( result + 0,  r.val[0] );
+    vst1q_f32( result + 4,  r.val[1] );
+    vst1q_f32( result + 8,  r.val[2] );
+    vst1q_f32( result + 12, r.val[3] );
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//      3次元ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+template<int Mode> inline
+void TransformFloat3Array
+(
+    const uint8_t*  pInput,
+    size_t          inputStride,
+    const float*    m,
+    uint8_t*        pOutput,
+    size_t          outputStride,
+    size_t          count
+)
+{
+#if defined(ASDX_MATH_SIMD)
+    auto r0 = LoadFloat4Simd( m + 0 );
+    auto r1 = LoadFloat4Simd( m + 4 );
+    auto r2 = LoadFloat4Simd( m + 8 );
+    auto r3 = LoadFloat4Simd( m + 12 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto v = LoadFloat3Simd( reinterpret_cast<const float*>( pInput + inputStride * i ) );
+
+        // スカラー版と同じ順序で加算する.
+        auto r = MulSimd( SplatSimd<0>( v ), r0 );
+        r = AddSimd( r, MulSimd( SplatSimd<1>( v ), r1 ) );
+        r = AddSimd( r, MulSimd( SplatSimd<2>( v ), r2 ) );
+
+        if ( Mode != TRANSFORM_NORMAL )
+        { r = AddSimd( r, r3 ); }
+
+        if ( Mode == TRANSFORM_COORD )
+        { r = DivSimd( r, SplatSimd<3>( r ) ); }
+
+        StoreFloat3Simd( reinterpret_cast<float*>( pOutput + outputStride * i ), r );
+    }
+#else
+    for( size_t i=0; i<count; ++i )
+    {
+        auto src = reinterpret_cast<const float*>( pInput + inputStride * i );
+        auto dst = reinterpret_cast<float*>( pOutput + outputStride * i );
+
+        // 入出力が同じ領域でも良いように先に読み込む.
+        auto x = src[0];
+        auto y = src[1];
+        auto z = src[2];
+
+        auto X = ( (x * m[0]) + (y * m[4]) ) + (z * m[8]);
+        auto Y = ( (x * m[1]) + (y * m[5]) ) + (z * m[9]);
+        auto Z = ( (x * m[2]) + (y * m[6]) ) + (z * m[10]);
+
+        if ( Mode != TRANSFORM_NORMAL )
+        {
+            X += m[12];
+            Y += m[13];
+            Z += m[14];
+        }
+
+        if ( Mode == TRANSFORM_COORD )
+        {
+            auto W = ( ( (x * m[3]) + (y * m[7]) ) + (z * m[11]) ) + m[15];
+            X /= W;
+            Y /= W;
+            Z /= W;
+        }
+
+        dst[0] = X;
+        dst[1] = Y;
+        dst[2] = Z;
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      成分毎に分離された3次元ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+template<int Mode> inline
+void TransformFloat3SoA
+(
+    const float*    pX,
+    const float*    pY,
+    const float*    pZ,
+    const float*    m,
+    float*          pOutX,
+    float*          pOutY,
+    float*          pOutZ,
+    size_t          count
+)
+{
+    size_t i = 0;
+
+#if defined(ASDX_MATH_SIMD)
+    // 4要素ずつ処理する.
+    SimdFloat4 c[16];
+    for( auto j=0; j<16; ++j )
+    { c[j] = ReplicateSimd( m[j] ); }
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto x = LoadFloat4Simd( pX + i );
+        auto y = LoadFloat4Simd( pY + i );
+        auto z = LoadFloat4Simd( pZ + i );
+
+        auto X = AddSimd( AddSimd( MulSimd( x, c[0] ), MulSimd( y, c[4] ) ), MulSimd( z, c[8] ) );
+        auto Y = AddSimd( AddSimd( MulSimd( x, c[1] ), MulSimd( y, c[5] ) ), MulSimd( z, c[9] ) );
+        auto Z = AddSimd( AddSimd( MulSimd( x, c[2] ), MulSimd( y, c[6] ) ), MulSimd( z, c[10] ) );
+
+        if ( Mode != TRANSFORM_NORMAL )
+        {
+            X = AddSimd( X, c[12] );
+            Y = AddSimd( Y, c[13] );
+            Z = AddSimd( Z, c[14] );
+        }
+
+        if ( Mode == TRANSFORM_COORD )
+        {
+            auto W = AddSimd( AddSimd( AddSimd( MulSimd( x, c[3] ), MulSimd( y, c[7] ) ), MulSimd( z, c[11] ) ), c[15] );
+            X = DivSimd( X, W );
+            Y = DivSimd( Y, W );
+            Z = DivSimd( Z, W );
+        }
+
+        StoreFloat4Simd( pOutX + i, X );
+        StoreFloat4Simd( pOutY + i, Y );
+        StoreFloat4Simd( pOutZ + i, Z );
+    }
+#endif
+
+    // 端数.
+    for( ; i<count; ++i )
+    {
+        auto x = pX[i];
+        auto y = pY[i];
+        auto z = pZ[i];
+
+        auto X = ( (x * m[0]) + (y * m[4]) ) + (z * m[8]);
+        auto Y = ( (x * m[1]) + (y * m[5]) ) + (z * m[9]);
+        auto Z = ( (x * m[2]) + (y * m[6]) ) + (z * m[10]);
+
+        if ( Mode != TRANSFORM_NORMAL )
+        {
+            X += m[12];
+            Y += m[13];
+            Z += m[14];
+        }
+
+        if ( Mode == TRANSFORM_COORD )
+        {
+            auto W = ( ( (x * m[3]) + (y * m[7]) ) + (z * m[11]) ) + m[15];
+            X /= W;
+            Y /= W;
+            Z /= W;
+        }
+
+        pOutX[i] = X;
+        pOutY[i] = Y;
+        pOutZ[i] = Z;
+    }
+}
+
+} // namespace detail
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Functions
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2132,6 +2691,126 @@ void Vector3::TransformCoord( const Vector3 &coords, const Matrix &matrix, Vecto
     result.z = Z / W;
 }
 
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride,
+    size_t          count
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    detail::TransformFloat3Array<detail::TRANSFORM_POSITION>(
+        reinterpret_cast<const uint8_t*>( pInput ), inputStride, &matrix._11,
+        reinterpret_cast<uint8_t*>( pOutput ), outputStride, count );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，成分毎に分離されたベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformArray
+(
+    const float*    pX,
+    const float*    pY,
+    const float*    pZ,
+    const Matrix&   matrix,
+    float*          pOutX,
+    float*          pOutY,
+    float*          pOutZ,
+    size_t          count
+)
+{
+    detail::TransformFloat3SoA<detail::TRANSFORM_POSITION>(
+        pX, pY, pZ, &matrix._11, pOutX, pOutY, pOutZ, count );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，法線ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformNormalArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride,
+    size_t          count
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    detail::TransformFloat3Array<detail::TRANSFORM_NORMAL>(
+        reinterpret_cast<const uint8_t*>( pInput ), inputStride, &matrix._11,
+        reinterpret_cast<uint8_t*>( pOutput ), outputStride, count );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，成分毎に分離された法線ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformNormalArray
+(
+    const float*    pX,
+    const float*    pY,
+    const float*    pZ,
+    const Matrix&   matrix,
+    float*          pOutX,
+    float*          pOutY,
+    float*          pOutZ,
+    size_t          count
+)
+{
+    detail::TransformFloat3SoA<detail::TRANSFORM_NORMAL>(
+        pX, pY, pZ, &matrix._11, pOutX, pOutY, pOutZ, count );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いてベクトル配列を変換し，変換結果をw=1に射影します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformCoordArray
+(
+    const Vector3*  pInput,
+    size_t          inputStride,
+    const Matrix&   matrix,
+    Vector3*        pOutput,
+    size_t          outputStride,
+    size_t          count
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    detail::TransformFloat3Array<detail::TRANSFORM_COORD>(
+        reinterpret_cast<const uint8_t*>( pInput ), inputStride, &matrix._11,
+        reinterpret_cast<uint8_t*>( pOutput ), outputStride, count );
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて成分毎に分離されたベクトル配列を変換し，変換結果をw=1に射影します.
+//-----------------------------------------------------------------------------
+inline
+void Vector3::TransformCoordArray
+(
+    const float*    pX,
+    const float*    pY,
+    const float*    pZ,
+    const Matrix&   matrix,
+    float*          pOutX,
+    float*          pOutY,
+    float*          pOutZ,
+    size_t          count
+)
+{
+    detail::TransformFloat3SoA<detail::TRANSFORM_COORD>(
+        pX, pY, pZ, &matrix._11, pOutX, pOutY, pOutZ, count );
+}
+
 //-----------------------------------------------------------------------------
 //      スカラー3重積を求めます.
 //-----------------------------------------------------------------------------
@@ -3056,11 +3735,17 @@ void Vector4::SmoothStep( const Vector4 &a, const Vector4 &b, float amount, Vect
 inline
 Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 {
+#if defined(ASDX_MATH_SIMD)
+    Vector4 result;
+    detail::TransformSimd( &position.x, &matrix._11, &result.x );
+    return result;
+#else
     return Vector4(
         ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41)),
         ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42)),
         ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43)),
         ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44)) );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3069,10 +3754,55 @@ Vector4 Vector4::Transform( const Vector4& position, const Matrix& matrix )
 inline
 void Vector4::Transform( const Vector4 &position, const Matrix &matrix, Vector4 &result )
 {
+#if defined(ASDX_MATH_SIMD)
+    detail::TransformSimd( &position.x, &matrix._11, &result.x );
+#else
     result.x = ( ( ((position.x * matrix._11) + (position.y * matrix._21)) + (position.z * matrix._31) ) + (position.w * matrix._41));
     result.y = ( ( ((position.x * matrix._12) + (position.y * matrix._22)) + (position.z * matrix._32) ) + (position.w * matrix._42));
     result.z = ( ( ((position.x * matrix._13) + (position.y * matrix._23)) + (position.z * matrix._33) ) + (position.w * matrix._43));
     result.w = ( ( ((position.x * matrix._14) + (position.y * matrix._24)) + (position.z * matrix._34) ) + (position.w * matrix._44));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      指定された行列を用いて，ベクトル配列を変換します.
+//-----------------------------------------------------------------------------
+inline
+void Vector4::TransformArray
+(
+    const Vector4*  pInput,
+    size_t          inputStride,
+    const Matrix&   matrix,
+    Vector4*        pOutput,
+    size_t          outputStride,
+    size_t          count
+)
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+    auto pSrc = reinterpret_cast<const uint8_t*>( pInput );
+    auto pDst = reinterpret_cast<uint8_t*>( pOutput );
+
+#if defined(ASDX_MATH_SIMD)
+    auto r0 = detail::LoadFloat4Simd( &matrix._11 );
+    auto r1 = detail::LoadFloat4Simd( &matrix._21 );
+    auto r2 = detail::LoadFloat4Simd( &matrix._31 );
+    auto r3 = detail::LoadFloat4Simd( &matrix._41 );
+
+    for( size_t i=0; i<count; ++i )
+    {
+        auto v = detail::LoadFloat4Simd( reinterpret_cast<const float*>( pSrc + inputStride * i ) );
+        detail::StoreFloat4Simd(
+            reinterpret_cast<float*>( pDst + outputStride * i ),
+            detail::TransformRowSimd( v, r0, r1, r2, r3 ) );
+    }
+#else
+    for( size_t i=0; i<count; ++i )
+    {
+        // 入出力が同じ領域でも良いように先に読み込む.
+        auto v = *reinterpret_cast<const Vector4*>( pSrc + inputStride * i );
+        Transform( v, matrix, *reinterpret_cast<Vector4*>( pDst + outputStride * i ) );
+    }
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -3492,6 +4222,11 @@ void Matrix::Transpose( const Matrix &value, Matrix &result )
 inline
 Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 {
+#if defined(ASDX_MATH_SIMD)
+    Matrix result;
+    detail::MultiplySimd( &a._11, &b._11, &result._11, false );
+    return result;
+#else
     return Matrix(
         ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
         ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 ),
@@ -3513,6 +4248,7 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
         ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 ),
         ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
     );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3521,6 +4257,9 @@ Matrix Matrix::Multiply( const Matrix& a, const Matrix& b )
 inline
 void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
 {
+#if defined(ASDX_MATH_SIMD)
+    detail::MultiplySimd( &a._11, &b._11, &result._11, false );
+#else
     result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
     result._12 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
     result._13 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
@@ -3540,6 +4279,7 @@ void Matrix::Multiply( const Matrix &a, const Matrix &b, Matrix &result )
     result._42 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
     result._43 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
     result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3588,6 +4328,11 @@ void Matrix::Multiply( const Matrix &value, float scaleFactor, Matrix &result )
 inline
 Matrix Matrix::MultiplyTranspose( const Matrix& a, const Matrix& b )
 {
+#if defined(ASDX_MATH_SIMD)
+    Matrix result;
+    detail::MultiplySimd( &a._11, &b._11, &result._11, true );
+    return result;
+#else
     return Matrix(
         ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 ),
         ( a._21 * b._11 ) + ( a._22 * b._21 ) + ( a._23 * b._31 ) + ( a._24 * b._41 ),
@@ -3609,6 +4354,7 @@ Matrix Matrix::MultiplyTranspose( const Matrix& a, const Matrix& b )
         ( a._31 * b._14 ) + ( a._32 * b._24 ) + ( a._33 * b._34 ) + ( a._34 * b._44 ),
         ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 )
     );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3617,6 +4363,9 @@ Matrix Matrix::MultiplyTranspose( const Matrix& a, const Matrix& b )
 inline
 void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result )
 {
+#if defined(ASDX_MATH_SIMD)
+    detail::MultiplySimd( &a._11, &b._11, &result._11, true );
+#else
     result._11 = ( a._11 * b._11 ) + ( a._12 * b._21 ) + ( a._13 * b._31 ) + ( a._14 * b._41 );
     result._21 = ( a._11 * b._12 ) + ( a._12 * b._22 ) + ( a._13 * b._32 ) + ( a._14 * b._42 );
     result._31 = ( a._11 * b._13 ) + ( a._12 * b._23 ) + ( a._13 * b._33 ) + ( a._14 * b._43 );
@@ -3636,6 +4385,48 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
     result._24 = ( a._41 * b._12 ) + ( a._42 * b._22 ) + ( a._43 * b._32 ) + ( a._44 * b._42 );
     result._34 = ( a._41 * b._13 ) + ( a._42 * b._23 ) + ( a._43 * b._33 ) + ( a._44 * b._43 );
     result._44 = ( a._41 * b._14 ) + ( a._42 * b._24 ) + ( a._43 * b._34 ) + ( a._44 * b._44 );
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      行列配列の各要素に同じ行列を乗算します.
+//-----------------------------------------------------------------------------
+inline
+void Matrix::MultiplyArray( const Matrix* pInput, const Matrix& matrix, Matrix* pOutput, size_t count )
+{
+    assert( count == 0 || ( pInput != nullptr && pOutput != nullptr ) );
+
+    // 出力先に含まれていても良いように複製しておく.
+    auto b = matrix;
+    for( size_t i=0; i<count; ++i )
+    {
+#if defined(ASDX_MATH_SIMD)
+        detail::MultiplySimd( &pInput[i]._11, &b._11, &pOutput[i]._11, false );
+#else
+        auto a = pInput[i];
+        Multiply( a, b, pOutput[i] );
+#endif
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      行列配列同士を要素毎に乗算します.
+//-----------------------------------------------------------------------------
+inline
+void Matrix::MultiplyArray( const Matrix* pA, const Matrix* pB, Matrix* pOutput, size_t count )
+{
+    assert( count == 0 || ( pA != nullptr && pB != nullptr && pOutput != nullptr ) );
+
+    for( size_t i=0; i<count; ++i )
+    {
+#if defined(ASDX_MATH_SIMD)
+        detail::MultiplySimd( &pA[i]._11, &pB[i]._11, &pOutput[i]._11, false );
+#else
+        auto a = pA[i];
+        auto b = pB[i];
+        Multiply( a, b, pOutput[i] );
+#endif
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -3644,6 +4435,11 @@ void Matrix::MultiplyTranspose( const Matrix &a, const Matrix &b, Matrix &result
 inline 
 Matrix Matrix::Invert( const Matrix& value )
 {
+#if defined(ASDX_MATH_SIMD) && defined(ASDX_MATH_SSE2)
+    Matrix result;
+    detail::InvertSimd( &value._11, &result._11 );
+    return result;
+#else
     auto det = value.Determinant();
     assert( !IsZero( det ) );
 
@@ -3672,6 +4468,7 @@ Matrix Matrix::Invert( const Matrix& value )
         m21 / det, m22 / det, m23 / det, m24 / det,
         m31 / det, m32 / det, m33 / det, m34 / det,
         m41 / det, m42 / det, m43 / det, m44 / det );
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -3679,7 +4476,10 @@ Matrix Matrix::Invert( const Matrix& value )
 //-----------------------------------------------------------------------------
 inline
 void Matrix::Invert( const Matrix &value, Matrix &result )
-{ 
+{
+#if defined(ASDX_MATH_SIMD) && defined(ASDX_MATH_SSE2)
+    detail::InvertSimd( &value._11, &result._11 );
+#else
     auto det = value.Determinant();
     assert( det != 0.0f );
 
@@ -3722,6 +4522,7 @@ void Matrix::Invert( const Matrix &value, Matrix &result )
     result._42 /= det;
     result._43 /= det;
     result._44 /= det;
+#endif
 }
 
 //-----------------------------------------------------------------------------
@@ -6409,6 +7210,49 @@ Vector2 DecodeSnorm2(uint16_t value)
     return result;
 }
 
+//-----------------------------------------------------------------------------
+//      八面体マッピングで2次元に変換します.
+//-----------------------------------------------------------------------------
+inline
+Vector2 EncodeOctahedral(const Vector3& value)
+{
+    auto len = fabs(value.x) + fabs(value.y) + fabs(value.z);
+    if (len <= 0.0f)
+    { return Vector2(0.0f, 0.0f); }
+
+    Vector2 result(value.x / len, value.y / len);
+
+    // 下半球は対角線で折り返す.
+    if (value.z < 0.0f)
+    {
+        auto x = result.x;
+        auto y = result.y;
+        result.x = (1.0f - fabs(y)) * Sign(x);
+        result.y = (1.0f - fabs(x)) * Sign(y);
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      八面体マッピングされた2次元ベクトルを展開します.
+//-----------------------------------------------------------------------------
+inline
+Vector3 DecodeOctahedral(const Vector2& value)
+{
+    Vector3 result(value.x, value.y, 1.0f - fabs(value.x) - fabs(value.y));
+
+    if (result.z < 0.0f)
+    {
+        auto x = result.x;
+        auto y = result.y;
+        result.x = (1.0f - fabs(y)) * Sign(x);
+        result.y = (1.0f - fabs(x)) * Sign(y);
+    }
+
+    return Vector3::SafeNormalize(result, Vector3(0.0f, 0.0f, 1.0f));
+}
+
 
 } // namespace asdx
 
@@ -0,0 +1,417 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxObjectPool.h
+// Desc : Fixed Size Object Pool.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <fnd/asdxSpinLock.h>
+
+
+namespace asdx {
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+// ThreadCacheIndexAllocator class
+///////////////////////////////////////////////////////////////////////////////
+class ThreadCacheIndexAllocator
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      シングルトンインスタンスを取得します.
+    //-------------------------------------------------------------------------
+    static ThreadCacheIndexAllocator& Instance()
+    {
+        static ThreadCacheIndexAllocator s_Instance;
+        return s_Instance;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      番号を確保します. 返却済みの番号があれば最も小さいものを再利用します.
+    //-------------------------------------------------------------------------
+    uint32_t Acquire()
+    {
+        asdx::ScopedLock locker(&m_Lock);
+        if (m_FreeIndices.empty())
+        { return m_NextIndex++; }
+
+        auto itr   = std::min_element(m_FreeIndices.begin(), m_FreeIndices.end());
+        auto index = *itr;
+        *itr = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+        return index;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      番号を返却します.
+    //-------------------------------------------------------------------------
+    void Release(uint32_t index)
+    {
+        asdx::ScopedLock locker(&m_Lock);
+        m_FreeIndices.push_back(index);
+    }
+
+private:
+    SpinLock                m_Lock;
+    uint32_t                m_NextIndex = 0;
+    std::vector<uint32_t>   m_FreeIndices;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ThreadCacheIndex structure
+///////////////////////////////////////////////////////////////////////////////
+struct ThreadCacheIndex
+{
+    uint32_t Value;
+
+    ThreadCacheIndex()
+    : Value(ThreadCacheIndexAllocator::Instance().Acquire())
+    { /* DO_NOTHING */ }
+
+    ~ThreadCacheIndex()
+    { ThreadCacheIndexAllocator::Instance().Release(Value); }
+};
+
+} // namespace detail
+
+//-----------------------------------------------------------------------------
+//! @brief      スレッド毎のキャッシュ番号を取得します.
+//!
+//! @return     生存中のスレッド間で重複しない番号を返却します.
+//! @note       スレッドの終了時に番号を返却し，以降に生成されたスレッドが再利用します.
+//!             同時に生存するスレッド数がキャッシュ数を超えた分のスレッドは，
+//!             いずれかのスレッドが終了するまでロック付きの共有リストを使用します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetThreadCacheIndex()
+{
+    static thread_local detail::ThreadCacheIndex s_Index;
+    return s_Index.Value;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ObjectPool class
+///////////////////////////////////////////////////////////////////////////////
+template<typename T>
+class ObjectPool
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    static const uint32_t MAX_THREAD_CACHE_COUNT = 64;  //!< キャッシュを持てる同時生存スレッド数の上限.
+    static const uint32_t THREAD_CACHE_BATCH     = 32;  //!< キャッシュと共有リスト間で一度に移動する数.
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //!
+    //! @param[in]      chunkCapacity   1チャンクあたりのオブジェクト数です.
+    //! @param[in]      threadCache     スレッド毎のキャッシュを使用する場合は true を指定します.
+    //-------------------------------------------------------------------------
+    explicit ObjectPool(uint32_t chunkCapacity = 64, bool threadCache = false)
+    : m_ChunkCapacity   ((chunkCapacity > 0) ? chunkCapacity : 1)
+    , m_pChunks         (nullptr)
+    , m_pFreeList       (nullptr)
+    , m_pCaches         (nullptr)
+    , m_Capacity        (0)
+    , m_AllocatedCount  (0)
+    {
+        if (threadCache)
+        { m_pCaches = new ThreadCache[MAX_THREAD_CACHE_COUNT]; }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~ObjectPool()
+    {
+        // 返却されていないオブジェクトがある場合は解放漏れです.
+        assert(GetAllocatedCount() == 0);
+
+        auto chunk = m_pChunks;
+        while(chunk != nullptr)
+        {
+            auto next = chunk->pNext;
+            ::operator delete(chunk);
+            chunk = next;
+        }
+
+        m_pChunks   = nullptr;
+        m_pFreeList = nullptr;
+
+        if (m_pCaches != nullptr)
+        {
+            delete[] m_pCaches;
+            m_pCaches = nullptr;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定数のオブジェクトを格納できるよう予約します.
+    //-------------------------------------------------------------------------
+    bool Reserve(uint32_t count)
+    {
+        asdx::ScopedLock locker(&m_Lock);
+        while(m_Capacity < count)
+        {
+            if (!Grow())
+            { return false; }
+        }
+
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      メモリを確保します(コンストラクタは呼ばれません).
+    //!
+    //! @return     確保したメモリを返却します. 確保に失敗した場合は nullptr を返却します.
+    //-------------------------------------------------------------------------
+    void* Alloc()
+    {
+        Slot* slot = nullptr;
+
+        auto cache = GetCache();
+        if (cache != nullptr)
+        {
+            if (cache->pHead == nullptr)
+            { Refill(cache); }
+
+            slot = cache->pHead;
+            if (slot != nullptr)
+            {
+                cache->pHead = slot->pNext;
+                cache->Count--;
+            }
+        }
+        else
+        {
+            asdx::ScopedLock locker(&m_Lock);
+            if (m_pFreeList == nullptr)
+            { Grow(); }
+
+            slot = m_pFreeList;
+            if (slot != nullptr)
+            { m_pFreeList = slot->pNext; }
+        }
+
+        if (slot == nullptr)
+        { return nullptr; }
+
+        m_AllocatedCount.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      メモリを返却します(デストラクタは呼ばれません).
+    //-------------------------------------------------------------------------
+    void Free(void* ptr)
+    {
+        if (ptr == nullptr)
+        { return; }
+
+        auto slot = static_cast<Slot*>(ptr);
+        m_AllocatedCount.fetch_sub(1, std::memory_order_relaxed);
+
+        auto cache = GetCache();
+        if (cache != nullptr)
+        {
+            slot->pNext  = cache->pHead;
+            cache->pHead = slot;
+            cache->Count++;
+
+            // 溜まりすぎたら共有リストに戻す.
+            if (cache->Count >= THREAD_CACHE_BATCH * 2)
+            { Flush(cache, THREAD_CACHE_BATCH); }
+        }
+        else
+        {
+            asdx::ScopedLock locker(&m_Lock);
+            slot->pNext = m_pFreeList;
+            m_pFreeList = slot;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      オブジェクトを生成します.
+    //-------------------------------------------------------------------------
+    template<typename... Args>
+    T* New(Args&&... args)
+    {
+        auto buf = Alloc();
+        if (buf == nullptr)
+        { return nullptr; }
+
+        return new(buf) T(std::forward<Args>(args)...);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      オブジェクトを破棄します.
+    //-------------------------------------------------------------------------
+    void Delete(T* ptr)
+    {
+        if (ptr == nullptr)
+        { return; }
+
+        ptr->~T();
+        Free(ptr);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      使用中のオブジェクト数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetAllocatedCount() const
+    { return m_AllocatedCount.load(std::memory_order_relaxed); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      確保済みの総オブジェクト数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetCapacity() const
+    { return m_Capacity; }
+
+private:
+    ///////////////////////////////////////////////////////////////////////////
+    // Slot union
+    ///////////////////////////////////////////////////////////////////////////
+    union Slot
+    {
+        Slot*   pNext;
+        alignas(T) uint8_t Storage[sizeof(T)];
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Chunk structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        Chunk*  pNext;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // ThreadCache structure
+    ///////////////////////////////////////////////////////////////////////////
+    struct ThreadCache
+    {
+        Slot*       pHead = nullptr;
+        uint32_t    Count = 0;
+        uint8_t     Padding[64 - sizeof(Slot*) - sizeof(uint32_t)];   // フォルスシェアリング回避.
+    };
+
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    uint32_t                m_ChunkCapacity;    //!< 1チャンクあたりのオブジェクト数.
+    Chunk*                  m_pChunks;          //!< チャンクリスト.
+    Slot*                   m_pFreeList;        //!< 共有フリーリスト.
+    ThreadCache*            m_pCaches;          //!< スレッド毎のキャッシュ.
+    uint32_t                m_Capacity;         //!< 総オブジェクト数.
+    std::atomic<uint32_t>   m_AllocatedCount;   //!< 使用中オブジェクト数.
+    SpinLock                m_Lock;             //!< 共有フリーリスト用ロック.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      チャンクを追加します(ロック済みで呼び出します).
+    //-------------------------------------------------------------------------
+    bool Grow()
+    {
+        auto header = (sizeof(Chunk) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+        auto buf = static_cast<uint8_t*>(
+            ::operator new(header + sizeof(Slot) * m_ChunkCapacity, std::nothrow));
+        if (buf == nullptr)
+        { return false; }
+
+        auto chunk = reinterpret_cast<Chunk*>(buf);
+        chunk->pNext = m_pChunks;
+        m_pChunks = chunk;
+
+        // 先頭から取り出されるように逆順に積む.
+        auto slots = reinterpret_cast<Slot*>(buf + header);
+        for(auto i=m_ChunkCapacity; i>0; --i)
+        {
+            slots[i - 1].pNext = m_pFreeList;
+            m_pFreeList = &slots[i - 1];
+        }
+
+        m_Capacity += m_ChunkCapacity;
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      呼び出しスレッドのキャッシュを取得します.
+    //-------------------------------------------------------------------------
+    ThreadCache* GetCache() const
+    {
+        if (m_pCaches == nullptr)
+        { return nullptr; }
+
+        auto index = GetThreadCacheIndex();
+        if (index >= MAX_THREAD_CACHE_COUNT)
+        { return nullptr; }
+
+        return &m_pCaches[index];
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      共有リストからキャッシュに補充します.
+    //-------------------------------------------------------------------------
+    void Refill(ThreadCache* cache)
+    {
+        asdx::ScopedLock locker(&m_Lock);
+        for(auto i=0u; i<THREAD_CACHE_BATCH; ++i)
+        {
+            if (m_pFreeList == nullptr && !Grow())
+            { break; }
+
+            auto slot = m_pFreeList;
+            m_pFreeList = slot->pNext;
+
+            slot->pNext  = cache->pHead;
+            cache->pHead = slot;
+            cache->Count++;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      キャッシュから共有リストへ戻します.
+    //-------------------------------------------------------------------------
+    void Flush(ThreadCache* cache, uint32_t count)
+    {
+        asdx::ScopedLock locker(&m_Lock);
+        for(auto i=0u; i<count && cache->pHead != nullptr; ++i)
+        {
+            auto slot = cache->pHead;
+            cache->pHead = slot->pNext;
+            cache->Count--;
+
+            slot->pNext = m_pFreeList;
+            m_pFreeList = slot;
+        }
+    }
+
+    ObjectPool      (const ObjectPool&) = delete;
+    void operator = (const ObjectPool&) = delete;
+};
+
+} // namespace asdx
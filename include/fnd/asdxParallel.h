@@ -0,0 +1,286 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxParallel.h
+// Desc : Data Parallel Algorithms.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <vector>
+#include <fnd/asdxThreadPool.h>
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//! @brief      並列アルゴリズム用の共有スレッドプールを取得します.
+//!
+//! @return     初回呼び出し時に (論理コア数 - 1) 個のワーカーで生成したスレッドプールを返却します.
+//!             生成に失敗した場合は nullptr を返却します.
+//-----------------------------------------------------------------------------
+IThreadPool* GetSharedThreadPool();
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+// ParallelRange class
+///////////////////////////////////////////////////////////////////////////////
+class ParallelRange
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ParallelRange(size_t begin, size_t end, size_t grain, size_t workers)
+    : m_Cursor  (begin)
+    , m_End     (end)
+    , m_Grain   (grain)
+    , m_Workers (workers)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      次に処理する範囲を取得します.
+    //!
+    //! @note       残り範囲に応じてチャンクを縮めていきます(ガイド付きスケジューリング).
+    //-------------------------------------------------------------------------
+    bool Next(size_t& begin, size_t& end)
+    {
+        auto b = m_Cursor.load(std::memory_order_relaxed);
+        while(b < m_End)
+        {
+            auto remain = m_End - b;
+            auto chunk  = remain / (m_Workers * 2);
+            if (chunk < m_Grain)
+            { chunk = m_Grain; }
+
+            auto e = (remain > chunk) ? b + chunk : m_End;
+            if (m_Cursor.compare_exchange_weak(b, e, std::memory_order_relaxed))
+            {
+                begin = b;
+                end   = e;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::atomic<size_t>     m_Cursor;
+    size_t                  m_End;
+    size_t                  m_Grain;
+    size_t                  m_Workers;
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ParallelTask class
+///////////////////////////////////////////////////////////////////////////////
+template<typename T, typename Func>
+class ParallelTask : public IRunnable
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    ParallelRange*  pRange  = nullptr;
+    const Func*     pFunc   = nullptr;
+    T               Result  = T();
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      処理を実行します.
+    //-------------------------------------------------------------------------
+    void Run() override
+    {
+        size_t b, e;
+        while(pRange->Next(b, e))
+        { Result = (*pFunc)(b, e, Result); }
+    }
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      粒度を決定します.
+//-----------------------------------------------------------------------------
+inline size_t CalcGrainSize(size_t count, size_t grain, size_t workers)
+{
+    if (grain > 0)
+    { return grain; }
+
+    // 1ワーカーあたり最低でも64チャンク程度に分割できるようにする.
+    auto result = count / (workers * 64);
+    return (result > 0) ? result : 1;
+}
+
+} // namespace detail
+
+
+//-----------------------------------------------------------------------------
+//! @brief      範囲を並列に縮約します.
+//!
+//! @param[in]      pThreadPool     スレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+//! @param[in]      begin           開始インデックスです.
+//! @param[in]      end             終了インデックスです(含みません).
+//! @param[in]      grain           最小チャンクサイズです. 0 の場合は自動で決定します.
+//! @param[in]      identity        単位元です.
+//! @param[in]      func            T func(size_t begin, size_t end, T value) で部分範囲を畳み込む関数です.
+//! @param[in]      reduce          T reduce(T lhs, T rhs) で部分結果を結合する関数です.
+//! @return     縮約結果を返却します.
+//! @note       チャンクは各タスクが取得した順に畳み込むため，1つのタスクが処理する部分範囲は
+//!             連続せず，結合の順序も実行ごとに変わります. このため reduce は結合則に加えて
+//!             交換則も満たす必要があります. 浮動小数点の加算などは結果が実行ごとに僅かに変わります.
+//-----------------------------------------------------------------------------
+template<typename T, typename Func, typename Reduce>
+T ParallelReduce
+(
+    IThreadPool*    pThreadPool,
+    size_t          begin,
+    size_t          end,
+    size_t          grain,
+    const T&        identity,
+    const Func&     func,
+    const Reduce&   reduce
+)
+{
+    if (begin >= end)
+    { return identity; }
+
+    auto count   = end - begin;
+    auto threads = (pThreadPool != nullptr) ? size_t(pThreadPool->GetThreadCount()) : 0;
+    grain = detail::CalcGrainSize(count, grain, threads + 1);
+
+    // 分割する意味がない場合は直接処理.
+    auto chunks  = (count + grain - 1) / grain;
+    auto workers = (threads + 1 < chunks) ? threads + 1 : chunks;
+    if (workers <= 1)
+    { return func(begin, end, identity); }
+
+    detail::ParallelRange range(begin, end, grain, workers);
+
+    std::vector<detail::ParallelTask<T, Func>> tasks(workers);
+    for(auto& task : tasks)
+    {
+        task.pRange = &range;
+        task.pFunc  = &func;
+        task.Result = identity;
+    }
+
+    JobCounter counter;
+    for(size_t i=1; i<workers; ++i)
+    { pThreadPool->Push(&tasks[i], &counter); }
+
+    // 呼び出しスレッドも処理する.
+    tasks[0].Run();
+    pThreadPool->Wait(&counter);
+
+    auto result = tasks[0].Result;
+    for(size_t i=1; i<workers; ++i)
+    { result = reduce(result, tasks[i].Result); }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      範囲を並列に縮約します(共有スレッドプールを使用).
+//-----------------------------------------------------------------------------
+template<typename T, typename Func, typename Reduce>
+T ParallelReduce
+(
+    size_t          begin,
+    size_t          end,
+    size_t          grain,
+    const T&        identity,
+    const Func&     func,
+    const Reduce&   reduce
+)
+{ return ParallelReduce(GetSharedThreadPool(), begin, end, grain, identity, func, reduce); }
+
+//-----------------------------------------------------------------------------
+//! @brief      部分範囲ごとに並列実行します.
+//!
+//! @param[in]      pThreadPool     スレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+//! @param[in]      begin           開始インデックスです.
+//! @param[in]      end             終了インデックスです(含みません).
+//! @param[in]      grain           最小チャンクサイズです. 0 の場合は自動で決定します.
+//! @param[in]      func            void func(size_t begin, size_t end) で部分範囲を処理する関数です.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelForRange(IThreadPool* pThreadPool, size_t begin, size_t end, size_t grain, const Func& func)
+{
+    auto wrapper = [&func](size_t b, size_t e, bool)
+    {
+        func(b, e);
+        return true;
+    };
+
+    ParallelReduce(pThreadPool, begin, end, grain, true, wrapper, [](bool, bool) { return true; });
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      部分範囲ごとに並列実行します(共有スレッドプールを使用).
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelForRange(size_t begin, size_t end, size_t grain, const Func& func)
+{ ParallelForRange(GetSharedThreadPool(), begin, end, grain, func); }
+
+//-----------------------------------------------------------------------------
+//! @brief      インデックスごとに並列実行します.
+//!
+//! @param[in]      pThreadPool     スレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+//! @param[in]      begin           開始インデックスです.
+//! @param[in]      end             終了インデックスです(含みません).
+//! @param[in]      grain           最小チャンクサイズです. 0 の場合は自動で決定します.
+//! @param[in]      func            void func(size_t index) で要素を処理する関数です.
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(IThreadPool* pThreadPool, size_t begin, size_t end, size_t grain, const Func& func)
+{
+    ParallelForRange(pThreadPool, begin, end, grain, [&func](size_t b, size_t e)
+    {
+        for(auto i=b; i<e; ++i)
+        { func(i); }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//! @brief      インデックスごとに並列実行します(共有スレッドプールを使用).
+//-----------------------------------------------------------------------------
+template<typename Func>
+void ParallelFor(size_t begin, size_t end, size_t grain, const Func& func)
+{ ParallelFor(GetSharedThreadPool(), begin, end, grain, func); }
+
+} // namespace asdx
@@ -9,16 +9,85 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <cstdint>
+#include <atomic>
 #include <fnd/asdxQueue.h>
 
 
 namespace asdx {
 
+///////////////////////////////////////////////////////////////////////////////
+// JobCounter class
+///////////////////////////////////////////////////////////////////////////////
+class JobCounter
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    JobCounter()
+    : m_Count(0)
+    { /* DO_NOTHING */ }
+
+    //-------------------------------------------------------------------------
+    //! @brief      未完了ジョブ数を加算します.
+    //-------------------------------------------------------------------------
+    void Add(uint32_t count = 1)
+    { m_Count.fetch_add(count, std::memory_order_relaxed); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブの完了を通知します.
+    //!
+    //! @return     最後のジョブが完了した場合に true を返却します.
+    //-------------------------------------------------------------------------
+    bool Done()
+    { return m_Count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    //-------------------------------------------------------------------------
+    //! @brief      未完了ジョブ数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetCount() const
+    { return m_Count.load(std::memory_order_acquire); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      全ジョブが完了したかどうかチェックします.
+    //-------------------------------------------------------------------------
+    bool IsCompleted() const
+    { return GetCount() == 0; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::atomic<uint32_t>   m_Count;    //!< 未完了ジョブ数.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    JobCounter      (const JobCounter&) = delete;
+    void operator = (const JobCounter&) = delete;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // IRunnable interface
 ///////////////////////////////////////////////////////////////////////////////
 struct IRunnable : public Queue<IRunnable>::Node
 {
+    friend class ThreadPool;
+
     //-------------------------------------------------------------------------
     //! @brief      デストラクタです.
     //-------------------------------------------------------------------------
@@ -29,6 +98,9 @@ struct IRunnable : public Queue<IRunnable>::Node
     //! @brief      処理を実行します.
     //-------------------------------------------------------------------------
     virtual void Run() = 0;
+
+private:
+    JobCounter* m_pCounter = nullptr;   //!< 完了通知先のカウンターです.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -52,10 +124,30 @@ struct IThreadPool
     //-------------------------------------------------------------------------
     virtual void Push(IRunnable* runnable) = 0;
 
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブを追加します.
+    //!
+    //! @param[in]      runnable    実行するジョブです.
+    //! @param[in]      counter     完了時にデクリメントするカウンターです.
+    //-------------------------------------------------------------------------
+    virtual void Push(IRunnable* runnable, JobCounter* counter) = 0;
+
     //-------------------------------------------------------------------------
     //! @brief      すべてのジョブの完了を待機します.
     //-------------------------------------------------------------------------
     virtual void Wait() = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      カウンターに紐づくジョブの完了を待機します.
+    //!
+    //! @note       待機中は呼び出しスレッドもジョブを実行します.
+    //-------------------------------------------------------------------------
+    virtual void Wait(JobCounter* counter) = 0;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ワーカースレッド数を取得します.
+    //-------------------------------------------------------------------------
+    virtual uint32_t GetThreadCount() const = 0;
 };
 
 //-----------------------------------------------------------------------------
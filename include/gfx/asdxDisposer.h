@@ -8,9 +8,10 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
-#include <list>
 #include <fnd/asdxRef.h>
+#include <fnd/asdxLogger.h>
 #include <fnd/asdxSpinLock.h>
+#include <fnd/asdxObjectPool.h>
 
 
 namespace asdx {
@@ -63,10 +64,25 @@ public:
 
         asdx::ScopedLock locker(&m_SpinLock);
 
-        Item item = {};
-        item.pObject    = pObject;
-        item.LifeTime   = lifeTime;
-        m_List.push_back(item);
+        auto item = m_Pool.New();
+        if (item == nullptr)
+        {
+            // 登録できない場合はリークさせないよう即時解放する.
+            ELOG("Error : Disposer Item Allocation Failed. Release Immediately.");
+            pObject->Release();
+            pObject = nullptr;
+            return;
+        }
+
+        item->pObject   = pObject;
+        item->LifeTime  = lifeTime;
+        item->pNext     = nullptr;
+
+        if (m_pTail != nullptr)
+        { m_pTail->pNext = item; }
+        else
+        { m_pHead = item; }
+        m_pTail = item;
 
         pObject = nullptr;
     }
@@ -78,9 +94,12 @@ public:
     {
         asdx::ScopedLock locker(&m_SpinLock);
 
-        auto itr = m_List.begin();
-        while(itr != m_List.end())
+        Item* prev = nullptr;
+        auto  itr  = m_pHead;
+        while(itr != nullptr)
         {
+            auto next = itr->pNext;
+
             --itr->LifeTime;
             if (itr->LifeTime <= 0)
             {
@@ -90,12 +109,23 @@ public:
                     itr->pObject = nullptr;
                 }
 
-                itr = m_List.erase(itr);
+                // リストから外してプールに戻す.
+                if (prev != nullptr)
+                { prev->pNext = next; }
+                else
+                { m_pHead = next; }
+
+                if (m_pTail == itr)
+                { m_pTail = prev; }
+
+                m_Pool.Delete(itr);
             }
             else
             {
-                ++itr;
+                prev = itr;
             }
+
+            itr = next;
         }
     }
 
@@ -106,9 +136,11 @@ public:
     {
         asdx::ScopedLock locker(&m_SpinLock);
 
-        auto itr = m_List.begin();
-        while(itr != m_List.end())
+        auto itr = m_pHead;
+        while(itr != nullptr)
         {
+            auto next = itr->pNext;
+
             if (itr->pObject != nullptr)
             {
                 // GPUが実行中 or メモリ解法漏れ があるとここで落ちるはずなので，
@@ -118,11 +150,12 @@ public:
                 itr->LifeTime  = 0;
             }
 
-            itr = m_List.erase(itr);
+            m_Pool.Delete(itr);
+            itr = next;
         }
 
-        // 念のため.
-        m_List.clear();
+        m_pHead = nullptr;
+        m_pTail = nullptr;
     }
 
 private:
@@ -133,13 +166,16 @@ private:
     {
         T*          pObject;    //!< 破棄オブジェクト.
         uint8_t     LifeTime;   //!< 生存フレーム数.
+        Item*       pNext;      //!< 次の項目.
     };
 
     //=========================================================================
     // private variables.
     //=========================================================================
-    std::list<Item>         m_List;         //!< 破棄リスト.
-    SpinLock                m_SpinLock;     //!< スピンロック.
+    ObjectPool<Item>        m_Pool;                 //!< 項目プール.
+    Item*                   m_pHead = nullptr;      //!< 破棄リスト先頭.
+    Item*                   m_pTail = nullptr;      //!< 破棄リスト末尾.
+    SpinLock                m_SpinLock;             //!< スピンロック.
 
     //=========================================================================
     // private methods.
@@ -0,0 +1,123 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBlockCompression.h
+// Desc : Block Compression Encoder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <fnd/asdxMath.h>
+#include <res/asdxResTexture.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// BC_FORMAT enum
+///////////////////////////////////////////////////////////////////////////////
+enum BC_FORMAT
+{
+    BC_FORMAT_BC1,      //!< RGB + 1bitアルファ(8byte/block).
+    BC_FORMAT_BC3,      //!< RGBA(16byte/block).
+    BC_FORMAT_BC4,      //!< R(8byte/block).
+    BC_FORMAT_BC5,      //!< RG(16byte/block).
+    BC_FORMAT_BC6H,     //!< 符号なし HDR RGB(16byte/block).
+    BC_FORMAT_BC7,      //!< 高品質 RGBA(16byte/block).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BC_QUALITY enum
+///////////////////////////////////////////////////////////////////////////////
+enum BC_QUALITY
+{
+    BC_QUALITY_FAST,    //!< バウンディングボックスによる端点推定のみ行います. BC6H/BC7 は単一モードのみ試行します.
+    BC_QUALITY_NORMAL,  //!< 主成分分析と最小二乗法による端点の再推定を行います. BC6H/BC7 は主要モードと上位パーティションを試行します.
+    BC_QUALITY_HIGH,    //!< 再推定の反復と，代替モード・端点近傍の探索を行います. BC6H/BC7 は全モードを試行します.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルをBC1ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA8 の 4x4 テクセル(64byte)です.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(8byte)です.
+//! @note       アルファが 128 未満のテクセルは透明として扱います.
+//-----------------------------------------------------------------------------
+void EncodeBC1(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルをBC3ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA8 の 4x4 テクセル(64byte)です.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(16byte)です.
+//-----------------------------------------------------------------------------
+void EncodeBC3(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルのR成分をBC4ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA8 の 4x4 テクセル(64byte)です.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(8byte)です.
+//-----------------------------------------------------------------------------
+void EncodeBC4(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルのR,G成分をBC5ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA8 の 4x4 テクセル(64byte)です.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(16byte)です.
+//-----------------------------------------------------------------------------
+void EncodeBC5(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルをBC6H(符号なし)ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA16F の 4x4 テクセル(64要素)です. アルファは無視します.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(16byte)です.
+//! @note       負の値は 0 に，無限大・非数は half の最大有限値に丸めます.
+//-----------------------------------------------------------------------------
+void EncodeBC6H(const half* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      4x4テクセルをBC7ブロックに圧縮します.
+//!
+//! @param[in]      pTexels     RGBA8 の 4x4 テクセル(64byte)です.
+//! @param[in]      quality     圧縮品質です.
+//! @param[out]     pBlock      ブロックの格納先(16byte)です.
+//-----------------------------------------------------------------------------
+void EncodeBC7(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock);
+
+//-----------------------------------------------------------------------------
+//! @brief      ブロック圧縮フォーマットに変換できるかどうかチェックします.
+//!
+//! @param[in]      srcFormat   変換元の DXGI フォーマットです.
+//! @param[in]      format      変換先のフォーマットです.
+//! @retval true    CompressResTexture() で変換可能です.
+//! @retval false   変換できません.
+//-----------------------------------------------------------------------------
+bool IsCompressibleFormat(uint32_t srcFormat, BC_FORMAT format);
+
+//-----------------------------------------------------------------------------
+//! @brief      リソーステクスチャをブロック圧縮フォーマットに変換します.
+//!
+//! @param[in,out]  resTexture  変換するリソーステクスチャです.
+//! @param[in]      format      変換先のフォーマットです.
+//! @param[in]      quality     圧縮品質です.
+//! @retval true    変換に成功.
+//! @retval false   変換に失敗.
+//! @note       入力は R8G8B8A8_UNORM(_SRGB), R8G8_UNORM, R8_UNORM, A8_UNORM に対応します.
+//!             A8_UNORM は (0, 0, 0, a) として扱い, アルファを保持できる BC3 への変換のみ受け付けます.
+//!             BC6H のみ R16G16B16A16_FLOAT, R32G32B32A32_FLOAT を入力とし BC6H_UF16 を出力します.
+//!             全サーフェイス・全ミップレベルを共有スレッドプールでブロック行ごとに並列処理します.
+//!             BC1, BC3, BC7 は入力が sRGB の場合 sRGB フォーマットを維持します.
+//-----------------------------------------------------------------------------
+bool CompressResTexture(ResTexture& resTexture, BC_FORMAT format, BC_QUALITY quality = BC_QUALITY_NORMAL);
+
+} // namespace asdx
@@ -0,0 +1,56 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMipGenerator.h
+// Desc : Mip Map Generator.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <res/asdxResTexture.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MIP_FILTER enum
+///////////////////////////////////////////////////////////////////////////////
+enum MIP_FILTER
+{
+    MIP_FILTER_BOX,         //!< ボックスフィルタ(奇数サイズは覆う面積で重み付け)です.
+    MIP_FILTER_KAISER,      //!< カイザー窓付き sinc フィルタです. ボックスより鮮明ですが低速です.
+                            //!< 負のローブで値がはみ出すため，UNORM は [0, 1] に，浮動小数点の RGB は 0 以上にクランプします.
+                            //!< 負の値を含む浮動小数点データにはボックスフィルタを使用してください.
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      リソーステクスチャのミップマップを生成します.
+//!
+//! @param[in,out]  resTexture      ミップマップを生成するリソーステクスチャです.
+//! @param[in]      filter          縮小フィルタです.
+//! @param[in]      alphaReference  アルファテストの閾値です. 0 より大きい場合は各ミップレベルで
+//!                                 閾値を超えるテクセルの割合がミップレベル0と一致するようアルファを補正します.
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       ミップレベル0から 1x1 までの全レベルを生成し，既存のミップレベルは破棄します.
+//!             入力は R8G8B8A8_UNORM(_SRGB), B8G8R8A8_UNORM(_SRGB), B8G8R8X8_UNORM(_SRGB), R8G8_UNORM,
+//!             R8_UNORM, A8_UNORM, R16G16B16A16_UNORM, R16_UNORM, R16G16B16A16_FLOAT, R16G16_FLOAT,
+//!             R16_FLOAT, R32G32B32A32_FLOAT, R32G32B32_FLOAT, R32G32_FLOAT, R32_FLOAT に対応します.
+//!             sRGB フォーマットは線形空間でフィルタリングします.
+//!             配列・キューブマップは各サーフェイスを独立に処理し，端はクランプします.
+//!             各レベルを行単位で共有スレッドプールにより並列処理します.
+//-----------------------------------------------------------------------------
+bool GenerateMipMaps(ResTexture& resTexture, MIP_FILTER filter = MIP_FILTER_BOX, float alphaReference = 0.0f);
+
+//-----------------------------------------------------------------------------
+//! @brief      ミップマップ生成に対応したフォーマットかどうかチェックします.
+//!
+//! @param[in]      format      DXGI フォーマットです.
+//! @retval true    GenerateMipMaps() で処理可能です.
+//! @retval false   処理できません.
+//-----------------------------------------------------------------------------
+bool IsMipMapSupportedFormat(uint32_t format);
+
+} // namespace asdx
@@ -0,0 +1,193 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxResBvh.h
+// Desc : Bounding Volume Hierarchy for CPU Ray Queries.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <vector>
+#include <fnd/asdxMath.h>
+#include <fnd/asdxCulling.h>
+#include <res/asdxResModel.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// BvhNode structure
+///////////////////////////////////////////////////////////////////////////////
+struct BvhNode
+{
+    Vector3     Min;        //!< 最小座標.
+    uint32_t    Offset;     //!< 葉の場合は先頭三角形番号, 節の場合は左の子の番号です(右の子は Offset + 1).
+    Vector3     Max;        //!< 最大座標.
+    uint16_t    Count;      //!< 三角形数です(節の場合は 0).
+    uint16_t    Axis;       //!< 分割軸です.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BvhTriangle structure
+///////////////////////////////////////////////////////////////////////////////
+struct BvhTriangle
+{
+    Vector3     P0;             //!< 頂点0.
+    Vector3     E1;             //!< 頂点0から頂点1へのエッジ.
+    Vector3     E2;             //!< 頂点0から頂点2へのエッジ.
+    uint32_t    PrimitiveId;    //!< 構築時の三角形番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BvhRay structure
+///////////////////////////////////////////////////////////////////////////////
+struct BvhRay
+{
+    Vector3     Origin;                 //!< 始点.
+    Vector3     Direction;              //!< 方向(正規化不要).
+    float       TMin    = 0.0f;         //!< 最小距離(0以上).
+    float       TMax    = FLT_MAX;      //!< 最大距離.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BvhHit structure
+///////////////////////////////////////////////////////////////////////////////
+struct BvhHit
+{
+    float       Distance    = FLT_MAX;      //!< 交差距離(方向ベクトルの長さ単位).
+    float       U           = 0.0f;         //!< 頂点1の重心座標.
+    float       V           = 0.0f;         //!< 頂点2の重心座標.
+    uint32_t    MeshId      = UINT32_MAX;   //!< メッシュ番号(交差しない場合は UINT32_MAX).
+    uint32_t    TriangleId  = UINT32_MAX;   //!< メッシュ内の三角形番号(交差しない場合は UINT32_MAX).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResBvh class
+///////////////////////////////////////////////////////////////////////////////
+class ResBvh
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    static const uint32_t kMaxLeafSize  = 4;    //!< 葉に格納する最大三角形数.
+    static const uint32_t kStackSize    = 64;   //!< 走査スタックのサイズ.
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    ResBvh();
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュの三角形から構築します.
+    //!
+    //! @param[in]      mesh        メッシュです.
+    //! @retval true    構築に成功.
+    //! @retval false   構築に失敗.
+    //! @note       ビン分割による SAH で構築し，共有スレッドプールで並列処理します.
+    //-------------------------------------------------------------------------
+    bool Build(const ResMesh& mesh);
+
+    //-------------------------------------------------------------------------
+    //! @brief      モデルの全メッシュの三角形から構築します.
+    //!
+    //! @param[in]      model       モデルです.
+    //! @retval true    構築に成功.
+    //! @retval false   構築に失敗.
+    //-------------------------------------------------------------------------
+    bool Build(const ResModel& model);
+
+    //-------------------------------------------------------------------------
+    //! @brief      破棄処理を行います.
+    //-------------------------------------------------------------------------
+    void Dispose();
+
+    //-------------------------------------------------------------------------
+    //! @brief      最も近い交差を求めます.
+    //!
+    //! @param[in]      ray         レイです.
+    //! @param[out]     hit         交差情報の格納先です.
+    //! @retval true    交差あり.
+    //! @retval false   交差なし.
+    //-------------------------------------------------------------------------
+    bool Intersect(const BvhRay& ray, BvhHit& hit) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      いずれかの三角形と交差するかどうかチェックします.
+    //!
+    //! @param[in]      ray         レイです.
+    //! @retval true    交差あり.
+    //! @retval false   交差なし.
+    //-------------------------------------------------------------------------
+    bool Occluded(const BvhRay& ray) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      複数のレイについて最も近い交差を並列に求めます.
+    //!
+    //! @param[in]      pRays       レイの配列です.
+    //! @param[in]      count       レイ数です.
+    //! @param[out]     pHits       交差情報の格納先です. count 個の要素が必要です.
+    //-------------------------------------------------------------------------
+    void Intersect(const BvhRay* pRays, uint32_t count, BvhHit* pHits) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      複数のレイについて遮蔽判定を並列に行います.
+    //!
+    //! @param[in]      pRays       レイの配列です.
+    //! @param[in]      count       レイ数です.
+    //! @param[out]     pResults    判定結果の格納先です. count 個の要素が必要です.
+    //-------------------------------------------------------------------------
+    void Occluded(const BvhRay* pRays, uint32_t count, bool* pResults) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      全体のバウンディングボックスを取得します.
+    //-------------------------------------------------------------------------
+    BoundingBox GetBounds() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ノード数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetNodeCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      ノードを取得します.
+    //-------------------------------------------------------------------------
+    const BvhNode* GetNodes() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      三角形数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetTriangleCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      葉の順に並び替えた三角形を取得します.
+    //-------------------------------------------------------------------------
+    const BvhTriangle* GetTriangles() const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    std::vector<BvhNode>        m_Nodes;            //!< ノード(m_Nodes[0] がルート).
+    std::vector<BvhTriangle>    m_Triangles;        //!< 葉の順に並び替えた三角形.
+    std::vector<uint32_t>       m_MeshOffsets;      //!< メッシュごとの先頭三角形番号.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    bool BuildTree(const std::vector<BvhTriangle>& triangles);
+    void ResolveHit(BvhHit& hit) const;
+};
+
+} // namespace asdx
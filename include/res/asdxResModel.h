@@ -12,10 +12,39 @@
 #include <string>
 #include <vector>
 #include <fnd/asdxMath.h>
+#include <fnd/asdxMappedFile.h>
 
 
 namespace asdx {
 
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class IThreadPool;
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshlet structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshlet
+{
+    uint32_t    VertexOffset;       //!< UniqueVertexIndices の開始位置.
+    uint32_t    VertexCount;        //!< 頂点数.
+    uint32_t    PrimitiveOffset;    //!< PrimitiveIndices の開始位置.
+    uint32_t    PrimitiveCount;     //!< プリミティブ数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshletBounds structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshletBounds
+{
+    asdx::Vector3   Center;         //!< バウンディングスフィアの中心.
+    float           Radius;         //!< バウンディングスフィアの半径.
+    asdx::Vector3   ConeApex;       //!< 法線コーンの頂点.
+    float           ConeCutoff;     //!< 法線コーンの開き角の半分の余弦.
+    asdx::Vector3   ConeAxis;       //!< 法線コーンの軸.
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 // ResMesh structure
 ///////////////////////////////////////////////////////////////////////////////
@@ -24,8 +53,8 @@ struct ResMesh
     static const uint32_t MAX_TEXCOORD_LAYERS = 4;   //!< 最大テクスチャ座標レイヤー数.
 
     std::string                 Name;                           //!< メッシュ名.
-    uint32_t                    MaterialId;                     //!< マテリアルID.
-    uint32_t                    BoneInfluenceCount;             //!< 影響するボーン数.
+    uint32_t                    MaterialId          = 0;        //!< マテリアルID.
+    uint32_t                    BoneInfluenceCount  = 0;        //!< 影響するボーン数.
     std::vector<asdx::Vector3>  Positions;                      //!< 位置座標.
     std::vector<asdx::Vector3>  Normals;                        //!< 法線ベクトル.
     std::vector<asdx::Vector3>  Tangents;                       //!< 接線ベクトル.
@@ -34,6 +63,10 @@ struct ResMesh
     std::vector<uint16_t>       BoneIndices;                    //!< ボーン番号.
     std::vector<float>          BoneWeights;                    //!< ボーン重み.
     std::vector<uint32_t>       VertexIndices;                  //!< 頂点番号.
+    std::vector<ResMeshlet>     Meshlets;                       //!< メッシュレット.
+    std::vector<uint32_t>       UniqueVertexIndices;            //!< メッシュレット毎の頂点番号.
+    std::vector<uint32_t>       PrimitiveIndices;               //!< メッシュレット内の頂点番号を 10bit ずつパックした三角形.
+    std::vector<ResMeshletBounds> MeshletBounds;                //!< メッシュレットのカリング用バウンディング.
 
     //-------------------------------------------------------------------------
     //! @brief      解放処理を行います.
@@ -49,6 +82,10 @@ struct ResMesh
         BoneIndices   .clear();
         BoneWeights   .clear();
         VertexIndices .clear();
+        Meshlets      .clear();
+        UniqueVertexIndices.clear();
+        PrimitiveIndices   .clear();
+        MeshletBounds      .clear();
 
         Name          .shrink_to_fit();
         Positions     .shrink_to_fit();
@@ -59,6 +96,10 @@ struct ResMesh
         BoneIndices   .shrink_to_fit();
         BoneWeights   .shrink_to_fit();
         VertexIndices .shrink_to_fit();
+        Meshlets      .shrink_to_fit();
+        UniqueVertexIndices.shrink_to_fit();
+        PrimitiveIndices   .shrink_to_fit();
+        MeshletBounds      .shrink_to_fit();
 
         MaterialId = 0;
     }
@@ -71,6 +112,59 @@ struct ResLodRange
 {
     uint32_t    Offset;     //!< メッシュオフセット番号.
     uint32_t    Count;      //!< メッシュ数.
+    float       Error;      //!< LOD0 に対する幾何誤差 (モデル空間での距離).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResLodSettings structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResLodSettings
+{
+    uint32_t    LodCount    = 4;        //!< 生成する最大LOD数 (LOD0 を含む).
+    float       Ratio       = 0.5f;     //!< 1段ごとの目標三角形比率.
+    float       TargetError = 0.05f;    //!< 許容誤差 (メッシュサイズに対する相対値).
+    bool        Sloppy      = false;    //!< 目標に届かない場合にトポロジーを無視した簡略化を行う場合は true.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshStatistics structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshStatistics
+{
+    static const uint32_t kVertexCacheSize = 16;    //!< 解析に用いる頂点キャッシュサイズ.
+
+    float   ACMR        = 0.0f;     //!< 変換頂点数 / 三角形数 (最良 0.5, 最悪 3.0).
+    float   ATVR        = 0.0f;     //!< 変換頂点数 / 頂点数 (最良 1.0).
+    float   Overdraw    = 0.0f;     //!< シェーディングピクセル数 / カバーピクセル数 (最良 1.0).
+    float   Overfetch   = 0.0f;     //!< フェッチバイト数 / 頂点バッファサイズ (最良 1.0).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResQuantizedMesh structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResQuantizedMesh
+{
+    asdx::Vector3               PositionScale;                  //!< 位置座標の展開スケール (位置 = 値 * スケール + バイアス).
+    asdx::Vector3               PositionBias;                   //!< 位置座標の展開バイアス.
+    std::vector<uint16_t>       Positions;                      //!< 位置座標 (R16G16B16A16_UNORM, 頂点あたり4要素で w は 0).
+    std::vector<uint32_t>       Normals;                        //!< 八面体マッピングした法線ベクトル (R16G16_SNORM).
+    std::vector<uint32_t>       Tangents;                       //!< 八面体マッピングした接線ベクトル (R16G16_SNORM).
+    std::vector<asdx::Half2>    TexCoords[ResMesh::MAX_TEXCOORD_LAYERS]; //!< テクスチャ座標 (R16G16_FLOAT).
+    std::vector<uint32_t>       Colors;                         //!< 頂点カラー (R8G8B8A8_UNORM).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResQuantizationError structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResQuantizationError
+{
+    float   Position        = 0.0f;     //!< 位置座標の最大誤差 (モデル空間での距離).
+    float   Normal          = 0.0f;     //!< 法線ベクトルの最大角度誤差 (度).
+    float   Tangent         = 0.0f;     //!< 接線ベクトルの最大角度誤差 (度).
+    float   TexCoord        = 0.0f;     //!< テクスチャ座標の最大誤差.
+    float   Color           = 0.0f;     //!< 頂点カラーの最大誤差.
+    size_t  SourceBytes     = 0;        //!< 量子化前の頂点データサイズ.
+    size_t  QuantizedBytes  = 0;        //!< 量子化後の頂点データサイズ.
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,24 +201,307 @@ struct ResModel
 
     //-------------------------------------------------------------------------
     //! @brief      ファイルからモデルリソースを生成します
-    //!             読み込み可能なファイルは OBJ です.
+    //!             読み込み可能なファイルは OBJ, AMDL です.
     //! 
     //! @param[in]      filename        ファイル名です.
+    //! @param[in]      optimize        true の場合は読み込み後に OptimizeMesh() を適用します.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //-------------------------------------------------------------------------
-    bool LoadFromFileA(const char* filename);
+    bool LoadFromFileA(const char* filename, bool optimize = false);
 
     //-------------------------------------------------------------------------
     //! @brief      ファイルからモデルリソースを生成します.
-    //!             読み込み可能なファイルは OBJ です.
+    //!             読み込み可能なファイルは OBJ, AMDL です.
     //! 
     //! @param[in]      filename        ファイル名です.
+    //! @param[in]      optimize        true の場合は読み込み後に OptimizeMesh() を適用します.
     //! @retval true    リソース生成に成功.
     //! @retval false   リソース生成に失敗.
     //-------------------------------------------------------------------------
-    bool LoadFromFileW(const wchar_t* filename);
+    bool LoadFromFileW(const wchar_t* filename, bool optimize = false);
+
+    //-------------------------------------------------------------------------
+    //! @brief      バイナリ形式(AMDL)でファイルに保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //-------------------------------------------------------------------------
+    bool SaveToFileA(const char* filename) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      バイナリ形式(AMDL)でファイルに保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //-------------------------------------------------------------------------
+    bool SaveToFileW(const wchar_t* filename) const;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ResMeshView structure
+///////////////////////////////////////////////////////////////////////////////
+struct ResMeshView
+{
+    const char*                 Name;                                   //!< メッシュ名.
+    uint32_t                    MaterialId;                             //!< マテリアルID.
+    uint32_t                    BoneInfluenceCount;                     //!< 影響するボーン数.
+    uint32_t                    VertexCount;                            //!< 頂点数.
+    uint32_t                    IndexCount;                             //!< 頂点インデックス数.
+    uint32_t                    MeshletCount;                           //!< メッシュレット数.
+    uint32_t                    UniqueVertexIndexCount;                 //!< メッシュレット毎の頂点番号の数.
+    uint32_t                    PrimitiveCount;                         //!< メッシュレットのプリミティブ数.
+    const asdx::Vector3*        pPositions;                             //!< 位置座標.
+    const asdx::Vector3*        pNormals;                               //!< 法線ベクトル (無い場合は nullptr).
+    const asdx::Vector3*        pTangents;                              //!< 接線ベクトル (無い場合は nullptr).
+    const asdx::Vector2*        pTexCoords[ResMesh::MAX_TEXCOORD_LAYERS]; //!< テクスチャ座標 (無い場合は nullptr).
+    const asdx::Vector4*        pColors;                                //!< 頂点カラー (無い場合は nullptr).
+    const uint16_t*             pBoneIndices;                           //!< ボーン番号 (無い場合は nullptr).
+    const float*                pBoneWeights;                           //!< ボーン重み (無い場合は nullptr).
+    const uint32_t*             pVertexIndices;                         //!< 頂点番号.
+    const ResMeshlet*           pMeshlets;                              //!< メッシュレット (無い場合は nullptr).
+    const uint32_t*             pUniqueVertexIndices;                   //!< メッシュレット毎の頂点番号 (無い場合は nullptr).
+    const uint32_t*             pPrimitiveIndices;                      //!< パックされた三角形 (無い場合は nullptr).
+    const ResMeshletBounds*     pMeshletBounds;                         //!< メッシュレットのバウンディング (無い場合は nullptr).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// CookedModel class
+///////////////////////////////////////////////////////////////////////////////
+class CookedModel
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    static const uint32_t kMagic   = 'LDMA';    //!< ファイル識別子 "AMDL".
+    static const uint32_t kVersion = 1;         //!< ファイルバージョン.
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    CookedModel();
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~CookedModel();
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルをメモリにマップして読み込みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //! @note       データはコピーされず，各ビューはマップされたメモリを直接指します.
+    //-------------------------------------------------------------------------
+    bool LoadA(const char* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルをメモリにマップして読み込みます.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    読み込みに成功.
+    //! @retval false   読み込みに失敗.
+    //! @note       データはコピーされず，各ビューはマップされたメモリを直接指します.
+    //-------------------------------------------------------------------------
+    bool LoadW(const wchar_t* filename);
+
+    //-------------------------------------------------------------------------
+    //! @brief      ファイルを閉じます. 取得済みのビューは無効になります.
+    //-------------------------------------------------------------------------
+    void Close();
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュ数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMeshCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      メッシュを取得します.
+    //-------------------------------------------------------------------------
+    const ResMeshView& GetMesh(uint32_t index) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      LOD数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetLodCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      LOD範囲を取得します.
+    //-------------------------------------------------------------------------
+    const ResLodRange& GetLodRange(uint32_t index) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      マテリアル数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetMaterialCount() const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      マテリアル名を取得します.
+    //-------------------------------------------------------------------------
+    const char* GetMaterialName(uint32_t index) const;
+
+    //-------------------------------------------------------------------------
+    //! @brief      モデルリソースにコピーします.
+    //!
+    //! @param[out]     model       コピー先です.
+    //-------------------------------------------------------------------------
+    void CopyTo(ResModel& model) const;
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    MappedFile                  m_File;         //!< マップされたファイル.
+    std::vector<ResMeshView>    m_Meshes;       //!< メッシュ.
+    const ResLodRange*          m_pLodRanges;   //!< LOD範囲.
+    uint32_t                    m_LodCount;     //!< LOD数.
+    std::vector<const char*>    m_Materials;    //!< マテリアル名.
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    bool Parse();
+
+    CookedModel     (const CookedModel&) = delete;
+    void operator = (const CookedModel&) = delete;
 };
 
+//-----------------------------------------------------------------------------
+//! @brief      重複頂点を統合し，インデックスバッファを生成します.
+//!
+//! @param[in,out]  mesh        処理するメッシュです.
+//! @note       全ての頂点属性がビット単位で一致する頂点を1つにまとめます.
+//-----------------------------------------------------------------------------
+void WeldVertices(ResMesh& mesh);
+
+//-----------------------------------------------------------------------------
+//! @brief      法線ベクトルを計算します.
+//!
+//! @param[in,out]  mesh            処理するメッシュです.
+//! @param[in]      smoothingAngle  スムージング角度(度)です.
+//! @note       頂点を共有する面法線の平均を求め，最後に参照する面とのなす角が
+//!             スムージング角度を超える場合はその面法線を使います.
+//-----------------------------------------------------------------------------
+void CalcNormals(ResMesh& mesh, float smoothingAngle = 59.7f);
+
+//-----------------------------------------------------------------------------
+//! @brief      スレッドプールを指定して法線ベクトルを計算します.
+//!
+//! @param[in,out]  mesh            処理するメッシュです.
+//! @param[in]      smoothingAngle  スムージング角度(度)です.
+//! @param[in]      pThreadPool     スレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+//! @note       スレッドプールを指定した場合は頂点から面への隣接情報を並列に構築して集計し，
+//!             nullptr の場合は面の順に直接加算します. 結果はスレッド数によらずビット単位で一致します.
+//!             スレッドプールを指定しない場合は，共有スレッドプールのワーカー数が少なければ直接加算します.
+//-----------------------------------------------------------------------------
+void CalcNormals(ResMesh& mesh, float smoothingAngle, IThreadPool* pThreadPool);
+
+//-----------------------------------------------------------------------------
+//! @brief      接線ベクトルを計算します.
+//!
+//! @param[in,out]  mesh        処理するメッシュです.
+//! @note       法線ベクトルが無い場合は先に計算します.
+//!             テクスチャ座標が無い場合は法線から適当な接線を求めます.
+//-----------------------------------------------------------------------------
+void CalcTangents(ResMesh& mesh);
+
+//-----------------------------------------------------------------------------
+//! @brief      スレッドプールを指定して接線ベクトルを計算します.
+//!
+//! @param[in,out]  mesh            処理するメッシュです.
+//! @param[in]      pThreadPool     スレッドプールです. nullptr の場合は呼び出しスレッドで処理します.
+//! @note       集計方法は CalcNormals() と同じです. 結果はスレッド数によらずビット単位で一致します.
+//-----------------------------------------------------------------------------
+void CalcTangents(ResMesh& mesh, IThreadPool* pThreadPool);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュの統計情報を求めます.
+//!
+//! @param[in]      mesh        解析するメッシュです.
+//! @param[out]     result      統計情報の格納先です.
+//-----------------------------------------------------------------------------
+void AnalyzeMesh(const ResMesh& mesh, ResMeshStatistics& result);
+
+//-----------------------------------------------------------------------------
+//! @brief      描画用にメッシュを最適化します.
+//!
+//! @param[in,out]  mesh                処理するメッシュです.
+//! @param[in]      overdrawThreshold   オーバードロー削減のために許容する ACMR の悪化率です.
+//! @note       頂点キャッシュ，オーバードロー，頂点フェッチの順に最適化し，
+//!             参照されていない頂点は取り除かれます.
+//-----------------------------------------------------------------------------
+void OptimizeMesh(ResMesh& mesh, float overdrawThreshold = 1.05f);
+
+//-----------------------------------------------------------------------------
+//! @brief      頂点属性を量子化します.
+//!
+//! @param[in]      mesh        量子化するメッシュです.
+//! @param[out]     result      量子化結果の格納先です. 頂点番号は元のメッシュのものをそのまま使用します.
+//! @param[out]     pError      誤差の格納先です. nullptr の場合は誤差を計算しません.
+//-----------------------------------------------------------------------------
+void QuantizeMesh(const ResMesh& mesh, ResQuantizedMesh& result, ResQuantizationError* pError = nullptr);
+
+//-----------------------------------------------------------------------------
+//! @brief      メッシュレットを生成します.
+//!
+//! @param[in,out]  mesh            処理するメッシュです.
+//! @param[in]      maxVertices     メッシュレットあたりの最大頂点数です (3 ～ 255).
+//! @param[in]      maxPrimitives   メッシュレットあたりの最大プリミティブ数です (4 ～ 512, 4の倍数に切り捨てます).
+//! @param[in]      coneWeight      法線コーンによるカリング効率を優先する度合いです (0 ～ 1).
+//! @retval true    生成に成功.
+//! @retval false   生成に失敗.
+//! @note       WeldVertices(), OptimizeMesh() を呼び出すとメッシュレットは破棄されます.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets
+(
+    ResMesh&    mesh,
+    uint32_t    maxVertices     = 64,
+    uint32_t    maxPrimitives   = 124,
+    float       coneWeight      = 0.5f
+);
+
+//-----------------------------------------------------------------------------
+//! @brief      LODチェインを生成します.
+//!
+//! @param[in,out]  model       処理するモデルです.
+//! @param[in]      settings    生成設定です.
+//! @note       LOD0 のメッシュ群を簡略化し，Meshes にLOD順で並べて LodRanges を設定します.
+//!             既に LodRanges が設定されている場合は LOD0 以外を破棄してから生成し直します.
+//!             全てのメッシュがそれ以上簡略化できなくなった時点で生成を打ち切ります.
+//-----------------------------------------------------------------------------
+void GenerateLods(ResModel& model, const ResLodSettings& settings = ResLodSettings());
+
+//-----------------------------------------------------------------------------
+//! @brief      画面上での誤差からLOD番号を選択します.
+//!
+//! @param[in]      model       モデルです.
+//! @param[in]      distance    カメラからの距離です.
+//! @param[in]      fovY        垂直画角(ラジアン)です.
+//! @param[in]      screenHeight    画面の高さ(ピクセル)です.
+//! @param[in]      threshold   許容する画面上での誤差(ピクセル)です.
+//! @return     誤差が閾値以下となる最も粗いLOD番号を返却します.
+//-----------------------------------------------------------------------------
+uint32_t SelectLod
+(
+    const ResModel& model,
+    float           distance,
+    float           fovY,
+    float           screenHeight,
+    float           threshold = 1.0f
+);
+
 } // namespace asdx
 
@@ -13,6 +13,11 @@
 
 namespace asdx {
 
+//-----------------------------------------------------------------------------
+// Forward Declarations.
+//-----------------------------------------------------------------------------
+class MappedFile;
+
 //-----------------------------------------------------------------------------
 //      nullptrを考慮してdelete[]を呼び出します.
 //-----------------------------------------------------------------------------
@@ -83,6 +88,8 @@ struct ResTexture
     uint32_t             MipMapCount;    //!< ミップマップ数です.
     uint32_t             SurfaceCount;   //!< サーフェイス数です(1次元配列テクスチャ, 2次元配列テクスチャ, キューブマップの場合のみ6以上の数が入ります).
     SubResource*         pResources;     //!< サブリソースです.
+    uint8_t*             pPixelData;     //!< 全サブリソースが参照する一括確保したテクセルデータです(個別に確保した場合は nullptr).
+    MappedFile*          pMappedFile;    //!< 全サブリソースが参照するメモリマップされたファイルです(マップしていない場合は nullptr).
 
     //-------------------------------------------------------------------------
     //! @brief      コンストラクタです.
@@ -96,20 +103,14 @@ struct ResTexture
     , MipMapCount   ( 0 )
     , SurfaceCount  ( 0 )
     , pResources    ( nullptr )
+    , pPixelData    ( nullptr )
+    , pMappedFile   ( nullptr )
     { /* DO_NOTHING */ }
 
     //-------------------------------------------------------------------------
     //! @brief      解放処理を行います.
     //-------------------------------------------------------------------------
-    void Dispose()
-    {
-        uint32_t mipCount = ( MipMapCount > 0 ) ? MipMapCount : 1;
-
-        for( uint32_t i=0; i<SurfaceCount * mipCount; ++i )
-        { pResources[i].Release(); }
-
-        SafeDeleteArray( pResources );
-    }
+    void Dispose();
 
     //---------------------------------------------------------------------------------------------
     //! @brief      ファイルからテクスチャリソースを生成します.
@@ -131,9 +132,52 @@ struct ResTexture
     //---------------------------------------------------------------------------------------------
     bool LoadFromFileW(const wchar_t* filename);
 
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルをメモリマップしてテクスチャリソースを生成します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    リソース生成に成功.
+    //! @retval false   リソース生成に失敗.
+    //! @note       DDSの場合はサブリソースのテクセルデータがマップを直接参照するため，コピーが発生しません.
+    //!             テクセルデータは読み取り専用になり，マップは Dispose() で解放されます.
+    //!             TGAとHDRはマップから直接デコードします.
+    //!             BGRAの並び替えが必要なフォーマットとその他のファイルは通常通り読み込みます.
+    //---------------------------------------------------------------------------------------------
+    bool MapFromFileA(const char* filename);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      ファイルをメモリマップしてテクスチャリソースを生成します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    リソース生成に成功.
+    //! @retval false   リソース生成に失敗.
+    //! @note       MapFromFileA() と同様です.
+    //---------------------------------------------------------------------------------------------
+    bool MapFromFileW(const wchar_t* filename);
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      DDSファイルに保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //! @note       DX10拡張ヘッダ付きで出力します. 書き出せるのは読み込み可能なDXGIフォーマットのみです.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToDDSA(const char* filename) const;
+
+    //---------------------------------------------------------------------------------------------
+    //! @brief      DDSファイルに保存します.
+    //!
+    //! @param[in]      filename        ファイル名です.
+    //! @retval true    保存に成功.
+    //! @retval false   保存に失敗.
+    //! @note       SaveToDDSA() と同様です.
+    //---------------------------------------------------------------------------------------------
+    bool SaveToDDSW(const wchar_t* filename) const;
+
     //---------------------------------------------------------------------------------------------
     //! @brief      メモリストリームからテクスチャリソースを生成します.
-    //!             メモリストリームの形式は DDS, BMP, JPG, PNG, TIFF, GIF, HDP である必要があります.
+    //!             メモリストリームの形式は DDS, BMP, JPG, PNG, TIFF, GIF, HDP, TGA, HDR である必要があります.
     //!
     //! @param[in]      pBuffer         バッファです.
     //! @param[in]      bufferSize      バッファサイズです.
@@ -143,4 +187,29 @@ struct ResTexture
     bool LoadFromMemory(const uint8_t* pBuffer, uint32_t bufferSize);
 };
 
+//-------------------------------------------------------------------------------------------------
+//! @brief      Targaのバイナリからテクスチャリソースを生成します.
+//!
+//! @param[in]      pBinary         バイナリです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     resTexture      生成したテクスチャリソースの格納先です.
+//! @retval true    リソース生成に成功.
+//! @retval false   リソース生成に失敗.
+//! @note       フッターの有無に関わらず読み込めます. カラーは R8G8B8A8_UNORM, グレースケールは
+//!             R8_UNORM または R8G8_UNORM に変換されます.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAMemory(const uint8_t* pBinary, size_t bufferSize, ResTexture& resTexture);
+
+//-------------------------------------------------------------------------------------------------
+//! @brief      Radiance HDR のバイナリからテクスチャリソースを生成します.
+//!
+//! @param[in]      pBinary         バイナリです.
+//! @param[in]      bufferSize      バッファサイズです.
+//! @param[out]     resTexture      生成したテクスチャリソースの格納先です.
+//! @retval true    リソース生成に成功.
+//! @retval false   リソース生成に失敗.
+//! @note       R16G16B16A16_FLOAT に変換されます. スキャンラインは並列にデコードします.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromHDRMemory(const uint8_t* pBinary, size_t bufferSize, ResTexture& resTexture);
+
 } // namespace asdx
@@ -0,0 +1,97 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTextureCache.h
+// Desc : Texture Cook Cache.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <cstddef>
+#include <res/asdxResTexture.h>
+#include <res/asdxMipGenerator.h>
+#include <res/asdxBlockCompression.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// TextureCookOption structure
+///////////////////////////////////////////////////////////////////////////////
+struct TextureCookOption
+{
+    bool        GenerateMipMaps;    //!< ミップマップを生成するかどうか?
+    MIP_FILTER  MipFilter;          //!< ミップマップの縮小フィルタです.
+    float       AlphaReference;     //!< アルファテストの閾値です(0 以下の場合はカバレッジを補正しません).
+    bool        Compress;           //!< ブロック圧縮するかどうか?
+    BC_FORMAT   Format;             //!< ブロック圧縮フォーマットです.
+    BC_QUALITY  Quality;            //!< ブロック圧縮の品質です.
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    TextureCookOption()
+    : GenerateMipMaps   ( true )
+    , MipFilter         ( MIP_FILTER_BOX )
+    , AlphaReference    ( 0.0f )
+    , Compress          ( false )
+    , Format            ( BC_FORMAT_BC7 )
+    , Quality           ( BC_QUALITY_NORMAL )
+    { /* DO_NOTHING */ }
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      クック済みテクスチャのキャッシュキーを計算します.
+//!
+//! @param[in]      pSource     ソースファイルのデータです.
+//! @param[in]      size        ソースファイルのサイズです.
+//! @param[in]      option      クックオプションです.
+//! @return     ソースの内容と，結果に影響するオプションから計算した64bitハッシュ値を返却します.
+//-----------------------------------------------------------------------------
+uint64_t CalcTextureCookKey(const void* pSource, size_t size, const TextureCookOption& option);
+
+//-----------------------------------------------------------------------------
+//! @brief      キャッシュを利用してクック済みテクスチャを読み込みます.
+//!
+//! @param[in]      filename        ソースファイル名です.
+//! @param[in]      cacheDir        キャッシュディレクトリです. 存在しない場合は途中のディレクトリを含めて生成します.
+//! @param[in]      option          クックオプションです.
+//! @param[out]     resTexture      読み込んだリソーステクスチャです.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       キャッシュにヒットした場合は "<キー>.dds" をメモリマップするだけで，
+//!             デコード・ミップマップ生成・ブロック圧縮を行いません.
+//!             ミスした場合はクック結果を返却し，キャッシュへの保存に失敗しても成功扱いとします.
+//!             ソースに適用できない処理は警告を出して飛ばします(既存のミップマップがある，
+//!             圧縮済みや未対応のフォーマットなど). 浮動小数点のソースは BC6H で圧縮します.
+//-----------------------------------------------------------------------------
+bool LoadCookedTextureA(
+    const char*                 filename,
+    const char*                 cacheDir,
+    const TextureCookOption&    option,
+    ResTexture&                 resTexture);
+
+//-----------------------------------------------------------------------------
+//! @brief      キャッシュを利用してクック済みテクスチャを読み込みます.
+//!
+//! @param[in]      filename        ソースファイル名です.
+//! @param[in]      cacheDir        キャッシュディレクトリです. 存在しない場合は途中のディレクトリを含めて生成します.
+//! @param[in]      option          クックオプションです.
+//! @param[out]     resTexture      読み込んだリソーステクスチャです.
+//! @retval true    読み込みに成功.
+//! @retval false   読み込みに失敗.
+//! @note       キャッシュにヒットした場合は "<キー>.dds" をメモリマップするだけで，
+//!             デコード・ミップマップ生成・ブロック圧縮を行いません.
+//!             ミスした場合はクック結果を返却し，キャッシュへの保存に失敗しても成功扱いとします.
+//!             ソースに適用できない処理は警告を出して飛ばします(既存のミップマップがある，
+//!             圧縮済みや未対応のフォーマットなど). 浮動小数点のソースは BC6H で圧縮します.
+//-----------------------------------------------------------------------------
+bool LoadCookedTextureW(
+    const wchar_t*              filename,
+    const wchar_t*              cacheDir,
+    const TextureCookOption&    option,
+    ResTexture&                 resTexture);
+
+} // namespace asdx
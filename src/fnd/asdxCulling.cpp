@@ -0,0 +1,482 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxCulling.cpp
+// Desc : Frustum Culling.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <cassert>
+#include <fnd/asdxCulling.h>
+#include <fnd/asdxParallel.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define ASDX_CULLING_AVX2   (1)
+#elif defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define ASDX_CULLING_SSE2   (1)
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kBitsPerWord = 32;   // マスク1要素あたりのオブジェクト数.
+
+///////////////////////////////////////////////////////////////////////////////
+// PlaneSet structure
+///////////////////////////////////////////////////////////////////////////////
+struct PlaneSet
+{
+    float       Nx[asdx::SHADOW_PLANE_COUNT];   // 法線X.
+    float       Ny[asdx::SHADOW_PLANE_COUNT];   // 法線Y.
+    float       Nz[asdx::SHADOW_PLANE_COUNT];   // 法線Z.
+    float       D [asdx::SHADOW_PLANE_COUNT];   // 距離.
+    float       Ax[asdx::SHADOW_PLANE_COUNT];   // 法線Xの絶対値.
+    float       Ay[asdx::SHADOW_PLANE_COUNT];   // 法線Yの絶対値.
+    float       Az[asdx::SHADOW_PLANE_COUNT];   // 法線Zの絶対値.
+    uint32_t    Count;                          // 平面数.
+};
+
+//-----------------------------------------------------------------------------
+//      最下位の立っているビット位置を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t FindFirstBit(uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return uint32_t(index);
+#else
+    return uint32_t(__builtin_ctz(value));
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      平面を成分毎に分離します.
+//-----------------------------------------------------------------------------
+void SetupPlanes(const asdx::Vector4* planes, uint32_t count, PlaneSet& result)
+{
+    for(auto i=0u; i<count; ++i)
+    {
+        result.Nx[i] = planes[i].x;
+        result.Ny[i] = planes[i].y;
+        result.Nz[i] = planes[i].z;
+        result.D [i] = planes[i].w;
+        result.Ax[i] = fabsf(planes[i].x);
+        result.Ay[i] = fabsf(planes[i].y);
+        result.Az[i] = fabsf(planes[i].z);
+    }
+    result.Count = count;
+}
+
+//-----------------------------------------------------------------------------
+//      中心と半径(各軸の広がり)から可視判定を行います.
+//-----------------------------------------------------------------------------
+inline bool IsVisible
+(
+    const PlaneSet& planes,
+    float cx, float cy, float cz,
+    float ex, float ey, float ez
+)
+{
+    for(auto i=0u; i<planes.Count; ++i)
+    {
+        auto d = planes.Nx[i] * cx + planes.Ny[i] * cy + planes.Nz[i] * cz + planes.D[i];
+        auto r = planes.Ax[i] * ex + planes.Ay[i] * ey + planes.Az[i] * ez;
+        if (d + r < 0.0f)
+        { return false; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ボックスの中心と広がりを求めます.
+//-----------------------------------------------------------------------------
+inline void GetCenterExtent
+(
+    const asdx::BoundingBox& box,
+    float& cx, float& cy, float& cz,
+    float& ex, float& ey, float& ez
+)
+{
+    cx = (box.Max.x + box.Min.x) * 0.5f;
+    cy = (box.Max.y + box.Min.y) * 0.5f;
+    cz = (box.Max.z + box.Min.z) * 0.5f;
+    ex = (box.Max.x - box.Min.x) * 0.5f;
+    ey = (box.Max.y - box.Min.y) * 0.5f;
+    ez = (box.Max.z - box.Min.z) * 0.5f;
+}
+
+#if defined(ASDX_CULLING_AVX2)
+///////////////////////////////////////////////////////////////////////////////
+// SimdLane structure (8並列)
+///////////////////////////////////////////////////////////////////////////////
+struct SimdLane
+{
+    using Type = __m256;
+    static const uint32_t Width = 8;
+
+    static Type Set1(float v)               { return _mm256_set1_ps(v); }
+    static Type Add (Type a, Type b)        { return _mm256_add_ps(a, b); }
+    static Type Sub (Type a, Type b)        { return _mm256_sub_ps(a, b); }
+    static Type Mul (Type a, Type b)        { return _mm256_mul_ps(a, b); }
+    static Type And (Type a, Type b)        { return _mm256_and_ps(a, b); }
+    static Type CmpGE(Type a, Type b)       { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Type True()                      { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+    static uint32_t MoveMask(Type v)        { return uint32_t(_mm256_movemask_ps(v)); }
+
+    // stride 個おきに読み込みます.
+    static Type Load(const float* p, size_t stride)
+    {
+        return _mm256_set_ps(
+            p[stride * 7], p[stride * 6], p[stride * 5], p[stride * 4],
+            p[stride * 3], p[stride * 2], p[stride * 1], p[0]);
+    }
+};
+#elif defined(ASDX_CULLING_SSE2)
+///////////////////////////////////////////////////////////////////////////////
+// SimdLane structure (4並列)
+///////////////////////////////////////////////////////////////////////////////
+struct SimdLane
+{
+    using Type = __m128;
+    static const uint32_t Width = 4;
+
+    static Type Set1(float v)               { return _mm_set1_ps(v); }
+    static Type Add (Type a, Type b)        { return _mm_add_ps(a, b); }
+    static Type Sub (Type a, Type b)        { return _mm_sub_ps(a, b); }
+    static Type Mul (Type a, Type b)        { return _mm_mul_ps(a, b); }
+    static Type And (Type a, Type b)        { return _mm_and_ps(a, b); }
+    static Type CmpGE(Type a, Type b)       { return _mm_cmpge_ps(a, b); }
+    static Type True()                      { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+    static uint32_t MoveMask(Type v)        { return uint32_t(_mm_movemask_ps(v)); }
+
+    // stride 個おきに読み込みます.
+    static Type Load(const float* p, size_t stride)
+    { return _mm_set_ps(p[stride * 3], p[stride * 2], p[stride * 1], p[0]); }
+};
+#endif
+
+#if defined(ASDX_CULLING_AVX2) || defined(ASDX_CULLING_SSE2)
+//-----------------------------------------------------------------------------
+//      中心と広がりから可視判定を行い，ビットマスクを返却します.
+//-----------------------------------------------------------------------------
+inline uint32_t TestSimd
+(
+    const PlaneSet&         planes,
+    SimdLane::Type          cx,
+    SimdLane::Type          cy,
+    SimdLane::Type          cz,
+    SimdLane::Type          ex,
+    SimdLane::Type          ey,
+    SimdLane::Type          ez,
+    bool                    sphere
+)
+{
+    using L = SimdLane;
+    auto zero    = L::Set1(0.0f);
+    auto visible = L::True();
+
+    for(auto i=0u; i<planes.Count; ++i)
+    {
+        auto d = L::Add(L::Add(L::Add(
+            L::Mul(L::Set1(planes.Nx[i]), cx),
+            L::Mul(L::Set1(planes.Ny[i]), cy)),
+            L::Mul(L::Set1(planes.Nz[i]), cz)),
+            L::Set1(planes.D[i]));
+
+        // スフィアは ex に半径が入っている.
+        auto r = (sphere) ? ex : L::Add(L::Add(
+            L::Mul(L::Set1(planes.Ax[i]), ex),
+            L::Mul(L::Set1(planes.Ay[i]), ey)),
+            L::Mul(L::Set1(planes.Az[i]), ez));
+
+        visible = L::And(visible, L::CmpGE(L::Add(d, r), zero));
+    }
+
+    return L::MoveMask(visible);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+//      最大32個のボックスの可視判定を行います.
+//-----------------------------------------------------------------------------
+uint32_t TestBoxes(const PlaneSet& planes, const asdx::BoundingBox* pBoxes, uint32_t count)
+{
+    uint32_t mask = 0;
+    uint32_t i    = 0;
+
+#if defined(ASDX_CULLING_AVX2) || defined(ASDX_CULLING_SSE2)
+    using L = SimdLane;
+    const auto stride = sizeof(asdx::BoundingBox) / sizeof(float);
+    const auto half   = L::Set1(0.5f);
+
+    for(; i + L::Width <= count; i += L::Width)
+    {
+        auto p = reinterpret_cast<const float*>(&pBoxes[i]);
+
+        auto minX = L::Load(p + 0, stride);
+        auto minY = L::Load(p + 1, stride);
+        auto minZ = L::Load(p + 2, stride);
+        auto maxX = L::Load(p + 3, stride);
+        auto maxY = L::Load(p + 4, stride);
+        auto maxZ = L::Load(p + 5, stride);
+
+        auto cx = L::Mul(L::Add(maxX, minX), half);
+        auto cy = L::Mul(L::Add(maxY, minY), half);
+        auto cz = L::Mul(L::Add(maxZ, minZ), half);
+        auto ex = L::Mul(L::Sub(maxX, minX), half);
+        auto ey = L::Mul(L::Sub(maxY, minY), half);
+        auto ez = L::Mul(L::Sub(maxZ, minZ), half);
+
+        mask |= TestSimd(planes, cx, cy, cz, ex, ey, ez, false) << i;
+    }
+#endif
+
+    // 端数.
+    for(; i<count; ++i)
+    {
+        float cx, cy, cz, ex, ey, ez;
+        GetCenterExtent(pBoxes[i], cx, cy, cz, ex, ey, ez);
+        if (IsVisible(planes, cx, cy, cz, ex, ey, ez))
+        { mask |= 1u << i; }
+    }
+
+    return mask;
+}
+
+//-----------------------------------------------------------------------------
+//      最大32個のスフィアの可視判定を行います.
+//-----------------------------------------------------------------------------
+uint32_t TestSpheres(const PlaneSet& planes, const asdx::BoundingSphere* pSpheres, uint32_t count)
+{
+    uint32_t mask = 0;
+    uint32_t i    = 0;
+
+#if defined(ASDX_CULLING_AVX2) || defined(ASDX_CULLING_SSE2)
+    using L = SimdLane;
+    const auto stride = sizeof(asdx::BoundingSphere) / sizeof(float);
+
+    for(; i + L::Width <= count; i += L::Width)
+    {
+        auto p = reinterpret_cast<const float*>(&pSpheres[i]);
+
+        auto cx = L::Load(p + 0, stride);
+        auto cy = L::Load(p + 1, stride);
+        auto cz = L::Load(p + 2, stride);
+        auto r  = L::Load(p + 3, stride);
+
+        mask |= TestSimd(planes, cx, cy, cz, r, r, r, true) << i;
+    }
+#endif
+
+    // 端数.
+    for(; i<count; ++i)
+    {
+        const auto& s = pSpheres[i];
+
+        auto visible = true;
+        for(auto j=0u; j<planes.Count; ++j)
+        {
+            auto d = planes.Nx[j] * s.Center.x + planes.Ny[j] * s.Center.y + planes.Nz[j] * s.Center.z + planes.D[j];
+            if (d + s.Radius < 0.0f)
+            {
+                visible = false;
+                break;
+            }
+        }
+
+        if (visible)
+        { mask |= 1u << i; }
+    }
+
+    return mask;
+}
+
+//-----------------------------------------------------------------------------
+//      可視マスクを求めます.
+//-----------------------------------------------------------------------------
+template<typename T, typename Func>
+void TestAll
+(
+    const PlaneSet&     planes,
+    const T*            pItems,
+    uint32_t            count,
+    uint32_t*           pMask,
+    asdx::IThreadPool*  pThreadPool,
+    Func                func
+)
+{
+    auto wordCount = (count + kBitsPerWord - 1) / kBitsPerWord;
+
+    // マスク1要素単位で分割するので，ワーカー間で書き込み先が重なることはない.
+    asdx::ParallelForRange(pThreadPool, 0, wordCount, 0, [&](size_t begin, size_t end)
+    {
+        for(auto w=begin; w<end; ++w)
+        {
+            auto offset = uint32_t(w) * kBitsPerWord;
+            auto n = count - offset;
+            if (n > kBitsPerWord)
+            { n = kBitsPerWord; }
+
+            pMask[w] = func(planes, pItems + offset, n);
+        }
+    });
+}
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// FrustumCuller class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+FrustumCuller::FrustumCuller()
+: m_PlaneCount(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      ビュー行列と射影行列から視錐台を設定します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::SetFrustum(const Matrix& view, const Matrix& proj)
+{
+    CalcFrustumPlanes(view, proj, m_Planes);
+    m_PlaneCount = PLANE_COUNT;
+}
+
+//-----------------------------------------------------------------------------
+//      カリングに用いる平面を設定します.
+//-----------------------------------------------------------------------------
+void FrustumCuller::SetPlanes(const Vector4* planes, uint32_t count)
+{
+    assert(planes != nullptr || count == 0);
+    assert(count <= SHADOW_PLANE_COUNT);
+    if (count > SHADOW_PLANE_COUNT)
+    { count = SHADOW_PLANE_COUNT; }
+
+    for(auto i=0u; i<count; ++i)
+    { m_Planes[i] = planes[i]; }
+
+    m_PlaneCount = count;
+}
+
+//-----------------------------------------------------------------------------
+//      平面を取得します.
+//-----------------------------------------------------------------------------
+const Vector4* FrustumCuller::GetPlanes() const
+{ return m_Planes; }
+
+//-----------------------------------------------------------------------------
+//      平面数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t FrustumCuller::GetPlaneCount() const
+{ return m_PlaneCount; }
+
+//-----------------------------------------------------------------------------
+//      バウンディングボックスの可視判定を行います.
+//-----------------------------------------------------------------------------
+void FrustumCuller::Test
+(
+    const BoundingBox*  pBoxes,
+    uint32_t            count,
+    uint32_t*           pMask,
+    IThreadPool*        pThreadPool
+) const
+{
+    assert(count == 0 || (pBoxes != nullptr && pMask != nullptr));
+
+    PlaneSet planes;
+    SetupPlanes(m_Planes, m_PlaneCount, planes);
+    TestAll(planes, pBoxes, count, pMask, pThreadPool, TestBoxes);
+}
+
+//-----------------------------------------------------------------------------
+//      バウンディングスフィアの可視判定を行います.
+//-----------------------------------------------------------------------------
+void FrustumCuller::Test
+(
+    const BoundingSphere*   pSpheres,
+    uint32_t                count,
+    uint32_t*               pMask,
+    IThreadPool*            pThreadPool
+) const
+{
+    assert(count == 0 || (pSpheres != nullptr && pMask != nullptr));
+
+    PlaneSet planes;
+    SetupPlanes(m_Planes, m_PlaneCount, planes);
+    TestAll(planes, pSpheres, count, pMask, pThreadPool, TestSpheres);
+}
+
+//-----------------------------------------------------------------------------
+//      バウンディングボックスをカリングし，可視なものの番号を詰めて格納します.
+//-----------------------------------------------------------------------------
+uint32_t FrustumCuller::Cull
+(
+    const BoundingBox*  pBoxes,
+    uint32_t            count,
+    uint32_t*           pIndices,
+    IThreadPool*        pThreadPool
+) const
+{
+    // 番号の格納先の末尾をマスクの一時領域として使う.
+    // k 番目のマスクを読むまでに書き込まれる番号は 32 * k 個以下なので，未読のマスクを上書きしない.
+    auto pMask = pIndices + count - (count + kBitsPerWord - 1) / kBitsPerWord;
+    Test(pBoxes, count, pMask, pThreadPool);
+    return CompactVisibleIndices(pMask, count, pIndices);
+}
+
+//-----------------------------------------------------------------------------
+//      バウンディングスフィアをカリングし，可視なものの番号を詰めて格納します.
+//-----------------------------------------------------------------------------
+uint32_t FrustumCuller::Cull
+(
+    const BoundingSphere*   pSpheres,
+    uint32_t                count,
+    uint32_t*               pIndices,
+    IThreadPool*            pThreadPool
+) const
+{
+    auto pMask = pIndices + count - (count + kBitsPerWord - 1) / kBitsPerWord;
+    Test(pSpheres, count, pMask, pThreadPool);
+    return CompactVisibleIndices(pMask, count, pIndices);
+}
+
+//-----------------------------------------------------------------------------
+//      可視マスクから可視なものの番号を詰めて格納します.
+//-----------------------------------------------------------------------------
+uint32_t CompactVisibleIndices(const uint32_t* pMask, uint32_t count, uint32_t* pIndices)
+{
+    auto wordCount = (count + kBitsPerWord - 1) / kBitsPerWord;
+    uint32_t result = 0;
+
+    for(auto w=0u; w<wordCount; ++w)
+    {
+        auto bits = pMask[w];   // 書き込み前に読み込んでおく.
+        auto base = w * kBitsPerWord;
+        while(bits != 0)
+        {
+            pIndices[result++] = base + FindFirstBit(bits);
+            bits &= bits - 1;
+        }
+    }
+
+    return result;
+}
+
+} // namespace asdx
@@ -8,10 +8,50 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <new>
+#include <cassert>
 #include <fnd/asdxFrameHeap.h>
 #include <fnd/asdxLogger.h>
 
 
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kThreadCacheCount = 8;    // スレッド毎にキャッシュするヒープ数(2のべき乗).
+
+///////////////////////////////////////////////////////////////////////////////
+// ThreadCache structure
+///////////////////////////////////////////////////////////////////////////////
+struct ThreadCache
+{
+    uint64_t    Epoch   = 0;        //!< 割り当て時の世代番号(0は無効).
+    uint8_t*    pCurr   = nullptr;  //!< ページ内の現在位置.
+    uint8_t*    pEnd    = nullptr;  //!< ページ終端.
+};
+
+//-----------------------------------------------------------------------------
+// Global Variables.
+//-----------------------------------------------------------------------------
+std::atomic<uint64_t>   g_Epoch(0);                                 // 全ヒープ共通の世代番号.
+thread_local ThreadCache g_ThreadCache[kThreadCacheCount] = {};     // スレッド毎のページキャッシュ.
+
+//-----------------------------------------------------------------------------
+//      アライメントを揃えます.
+//-----------------------------------------------------------------------------
+inline uintptr_t AlignUp(uintptr_t value, size_t alignment)
+{ return (value + alignment - 1) & ~uintptr_t(alignment - 1); }
+
+//-----------------------------------------------------------------------------
+//      新しい世代番号を発行します.
+//-----------------------------------------------------------------------------
+inline uint64_t NewEpoch()
+{ return g_Epoch.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+} // namespace
+
+
+
 namespace asdx {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -22,9 +62,14 @@ namespace asdx {
 //      コンストラクタです.
 //-----------------------------------------------------------------------------
 FrameHeap::FrameHeap()
-: m_Size    (0)
-, m_pBuffer (nullptr)
-, m_Offset  (0)
+: m_Size            (0)
+, m_PageSize        (DEFAULT_PAGE_SIZE)
+, m_FrameCount      (0)
+, m_FrameIndex      (0)
+, m_pFrames         (nullptr)
+, m_Epoch           (0)
+, m_HighWaterMark   (0)
+, m_FailedCount     (0)
 { /* DO_NOTHING */ }
 
 //-----------------------------------------------------------------------------
@@ -36,19 +81,43 @@ FrameHeap::~FrameHeap()
 //-----------------------------------------------------------------------------
 //      初期化処理を行います.
 //-----------------------------------------------------------------------------
-bool FrameHeap::Init(size_t size)
+bool FrameHeap::Init(size_t size, uint32_t frameCount, size_t pageSize)
 {
     Term();
 
-    m_pBuffer = new(std::nothrow) uint8_t[size];
-    if (m_pBuffer == nullptr)
+    if (size == 0 || frameCount == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    m_pFrames = new(std::nothrow) Frame[frameCount];
+    if (m_pFrames == nullptr)
     {
         ELOG("Error : Out of memory.");
         return false;
     }
 
-    m_Size   = size;
-    m_Offset = 0;
+    for(auto i=0u; i<frameCount; ++i)
+    {
+        m_pFrames[i].Offset.store(0);
+        m_pFrames[i].pBuffer = new(std::nothrow) uint8_t[size];
+        if (m_pFrames[i].pBuffer == nullptr)
+        {
+            ELOG("Error : Out of memory.");
+            m_FrameCount = i;
+            Term();
+            return false;
+        }
+    }
+
+    m_Size       = size;
+    m_PageSize   = (pageSize > 0) ? pageSize : DEFAULT_PAGE_SIZE;
+    m_FrameCount = frameCount;
+    m_FrameIndex = 0;
+    m_Epoch        .store(NewEpoch());
+    m_HighWaterMark.store(0);
+    m_FailedCount  .store(0);
 
     return true;
 }
@@ -58,32 +127,89 @@ bool FrameHeap::Init(size_t size)
 //-----------------------------------------------------------------------------
 void FrameHeap::Term()
 {
-    if (m_pBuffer != nullptr)
+    if (m_pFrames != nullptr)
     {
-        delete[] m_pBuffer;
-        m_pBuffer = nullptr;
+        for(auto i=0u; i<m_FrameCount; ++i)
+        {
+            if (m_pFrames[i].pBuffer != nullptr)
+            {
+                delete[] m_pFrames[i].pBuffer;
+                m_pFrames[i].pBuffer = nullptr;
+            }
+        }
+
+        delete[] m_pFrames;
+        m_pFrames = nullptr;
     }
 
-    m_Size   = 0;
-    m_Offset = 0;
+    m_Size       = 0;
+    m_FrameCount = 0;
+    m_FrameIndex = 0;
+    m_Epoch.store(0);
 }
 
 //-----------------------------------------------------------------------------
-//      バッファ先頭にオフセットをリセットします.
+//      次のフレームに切り替え，そのフレームのバッファをリセットします.
 //-----------------------------------------------------------------------------
 void FrameHeap::Reset()
-{ m_Offset = 0; }
+{
+    if (m_pFrames == nullptr)
+    { return; }
+
+    m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
+    m_pFrames[m_FrameIndex].Offset.store(0, std::memory_order_relaxed);
+
+    // 世代番号を進めて，各スレッドが持っているページを無効化する.
+    m_Epoch.store(NewEpoch(), std::memory_order_release);
+}
 
 //-----------------------------------------------------------------------------
 //      メモリ確保を行います.
 //-----------------------------------------------------------------------------
-void* FrameHeap::Alloc(size_t size)
+void* FrameHeap::Alloc(size_t size, size_t alignment)
 {
-    if (GetRestSize() < size)
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    auto epoch = m_Epoch.load(std::memory_order_acquire);
+    if (epoch == 0)
     { return nullptr; }
 
-    auto ptr = m_pBuffer + m_Offset;
-    m_Offset += size;
+    // スレッドのページから切り出す.
+    auto& cache = g_ThreadCache[(uintptr_t(this) >> 6) & (kThreadCacheCount - 1)];
+    if (cache.Epoch == epoch)
+    {
+        auto ptr = reinterpret_cast<uint8_t*>(AlignUp(uintptr_t(cache.pCurr), alignment));
+        if (ptr + size <= cache.pEnd)
+        {
+            cache.pCurr = ptr + size;
+            return ptr;
+        }
+
+        // 使い切れなかったページの末尾は，返却できれば次の確保に回す.
+        if (ReturnToFrame(cache.pCurr, cache.pEnd))
+        { cache.Epoch = 0; }
+    }
+
+    // 大きなサイズはページを経由せずに直接切り出す.
+    uint8_t* page = nullptr;
+    if (size + alignment <= m_PageSize / 2)
+    { page = AllocFromFrame(m_PageSize, DEFAULT_ALIGNMENT); }
+
+    // ページを確保できない場合は必要分だけ切り出す.
+    if (page == nullptr)
+    {
+        auto ptr = AllocFromFrame(size, alignment);
+        if (ptr == nullptr)
+        { m_FailedCount.fetch_add(1, std::memory_order_relaxed); }
+
+        return ptr;
+    }
+
+    auto ptr = reinterpret_cast<uint8_t*>(AlignUp(uintptr_t(page), alignment));
+    cache.Epoch = epoch;
+    cache.pCurr = ptr + size;
+    cache.pEnd  = page + m_PageSize;
+
     return ptr;
 }
 
@@ -97,6 +223,75 @@ size_t FrameHeap::GetSize() const
 //      利用可能なメモリサイズを取得します.
 //-----------------------------------------------------------------------------
 size_t FrameHeap::GetRestSize() const
-{ return m_Size - m_Offset; }
+{ return m_Size - GetUsedSize(); }
+
+//-----------------------------------------------------------------------------
+//      使用済みメモリサイズを取得します.
+//-----------------------------------------------------------------------------
+size_t FrameHeap::GetUsedSize() const
+{
+    if (m_pFrames == nullptr)
+    { return 0; }
+
+    return m_pFrames[m_FrameIndex].Offset.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------
+//      最大使用メモリサイズを取得します.
+//-----------------------------------------------------------------------------
+size_t FrameHeap::GetHighWaterMark() const
+{ return m_HighWaterMark.load(std::memory_order_relaxed); }
+
+//-----------------------------------------------------------------------------
+//      最大使用メモリサイズをリセットします.
+//-----------------------------------------------------------------------------
+void FrameHeap::ResetHighWaterMark()
+{ m_HighWaterMark.store(GetUsedSize(), std::memory_order_relaxed); }
+
+//-----------------------------------------------------------------------------
+//      確保に失敗した回数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t FrameHeap::GetFailedCount() const
+{ return m_FailedCount.load(std::memory_order_relaxed); }
+
+//-----------------------------------------------------------------------------
+//      現在のフレームから直接切り出します.
+//-----------------------------------------------------------------------------
+uint8_t* FrameHeap::AllocFromFrame(size_t size, size_t alignment)
+{
+    auto& frame = m_pFrames[m_FrameIndex];
+    auto  base  = uintptr_t(frame.pBuffer);
+
+    auto offset = frame.Offset.load(std::memory_order_relaxed);
+    size_t head, tail;
+    do
+    {
+        head = AlignUp(base + offset, alignment) - base;
+        tail = head + size;
+        if (tail > m_Size)
+        { return nullptr; }
+    }
+    while(!frame.Offset.compare_exchange_weak(offset, tail, std::memory_order_relaxed));
+
+    // 最大使用量を更新.
+    auto peak = m_HighWaterMark.load(std::memory_order_relaxed);
+    while(peak < tail && !m_HighWaterMark.compare_exchange_weak(peak, tail, std::memory_order_relaxed))
+    { /* DO_NOTHING */ }
+
+    return frame.pBuffer + head;
+}
+
+//-----------------------------------------------------------------------------
+//      ページの末尾が現在のフレームの先頭位置であれば，未使用分を返却します.
+//-----------------------------------------------------------------------------
+bool FrameHeap::ReturnToFrame(uint8_t* pCurr, uint8_t* pEnd)
+{
+    auto& frame = m_pFrames[m_FrameIndex];
+    auto  tail  = size_t(pEnd  - frame.pBuffer);
+    auto  curr  = size_t(pCurr - frame.pBuffer);
+
+    // 後ろから別のページや領域が切り出されていれば，先頭位置が一致しないので失敗する.
+    return frame.Offset.compare_exchange_strong(tail, curr, std::memory_order_relaxed);
+}
 
-} // namespace asdx
\ No newline at end of file
+} // namespace asdx
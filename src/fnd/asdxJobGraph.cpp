@@ -0,0 +1,314 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxJobGraph.cpp
+// Desc : Job Graph.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <new>
+#include <cstring>
+#include <cassert>
+#include <fnd/asdxJobGraph.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// Job class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+Job::Job()
+: m_PendingDeps(0)
+, m_PendingWork(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+Job::~Job()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      ジョブを実行します.
+//-----------------------------------------------------------------------------
+void Job::Run()
+{
+    if (m_Function != nullptr)
+    { m_Function(m_pGraph, this); }
+
+    // 自身の分を完了.
+    Finish();
+}
+
+//-----------------------------------------------------------------------------
+//      タグを取得します.
+//-----------------------------------------------------------------------------
+const char* Job::GetTag() const
+{ return m_Tag; }
+
+//-----------------------------------------------------------------------------
+//      親ジョブを取得します.
+//-----------------------------------------------------------------------------
+Job* Job::GetParent() const
+{ return m_pParent; }
+
+//-----------------------------------------------------------------------------
+//      自身または子ジョブの完了を通知します.
+//-----------------------------------------------------------------------------
+void Job::Finish()
+{
+    // 子ジョブが残っている場合は最後の子ジョブが完了処理を行う.
+    if (m_PendingWork.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    { return; }
+
+    // 後続ジョブの依存を解決.
+    for(auto& successor : m_Successors)
+    {
+        if (successor->m_PendingDeps.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        { m_pGraph->Submit(successor); }
+    }
+
+    // 親ジョブに完了を通知.
+    if (m_pParent != nullptr)
+    { m_pParent->Finish(); }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// JobGraph class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+JobGraph::JobGraph()
+: m_JobCount(0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+JobGraph::~JobGraph()
+{ Term(); }
+
+//-----------------------------------------------------------------------------
+//      初期化処理を行います.
+//-----------------------------------------------------------------------------
+bool JobGraph::Init(IThreadPool* pThreadPool, uint32_t maxJobCount)
+{
+    if (pThreadPool == nullptr || maxJobCount == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    Term();
+
+    m_pJobs = new(std::nothrow) Job[maxJobCount];
+    if (m_pJobs == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    m_pThreadPool   = pThreadPool;
+    m_MaxJobCount   = maxJobCount;
+    m_StaticCount   = 0;
+    m_JobCount.store(0);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      終了処理を行います.
+//-----------------------------------------------------------------------------
+void JobGraph::Term()
+{
+    if (m_pThreadPool != nullptr)
+    { Wait(); }
+
+    if (m_pJobs != nullptr)
+    {
+        delete[] m_pJobs;
+        m_pJobs = nullptr;
+    }
+
+    m_pThreadPool   = nullptr;
+    m_MaxJobCount   = 0;
+    m_StaticCount   = 0;
+    m_JobCount.store(0);
+}
+
+//-----------------------------------------------------------------------------
+//      ジョブを追加します.
+//-----------------------------------------------------------------------------
+Job* JobGraph::AddJob(const char* tag, JobFunction function)
+{
+    assert(m_Counter.IsCompleted());
+
+    // 前回生成された子ジョブが静的ジョブとして残らないよう破棄しておく.
+    TrimSpawnedJobs();
+
+    auto job = Alloc(tag, function);
+    if (job == nullptr)
+    { return nullptr; }
+
+    m_StaticCount = m_JobCount.load();
+    return job;
+}
+
+//-----------------------------------------------------------------------------
+//      依存関係を追加します.
+//-----------------------------------------------------------------------------
+void JobGraph::AddDependency(Job* before, Job* after)
+{
+    assert(before != nullptr && after != nullptr && before != after);
+    assert(m_Counter.IsCompleted());
+    if (before == nullptr || after == nullptr || before == after)
+    { return; }
+
+    before->m_Successors.push_back(after);
+    after->m_DependencyCount++;
+}
+
+//-----------------------------------------------------------------------------
+//      子ジョブを生成し，実行を開始します.
+//-----------------------------------------------------------------------------
+Job* JobGraph::Spawn(Job* parent, const char* tag, JobFunction function)
+{
+    assert(parent != nullptr);
+    auto job = Alloc(tag, function);
+    if (job == nullptr)
+    { return nullptr; }
+
+    job->m_pParent = parent;
+    job->m_PendingWork.store(1, std::memory_order_relaxed);
+
+    // 親は子の完了を待つ.
+    parent->m_PendingWork.fetch_add(1, std::memory_order_acq_rel);
+
+    Submit(job);
+    return job;
+}
+
+//-----------------------------------------------------------------------------
+//      先行ジョブを持たないジョブから実行を開始します.
+//-----------------------------------------------------------------------------
+void JobGraph::Execute()
+{
+    assert(m_Counter.IsCompleted());
+
+    // 前回生成された子ジョブを破棄.
+    TrimSpawnedJobs();
+
+    // 待ち数を初期化してから実行を開始する.
+    for(auto i=0u; i<m_StaticCount; ++i)
+    {
+        auto& job = m_pJobs[i];
+        job.m_PendingDeps.store(job.m_DependencyCount, std::memory_order_relaxed);
+        job.m_PendingWork.store(1, std::memory_order_relaxed);
+    }
+
+    for(auto i=0u; i<m_StaticCount; ++i)
+    {
+        if (m_pJobs[i].m_DependencyCount == 0)
+        { Submit(&m_pJobs[i]); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      すべてのジョブの完了を待機します.
+//-----------------------------------------------------------------------------
+void JobGraph::Wait()
+{
+    if (m_pThreadPool == nullptr)
+    { return; }
+
+    m_pThreadPool->Wait(&m_Counter);
+}
+
+//-----------------------------------------------------------------------------
+//      すべてのジョブと依存関係を削除します.
+//-----------------------------------------------------------------------------
+void JobGraph::Reset()
+{
+    Wait();
+
+    auto count = m_JobCount.load();
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& job = m_pJobs[i];
+        job.m_pParent           = nullptr;
+        job.m_Function          = nullptr;
+        job.m_DependencyCount   = 0;
+        job.m_Successors.clear();
+    }
+
+    m_StaticCount = 0;
+    m_JobCount.store(0);
+}
+
+//-----------------------------------------------------------------------------
+//      ジョブ数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t JobGraph::GetJobCount() const
+{ return m_JobCount.load(); }
+
+//-----------------------------------------------------------------------------
+//      ジョブプールから確保します.
+//-----------------------------------------------------------------------------
+Job* JobGraph::Alloc(const char* tag, JobFunction function)
+{
+    auto index = m_JobCount.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= m_MaxJobCount)
+    {
+        m_JobCount.fetch_sub(1, std::memory_order_acq_rel);
+        ELOG("Error : Job Pool Overflow. MaxJobCount = %u", m_MaxJobCount);
+        return nullptr;
+    }
+
+    auto job = &m_pJobs[index];
+    job->m_pGraph           = this;
+    job->m_pParent          = nullptr;
+    job->m_Function         = function;
+    job->m_DependencyCount  = 0;
+    job->m_Successors.clear();
+
+    if (tag != nullptr)
+    {
+        strncpy(job->m_Tag, tag, sizeof(job->m_Tag) - 1);
+        job->m_Tag[sizeof(job->m_Tag) - 1] = '\0';
+    }
+    else
+    { job->m_Tag[0] = '\0'; }
+
+    return job;
+}
+
+//-----------------------------------------------------------------------------
+//      前回の実行で生成された子ジョブを破棄します.
+//-----------------------------------------------------------------------------
+void JobGraph::TrimSpawnedJobs()
+{
+    auto count = m_JobCount.load();
+    for(auto i=m_StaticCount; i<count; ++i)
+    {
+        m_pJobs[i].m_pParent  = nullptr;
+        m_pJobs[i].m_Function = nullptr;
+    }
+    m_JobCount.store(m_StaticCount);
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドプールにジョブを積みます.
+//-----------------------------------------------------------------------------
+void JobGraph::Submit(Job* job)
+{ m_pThreadPool->Push(job, &m_Counter); }
+
+} // namespace asdx
@@ -0,0 +1,160 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMappedFile.cpp
+// Desc : Memory Mapped File.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <Windows.h>
+#include <fnd/asdxMappedFile.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxMisc.h>
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// MappedFile class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+MappedFile::MappedFile()
+: m_hFile   (nullptr)
+, m_hMapping(nullptr)
+, m_pData   (nullptr)
+, m_Size    (0)
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{ Close(); }
+
+//-----------------------------------------------------------------------------
+//      ファイルを読み取り専用でメモリにマップします.
+//-----------------------------------------------------------------------------
+bool MappedFile::OpenA(const char* path)
+{
+    if (path == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto pathW = ToStringW(path);
+    return OpenW(pathW.c_str());
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを読み取り専用でメモリにマップします.
+//-----------------------------------------------------------------------------
+bool MappedFile::OpenW(const wchar_t* path)
+{
+    Close();
+
+    if (path == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto hFile = CreateFileW(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        ELOGW("Error : File Open Failed. path = %s", path);
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(hFile, &size))
+    {
+        ELOGW("Error : GetFileSizeEx() Failed. path = %s", path);
+        CloseHandle(hFile);
+        return false;
+    }
+
+    m_hFile = hFile;
+    m_Size  = size_t(size.QuadPart);
+
+    // サイズ 0 のファイルはマップできないので，開いた状態だけにしておく.
+    if (m_Size == 0)
+    { return true; }
+
+    auto hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (hMapping == nullptr)
+    {
+        ELOGW("Error : CreateFileMappingW() Failed. path = %s", path);
+        Close();
+        return false;
+    }
+    m_hMapping = hMapping;
+
+    auto ptr = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr)
+    {
+        ELOGW("Error : MapViewOfFile() Failed. path = %s", path);
+        Close();
+        return false;
+    }
+    m_pData = static_cast<uint8_t*>(ptr);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      マップを解除し，ファイルを閉じます.
+//-----------------------------------------------------------------------------
+void MappedFile::Close()
+{
+    if (m_pData != nullptr)
+    {
+        UnmapViewOfFile(m_pData);
+        m_pData = nullptr;
+    }
+
+    if (m_hMapping != nullptr)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != nullptr)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = nullptr;
+    }
+
+    m_Size = 0;
+}
+
+//-----------------------------------------------------------------------------
+//      マップされたデータの先頭を取得します.
+//-----------------------------------------------------------------------------
+const uint8_t* MappedFile::GetData() const
+{ return m_pData; }
+
+//-----------------------------------------------------------------------------
+//      ファイルサイズを取得します.
+//-----------------------------------------------------------------------------
+size_t MappedFile::GetSize() const
+{ return m_Size; }
+
+//-----------------------------------------------------------------------------
+//      ファイルが開かれているかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool MappedFile::IsOpen() const
+{ return m_hFile != nullptr; }
+
+} // namespace asdx
@@ -0,0 +1,302 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMath.cpp
+// Desc : Math Module.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <fnd/asdxMath.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define ASDX_HALF_SSE2      (1)
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define ASDX_TARGET_F16C
+    #else
+        #define ASDX_TARGET_F16C    __attribute__((target("f16c")))
+    #endif
+#endif
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const float kHalfMax = 65504.0f;     // half型で表現できる最大値.
+
+//-----------------------------------------------------------------------------
+//      ビット列を float 型として解釈します.
+//-----------------------------------------------------------------------------
+inline float AsFloat(uint32_t value)
+{
+    float result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      float 型をビット列として解釈します.
+//-----------------------------------------------------------------------------
+inline uint32_t AsUint(float value)
+{
+    uint32_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      float型からhalf型に変換します.
+//-----------------------------------------------------------------------------
+inline asdx::half FloatToHalf(float value)
+{
+    auto bits = AsUint(value);
+    auto sign = (bits >> 16) & 0x8000u;
+    auto abs  = bits & 0x7fffffffu;
+
+    // NaN.
+    if (abs > 0x7f800000u)
+    { return asdx::half(sign | 0x7e00u); }
+
+    // 範囲外は最大値に飽和.
+    if (abs >= AsUint(kHalfMax))
+    { return asdx::half(sign | 0x7bffu); }
+
+    // 非正規化数になる場合は加算による丸めを利用する.
+    if (abs < (113u << 23))
+    {
+        auto f = AsFloat(abs) + AsFloat(126u << 23);
+        return asdx::half(sign | (AsUint(f) - (126u << 23)));
+    }
+
+    // 指数部のバイアスを付け替えて最近接偶数丸め.
+    auto odd = (abs >> 13) & 1u;
+    return asdx::half(sign | ((abs + 0xfffu + odd - (112u << 23)) >> 13));
+}
+
+//-----------------------------------------------------------------------------
+//      half型からfloat型に変換します.
+//-----------------------------------------------------------------------------
+inline float HalfToFloat(asdx::half value)
+{
+    auto sign     = uint32_t(value & 0x8000u) << 16;
+    auto exponent = uint32_t(value >> 10) & 0x1fu;
+    auto mantissa = uint32_t(value & 0x3ffu);
+
+    // ゼロ または 非正規化数.
+    if (exponent == 0)
+    {
+        auto f = float(mantissa) * AsFloat(103u << 23);  // 2^-24
+        return AsFloat(sign | AsUint(f));
+    }
+
+    // 無限大 または NaN.
+    if (exponent == 0x1f)
+    { return AsFloat(sign | 0x7f800000u | (mantissa << 13)); }
+
+    return AsFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+#if defined(ASDX_HALF_SSE2)
+//-----------------------------------------------------------------------------
+//      NaN を保持したまま ±65504 に飽和させます.
+//-----------------------------------------------------------------------------
+inline __m128 SaturateHalf(__m128 value)
+{
+    // minps/maxps は NaN の場合に第2引数を返す.
+    value = _mm_min_ps(_mm_set1_ps( kHalfMax), value);
+    value = _mm_max_ps(_mm_set1_ps(-kHalfMax), value);
+    return value;
+}
+
+//-----------------------------------------------------------------------------
+//      float型4要素をhalf型に変換します(SSE2).
+//-----------------------------------------------------------------------------
+inline __m128i FloatToHalfSSE2(__m128 value)
+{
+    // F. Giesen, "float->half variants" を元に飽和処理を加えたもの.
+    value = SaturateHalf(value);
+
+    auto justSign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u))));
+    auto absf     = _mm_xor_ps(value, justSign);
+    auto absi     = _mm_castps_si128(absf);
+    auto isNaN    = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+    auto isSub    = _mm_cmpgt_epi32(_mm_set1_epi32(113 << 23), absi);
+
+    // 非正規化数.
+    auto magic    = _mm_set1_epi32(126 << 23);
+    auto subnorm  = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(magic))), magic);
+
+    // 正規化数.
+    auto odd      = _mm_srai_epi32(_mm_slli_epi32(absi, 31 - 13), 31);
+    auto normal   = _mm_add_epi32(absi, _mm_set1_epi32(0xfff - (112 << 23)));
+    normal = _mm_srli_epi32(_mm_sub_epi32(normal, odd), 13);
+
+    auto result = _mm_or_si128(_mm_and_si128(isSub, subnorm), _mm_andnot_si128(isSub, normal));
+    result = _mm_or_si128(_mm_and_si128(isNaN, _mm_set1_epi32(0x7e00)), _mm_andnot_si128(isNaN, result));
+
+    // 符号は上位ビットも埋めておき，パック時に飽和しないようにする.
+    return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(justSign), 16));
+}
+
+//-----------------------------------------------------------------------------
+//      half型4要素をfloat型に変換します(SSE2).
+//-----------------------------------------------------------------------------
+inline __m128 HalfToFloatSSE2(__m128i value)
+{
+    // F. Giesen, "half_to_float_SSE2".
+    auto expmant  = _mm_and_si128(value, _mm_set1_epi32(0x7fff));
+    auto justSign = _mm_xor_si128(value, expmant);
+    auto scaled   = _mm_mul_ps(
+        _mm_castsi128_ps(_mm_slli_epi32(expmant, 13)),
+        _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+    auto isInfNaN = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff));
+    auto special  = _mm_or_si128(_mm_slli_epi32(justSign, 16), _mm_and_si128(isInfNaN, _mm_set1_epi32(255 << 23)));
+    return _mm_or_ps(scaled, _mm_castsi128_ps(special));
+}
+
+//-----------------------------------------------------------------------------
+//      float型配列をhalf型配列に変換します(SSE2).
+//-----------------------------------------------------------------------------
+size_t ConvertF32ToF16SSE2(const float* pSrc, asdx::half* pDst, size_t count)
+{
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto lo = FloatToHalfSSE2(_mm_loadu_ps(pSrc + i + 0));
+        auto hi = FloatToHalfSSE2(_mm_loadu_ps(pSrc + i + 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_packs_epi32(lo, hi));
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+//      half型配列をfloat型配列に変換します(SSE2).
+//-----------------------------------------------------------------------------
+size_t ConvertF16ToF32SSE2(const asdx::half* pSrc, float* pDst, size_t count)
+{
+    auto zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_ps(pDst + i + 0, HalfToFloatSSE2(_mm_unpacklo_epi16(h, zero)));
+        _mm_storeu_ps(pDst + i + 4, HalfToFloatSSE2(_mm_unpackhi_epi16(h, zero)));
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+//      float型配列をhalf型配列に変換します(F16C).
+//-----------------------------------------------------------------------------
+ASDX_TARGET_F16C
+size_t ConvertF32ToF16F16C(const float* pSrc, asdx::half* pDst, size_t count)
+{
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto lo = _mm_cvtps_ph(SaturateHalf(_mm_loadu_ps(pSrc + i + 0)), _MM_FROUND_TO_NEAREST_INT);
+        auto hi = _mm_cvtps_ph(SaturateHalf(_mm_loadu_ps(pSrc + i + 4)), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_unpacklo_epi64(lo, hi));
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+//      half型配列をfloat型配列に変換します(F16C).
+//-----------------------------------------------------------------------------
+ASDX_TARGET_F16C
+size_t ConvertF16ToF32F16C(const asdx::half* pSrc, float* pDst, size_t count)
+{
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8)
+    {
+        auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_ps(pDst + i + 0, _mm_cvtph_ps(h));
+        _mm_storeu_ps(pDst + i + 4, _mm_cvtph_ps(_mm_unpackhi_epi64(h, h)));
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+//      F16C命令が使用可能かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSupportedF16C()
+{
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+
+    // OSXSAVE, AVX, F16C.
+    const int mask = (1 << 27) | (1 << 28) | (1 << 29);
+    if ((info[2] & mask) != mask)
+    { return false; }
+
+    // OS が YMM レジスタを保存するかどうか.
+    return (_xgetbv(0) & 0x6) == 0x6;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      F16C命令が使用可能かどうかを取得します.
+//-----------------------------------------------------------------------------
+bool UseF16C()
+{
+    static const bool s_Supported = IsSupportedF16C();
+    return s_Supported;
+}
+#endif//ASDX_HALF_SSE2
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      float型の配列をhalf型の配列に一括変換します.
+//-----------------------------------------------------------------------------
+void ConvertF32ToF16( const float* pSrc, half* pDst, size_t count )
+{
+    assert( count == 0 || ( pSrc != nullptr && pDst != nullptr ) );
+    size_t i = 0;
+
+#if defined(ASDX_HALF_SSE2)
+    i = UseF16C()
+        ? ConvertF32ToF16F16C( pSrc, pDst, count )
+        : ConvertF32ToF16SSE2( pSrc, pDst, count );
+#endif
+
+    // 端数.
+    for( ; i<count; ++i )
+    { pDst[i] = FloatToHalf( pSrc[i] ); }
+}
+
+//-----------------------------------------------------------------------------
+//      half型の配列をfloat型の配列に一括変換します.
+//-----------------------------------------------------------------------------
+void ConvertF16ToF32( const half* pSrc, float* pDst, size_t count )
+{
+    assert( count == 0 || ( pSrc != nullptr && pDst != nullptr ) );
+    size_t i = 0;
+
+#if defined(ASDX_HALF_SSE2)
+    i = UseF16C()
+        ? ConvertF16ToF32F16C( pSrc, pDst, count )
+        : ConvertF16ToF32SSE2( pSrc, pDst, count );
+#endif
+
+    // 端数.
+    for( ; i<count; ++i )
+    { pDst[i] = HalfToFloat( pSrc[i] ); }
+}
+
+} // namespace asdx
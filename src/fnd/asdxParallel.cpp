@@ -0,0 +1,99 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxParallel.cpp
+// Desc : Data Parallel Algorithms.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <thread>
+#include <fnd/asdxParallel.h>
+#include <fnd/asdxLogger.h>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// SharedThreadPool class
+///////////////////////////////////////////////////////////////////////////////
+class SharedThreadPool
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    SharedThreadPool()
+    {
+        // 呼び出しスレッドも処理に参加するので1つ減らす.
+        auto count = std::thread::hardware_concurrency();
+        count = (count > 1) ? count - 1 : 1;
+        if (count > UINT8_MAX)
+        { count = UINT8_MAX; }
+
+        if (!asdx::CreateThreadPool(uint8_t(count), &m_pThreadPool))
+        {
+            ELOGA("Error : CreateThreadPool() Failed.");
+            m_pThreadPool = nullptr;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      デストラクタです.
+    //-------------------------------------------------------------------------
+    ~SharedThreadPool()
+    {
+        if (m_pThreadPool != nullptr)
+        {
+            m_pThreadPool->Release();
+            m_pThreadPool = nullptr;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      スレッドプールを取得します.
+    //-------------------------------------------------------------------------
+    asdx::IThreadPool* Get() const
+    { return m_pThreadPool; }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    asdx::IThreadPool*  m_pThreadPool = nullptr;
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      並列アルゴリズム用の共有スレッドプールを取得します.
+//-----------------------------------------------------------------------------
+IThreadPool* GetSharedThreadPool()
+{
+    static SharedThreadPool s_Instance;
+    return s_Instance.Get();
+}
+
+} // namespace asdx
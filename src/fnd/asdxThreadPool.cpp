@@ -7,13 +7,140 @@
 //-----------------------------------------------------------------------------
 // Includes
 //-----------------------------------------------------------------------------
-#include <functional>
+#include <new>
 #include <vector>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <cassert>
 #include <fnd/asdxThreadPool.h>
+#include <fnd/asdxSpinLock.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static constexpr int64_t    kDequeCapacity  = 4096;                 // ワーカー毎のデック容量(2のべき乗).
+static constexpr int64_t    kDequeMask      = kDequeCapacity - 1;   // インデックスマスク.
+static constexpr uint32_t   kSpinCount      = 64;                   // スリープするまでのスピン回数.
+
+
+///////////////////////////////////////////////////////////////////////////////
+// WorkStealingDeque class
+///////////////////////////////////////////////////////////////////////////////
+class WorkStealingDeque
+{
+    //=========================================================================
+    // list of friend classes and methods.
+    //=========================================================================
+    /* NOTHING */
+
+public:
+    //=========================================================================
+    // public variables.
+    //=========================================================================
+    /* NOTHING */
+
+    //=========================================================================
+    // public methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      コンストラクタです.
+    //-------------------------------------------------------------------------
+    WorkStealingDeque()
+    : m_Top     (0)
+    , m_Bottom  (0)
+    {
+        for(auto i=0; i<kDequeCapacity; ++i)
+        { m_Items[i].store(nullptr, std::memory_order_relaxed); }
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      末尾に追加します(所有スレッドのみ).
+    //!
+    //! @retval true    追加に成功.
+    //! @retval false   容量不足.
+    //-------------------------------------------------------------------------
+    bool Push(asdx::IRunnable* item)
+    {
+        auto b = m_Bottom.load(std::memory_order_relaxed);
+        auto t = m_Top   .load(std::memory_order_acquire);
+        if (b - t >= kDequeCapacity)
+        { return false; }
+
+        m_Items[b & kDequeMask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_Bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      末尾から取り出します(所有スレッドのみ).
+    //-------------------------------------------------------------------------
+    asdx::IRunnable* Pop()
+    {
+        auto b = m_Bottom.load(std::memory_order_relaxed) - 1;
+        m_Bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto t = m_Top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // 空だった.
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto item = m_Items[b & kDequeMask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // 最後の1つは盗みと競合するので CAS で確定させる.
+            if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            { item = nullptr; }
+
+            m_Bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      先頭から盗みます(任意のスレッド).
+    //-------------------------------------------------------------------------
+    asdx::IRunnable* Steal()
+    {
+        auto t = m_Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto b = m_Bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        { return nullptr; }
+
+        auto item = m_Items[t & kDequeMask].load(std::memory_order_relaxed);
+        if (!m_Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        { return nullptr; }
+
+        return item;
+    }
+
+private:
+    //=========================================================================
+    // private variables.
+    //=========================================================================
+    alignas(64) std::atomic<int64_t>    m_Top;
+    alignas(64) std::atomic<int64_t>    m_Bottom;
+    std::atomic<asdx::IRunnable*>       m_Items[kDequeCapacity];
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+    /* NOTHING */
+};
+
+} // namespace
 
 
 namespace asdx {
@@ -43,9 +170,16 @@ public:
     //-------------------------------------------------------------------------
     ThreadPool(uint8_t threadCount)
     : m_RequestTerminate(false)
+    , m_QueuedCount     (0)
+    , m_SleepCount      (0)
     {
+        // 起動前に全デックを確保しておく(ワーカーから相互に参照するため).
+        m_Deques.resize(threadCount);
+        for(auto i=0u; i<threadCount; ++i)
+        { m_Deques[i] = new WorkStealingDeque(); }
+
         for(auto i=0u; i<threadCount; ++i)
-        { m_Threads.emplace_back(std::thread(m_Worker)); }
+        { m_Threads.emplace_back(std::thread(&ThreadPool::Worker, this, i)); }
     }
 
     //-------------------------------------------------------------------------
@@ -53,17 +187,25 @@ public:
     //-------------------------------------------------------------------------
     ~ThreadPool()
     {
+        // 残っているジョブを完了させる.
+        Wait();
+
         // ブロック.
         {
-            std::unique_lock<std::mutex> locker(m_Mutex);
-            m_RequestTerminate = true;
+            std::unique_lock<std::mutex> locker(m_SleepMutex);
+            m_RequestTerminate.store(true);
         }
 
-        m_Condtion.notify_all();
+        m_SleepCondition.notify_all();
 
         auto count = m_Threads.size();
-        for(auto i=0; i<count; ++i)
+        for(auto i=0u; i<count; ++i)
         { m_Threads.at(i).join(); }
+
+        for(auto& deque : m_Deques)
+        { delete deque; }
+
+        m_Deques.clear();
     }
 
     //-------------------------------------------------------------------------
@@ -76,71 +218,203 @@ public:
     //! @brief      ジョブを追加します.
     //-------------------------------------------------------------------------
     void Push(IRunnable* runnable) override
+    { Push(runnable, nullptr); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブを追加します.
+    //-------------------------------------------------------------------------
+    void Push(IRunnable* runnable, JobCounter* counter) override
     {
         assert(runnable != nullptr);
         if (runnable == nullptr)
         { return; }
 
-        // ブロック.
+        runnable->m_pCounter = counter;
+
+        m_Counter.Add();
+        if (counter != nullptr)
+        { counter->Add(); }
+
+        m_QueuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+        // ワーカースレッドからの追加は自分のデックへ. それ以外は投入キューへ.
+        if (s_pOwner != this || !m_Deques[s_WorkerIndex]->Push(runnable))
         {
-            std::unique_lock<std::mutex> locker(m_Mutex);
-            m_Queue.Push(runnable);
+            ScopedLock locker(&m_InjectLock);
+            m_InjectQueue.Push(runnable);
         }
 
-        m_Condtion.notify_all();
+        // 寝ているワーカーがいれば起こす.
+        if (m_SleepCount.load(std::memory_order_seq_cst) > 0)
+        {
+            { std::unique_lock<std::mutex> locker(m_SleepMutex); }
+            m_SleepCondition.notify_one();
+        }
     }
 
     //-------------------------------------------------------------------------
-    //! @brief      ジョブの完了を待機します.
+    //! @brief      すべてのジョブの完了を待機します.
     //-------------------------------------------------------------------------
     void Wait() override
+    { Wait(&m_Counter); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      カウンターに紐づくジョブの完了を待機します.
+    //-------------------------------------------------------------------------
+    void Wait(JobCounter* counter) override
     {
-        std::unique_lock<std::mutex> locker(m_Mutex);
-        if (m_Queue.IsEmpty())
+        if (counter == nullptr)
         { return; }
 
-        m_Condtion.wait(locker);
+        // 待っている間も手伝う.
+        while(!counter->IsCompleted())
+        {
+            auto runnable = Fetch();
+            if (runnable != nullptr)
+            { Execute(runnable); }
+            else
+            { std::this_thread::yield(); }
+        }
     }
 
+    //-------------------------------------------------------------------------
+    //! @brief      ワーカースレッド数を取得します.
+    //-------------------------------------------------------------------------
+    uint32_t GetThreadCount() const override
+    { return uint32_t(m_Threads.size()); }
+
 private:
     //=========================================================================
     // private variables.
     //=========================================================================
-    bool                        m_RequestTerminate = false;
-    asdx::Queue<IRunnable>      m_Queue;
-    std::mutex                  m_Mutex;
-    std::condition_variable     m_Condtion;
-    std::vector<std::thread>    m_Threads;
+    static thread_local ThreadPool*     s_pOwner;
+    static thread_local uint32_t        s_WorkerIndex;
+
+    std::atomic<bool>                   m_RequestTerminate;
+    std::atomic<uint32_t>               m_QueuedCount;      //!< 取り出し待ちのジョブ数.
+    std::atomic<uint32_t>               m_SleepCount;       //!< スリープ中のワーカー数.
+    JobCounter                          m_Counter;          //!< 全ジョブのカウンター.
+    std::vector<WorkStealingDeque*>     m_Deques;
+    SpinLock                            m_InjectLock;
+    asdx::Queue<IRunnable>              m_InjectQueue;
+    std::mutex                          m_SleepMutex;
+    std::condition_variable             m_SleepCondition;
+    std::vector<std::thread>            m_Threads;
+
+    //=========================================================================
+    // private methods.
+    //=========================================================================
+
+    //-------------------------------------------------------------------------
+    //! @brief      実行可能なジョブを取り出します.
+    //-------------------------------------------------------------------------
+    IRunnable* Fetch()
+    {
+        if (m_QueuedCount.load(std::memory_order_acquire) == 0)
+        { return nullptr; }
+
+        IRunnable* runnable = nullptr;
+        auto count = uint32_t(m_Deques.size());
+        auto start = 0u;
+
+        // 自分のデックから取り出す.
+        if (s_pOwner == this)
+        {
+            runnable = m_Deques[s_WorkerIndex]->Pop();
+            start = s_WorkerIndex + 1;
+        }
+
+        // 投入キューから取り出す.
+        if (runnable == nullptr)
+        {
+            ScopedLock locker(&m_InjectLock);
+            runnable = m_InjectQueue.Pop();
+        }
+
+        // 他のワーカーから盗む.
+        for(auto i=0u; i<count && runnable == nullptr; ++i)
+        {
+            auto victim = (start + i) % count;
+            if (s_pOwner == this && victim == s_WorkerIndex)
+            { continue; }
+
+            runnable = m_Deques[victim]->Steal();
+        }
+
+        if (runnable != nullptr)
+        { m_QueuedCount.fetch_sub(1, std::memory_order_acq_rel); }
+
+        return runnable;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ジョブを実行し，完了を通知します.
+    //-------------------------------------------------------------------------
+    void Execute(IRunnable* runnable)
+    {
+        // Run() 内で破棄される可能性があるので先に取り出しておく.
+        auto counter = runnable->m_pCounter;
+        runnable->m_pCounter = nullptr;
+
+        runnable->Run();
+
+        if (counter != nullptr)
+        { counter->Done(); }
 
-    std::function<void()> m_Worker = [this]()
+        m_Counter.Done();
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      ワーカースレッドのメイン処理です.
+    //-------------------------------------------------------------------------
+    void Worker(uint32_t index)
     {
+        s_pOwner      = this;
+        s_WorkerIndex = index;
+
+        auto spin = 0u;
         while(true)
         {
-            IRunnable* runnable = nullptr;
+            auto runnable = Fetch();
+            if (runnable != nullptr)
             {
-                std::unique_lock<std::mutex> locker(m_Mutex);
-                while(m_Queue.IsEmpty())
-                {
-                    if (m_RequestTerminate)
-                    { return; }
+                Execute(runnable);
+                spin = 0;
+                continue;
+            }
 
-                    m_Condtion.wait(locker);
+            if (spin < kSpinCount)
+            {
+                spin++;
+                std::this_thread::yield();
+                continue;
+            }
+
+            // ジョブが来るまでスリープ.
+            std::unique_lock<std::mutex> locker(m_SleepMutex);
+            m_SleepCount.fetch_add(1, std::memory_order_seq_cst);
+            while(m_QueuedCount.load(std::memory_order_seq_cst) == 0)
+            {
+                if (m_RequestTerminate.load())
+                {
+                    m_SleepCount.fetch_sub(1, std::memory_order_seq_cst);
+                    return;
                 }
 
-                runnable = m_Queue.Pop();
-                assert(runnable != nullptr);
+                m_SleepCondition.wait(locker);
             }
-
-            runnable->Run();
+            m_SleepCount.fetch_sub(1, std::memory_order_seq_cst);
+            spin = 0;
         }
-    };
-
-    //=========================================================================
-    // private methods.
-    //=========================================================================
-    /* NOTHING */
+    }
 };
 
+//-----------------------------------------------------------------------------
+// Static Variables.
+//-----------------------------------------------------------------------------
+thread_local ThreadPool*    ThreadPool::s_pOwner      = nullptr;
+thread_local uint32_t       ThreadPool::s_WorkerIndex = 0;
+
 //-----------------------------------------------------------------------------
 //      スレッドプールを生成します.
 //-----------------------------------------------------------------------------
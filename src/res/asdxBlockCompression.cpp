@@ -0,0 +1,2708 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxBlockCompression.cpp
+// Desc : Block Compression Encoder.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <res/asdxBlockCompression.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxParallel.h>
+#include <fnd/asdxMath.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define ASDX_BC_SSE2    (1)
+#endif
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kPowerIterationCount  = 8;        // 主軸を求める冪乗法の反復回数.
+static const uint32_t kAlphaThreshold       = 128;      // BC1 でこれ未満のアルファは透明とみなす.
+static const int      kAlphaSearchRadius    = 3;        // BC4 の端点探索範囲.
+static const uint32_t kOpaqueMask           = 0xFFFF;   // 全テクセルが不透明な場合のマスク.
+
+///////////////////////////////////////////////////////////////////////////////
+// SOURCE_LAYOUT enum
+///////////////////////////////////////////////////////////////////////////////
+enum SOURCE_LAYOUT
+{
+    SOURCE_LAYOUT_RGBA8,    // R8G8B8A8.
+    SOURCE_LAYOUT_RG8,      // R8G8 -> (r, g, 0, 255).
+    SOURCE_LAYOUT_R8,       // R8   -> (r, r, r, 255).
+    SOURCE_LAYOUT_A8,       // A8   -> (0, 0, 0, a).
+    SOURCE_LAYOUT_RGBA16F,  // R16G16B16A16_FLOAT.
+    SOURCE_LAYOUT_RGBA32F,  // R32G32B32A32_FLOAT.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ColorBlock structure
+///////////////////////////////////////////////////////////////////////////////
+struct ColorBlock
+{
+    float       R[16];      // 赤成分.
+    float       G[16];      // 緑成分.
+    float       B[16];      // 青成分.
+    uint32_t    Mask;       // 不透明なテクセルのビットマスク.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ColorCandidate structure
+///////////////////////////////////////////////////////////////////////////////
+struct ColorCandidate
+{
+    uint16_t    C0;         // 端点0(RGB565).
+    uint16_t    C1;         // 端点1(RGB565).
+    uint32_t    Indices;    // 2bit インデックス.
+    float       Error;      // 二乗誤差.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// AlphaCandidate structure
+///////////////////////////////////////////////////////////////////////////////
+struct AlphaCandidate
+{
+    uint8_t     A0;         // 端点0.
+    uint8_t     A1;         // 端点1.
+    uint64_t    Indices;    // 3bit インデックス.
+    uint32_t    Error;      // 二乗誤差.
+};
+
+//-----------------------------------------------------------------------------
+//      値を指定範囲に収めます.
+//-----------------------------------------------------------------------------
+inline float Saturate255(float value)
+{ return std::min(std::max(value, 0.0f), 255.0f); }
+
+//-----------------------------------------------------------------------------
+//      RGB を RGB565 に量子化します.
+//-----------------------------------------------------------------------------
+inline uint16_t QuantizeRGB565(const float* color)
+{
+    auto r = int(Saturate255(color[0]) * (31.0f / 255.0f) + 0.5f);
+    auto g = int(Saturate255(color[1]) * (63.0f / 255.0f) + 0.5f);
+    auto b = int(Saturate255(color[2]) * (31.0f / 255.0f) + 0.5f);
+    return uint16_t((r << 11) | (g << 5) | b);
+}
+
+//-----------------------------------------------------------------------------
+//      RGB565 を 8bit RGB に展開します.
+//-----------------------------------------------------------------------------
+inline void ExpandRGB565(uint16_t value, int* color)
+{
+    auto r = (value >> 11) & 0x1f;
+    auto g = (value >> 5)  & 0x3f;
+    auto b = value & 0x1f;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+//-----------------------------------------------------------------------------
+//      カラーパレットを構築します.
+//-----------------------------------------------------------------------------
+uint32_t BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColor, float palette[4][3])
+{
+    int e0[3], e1[3];
+    ExpandRGB565(c0, e0);
+    ExpandRGB565(c1, e1);
+
+    // c0 > c1 でない場合は3色モードとして解釈される.
+    auto count = (fourColor && c0 > c1) ? 4u : 3u;
+
+    for(auto i=0; i<3; ++i)
+    {
+        palette[0][i] = float(e0[i]);
+        palette[1][i] = float(e1[i]);
+        if (count == 4)
+        {
+            palette[2][i] = float((2 * e0[i] + e1[i]) / 3);
+            palette[3][i] = float((e0[i] + 2 * e1[i]) / 3);
+        }
+        else
+        {
+            palette[2][i] = float((e0[i] + e1[i]) / 2);
+            palette[3][i] = 0.0f;
+        }
+    }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      最も近いパレットのインデックスを選択します.
+//-----------------------------------------------------------------------------
+uint32_t SelectColorIndices
+(
+    const ColorBlock&   block,
+    const float         palette[4][3],
+    uint32_t            paletteCount,
+    float&              error
+)
+{
+    int     index[16];
+    float   dist [16];
+
+#if ASDX_BC_SSE2
+    for(auto k=0; k<16; k+=4)
+    {
+        auto r = _mm_loadu_ps(block.R + k);
+        auto g = _mm_loadu_ps(block.G + k);
+        auto b = _mm_loadu_ps(block.B + k);
+
+        auto best = _mm_set1_ps(FLT_MAX);
+        auto idx  = _mm_setzero_si128();
+
+        for(auto p=0u; p<paletteCount; ++p)
+        {
+            auto dr = _mm_sub_ps(r, _mm_set1_ps(palette[p][0]));
+            auto dg = _mm_sub_ps(g, _mm_set1_ps(palette[p][1]));
+            auto db = _mm_sub_ps(b, _mm_set1_ps(palette[p][2]));
+            auto d  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+
+            auto lt = _mm_castps_si128(_mm_cmplt_ps(d, best));
+            best = _mm_min_ps(d, best);
+            idx  = _mm_or_si128(_mm_andnot_si128(lt, idx), _mm_and_si128(lt, _mm_set1_epi32(int(p))));
+        }
+
+        _mm_storeu_ps(dist + k, best);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(index + k), idx);
+    }
+#else
+    for(auto k=0; k<16; ++k)
+    {
+        auto best = FLT_MAX;
+        auto idx  = 0;
+
+        for(auto p=0u; p<paletteCount; ++p)
+        {
+            auto dr = block.R[k] - palette[p][0];
+            auto dg = block.G[k] - palette[p][1];
+            auto db = block.B[k] - palette[p][2];
+            auto d  = dr * dr + dg * dg + db * db;
+            if (d < best)
+            {
+                best = d;
+                idx  = int(p);
+            }
+        }
+
+        dist [k] = best;
+        index[k] = idx;
+    }
+#endif
+
+    uint32_t result = 0;
+    error = 0.0f;
+
+    for(auto k=0; k<16; ++k)
+    {
+        // 透明なテクセルは3色モードのインデックス3を使う.
+        if ((block.Mask & (1u << k)) == 0)
+        {
+            result |= 3u << (2 * k);
+            continue;
+        }
+
+        result |= uint32_t(index[k]) << (2 * k);
+        error  += dist[k];
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      端点を評価します.
+//-----------------------------------------------------------------------------
+void EvaluateColor(const ColorBlock& block, uint16_t c0, uint16_t c1, bool fourColor, ColorCandidate& result)
+{
+    // 4色モードは c0 > c1，3色モードは c0 <= c1 になるように並べる.
+    if ((fourColor && c0 < c1) || (!fourColor && c0 > c1))
+    { std::swap(c0, c1); }
+
+    float palette[4][3];
+    auto count = BuildColorPalette(c0, c1, fourColor, palette);
+
+    result.C0      = c0;
+    result.C1      = c1;
+    result.Indices = SelectColorIndices(block, palette, count, result.Error);
+}
+
+//-----------------------------------------------------------------------------
+//      バウンディングボックスから端点を求めます.
+//-----------------------------------------------------------------------------
+void ComputeBoxEndpoints(const ColorBlock& block, float* c0, float* c1)
+{
+    float mini[3] = { 255.0f, 255.0f, 255.0f };
+    float maxi[3] = { 0.0f, 0.0f, 0.0f };
+
+    for(auto i=0; i<16; ++i)
+    {
+        if ((block.Mask & (1u << i)) == 0)
+        { continue; }
+
+        mini[0] = std::min(mini[0], block.R[i]); maxi[0] = std::max(maxi[0], block.R[i]);
+        mini[1] = std::min(mini[1], block.G[i]); maxi[1] = std::max(maxi[1], block.G[i]);
+        mini[2] = std::min(mini[2], block.B[i]); maxi[2] = std::max(maxi[2], block.B[i]);
+    }
+
+    // 補間色が端に寄り過ぎないよう内側に寄せる.
+    for(auto i=0; i<3; ++i)
+    {
+        auto inset = (maxi[i] - mini[i]) / 16.0f;
+        c0[i] = maxi[i] - inset;
+        c1[i] = mini[i] + inset;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      主成分分析により端点を求めます.
+//-----------------------------------------------------------------------------
+void ComputePrincipalEndpoints(const ColorBlock& block, float* c0, float* c1)
+{
+    float mean[3] = {};
+    auto  count   = 0;
+
+    for(auto i=0; i<16; ++i)
+    {
+        if ((block.Mask & (1u << i)) == 0)
+        { continue; }
+
+        mean[0] += block.R[i];
+        mean[1] += block.G[i];
+        mean[2] += block.B[i];
+        count++;
+    }
+
+    for(auto i=0; i<3; ++i)
+    { mean[i] /= float(count); }
+
+    // 共分散行列 (rr, rg, rb, gg, gb, bb).
+    float cov[6] = {};
+    for(auto i=0; i<16; ++i)
+    {
+        if ((block.Mask & (1u << i)) == 0)
+        { continue; }
+
+        auto r = block.R[i] - mean[0];
+        auto g = block.G[i] - mean[1];
+        auto b = block.B[i] - mean[2];
+
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // 対角成分が最大の行を初期ベクトルとする.
+    float axis[3];
+    if (cov[0] >= cov[3] && cov[0] >= cov[5])
+    { axis[0] = cov[0]; axis[1] = cov[1]; axis[2] = cov[2]; }
+    else if (cov[3] >= cov[5])
+    { axis[0] = cov[1]; axis[1] = cov[3]; axis[2] = cov[4]; }
+    else
+    { axis[0] = cov[2]; axis[1] = cov[4]; axis[2] = cov[5]; }
+
+    for(auto it=0u; it<kPowerIterationCount; ++it)
+    {
+        float v[3];
+        v[0] = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        v[1] = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        v[2] = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+
+        auto scale = std::max(std::max(fabsf(v[0]), fabsf(v[1])), fabsf(v[2]));
+        if (scale < FLT_EPSILON)
+        { break; }
+
+        axis[0] = v[0] / scale;
+        axis[1] = v[1] / scale;
+        axis[2] = v[2] / scale;
+    }
+
+    auto lenSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    if (lenSq < FLT_EPSILON)
+    {
+        // 単色ブロック.
+        for(auto i=0; i<3; ++i)
+        { c0[i] = c1[i] = mean[i]; }
+        return;
+    }
+
+    auto invLen = 1.0f / sqrtf(lenSq);
+    axis[0] *= invLen;
+    axis[1] *= invLen;
+    axis[2] *= invLen;
+
+    auto minT =  FLT_MAX;
+    auto maxT = -FLT_MAX;
+    for(auto i=0; i<16; ++i)
+    {
+        if ((block.Mask & (1u << i)) == 0)
+        { continue; }
+
+        auto t = (block.R[i] - mean[0]) * axis[0]
+               + (block.G[i] - mean[1]) * axis[1]
+               + (block.B[i] - mean[2]) * axis[2];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    for(auto i=0; i<3; ++i)
+    {
+        c0[i] = Saturate255(mean[i] + axis[i] * maxT);
+        c1[i] = Saturate255(mean[i] + axis[i] * minT);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      インデックスを固定して最小二乗法で端点を再推定します.
+//-----------------------------------------------------------------------------
+bool RefineColorEndpoints(const ColorBlock& block, const ColorCandidate& candidate, bool fourColor, float* c0, float* c1)
+{
+    static const float kWeight4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+    static const float kWeight3[4] = { 1.0f, 0.0f, 0.5f, 0.0f };
+
+    // 並べ替えにより 3色モードで評価されている場合はそちらの重みを使う.
+    auto isFour   = fourColor && (candidate.C0 > candidate.C1);
+    auto pWeight  = (isFour) ? kWeight4 : kWeight3;
+
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    float ax[3] = {}, bx[3] = {};
+
+    for(auto i=0; i<16; ++i)
+    {
+        if ((block.Mask & (1u << i)) == 0)
+        { continue; }
+
+        auto idx = (candidate.Indices >> (2 * i)) & 0x3;
+        if (!isFour && idx == 3)
+        { continue; }
+
+        auto a = pWeight[idx];
+        auto b = 1.0f - a;
+
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+
+        ax[0] += a * block.R[i]; ax[1] += a * block.G[i]; ax[2] += a * block.B[i];
+        bx[0] += b * block.R[i]; bx[1] += b * block.G[i]; bx[2] += b * block.B[i];
+    }
+
+    auto det = aa * bb - ab * ab;
+    if (fabsf(det) < FLT_EPSILON)
+    { return false; }
+
+    auto invDet = 1.0f / det;
+    for(auto i=0; i<3; ++i)
+    {
+        c0[i] = Saturate255((ax[i] * bb - bx[i] * ab) * invDet);
+        c1[i] = Saturate255((bx[i] * aa - ax[i] * ab) * invDet);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      端点を初期値から反復して改善します.
+//-----------------------------------------------------------------------------
+void OptimizeColor
+(
+    const ColorBlock&   block,
+    const float*        c0,
+    const float*        c1,
+    bool                fourColor,
+    uint32_t            refineCount,
+    ColorCandidate&     best
+)
+{
+    EvaluateColor(block, QuantizeRGB565(c0), QuantizeRGB565(c1), fourColor, best);
+
+    for(auto it=0u; it<refineCount; ++it)
+    {
+        float e0[3], e1[3];
+        if (!RefineColorEndpoints(block, best, fourColor, e0, e1))
+        { break; }
+
+        ColorCandidate candidate;
+        EvaluateColor(block, QuantizeRGB565(e0), QuantizeRGB565(e1), fourColor, candidate);
+        if (candidate.Error >= best.Error)
+        { break; }
+
+        best = candidate;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      量子化後の端点を1段階ずつ動かして改善します.
+//-----------------------------------------------------------------------------
+void PerturbColor(const ColorBlock& block, bool fourColor, ColorCandidate& best)
+{
+    static const int kShift[3] = { 11, 5, 0 };
+    static const int kLimit[3] = { 31, 63, 31 };
+
+    auto improved = true;
+    for(auto pass=0; pass<2 && improved; ++pass)
+    {
+        improved = false;
+
+        for(auto e=0; e<2; ++e)
+        {
+            for(auto ch=0; ch<3; ++ch)
+            {
+                for(auto delta=-1; delta<=1; delta+=2)
+                {
+                    uint16_t ep[2] = { best.C0, best.C1 };
+
+                    auto value = ((ep[e] >> kShift[ch]) & kLimit[ch]) + delta;
+                    if (value < 0 || value > kLimit[ch])
+                    { continue; }
+
+                    ep[e] = uint16_t((ep[e] & ~(kLimit[ch] << kShift[ch])) | (value << kShift[ch]));
+
+                    ColorCandidate candidate;
+                    EvaluateColor(block, ep[0], ep[1], fourColor, candidate);
+                    if (candidate.Error < best.Error)
+                    {
+                        best     = candidate;
+                        improved = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      カラーブロックを圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeColorBlock(const ColorBlock& block, asdx::BC_QUALITY quality, bool allowThreeColor, uint8_t* pBlock)
+{
+    ColorCandidate best = {};
+
+    if (block.Mask == 0)
+    {
+        // 全て透明.
+        best.Indices = 0xFFFFFFFF;
+    }
+    else
+    {
+        // 透明なテクセルがあれば3色モードにする必要がある.
+        auto fourColor = (block.Mask == kOpaqueMask);
+
+        float c0[3], c1[3];
+        if (quality == asdx::BC_QUALITY_FAST)
+        {
+            ComputeBoxEndpoints(block, c0, c1);
+            OptimizeColor(block, c0, c1, fourColor, 0, best);
+        }
+        else
+        {
+            auto refineCount = (quality == asdx::BC_QUALITY_HIGH) ? 4u : 1u;
+            ComputePrincipalEndpoints(block, c0, c1);
+            OptimizeColor(block, c0, c1, fourColor, refineCount, best);
+
+            // 主軸に乗らない分布ではバウンディングボックスの方が良い場合がある.
+            float b0[3], b1[3];
+            ComputeBoxEndpoints(block, b0, b1);
+
+            ColorCandidate box;
+            EvaluateColor(block, QuantizeRGB565(b0), QuantizeRGB565(b1), fourColor, box);
+            if (box.Error < best.Error)
+            { best = box; }
+
+            if (quality == asdx::BC_QUALITY_HIGH)
+            {
+                PerturbColor(block, fourColor, best);
+
+                // 不透明でも3色モードの方が良い場合がある.
+                if (allowThreeColor && fourColor)
+                {
+                    ColorCandidate three;
+                    OptimizeColor(block, c0, c1, false, refineCount, three);
+                    PerturbColor(block, false, three);
+                    if (three.Error < best.Error)
+                    { best = three; }
+                }
+            }
+        }
+    }
+
+    pBlock[0] = uint8_t(best.C0 & 0xff);
+    pBlock[1] = uint8_t(best.C0 >> 8);
+    pBlock[2] = uint8_t(best.C1 & 0xff);
+    pBlock[3] = uint8_t(best.C1 >> 8);
+    pBlock[4] = uint8_t(best.Indices & 0xff);
+    pBlock[5] = uint8_t((best.Indices >> 8) & 0xff);
+    pBlock[6] = uint8_t((best.Indices >> 16) & 0xff);
+    pBlock[7] = uint8_t(best.Indices >> 24);
+}
+
+//-----------------------------------------------------------------------------
+//      単一チャンネルのパレットを構築します.
+//-----------------------------------------------------------------------------
+void BuildAlphaPalette(int a0, int a1, uint8_t palette[8])
+{
+    palette[0] = uint8_t(a0);
+    palette[1] = uint8_t(a1);
+
+    if (a0 > a1)
+    {
+        // 8値モード.
+        for(auto i=1; i<7; ++i)
+        { palette[i + 1] = uint8_t(((7 - i) * a0 + i * a1 + 3) / 7); }
+    }
+    else
+    {
+        // 6値モード.
+        for(auto i=1; i<5; ++i)
+        { palette[i + 1] = uint8_t(((5 - i) * a0 + i * a1 + 2) / 5); }
+
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      単一チャンネルの端点を評価します.
+//-----------------------------------------------------------------------------
+void EvaluateAlpha(const uint8_t* values, int a0, int a1, AlphaCandidate& result)
+{
+    uint8_t palette[8];
+    BuildAlphaPalette(a0, a1, palette);
+
+    uint8_t index[16];
+
+#if ASDX_BC_SSE2
+    auto x    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+    auto best = _mm_set1_epi8(char(0xff));
+    auto idx  = _mm_setzero_si128();
+    auto ones = _mm_set1_epi8(char(0xff));
+
+    for(auto p=0; p<8; ++p)
+    {
+        auto v  = _mm_set1_epi8(char(palette[p]));
+        auto d  = _mm_or_si128(_mm_subs_epu8(x, v), _mm_subs_epu8(v, x));
+        auto mn = _mm_min_epu8(d, best);
+        auto lt = _mm_andnot_si128(_mm_cmpeq_epi8(mn, best), ones);
+        best = mn;
+        idx  = _mm_or_si128(_mm_andnot_si128(lt, idx), _mm_and_si128(lt, _mm_set1_epi8(char(p))));
+    }
+
+    // 二乗誤差の総和.
+    auto zero = _mm_setzero_si128();
+    auto lo   = _mm_unpacklo_epi8(best, zero);
+    auto hi   = _mm_unpackhi_epi8(best, zero);
+    auto sum  = _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    result.Error = uint32_t(_mm_cvtsi128_si32(sum));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(index), idx);
+#else
+    result.Error = 0;
+    for(auto k=0; k<16; ++k)
+    {
+        auto best = 256;
+        for(auto p=0; p<8; ++p)
+        {
+            auto d = std::abs(int(values[k]) - int(palette[p]));
+            if (d < best)
+            {
+                best     = d;
+                index[k] = uint8_t(p);
+            }
+        }
+        result.Error += uint32_t(best * best);
+    }
+#endif
+
+    uint64_t bits = 0;
+    for(auto k=0; k<16; ++k)
+    { bits |= uint64_t(index[k]) << (3 * k); }
+
+    result.A0      = uint8_t(a0);
+    result.A1      = uint8_t(a1);
+    result.Indices = bits;
+}
+
+//-----------------------------------------------------------------------------
+//      単一チャンネルのブロックを圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeAlphaBlock(const uint8_t* values, asdx::BC_QUALITY quality, uint8_t* pBlock)
+{
+    int mini  = 255, maxi  = 0;     // 全体の範囲.
+    int mini6 = 255, maxi6 = 0;     // 0, 255 を除いた範囲.
+
+    for(auto i=0; i<16; ++i)
+    {
+        int v = values[i];
+        mini = std::min(mini, v);
+        maxi = std::max(maxi, v);
+
+        if (v != 0 && v != 255)
+        {
+            mini6 = std::min(mini6, v);
+            maxi6 = std::max(maxi6, v);
+        }
+    }
+
+    AlphaCandidate best;
+    if (mini == maxi)
+    {
+        // 単色ブロックは6値モードの端点0で表現できる.
+        EvaluateAlpha(values, mini, mini, best);
+    }
+    else
+    {
+        EvaluateAlpha(values, maxi, mini, best);
+
+        if (quality != asdx::BC_QUALITY_FAST && best.Error > 0)
+        {
+            // 0, 255 以外が無ければ端点は何でもよい.
+            if (mini6 > maxi6)
+            { mini6 = maxi6 = 0; }
+
+            AlphaCandidate candidate;
+            EvaluateAlpha(values, mini6, maxi6, candidate);
+            if (candidate.Error < best.Error)
+            { best = candidate; }
+        }
+
+        if (quality == asdx::BC_QUALITY_HIGH && best.Error > 0)
+        {
+            // 範囲を内側に狭めて探索.
+            for(auto lo=mini; lo<=mini + kAlphaSearchRadius; ++lo)
+            {
+                for(auto hi=maxi; hi>=maxi - kAlphaSearchRadius && hi>lo; --hi)
+                {
+                    AlphaCandidate candidate;
+                    EvaluateAlpha(values, hi, lo, candidate);
+                    if (candidate.Error < best.Error)
+                    { best = candidate; }
+                }
+            }
+
+            for(auto lo=mini6; lo<=mini6 + kAlphaSearchRadius; ++lo)
+            {
+                for(auto hi=maxi6; hi>=maxi6 - kAlphaSearchRadius && hi>=lo; --hi)
+                {
+                    AlphaCandidate candidate;
+                    EvaluateAlpha(values, lo, hi, candidate);
+                    if (candidate.Error < best.Error)
+                    { best = candidate; }
+                }
+            }
+        }
+    }
+
+    pBlock[0] = best.A0;
+    pBlock[1] = best.A1;
+    for(auto i=0; i<6; ++i)
+    { pBlock[2 + i] = uint8_t((best.Indices >> (8 * i)) & 0xff); }
+}
+
+//-----------------------------------------------------------------------------
+//      RGBA8 テクセルからカラーブロックを設定します.
+//-----------------------------------------------------------------------------
+void SetupColorBlock(const uint8_t* pTexels, bool useAlpha, ColorBlock& block)
+{
+    block.Mask = 0;
+    for(auto i=0; i<16; ++i)
+    {
+        block.R[i] = float(pTexels[i * 4 + 0]);
+        block.G[i] = float(pTexels[i * 4 + 1]);
+        block.B[i] = float(pTexels[i * 4 + 2]);
+
+        if (!useAlpha || pTexels[i * 4 + 3] >= kAlphaThreshold)
+        { block.Mask |= 1u << i; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      RGBA8 テクセルから1チャンネルを取り出します.
+//-----------------------------------------------------------------------------
+void ExtractChannel(const uint8_t* pTexels, int channel, uint8_t* values)
+{
+    for(auto i=0; i<16; ++i)
+    { values[i] = pTexels[i * 4 + channel]; }
+}
+
+//-----------------------------------------------------------------------------
+// BC6H / BC7 Constant Values.
+//-----------------------------------------------------------------------------
+static const int      kMomentSize  = 16;    // モーメントの要素数(個数, 総和 x4, 積の総和 x10, 未使用).
+static const uint32_t kWeight2[4]  = { 0, 21, 43, 64 };
+static const uint32_t kWeight3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint32_t kWeight4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// 2分割パーティション(ビット i がテクセル i の属するサブセット).
+static const uint16_t kPartitionTable2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// 3分割パーティション(2ビットずつテクセルの属するサブセット).
+static const uint32_t kPartitionTable3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// 2分割の2番目のサブセットのアンカー.
+static const uint8_t kAnchorTable2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+};
+
+// 3分割の2番目のサブセットのアンカー.
+static const uint8_t kAnchorTable3a[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+};
+
+// 3分割の3番目のサブセットのアンカー.
+static const uint8_t kAnchorTable3b[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc7ModeInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc7ModeInfo
+{
+    uint32_t    SubsetCount;        // サブセット数.
+    uint32_t    PartitionBits;      // パーティション番号のビット数.
+    uint32_t    RotationBits;       // 回転のビット数.
+    uint32_t    IndexSelectionBits; // インデックス選択のビット数.
+    uint32_t    ColorBits;          // カラー端点のビット数.
+    uint32_t    AlphaBits;          // アルファ端点のビット数.
+    uint32_t    EndpointPBits;      // 端点ごとの P-bit 数.
+    uint32_t    SharedPBits;        // サブセットごとの P-bit 数.
+    uint32_t    IndexBits;          // インデックスのビット数.
+    uint32_t    Index2Bits;         // 2番目のインデックスのビット数.
+};
+
+static const Bc7ModeInfo kBc7Modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SearchBudget structure
+///////////////////////////////////////////////////////////////////////////////
+struct SearchBudget
+{
+    uint32_t    ModeMask;           // 試行するモードのビットマスク.
+    uint32_t    PartitionCount2;    // 2分割で試行するパーティション数.
+    uint32_t    PartitionCount3;    // 3分割で試行するパーティション数.
+    uint32_t    RefineCount;        // 最小二乗法による再推定の回数.
+    bool        Exhaustive;         // 回転やインデックス選択を全て試行するかどうか.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// TexelBlock structure
+///////////////////////////////////////////////////////////////////////////////
+struct TexelBlock
+{
+    int         Value[16][4];       // 誤差評価に用いる値.
+    float       Point[16][4];       // 端点推定に用いる値.
+};
+
+//-----------------------------------------------------------------------------
+//      インデックスのビット数から補間の重みを取得します.
+//-----------------------------------------------------------------------------
+inline const uint32_t* GetWeights(uint32_t indexBits)
+{
+    return (indexBits == 2) ? kWeight2
+         : (indexBits == 3) ? kWeight3 : kWeight4;
+}
+
+//-----------------------------------------------------------------------------
+//      端点を補間します.
+//-----------------------------------------------------------------------------
+inline int Interpolate(int e0, int e1, uint32_t weight)
+{ return int((uint32_t(e0) * (64 - weight) + uint32_t(e1) * weight + 32) >> 6); }
+
+//-----------------------------------------------------------------------------
+//      テクセルの属するサブセットを取得します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetSubset(uint32_t subsetCount, uint32_t partition, uint32_t texel)
+{
+    if (subsetCount == 2)
+    { return (kPartitionTable2[partition] >> texel) & 0x1; }
+
+    if (subsetCount == 3)
+    { return (kPartitionTable3[partition] >> (2 * texel)) & 0x3; }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+//      サブセットのアンカーテクセルを取得します.
+//-----------------------------------------------------------------------------
+inline uint32_t GetAnchor(uint32_t subsetCount, uint32_t partition, uint32_t subset)
+{
+    if (subset == 0)
+    { return 0; }
+
+    if (subsetCount == 2)
+    { return kAnchorTable2[partition]; }
+
+    return (subset == 1) ? kAnchorTable3a[partition] : kAnchorTable3b[partition];
+}
+
+//-----------------------------------------------------------------------------
+//      パーティションのサブセットごとのテクセル番号リストを作成します.
+//-----------------------------------------------------------------------------
+void BuildSubsetLists(uint32_t subsetCount, uint32_t partition, uint8_t lists[3][16], uint32_t counts[3])
+{
+    counts[0] = counts[1] = counts[2] = 0;
+    for(auto i=0u; i<16; ++i)
+    {
+        auto s = GetSubset(subsetCount, partition, i);
+        lists[s][counts[s]++] = uint8_t(i);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      主成分分析により端点を求めます.
+//-----------------------------------------------------------------------------
+void FitEndpoints
+(
+    const TexelBlock&   block,
+    const uint8_t*      pList,
+    uint32_t            count,
+    uint32_t            ch0,
+    uint32_t            chCount,
+    float*              e0,
+    float*              e1
+)
+{
+    float mean[4] = {};
+    for(auto i=0u; i<count; ++i)
+    {
+        for(auto c=0u; c<chCount; ++c)
+        { mean[c] += block.Point[pList[i]][ch0 + c]; }
+    }
+
+    for(auto c=0u; c<chCount; ++c)
+    { mean[c] /= float(count); }
+
+    float cov[4][4] = {};
+    for(auto i=0u; i<count; ++i)
+    {
+        float d[4];
+        for(auto c=0u; c<chCount; ++c)
+        { d[c] = block.Point[pList[i]][ch0 + c] - mean[c]; }
+
+        for(auto r=0u; r<chCount; ++r)
+        {
+            for(auto c=0u; c<chCount; ++c)
+            { cov[r][c] += d[r] * d[c]; }
+        }
+    }
+
+    // 対角成分が最大の行を初期ベクトルとする.
+    auto maxRow = 0u;
+    for(auto r=1u; r<chCount; ++r)
+    {
+        if (cov[r][r] > cov[maxRow][maxRow])
+        { maxRow = r; }
+    }
+
+    float axis[4];
+    for(auto c=0u; c<chCount; ++c)
+    { axis[c] = cov[maxRow][c]; }
+
+    for(auto it=0u; it<kPowerIterationCount; ++it)
+    {
+        float v[4] = {};
+        auto  scale = 0.0f;
+        for(auto r=0u; r<chCount; ++r)
+        {
+            for(auto c=0u; c<chCount; ++c)
+            { v[r] += cov[r][c] * axis[c]; }
+            scale = std::max(scale, fabsf(v[r]));
+        }
+
+        if (scale < FLT_EPSILON)
+        { break; }
+
+        for(auto c=0u; c<chCount; ++c)
+        { axis[c] = v[c] / scale; }
+    }
+
+    auto lenSq = 0.0f;
+    for(auto c=0u; c<chCount; ++c)
+    { lenSq += axis[c] * axis[c]; }
+
+    if (lenSq < FLT_EPSILON)
+    {
+        for(auto c=0u; c<chCount; ++c)
+        { e0[c] = e1[c] = mean[c]; }
+        return;
+    }
+
+    auto invLen = 1.0f / sqrtf(lenSq);
+    for(auto c=0u; c<chCount; ++c)
+    { axis[c] *= invLen; }
+
+    auto minT =  FLT_MAX;
+    auto maxT = -FLT_MAX;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto t = 0.0f;
+        for(auto c=0u; c<chCount; ++c)
+        { t += (block.Point[pList[i]][ch0 + c] - mean[c]) * axis[c]; }
+
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+
+    for(auto c=0u; c<chCount; ++c)
+    {
+        e0[c] = mean[c] + axis[c] * minT;
+        e1[c] = mean[c] + axis[c] * maxT;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      テクセルのモーメント(個数, 総和, 積の総和)を加算します.
+//-----------------------------------------------------------------------------
+inline void AddMoment(const float* pSrc, float* pDst)
+{
+    for(auto i=0; i<kMomentSize; ++i)
+    { pDst[i] += pSrc[i]; }
+}
+
+//-----------------------------------------------------------------------------
+//      テクセルのモーメントを設定します.
+//-----------------------------------------------------------------------------
+void SetupMoment(const float* point, float* pMoment)
+{
+    pMoment[0] = 1.0f;
+
+    auto k = 5;
+    for(auto r=0; r<4; ++r)
+    {
+        pMoment[1 + r] = point[r];
+        for(auto c=r; c<4; ++c)
+        { pMoment[k++] = point[r] * point[c]; }
+    }
+
+    pMoment[15] = 0.0f;
+}
+
+//-----------------------------------------------------------------------------
+//      モーメントから主軸を外れる量(最小二乗直線への残差)を見積もります.
+//-----------------------------------------------------------------------------
+float EstimateLineError(const float* pMoment)
+{
+    auto count = pMoment[0];
+    if (count <= 1.0f)
+    { return 0.0f; }
+
+    // 共分散行列を求める.
+    float cov[4][4];
+    auto k = 5;
+    for(auto r=0; r<4; ++r)
+    {
+        for(auto c=r; c<4; ++c)
+        {
+            cov[r][c] = cov[c][r] = pMoment[k++] - pMoment[1 + r] * pMoment[1 + c] / count;
+        }
+    }
+
+    auto trace  = cov[0][0] + cov[1][1] + cov[2][2] + cov[3][3];
+    auto maxRow = 0;
+    for(auto r=1; r<4; ++r)
+    {
+        if (cov[r][r] > cov[maxRow][maxRow])
+        { maxRow = r; }
+    }
+
+    float axis[4];
+    for(auto c=0; c<4; ++c)
+    { axis[c] = cov[maxRow][c]; }
+
+    // 最大固有値をレイリー商で近似する.
+    auto num = 0.0f;
+    auto den = 0.0f;
+    for(auto it=0; it<3; ++it)
+    {
+        float v[4];
+        for(auto r=0; r<4; ++r)
+        { v[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2] + cov[r][3] * axis[3]; }
+
+        num = axis[0] * v[0] + axis[1] * v[1] + axis[2] * v[2] + axis[3] * v[3];
+        den = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] + axis[3] * axis[3];
+        memcpy(axis, v, sizeof(axis));
+    }
+
+    if (den < FLT_EPSILON)
+    { return 0.0f; }
+
+    return std::max(trace - num / den, 0.0f);
+}
+
+//-----------------------------------------------------------------------------
+//      インデックスを固定して最小二乗法で端点を再推定します.
+//-----------------------------------------------------------------------------
+bool RefineEndpoints
+(
+    const TexelBlock&   block,
+    const uint8_t*      pList,
+    uint32_t            count,
+    uint32_t            ch0,
+    uint32_t            chCount,
+    const uint8_t*      pIndex,
+    uint32_t            indexBits,
+    float*              e0,
+    float*              e1
+)
+{
+    auto pWeight = GetWeights(indexBits);
+
+    float aa = 0.0f, bb = 0.0f, ab = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto texel = pList[i];
+        auto b = float(pWeight[pIndex[texel]]) / 64.0f;
+        auto a = 1.0f - b;
+
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+
+        for(auto c=0u; c<chCount; ++c)
+        {
+            ax[c] += a * block.Point[texel][ch0 + c];
+            bx[c] += b * block.Point[texel][ch0 + c];
+        }
+    }
+
+    auto det = aa * bb - ab * ab;
+    if (fabsf(det) < FLT_EPSILON)
+    { return false; }
+
+    auto invDet = 1.0f / det;
+    for(auto c=0u; c<chCount; ++c)
+    {
+        e0[c] = (ax[c] * bb - bx[c] * ab) * invDet;
+        e1[c] = (bx[c] * aa - ax[c] * ab) * invDet;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      パレットとの二乗誤差を求めます.
+//-----------------------------------------------------------------------------
+inline uint64_t PaletteDistance(const int* value, const int* color, uint32_t chCount)
+{
+    uint64_t d = 0;
+    for(auto c=0u; c<chCount; ++c)
+    {
+        int64_t diff = value[c] - color[c];
+        d += uint64_t(diff * diff);
+    }
+    return d;
+}
+
+//-----------------------------------------------------------------------------
+//      最も近いパレットのインデックスを選択します.
+//-----------------------------------------------------------------------------
+uint64_t SelectIndices
+(
+    const TexelBlock&   block,
+    const uint8_t*      pList,
+    uint32_t            count,
+    uint32_t            ch0,
+    uint32_t            chCount,
+    const int           palette[16][4],
+    uint32_t            paletteCount,
+    int                 anchor,
+    uint8_t*            pIndex
+)
+{
+    // パレットはほぼ直線上に並ぶので，端点を結ぶ軸への射影で候補を絞り込む.
+    int64_t axis[4];
+    int64_t lenSq = 0;
+    for(auto c=0u; c<chCount; ++c)
+    {
+        axis[c] = palette[paletteCount - 1][c] - palette[0][c];
+        lenSq  += axis[c] * axis[c];
+    }
+
+    uint64_t error = 0;
+
+    for(auto i=0u; i<count; ++i)
+    {
+        auto texel  = pList[i];
+        auto pValue = block.Value[texel] + ch0;
+
+        // アンカーは最上位ビットが 0 のインデックスしか使えない.
+        auto limit = int((int(texel) == anchor) ? paletteCount / 2 : paletteCount);
+
+        auto center = 0;
+        if (lenSq > 0)
+        {
+            int64_t dot = 0;
+            for(auto c=0u; c<chCount; ++c)
+            { dot += (pValue[c] - palette[0][c]) * axis[c]; }
+
+            auto t = double(dot) * double(paletteCount - 1) / double(lenSq);
+            center = std::min(std::max(int(t + 0.5), 0), limit - 1);
+        }
+
+        auto best    = PaletteDistance(pValue, palette[center], chCount);
+        auto bestIdx = center;
+
+        // 重みは等間隔ではないので両隣も評価する.
+        for(auto p=center-1; p<=center+1; p+=2)
+        {
+            if (p < 0 || p >= limit)
+            { continue; }
+
+            auto d = PaletteDistance(pValue, palette[p], chCount);
+            if (d < best)
+            {
+                best    = d;
+                bestIdx = p;
+            }
+        }
+
+        pIndex[texel] = uint8_t(bestIdx);
+        error += best;
+    }
+
+    return error;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BitWriter class
+///////////////////////////////////////////////////////////////////////////////
+class BitWriter
+{
+public:
+    //-------------------------------------------------------------------------
+    //      コンストラクタです.
+    //-------------------------------------------------------------------------
+    explicit BitWriter(uint8_t* pBlock)
+    : m_pBlock  (pBlock)
+    , m_Position(0)
+    { memset(m_pBlock, 0, 16); }
+
+    //-------------------------------------------------------------------------
+    //      下位ビットから順に書き込みます.
+    //-------------------------------------------------------------------------
+    void Write(uint32_t value, uint32_t bits)
+    {
+        for(auto i=0u; i<bits; ++i, ++m_Position)
+        {
+            if ((value >> i) & 0x1)
+            { m_pBlock[m_Position >> 3] |= uint8_t(1u << (m_Position & 0x7)); }
+        }
+    }
+
+private:
+    uint8_t*    m_pBlock;       // ブロックの格納先.
+    uint32_t    m_Position;     // 書き込み位置(ビット).
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc7Subset structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc7Subset
+{
+    uint32_t    Ch0;                // 先頭チャンネル.
+    uint32_t    ChCount;            // チャンネル数.
+    uint32_t    Bits;               // 端点のビット数(P-bit を除く).
+    uint32_t    PBitMode;           // 0 : なし, 1 : 端点ごと, 2 : 共有.
+    uint32_t    IndexBits;          // インデックスのビット数.
+};
+
+//-----------------------------------------------------------------------------
+//      BC7 の端点を 8bit に展開します.
+//-----------------------------------------------------------------------------
+inline int ExpandBc7(int q, uint32_t bits)
+{
+    q <<= (8 - bits);
+    return q | (q >> bits);
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 の端点の1成分を量子化します.
+//-----------------------------------------------------------------------------
+int QuantizeBc7(float value, uint32_t bits, int pbit, bool hasPBit)
+{
+    auto total = bits + (hasPBit ? 1 : 0);
+    auto maxQ  = (1 << bits) - 1;
+    auto v     = Saturate255(value);
+
+    auto q = int(v * float((1 << total) - 1) / 255.0f + 0.5f);
+    if (hasPBit)
+    { q = (q - pbit) >> 1; }
+
+    // 展開後の値で最も近いものを選ぶ.
+    auto best  = 0;
+    auto bestD = FLT_MAX;
+    for(auto c=q-1; c<=q+1; ++c)
+    {
+        if (c < 0 || c > maxQ)
+        { continue; }
+
+        auto e = (hasPBit) ? ExpandBc7((c << 1) | pbit, total) : ExpandBc7(c, total);
+        auto d = fabsf(float(e) - v);
+        if (d < bestD)
+        {
+            bestD = d;
+            best  = c;
+        }
+    }
+
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 のサブセットのパレットを構築します.
+//-----------------------------------------------------------------------------
+uint32_t BuildBc7Palette(const Bc7Subset& subset, const int q[2][4], const int pbit[2], int palette[16][4])
+{
+    int e[2][4];
+    for(auto i=0; i<2; ++i)
+    {
+        for(auto c=0u; c<subset.ChCount; ++c)
+        {
+            e[i][c] = (subset.PBitMode != 0)
+                ? ExpandBc7((q[i][c] << 1) | pbit[i], subset.Bits + 1)
+                : ExpandBc7(q[i][c], subset.Bits);
+        }
+    }
+
+    auto count   = 1u << subset.IndexBits;
+    auto pWeight = GetWeights(subset.IndexBits);
+    for(auto p=0u; p<count; ++p)
+    {
+        for(auto c=0u; c<subset.ChCount; ++c)
+        { palette[p][c] = Interpolate(e[0][c], e[1][c], pWeight[p]); }
+    }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 の端点を量子化して評価します.
+//-----------------------------------------------------------------------------
+uint64_t QuantizeBc7Subset
+(
+    const TexelBlock&   block,
+    const uint8_t*      pList,
+    uint32_t            count,
+    const Bc7Subset&    subset,
+    const float         e[2][4],
+    int                 q[2][4],
+    int                 pbit[2],
+    uint8_t*            pIndex
+)
+{
+    int palette[16][4];
+
+    if (subset.PBitMode == 0)
+    {
+        pbit[0] = pbit[1] = 0;
+        for(auto i=0; i<2; ++i)
+        {
+            for(auto c=0u; c<subset.ChCount; ++c)
+            { q[i][c] = QuantizeBc7(e[i][c], subset.Bits, 0, false); }
+        }
+    }
+    else if (subset.PBitMode == 1)
+    {
+        // 端点ごとに誤差の小さい P-bit を選ぶ.
+        for(auto i=0; i<2; ++i)
+        {
+            auto bestD = FLT_MAX;
+            for(auto p=0; p<2; ++p)
+            {
+                int   t[4];
+                float d = 0.0f;
+                for(auto c=0u; c<subset.ChCount; ++c)
+                {
+                    t[c] = QuantizeBc7(e[i][c], subset.Bits, p, true);
+                    auto diff = float(ExpandBc7((t[c] << 1) | p, subset.Bits + 1)) - Saturate255(e[i][c]);
+                    d += diff * diff;
+                }
+
+                if (d < bestD)
+                {
+                    bestD   = d;
+                    pbit[i] = p;
+                    memcpy(q[i], t, sizeof(t));
+                }
+            }
+        }
+    }
+    else
+    {
+        // 共有 P-bit は両方を試す.
+        auto    best = UINT64_MAX;
+        uint8_t index[16];
+        for(auto p=0; p<2; ++p)
+        {
+            int t[2][4];
+            int tp[2] = { p, p };
+            for(auto i=0; i<2; ++i)
+            {
+                for(auto c=0u; c<subset.ChCount; ++c)
+                { t[i][c] = QuantizeBc7(e[i][c], subset.Bits, p, true); }
+            }
+
+            auto n   = BuildBc7Palette(subset, t, tp, palette);
+            auto err = SelectIndices(block, pList, count, subset.Ch0, subset.ChCount, palette, n, -1, index);
+            if (err < best)
+            {
+                best = err;
+                memcpy(q, t, sizeof(t));
+                pbit[0] = pbit[1] = p;
+                for(auto k=0u; k<count; ++k)
+                { pIndex[pList[k]] = index[pList[k]]; }
+            }
+        }
+        return best;
+    }
+
+    auto n = BuildBc7Palette(subset, q, pbit, palette);
+    return SelectIndices(block, pList, count, subset.Ch0, subset.ChCount, palette, n, -1, pIndex);
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 のサブセットを圧縮します.
+//-----------------------------------------------------------------------------
+uint64_t EncodeBc7Subset
+(
+    const TexelBlock&   block,
+    const uint8_t*      pList,
+    uint32_t            count,
+    const Bc7Subset&    subset,
+    uint32_t            refineCount,
+    int                 q[2][4],
+    int                 pbit[2],
+    uint8_t*            pIndex
+)
+{
+    float e[2][4];
+    FitEndpoints(block, pList, count, subset.Ch0, subset.ChCount, e[0], e[1]);
+
+    auto best = QuantizeBc7Subset(block, pList, count, subset, e, q, pbit, pIndex);
+
+    for(auto it=0u; it<refineCount && best > 0; ++it)
+    {
+        if (!RefineEndpoints(block, pList, count, subset.Ch0, subset.ChCount, pIndex, subset.IndexBits, e[0], e[1]))
+        { break; }
+
+        int     tq[2][4];
+        int     tp[2];
+        uint8_t index[16];
+        auto err = QuantizeBc7Subset(block, pList, count, subset, e, tq, tp, index);
+        if (err >= best)
+        { break; }
+
+        best = err;
+        memcpy(q, tq, sizeof(tq));
+        pbit[0] = tp[0];
+        pbit[1] = tp[1];
+        for(auto k=0u; k<count; ++k)
+        { pIndex[pList[k]] = index[pList[k]]; }
+    }
+
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+//      アンカーの最上位ビットが 0 になるよう端点を入れ替えます.
+//-----------------------------------------------------------------------------
+void FixAnchor(const uint8_t* pList, uint32_t count, uint32_t anchor, uint32_t indexBits, int q[2][4], int pbit[2], uint8_t* pIndex)
+{
+    auto maxIndex = (1u << indexBits) - 1;
+    if (pIndex[anchor] <= (maxIndex >> 1))
+    { return; }
+
+    // 重みは対称なので入れ替えと反転で同じ値になる.
+    for(auto c=0; c<4; ++c)
+    { std::swap(q[0][c], q[1][c]); }
+    std::swap(pbit[0], pbit[1]);
+
+    for(auto k=0u; k<count; ++k)
+    { pIndex[pList[k]] = uint8_t(maxIndex - pIndex[pList[k]]); }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc7Block structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc7Block
+{
+    uint32_t    Mode;               // モード.
+    uint32_t    Partition;          // パーティション番号.
+    uint32_t    Rotation;           // 回転.
+    uint32_t    IndexSelection;     // インデックス選択.
+    int         Color[3][2][4];     // 量子化されたカラー端点.
+    int         Alpha[2];           // 量子化されたアルファ端点(モード4, 5).
+    int         PBit[3][2];         // P-bit.
+    uint8_t     Index [16];         // インデックス.
+    uint8_t     Index2[16];         // 2番目のインデックス(モード4, 5).
+    uint64_t    Error;              // 二乗誤差.
+};
+
+//-----------------------------------------------------------------------------
+//      パーティションを持つモードで圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBc7Partitioned(const TexelBlock& block, uint32_t mode, uint32_t partition, uint32_t refineCount, Bc7Block& result)
+{
+    auto& info     = kBc7Modes[mode];
+    auto  hasAlpha = (info.AlphaBits > 0);
+
+    Bc7Subset subset;
+    subset.Ch0       = 0;
+    subset.ChCount   = (hasAlpha) ? 4 : 3;
+    subset.Bits      = info.ColorBits;
+    subset.PBitMode  = (info.EndpointPBits > 0) ? 1 : (info.SharedPBits > 0) ? 2 : 0;
+    subset.IndexBits = info.IndexBits;
+
+    uint8_t  lists [3][16];
+    uint32_t counts[3];
+    BuildSubsetLists(info.SubsetCount, partition, lists, counts);
+
+    result.Mode           = mode;
+    result.Partition      = partition;
+    result.Rotation       = 0;
+    result.IndexSelection = 0;
+    result.Error          = 0;
+
+    for(auto s=0u; s<info.SubsetCount; ++s)
+    {
+        auto& q = result.Color[s];
+        q[0][3] = q[1][3] = 0;
+
+        result.Error += EncodeBc7Subset(block, lists[s], counts[s], subset, refineCount, q, result.PBit[s], result.Index);
+
+        FixAnchor(lists[s], counts[s], GetAnchor(info.SubsetCount, partition, s), info.IndexBits, q, result.PBit[s], result.Index);
+    }
+
+    // アルファを持たないモードは 255 として復元される.
+    if (!hasAlpha)
+    {
+        for(auto i=0; i<16; ++i)
+        {
+            int64_t d = 255 - block.Value[i][3];
+            result.Error += uint64_t(d * d);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      カラーとアルファを分離するモードで圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBc7Separate
+(
+    const TexelBlock&   source,
+    uint32_t            mode,
+    uint32_t            rotation,
+    uint32_t            indexSelection,
+    uint32_t            refineCount,
+    Bc7Block&           result
+)
+{
+    auto& info = kBc7Modes[mode];
+
+    // 回転はアルファと指定チャンネルを入れ替える.
+    auto block = source;
+    if (rotation > 0)
+    {
+        for(auto i=0; i<16; ++i)
+        {
+            std::swap(block.Value[i][rotation - 1], block.Value[i][3]);
+            std::swap(block.Point[i][rotation - 1], block.Point[i][3]);
+        }
+    }
+
+    uint8_t list[16];
+    for(auto i=0; i<16; ++i)
+    { list[i] = uint8_t(i); }
+
+    Bc7Subset color;
+    color.Ch0       = 0;
+    color.ChCount   = 3;
+    color.Bits      = info.ColorBits;
+    color.PBitMode  = 0;
+    color.IndexBits = (indexSelection) ? info.Index2Bits : info.IndexBits;
+
+    Bc7Subset alpha;
+    alpha.Ch0       = 3;
+    alpha.ChCount   = 1;
+    alpha.Bits      = info.AlphaBits;
+    alpha.PBitMode  = 0;
+    alpha.IndexBits = (indexSelection) ? info.IndexBits : info.Index2Bits;
+
+    result.Mode           = mode;
+    result.Partition      = 0;
+    result.Rotation       = rotation;
+    result.IndexSelection = indexSelection;
+
+    int pbit[2] = {};
+    result.Error = EncodeBc7Subset(block, list, 16, color, refineCount, result.Color[0], pbit, result.Index);
+    FixAnchor(list, 16, 0, color.IndexBits, result.Color[0], pbit, result.Index);
+
+    int q[2][4] = {};
+    result.Error += EncodeBc7Subset(block, list, 16, alpha, refineCount, q, pbit, result.Index2);
+    FixAnchor(list, 16, 0, alpha.IndexBits, q, pbit, result.Index2);
+
+    result.Alpha[0] = q[0][0];
+    result.Alpha[1] = q[1][0];
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 ブロックを書き出します.
+//-----------------------------------------------------------------------------
+void WriteBc7Block(const Bc7Block& block, uint8_t* pBlock)
+{
+    auto& info = kBc7Modes[block.Mode];
+
+    BitWriter writer(pBlock);
+    writer.Write(1u << block.Mode, block.Mode + 1);
+    writer.Write(block.Partition,      info.PartitionBits);
+    writer.Write(block.Rotation,       info.RotationBits);
+    writer.Write(block.IndexSelection, info.IndexSelectionBits);
+
+    for(auto c=0; c<3; ++c)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        {
+            writer.Write(uint32_t(block.Color[s][0][c]), info.ColorBits);
+            writer.Write(uint32_t(block.Color[s][1][c]), info.ColorBits);
+        }
+    }
+
+    if (info.AlphaBits > 0)
+    {
+        for(auto s=0u; s<info.SubsetCount; ++s)
+        {
+            if (info.RotationBits > 0)
+            {
+                writer.Write(uint32_t(block.Alpha[0]), info.AlphaBits);
+                writer.Write(uint32_t(block.Alpha[1]), info.AlphaBits);
+            }
+            else
+            {
+                writer.Write(uint32_t(block.Color[s][0][3]), info.AlphaBits);
+                writer.Write(uint32_t(block.Color[s][1][3]), info.AlphaBits);
+            }
+        }
+    }
+
+    for(auto s=0u; s<info.SubsetCount; ++s)
+    {
+        if (info.EndpointPBits > 0)
+        {
+            writer.Write(uint32_t(block.PBit[s][0]), 1);
+            writer.Write(uint32_t(block.PBit[s][1]), 1);
+        }
+        else if (info.SharedPBits > 0)
+        { writer.Write(uint32_t(block.PBit[s][0]), 1); }
+    }
+
+    // 2ビットのインデックスが先に格納される.
+    auto pFirst  = (block.IndexSelection) ? block.Index2 : block.Index;
+    auto pSecond = (block.IndexSelection) ? block.Index  : block.Index2;
+
+    for(auto i=0u; i<16; ++i)
+    {
+        auto isAnchor = (i == 0)
+            || (info.SubsetCount > 1 && i == GetAnchor(info.SubsetCount, block.Partition, 1))
+            || (info.SubsetCount > 2 && i == GetAnchor(info.SubsetCount, block.Partition, 2));
+        writer.Write(pFirst[i], info.IndexBits - (isAnchor ? 1 : 0));
+    }
+
+    if (info.Index2Bits > 0)
+    {
+        for(auto i=0u; i<16; ++i)
+        { writer.Write(pSecond[i], info.Index2Bits - (i == 0 ? 1 : 0)); }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 の探索範囲を取得します.
+//-----------------------------------------------------------------------------
+SearchBudget GetBc7Budget(asdx::BC_QUALITY quality)
+{
+    SearchBudget budget = {};
+    switch(quality)
+    {
+    case asdx::BC_QUALITY_FAST:
+        budget.ModeMask        = (1u << 6);
+        budget.RefineCount     = 1;
+        break;
+
+    case asdx::BC_QUALITY_NORMAL:
+        budget.ModeMask        = (1u << 1) | (1u << 3) | (1u << 5) | (1u << 6) | (1u << 7);
+        budget.PartitionCount2 = 4;
+        budget.RefineCount     = 1;
+        break;
+
+    case asdx::BC_QUALITY_HIGH:
+    default:
+        budget.ModeMask        = 0xFF;
+        budget.PartitionCount2 = 16;
+        budget.PartitionCount3 = 8;
+        budget.RefineCount     = 3;
+        budget.Exhaustive      = true;
+        break;
+    }
+    return budget;
+}
+
+//-----------------------------------------------------------------------------
+//      見積もり誤差の小さいパーティションを選びます.
+//-----------------------------------------------------------------------------
+uint32_t SelectPartitions
+(
+    const TexelBlock&   block,
+    uint32_t            subsetCount,
+    uint32_t            partitionCount,
+    uint32_t            budget,
+    uint32_t*           pResult
+)
+{
+    // 桁落ちを避けるためブロックの平均を原点とする.
+    float mean[4] = {};
+    for(auto i=0; i<16; ++i)
+    {
+        for(auto c=0; c<4; ++c)
+        { mean[c] += block.Point[i][c] * (1.0f / 16.0f); }
+    }
+
+    float moments[16][kMomentSize];
+    float total[kMomentSize] = {};
+    for(auto i=0; i<16; ++i)
+    {
+        float point[4];
+        for(auto c=0; c<4; ++c)
+        { point[c] = block.Point[i][c] - mean[c]; }
+
+        SetupMoment(point, moments[i]);
+        AddMoment(moments[i], total);
+    }
+
+    float    estimate[64];
+    uint32_t order   [64];
+
+    for(auto p=0u; p<partitionCount; ++p)
+    {
+        // サブセット0 は全体から残りを引いて求める.
+        float subset[3][kMomentSize] = {};
+        for(auto i=0u; i<16; ++i)
+        {
+            auto s = GetSubset(subsetCount, p, i);
+            if (s > 0)
+            { AddMoment(moments[i], subset[s]); }
+        }
+
+        for(auto i=0; i<kMomentSize; ++i)
+        { subset[0][i] = total[i] - subset[1][i] - subset[2][i]; }
+
+        estimate[p] = 0.0f;
+        for(auto s=0u; s<subsetCount; ++s)
+        { estimate[p] += EstimateLineError(subset[s]); }
+
+        order[p] = p;
+    }
+
+    auto count = std::min(budget, partitionCount);
+    std::partial_sort(order, order + count, order + partitionCount, [&](uint32_t a, uint32_t b)
+    { return estimate[a] < estimate[b]; });
+
+    memcpy(pResult, order, sizeof(uint32_t) * count);
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      BC7 ブロックを予算内で探索して圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBc7Block(const TexelBlock& block, const SearchBudget& budget, uint8_t* pBlock)
+{
+    auto isOpaque = true;
+    for(auto i=0; i<16; ++i)
+    { isOpaque &= (block.Value[i][3] == 255); }
+
+    Bc7Block best = {};
+    best.Error = UINT64_MAX;
+
+    Bc7Block candidate;
+
+    // パーティションの選択はサブセット数ごとに1度だけ行う.
+    uint32_t partitions    [2][64];
+    uint32_t partitionCount[2] = {};
+    bool     isSelected    [2] = {};
+
+    for(auto mode=0u; mode<8 && best.Error > 0; ++mode)
+    {
+        if ((budget.ModeMask & (1u << mode)) == 0)
+        { continue; }
+
+        auto& info = kBc7Modes[mode];
+
+        // アルファを持たないモードは不透明なブロックのみ.
+        if (info.AlphaBits == 0 && !isOpaque)
+        { continue; }
+
+        // 不透明なブロックでアルファ専用の精度を割くのは網羅探索時のみ.
+        if (info.AlphaBits > 0 && mode != 6 && isOpaque && !budget.Exhaustive)
+        { continue; }
+
+        if (info.RotationBits > 0)
+        {
+            auto rotationCount  = (budget.Exhaustive) ? 4u : 1u;
+            auto selectionCount = (budget.Exhaustive) ? (1u << info.IndexSelectionBits) : 1u;
+            for(auto r=0u; r<rotationCount; ++r)
+            {
+                for(auto sel=0u; sel<selectionCount; ++sel)
+                {
+                    EncodeBc7Separate(block, mode, r, sel, budget.RefineCount, candidate);
+                    if (candidate.Error < best.Error)
+                    { best = candidate; }
+                }
+            }
+        }
+        else if (info.SubsetCount > 1)
+        {
+            auto k = info.SubsetCount - 2;
+            if (!isSelected[k])
+            {
+                auto trial = (info.SubsetCount == 2) ? budget.PartitionCount2 : budget.PartitionCount3;
+                partitionCount[k] = SelectPartitions(block, info.SubsetCount, 64, trial, partitions[k]);
+                isSelected[k] = true;
+            }
+
+            // モード 0 は先頭 16 パーティションのみ使用できる.
+            auto maxPartition = 1u << info.PartitionBits;
+            for(auto i=0u; i<partitionCount[k]; ++i)
+            {
+                if (partitions[k][i] >= maxPartition)
+                { continue; }
+
+                EncodeBc7Partitioned(block, mode, partitions[k][i], budget.RefineCount, candidate);
+                if (candidate.Error < best.Error)
+                { best = candidate; }
+            }
+        }
+        else
+        {
+            EncodeBc7Partitioned(block, mode, 0, budget.RefineCount, candidate);
+            if (candidate.Error < best.Error)
+            { best = candidate; }
+        }
+    }
+
+    WriteBc7Block(best, pBlock);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BC6_FIELD enum
+///////////////////////////////////////////////////////////////////////////////
+enum BC6_FIELD
+{
+    BC6_FIELD_RW, BC6_FIELD_RX, BC6_FIELD_RY, BC6_FIELD_RZ,
+    BC6_FIELD_GW, BC6_FIELD_GX, BC6_FIELD_GY, BC6_FIELD_GZ,
+    BC6_FIELD_BW, BC6_FIELD_BX, BC6_FIELD_BY, BC6_FIELD_BZ,
+    BC6_FIELD_D,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc6Field structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc6Field
+{
+    uint8_t     Field;      // フィールド.
+    uint8_t     High;       // 表記上の上位ビット.
+    uint8_t     Low;        // 表記上の下位ビット(こちらから格納する).
+};
+
+// 仕様書の表記 [High:Low] の順に並べる(rw[10:11] のような逆順表記も含む).
+static const Bc6Field kBc6Layout1[] = {
+    { BC6_FIELD_GY, 4, 4 }, { BC6_FIELD_BY, 4, 4 }, { BC6_FIELD_BZ, 4, 4 },
+    { BC6_FIELD_RW, 9, 0 }, { BC6_FIELD_GW, 9, 0 }, { BC6_FIELD_BW, 9, 0 },
+    { BC6_FIELD_RX, 4, 0 }, { BC6_FIELD_GZ, 4, 4 }, { BC6_FIELD_GY, 3, 0 },
+    { BC6_FIELD_GX, 4, 0 }, { BC6_FIELD_BZ, 0, 0 }, { BC6_FIELD_GZ, 3, 0 },
+    { BC6_FIELD_BX, 4, 0 }, { BC6_FIELD_BZ, 1, 1 }, { BC6_FIELD_BY, 3, 0 },
+    { BC6_FIELD_RY, 4, 0 }, { BC6_FIELD_BZ, 2, 2 }, { BC6_FIELD_RZ, 4, 0 },
+    { BC6_FIELD_BZ, 3, 3 }, { BC6_FIELD_D,  4, 0 },
+};
+
+static const Bc6Field kBc6Layout2[] = {
+    { BC6_FIELD_GY, 5, 5 }, { BC6_FIELD_GZ, 4, 4 }, { BC6_FIELD_GZ, 5, 5 },
+    { BC6_FIELD_RW, 6, 0 }, { BC6_FIELD_BZ, 0, 0 }, { BC6_FIELD_BZ, 1, 1 },
+    { BC6_FIELD_BY, 4, 4 }, { BC6_FIELD_GW, 6, 0 }, { BC6_FIELD_BY, 5, 5 },
+    { BC6_FIELD_BZ, 2, 2 }, { BC6_FIELD_GY, 4, 4 }, { BC6_FIELD_BW, 6, 0 },
+    { BC6_FIELD_BZ, 3, 3 }, { BC6_FIELD_BZ, 5, 5 }, { BC6_FIELD_BZ, 4, 4 },
+    { BC6_FIELD_RX, 5, 0 }, { BC6_FIELD_GY, 3, 0 }, { BC6_FIELD_GX, 5, 0 },
+    { BC6_FIELD_GZ, 3, 0 }, { BC6_FIELD_BX, 5, 0 }, { BC6_FIELD_BY, 3, 0 },
+    { BC6_FIELD_RY, 5, 0 }, { BC6_FIELD_RZ, 5, 0 }, { BC6_FIELD_D,  4, 0 },
+};
+
+static const Bc6Field kBc6Layout10[] = {
+    { BC6_FIELD_RW, 5, 0 }, { BC6_FIELD_GZ, 4, 4 }, { BC6_FIELD_BZ, 0, 0 },
+    { BC6_FIELD_BZ, 1, 1 }, { BC6_FIELD_BY, 4, 4 }, { BC6_FIELD_GW, 5, 0 },
+    { BC6_FIELD_GY, 5, 5 }, { BC6_FIELD_BY, 5, 5 }, { BC6_FIELD_BZ, 2, 2 },
+    { BC6_FIELD_GY, 4, 4 }, { BC6_FIELD_BW, 5, 0 }, { BC6_FIELD_GZ, 5, 5 },
+    { BC6_FIELD_BZ, 3, 3 }, { BC6_FIELD_BZ, 5, 5 }, { BC6_FIELD_BZ, 4, 4 },
+    { BC6_FIELD_RX, 5, 0 }, { BC6_FIELD_GY, 3, 0 }, { BC6_FIELD_GX, 5, 0 },
+    { BC6_FIELD_GZ, 3, 0 }, { BC6_FIELD_BX, 5, 0 }, { BC6_FIELD_BY, 3, 0 },
+    { BC6_FIELD_RY, 5, 0 }, { BC6_FIELD_RZ, 5, 0 }, { BC6_FIELD_D,  4, 0 },
+};
+
+static const Bc6Field kBc6Layout11[] = {
+    { BC6_FIELD_RW, 9, 0 }, { BC6_FIELD_GW, 9, 0 }, { BC6_FIELD_BW, 9, 0 },
+    { BC6_FIELD_RX, 9, 0 }, { BC6_FIELD_GX, 9, 0 }, { BC6_FIELD_BX, 9, 0 },
+};
+
+static const Bc6Field kBc6Layout12[] = {
+    { BC6_FIELD_RW, 9, 0 }, { BC6_FIELD_GW, 9, 0 }, { BC6_FIELD_BW, 9, 0 },
+    { BC6_FIELD_RX, 8, 0 }, { BC6_FIELD_RW, 10, 10 },
+    { BC6_FIELD_GX, 8, 0 }, { BC6_FIELD_GW, 10, 10 },
+    { BC6_FIELD_BX, 8, 0 }, { BC6_FIELD_BW, 10, 10 },
+};
+
+static const Bc6Field kBc6Layout13[] = {
+    { BC6_FIELD_RW, 9, 0 }, { BC6_FIELD_GW, 9, 0 }, { BC6_FIELD_BW, 9, 0 },
+    { BC6_FIELD_RX, 7, 0 }, { BC6_FIELD_RW, 10, 11 },
+    { BC6_FIELD_GX, 7, 0 }, { BC6_FIELD_GW, 10, 11 },
+    { BC6_FIELD_BX, 7, 0 }, { BC6_FIELD_BW, 10, 11 },
+};
+
+static const Bc6Field kBc6Layout14[] = {
+    { BC6_FIELD_RW, 9, 0 }, { BC6_FIELD_GW, 9, 0 }, { BC6_FIELD_BW, 9, 0 },
+    { BC6_FIELD_RX, 3, 0 }, { BC6_FIELD_RW, 10, 15 },
+    { BC6_FIELD_GX, 3, 0 }, { BC6_FIELD_GW, 10, 15 },
+    { BC6_FIELD_BX, 3, 0 }, { BC6_FIELD_BW, 10, 15 },
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc6ModeInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc6ModeInfo
+{
+    uint32_t        ModeValue;      // モード値.
+    uint32_t        ModeBits;       // モード値のビット数.
+    uint32_t        RegionCount;    // 領域数.
+    uint32_t        EndpointBits;   // 基準端点のビット数.
+    uint32_t        DeltaBits[3];   // 差分のビット数(R, G, B). 差分を使わない場合は 0.
+    const Bc6Field* pLayout;        // ビット配置.
+    uint32_t        LayoutCount;    // ビット配置の要素数.
+};
+
+// 仕様書のモード 1, 2, 10, 11, 12, 13, 14 に対応.
+static const Bc6ModeInfo kBc6Modes[] = {
+    { 0x00, 2, 2, 10, {  5,  5,  5 }, kBc6Layout1,  uint32_t(sizeof(kBc6Layout1)  / sizeof(Bc6Field)) },
+    { 0x01, 2, 2,  7, {  6,  6,  6 }, kBc6Layout2,  uint32_t(sizeof(kBc6Layout2)  / sizeof(Bc6Field)) },
+    { 0x1E, 5, 2,  6, {  0,  0,  0 }, kBc6Layout10, uint32_t(sizeof(kBc6Layout10) / sizeof(Bc6Field)) },
+    { 0x03, 5, 1, 10, {  0,  0,  0 }, kBc6Layout11, uint32_t(sizeof(kBc6Layout11) / sizeof(Bc6Field)) },
+    { 0x07, 5, 1, 11, {  9,  9,  9 }, kBc6Layout12, uint32_t(sizeof(kBc6Layout12) / sizeof(Bc6Field)) },
+    { 0x0B, 5, 1, 12, {  8,  8,  8 }, kBc6Layout13, uint32_t(sizeof(kBc6Layout13) / sizeof(Bc6Field)) },
+    { 0x0F, 5, 1, 16, {  4,  4,  4 }, kBc6Layout14, uint32_t(sizeof(kBc6Layout14) / sizeof(Bc6Field)) },
+};
+
+static const uint32_t kBc6ModeCount      = uint32_t(sizeof(kBc6Modes) / sizeof(Bc6ModeInfo));
+static const uint32_t kBc6PartitionCount = 32;
+static const int      kBc6MaxHalf        = 0x7BFF;      // 符号なし half の最大有限値.
+
+///////////////////////////////////////////////////////////////////////////////
+// Bc6Block structure
+///////////////////////////////////////////////////////////////////////////////
+struct Bc6Block
+{
+    uint32_t    Mode;               // kBc6Modes の番号.
+    uint32_t    Partition;          // パーティション番号.
+    int         Endpoint[2][2][3];  // 量子化された端点 [領域][端点][チャンネル].
+    uint8_t     Index[16];          // インデックス.
+    uint64_t    Error;              // half のビット表現での二乗誤差.
+};
+
+//-----------------------------------------------------------------------------
+//      BC6H の端点を逆量子化します(符号なし).
+//-----------------------------------------------------------------------------
+inline int UnquantizeBc6(int q, uint32_t bits)
+{
+    if (bits >= 15)
+    { return q; }
+
+    if (q == 0)
+    { return 0; }
+
+    if (q == (1 << bits) - 1)
+    { return 0xFFFF; }
+
+    return ((q << 16) + 0x8000) >> bits;
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H の補間結果を half のビット表現に変換します(符号なし).
+//-----------------------------------------------------------------------------
+inline int FinishBc6(int value)
+{ return (value * 31) >> 6; }
+
+//-----------------------------------------------------------------------------
+//      BC6H の端点の1成分を量子化します(符号なし).
+//-----------------------------------------------------------------------------
+int QuantizeBc6(float value, uint32_t bits)
+{
+    auto v = std::min(std::max(value, 0.0f), 65535.0f);
+    if (bits >= 16)
+    { return int(v + 0.5f); }
+
+    auto maxQ = (1 << bits) - 1;
+    auto q    = std::min(int(v * float(1 << bits) / 65536.0f), maxQ);
+
+    auto best  = q;
+    auto bestD = FLT_MAX;
+    for(auto c=q-1; c<=q+1; ++c)
+    {
+        if (c < 0 || c > maxQ)
+        { continue; }
+
+        auto d = fabsf(float(UnquantizeBc6(c, bits)) - v);
+        if (d < bestD)
+        {
+            bestD = d;
+            best  = c;
+        }
+    }
+
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H の領域のパレットを構築します.
+//-----------------------------------------------------------------------------
+uint32_t BuildBc6Palette(const int endpoint[2][3], uint32_t bits, uint32_t indexBits, int palette[16][4])
+{
+    int u[2][3];
+    for(auto i=0; i<2; ++i)
+    {
+        for(auto c=0; c<3; ++c)
+        { u[i][c] = UnquantizeBc6(endpoint[i][c], bits); }
+    }
+
+    auto count   = 1u << indexBits;
+    auto pWeight = GetWeights(indexBits);
+    for(auto p=0u; p<count; ++p)
+    {
+        for(auto c=0; c<3; ++c)
+        { palette[p][c] = FinishBc6(Interpolate(u[0][c], u[1][c], pWeight[p])); }
+    }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+//      差分で表現できるよう端点を基準端点の近くに寄せます.
+//-----------------------------------------------------------------------------
+void ClampBc6Delta(const Bc6ModeInfo& info, int endpoint[2][2][3])
+{
+    if (info.DeltaBits[0] == 0)
+    { return; }
+
+    for(auto c=0; c<3; ++c)
+    {
+        auto base  = endpoint[0][0][c];
+        auto lower = -(1 << (info.DeltaBits[c] - 1));
+        auto upper =  (1 << (info.DeltaBits[c] - 1)) - 1;
+
+        for(auto k=1u; k<info.RegionCount * 2; ++k)
+        {
+            auto& e = endpoint[k / 2][k % 2][c];
+            e = base + std::min(std::max(e - base, lower), upper);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H のモードとパーティションで圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBc6Mode
+(
+    const TexelBlock&   block,
+    uint32_t            mode,
+    uint32_t            partition,
+    uint32_t            refineCount,
+    Bc6Block&           result
+)
+{
+    auto& info      = kBc6Modes[mode];
+    auto  indexBits = (info.RegionCount == 1) ? 4u : 3u;
+
+    uint8_t  lists [3][16];
+    uint32_t counts[3];
+    BuildSubsetLists(info.RegionCount, partition, lists, counts);
+
+    float e[2][2][4];
+    for(auto r=0u; r<info.RegionCount; ++r)
+    { FitEndpoints(block, lists[r], counts[r], 0, 3, e[r][0], e[r][1]); }
+
+    result.Mode      = mode;
+    result.Partition = partition;
+    result.Error     = UINT64_MAX;
+
+    int palette[16][4];
+
+    for(auto it=0u; it<=refineCount; ++it)
+    {
+        int     q[2][2][3] = {};
+        uint8_t index[16];
+
+        for(auto r=0u; r<info.RegionCount; ++r)
+        {
+            for(auto i=0; i<2; ++i)
+            {
+                for(auto c=0; c<3; ++c)
+                { q[r][i][c] = QuantizeBc6(e[r][i][c], info.EndpointBits); }
+            }
+
+            // アンカーの最上位ビットが 0 になる向きにする.
+            auto n = BuildBc6Palette(q[r], info.EndpointBits, indexBits, palette);
+            SelectIndices(block, lists[r], counts[r], 0, 3, palette, n, -1, index);
+
+            auto anchor = GetAnchor(info.RegionCount, partition, r);
+            if (index[anchor] >= (n >> 1))
+            {
+                for(auto c=0; c<3; ++c)
+                { std::swap(q[r][0][c], q[r][1][c]); }
+
+                for(auto c=0; c<4; ++c)
+                { std::swap(e[r][0][c], e[r][1][c]); }
+            }
+        }
+
+        ClampBc6Delta(info, q);
+
+        uint64_t error = 0;
+        for(auto r=0u; r<info.RegionCount; ++r)
+        {
+            auto n = BuildBc6Palette(q[r], info.EndpointBits, indexBits, palette);
+            error += SelectIndices(block, lists[r], counts[r], 0, 3, palette, n, int(GetAnchor(info.RegionCount, partition, r)), index);
+        }
+
+        if (error < result.Error)
+        {
+            result.Error = error;
+            memcpy(result.Endpoint, q, sizeof(q));
+            memcpy(result.Index, index, sizeof(index));
+        }
+        else if (it > 0)
+        { break; }
+
+        if (it == refineCount || error == 0)
+        { break; }
+
+        auto refined = true;
+        for(auto r=0u; r<info.RegionCount && refined; ++r)
+        { refined = RefineEndpoints(block, lists[r], counts[r], 0, 3, index, indexBits, e[r][0], e[r][1]); }
+
+        if (!refined)
+        { break; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H ブロックを書き出します.
+//-----------------------------------------------------------------------------
+void WriteBc6Block(const Bc6Block& block, uint8_t* pBlock)
+{
+    auto& info      = kBc6Modes[block.Mode];
+    auto  indexBits = (info.RegionCount == 1) ? 4u : 3u;
+    auto  mask      = (1 << info.EndpointBits) - 1;
+
+    // フィールド値 (w : 基準端点, x, y, z : 差分または端点).
+    int value[13];
+    for(auto c=0; c<3; ++c)
+    {
+        auto base = block.Endpoint[0][0][c];
+        for(auto k=0; k<4; ++k)
+        {
+            auto e = block.Endpoint[k / 2][k % 2][c];
+            value[c * 4 + k] = (k > 0 && info.DeltaBits[0] > 0) ? ((e - base) & mask) : e;
+        }
+    }
+    value[BC6_FIELD_D] = int(block.Partition);
+
+    BitWriter writer(pBlock);
+    writer.Write(info.ModeValue, info.ModeBits);
+
+    for(auto i=0u; i<info.LayoutCount; ++i)
+    {
+        auto& f    = info.pLayout[i];
+        auto  step = (f.High >= f.Low) ? 1 : -1;
+        for(auto b=int(f.Low); ; b+=step)
+        {
+            writer.Write(uint32_t(value[f.Field] >> b) & 0x1, 1);
+            if (b == int(f.High))
+            { break; }
+        }
+    }
+
+    auto anchor = GetAnchor(info.RegionCount, block.Partition, 1);
+    for(auto i=0u; i<16; ++i)
+    {
+        auto isAnchor = (i == 0) || (info.RegionCount > 1 && i == anchor);
+        writer.Write(block.Index[i], indexBits - (isAnchor ? 1 : 0));
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H の探索範囲を取得します.
+//-----------------------------------------------------------------------------
+SearchBudget GetBc6Budget(asdx::BC_QUALITY quality)
+{
+    // ModeMask は kBc6Modes の番号のビットマスク.
+    SearchBudget budget = {};
+    switch(quality)
+    {
+    case asdx::BC_QUALITY_FAST:
+        budget.ModeMask        = (1u << 3);
+        budget.RefineCount     = 1;
+        break;
+
+    case asdx::BC_QUALITY_NORMAL:
+        budget.ModeMask        = 0x7F;
+        budget.PartitionCount2 = 4;
+        budget.RefineCount     = 1;
+        break;
+
+    case asdx::BC_QUALITY_HIGH:
+    default:
+        budget.ModeMask        = 0x7F;
+        budget.PartitionCount2 = kBc6PartitionCount;
+        budget.RefineCount     = 3;
+        budget.Exhaustive      = true;
+        break;
+    }
+    return budget;
+}
+
+//-----------------------------------------------------------------------------
+//      BC6H ブロックを予算内で探索して圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBc6Block(const TexelBlock& block, const SearchBudget& budget, uint8_t* pBlock)
+{
+    Bc6Block best = {};
+    best.Error = UINT64_MAX;
+
+    Bc6Block candidate;
+
+    uint32_t partitions[kBc6PartitionCount];
+    uint32_t partitionCount = 0;
+    if (budget.PartitionCount2 > 0)
+    { partitionCount = SelectPartitions(block, 2, kBc6PartitionCount, budget.PartitionCount2, partitions); }
+
+    for(auto mode=0u; mode<kBc6ModeCount && best.Error > 0; ++mode)
+    {
+        if ((budget.ModeMask & (1u << mode)) == 0)
+        { continue; }
+
+        if (kBc6Modes[mode].RegionCount == 1)
+        {
+            EncodeBc6Mode(block, mode, 0, budget.RefineCount, candidate);
+            if (candidate.Error < best.Error)
+            { best = candidate; }
+            continue;
+        }
+
+        for(auto i=0u; i<partitionCount; ++i)
+        {
+            EncodeBc6Mode(block, mode, partitions[i], budget.RefineCount, candidate);
+            if (candidate.Error < best.Error)
+            { best = candidate; }
+        }
+    }
+
+    WriteBc6Block(best, pBlock);
+}
+
+//-----------------------------------------------------------------------------
+//      テクセルを RGBA8 として取得します.
+//-----------------------------------------------------------------------------
+inline void FetchTexel(const uint8_t* pSrc, SOURCE_LAYOUT layout, uint8_t* pDst)
+{
+    switch(layout)
+    {
+    case SOURCE_LAYOUT_RGBA8:
+        memcpy(pDst, pSrc, 4);
+        break;
+
+    case SOURCE_LAYOUT_RG8:
+        pDst[0] = pSrc[0];
+        pDst[1] = pSrc[1];
+        pDst[2] = 0;
+        pDst[3] = 255;
+        break;
+
+    case SOURCE_LAYOUT_R8:
+        pDst[0] = pDst[1] = pDst[2] = pSrc[0];
+        pDst[3] = 255;
+        break;
+
+    case SOURCE_LAYOUT_A8:
+        pDst[0] = pDst[1] = pDst[2] = 0;
+        pDst[3] = pSrc[0];
+        break;
+
+    default:
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      テクセルを RGBA16F として取得します.
+//-----------------------------------------------------------------------------
+inline void FetchTexelHalf(const uint8_t* pSrc, SOURCE_LAYOUT layout, asdx::half* pDst)
+{
+    if (layout == SOURCE_LAYOUT_RGBA32F)
+    {
+        float value[4];
+        memcpy(value, pSrc, sizeof(value));
+        asdx::ConvertF32ToF16(value, pDst, 4);
+        return;
+    }
+
+    memcpy(pDst, pSrc, sizeof(asdx::half) * 4);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BlockRowTask structure
+///////////////////////////////////////////////////////////////////////////////
+struct BlockRowTask
+{
+    const asdx::SubResource*    pSrc;       // 入力サブリソース.
+    uint8_t*                    pDst;       // 出力先のブロック行.
+    uint32_t                    BlockY;     // ブロック行番号.
+};
+
+//-----------------------------------------------------------------------------
+//      ブロック1行分を圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBlockRow
+(
+    const BlockRowTask& task,
+    SOURCE_LAYOUT       layout,
+    uint32_t            texelSize,
+    asdx::BC_FORMAT     format,
+    asdx::BC_QUALITY    quality,
+    uint32_t            blockSize
+)
+{
+    auto& src = *task.pSrc;
+    auto blockWide = (src.Width + 3) / 4;
+
+    uint8_t    texels[64];
+    asdx::half halfs [64];
+
+    for(auto bx=0u; bx<blockWide; ++bx)
+    {
+        // 端のブロックは最終行・最終列を複製する.
+        for(auto y=0u; y<4; ++y)
+        {
+            auto sy   = std::min(task.BlockY * 4 + y, src.Height - 1);
+            auto pRow = src.pPixels + size_t(sy) * src.Pitch;
+
+            for(auto x=0u; x<4; ++x)
+            {
+                auto sx   = std::min(bx * 4 + x, src.Width - 1);
+                auto pSrc = pRow + size_t(sx) * texelSize;
+                if (format == asdx::BC_FORMAT_BC6H)
+                { FetchTexelHalf(pSrc, layout, halfs + (y * 4 + x) * 4); }
+                else
+                { FetchTexel(pSrc, layout, texels + (y * 4 + x) * 4); }
+            }
+        }
+
+        auto pBlock = task.pDst + size_t(bx) * blockSize;
+        switch(format)
+        {
+        case asdx::BC_FORMAT_BC1:  asdx::EncodeBC1 (texels, quality, pBlock); break;
+        case asdx::BC_FORMAT_BC3:  asdx::EncodeBC3 (texels, quality, pBlock); break;
+        case asdx::BC_FORMAT_BC4:  asdx::EncodeBC4 (texels, quality, pBlock); break;
+        case asdx::BC_FORMAT_BC5:  asdx::EncodeBC5 (texels, quality, pBlock); break;
+        case asdx::BC_FORMAT_BC6H: asdx::EncodeBC6H(halfs,  quality, pBlock); break;
+        case asdx::BC_FORMAT_BC7:  asdx::EncodeBC7 (texels, quality, pBlock); break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      入力フォーマットからテクセルの並びを求めます.
+//-----------------------------------------------------------------------------
+bool GetSourceLayout(uint32_t format, SOURCE_LAYOUT& layout, uint32_t& texelSize, bool& isSRGB)
+{
+    isSRGB = false;
+
+    switch(format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        isSRGB = true;
+        // FALLTHROUGH
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        layout    = SOURCE_LAYOUT_RGBA8;
+        texelSize = 4;
+        return true;
+
+    case DXGI_FORMAT_R8G8_UNORM:
+        layout    = SOURCE_LAYOUT_RG8;
+        texelSize = 2;
+        return true;
+
+    case DXGI_FORMAT_R8_UNORM:
+        layout    = SOURCE_LAYOUT_R8;
+        texelSize = 1;
+        return true;
+
+    case DXGI_FORMAT_A8_UNORM:
+        layout    = SOURCE_LAYOUT_A8;
+        texelSize = 1;
+        return true;
+
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        layout    = SOURCE_LAYOUT_RGBA16F;
+        texelSize = 8;
+        return true;
+
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        layout    = SOURCE_LAYOUT_RGBA32F;
+        texelSize = 16;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数点の並びかどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsFloatLayout(SOURCE_LAYOUT layout)
+{ return layout == SOURCE_LAYOUT_RGBA16F || layout == SOURCE_LAYOUT_RGBA32F; }
+
+//-----------------------------------------------------------------------------
+//      入力の並びと変換先フォーマットの組み合わせが有効かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsSupportedLayout(SOURCE_LAYOUT layout, asdx::BC_FORMAT format)
+{
+    // BC6H は浮動小数点, それ以外は 8bit の入力のみ受け付ける.
+    if (IsFloatLayout(layout) != (format == asdx::BC_FORMAT_BC6H))
+    { return false; }
+
+    // A8 はアルファのみなので, アルファを独立して持つ BC3 以外では意味のある結果にならない.
+    if (layout == SOURCE_LAYOUT_A8 && format != asdx::BC_FORMAT_BC3)
+    { return false; }
+
+    return true;
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルをBC1ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC1(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    ColorBlock block;
+    SetupColorBlock(pTexels, true, block);
+    EncodeColorBlock(block, quality, true, pBlock);
+}
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルをBC3ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC3(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    uint8_t alpha[16];
+    ExtractChannel(pTexels, 3, alpha);
+    EncodeAlphaBlock(alpha, quality, pBlock);
+
+    // BC3 のカラーは常に4色モードで解釈される.
+    ColorBlock block;
+    SetupColorBlock(pTexels, false, block);
+    EncodeColorBlock(block, quality, false, pBlock + 8);
+}
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルのR成分をBC4ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC4(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    uint8_t red[16];
+    ExtractChannel(pTexels, 0, red);
+    EncodeAlphaBlock(red, quality, pBlock);
+}
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルのR,G成分をBC5ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC5(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    uint8_t red  [16];
+    uint8_t green[16];
+    ExtractChannel(pTexels, 0, red);
+    ExtractChannel(pTexels, 1, green);
+    EncodeAlphaBlock(red,   quality, pBlock);
+    EncodeAlphaBlock(green, quality, pBlock + 8);
+}
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルをBC6H(符号なし)ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC6H(const half* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    TexelBlock block;
+    for(auto i=0; i<16; ++i)
+    {
+        for(auto c=0; c<3; ++c)
+        {
+            // 負の値は 0 に，無限大・非数は最大有限値に丸める.
+            auto h = int(pTexels[i * 4 + c]);
+            auto v = (h & 0x8000) ? 0 : std::min(h, kBc6MaxHalf);
+
+            block.Value[i][c] = v;
+            block.Point[i][c] = float(v) * (64.0f / 31.0f);
+        }
+        block.Value[i][3] = 0;
+        block.Point[i][3] = 0.0f;
+    }
+
+    EncodeBc6Block(block, GetBc6Budget(quality), pBlock);
+}
+
+//-----------------------------------------------------------------------------
+//      4x4テクセルをBC7ブロックに圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeBC7(const uint8_t* pTexels, BC_QUALITY quality, uint8_t* pBlock)
+{
+    TexelBlock block;
+    for(auto i=0; i<16; ++i)
+    {
+        for(auto c=0; c<4; ++c)
+        {
+            block.Value[i][c] = pTexels[i * 4 + c];
+            block.Point[i][c] = float(pTexels[i * 4 + c]);
+        }
+    }
+
+    EncodeBc7Block(block, GetBc7Budget(quality), pBlock);
+}
+
+//-----------------------------------------------------------------------------
+//      ブロック圧縮フォーマットに変換できるかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsCompressibleFormat(uint32_t srcFormat, BC_FORMAT format)
+{
+    SOURCE_LAYOUT layout;
+    uint32_t      texelSize;
+    bool          isSRGB;
+    if (!GetSourceLayout(srcFormat, layout, texelSize, isSRGB))
+    { return false; }
+
+    return IsSupportedLayout(layout, format);
+}
+
+//-----------------------------------------------------------------------------
+//      リソーステクスチャをブロック圧縮フォーマットに変換します.
+//-----------------------------------------------------------------------------
+bool CompressResTexture(ResTexture& resTexture, BC_FORMAT format, BC_QUALITY quality)
+{
+    if (resTexture.pResources == nullptr)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (resTexture.Dimension == TEXTURE_DIMENSION_3D)
+    {
+        ELOG("Error : Volume Texture is not supported.");
+        return false;
+    }
+
+    SOURCE_LAYOUT layout;
+    uint32_t      texelSize;
+    bool          isSRGB;
+    if (!GetSourceLayout(resTexture.Format, layout, texelSize, isSRGB))
+    {
+        ELOG("Error : Unsupported Format. format = %u", resTexture.Format);
+        return false;
+    }
+
+    if (!IsSupportedLayout(layout, format))
+    {
+        ELOG("Error : Unsupported Format. format = %u", resTexture.Format);
+        return false;
+    }
+
+    uint32_t dstFormat;
+    uint32_t blockSize;
+
+    switch(format)
+    {
+    case BC_FORMAT_BC1:
+        dstFormat = (isSRGB) ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        blockSize = 8;
+        break;
+
+    case BC_FORMAT_BC3:
+        dstFormat = (isSRGB) ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        blockSize = 16;
+        break;
+
+    case BC_FORMAT_BC4:
+        dstFormat = DXGI_FORMAT_BC4_UNORM;
+        blockSize = 8;
+        break;
+
+    case BC_FORMAT_BC5:
+        dstFormat = DXGI_FORMAT_BC5_UNORM;
+        blockSize = 16;
+        break;
+
+    case BC_FORMAT_BC6H:
+        dstFormat = DXGI_FORMAT_BC6H_UF16;
+        blockSize = 16;
+        break;
+
+    case BC_FORMAT_BC7:
+        dstFormat = (isSRGB) ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        blockSize = 16;
+        break;
+
+    default:
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    auto mipCount = (resTexture.MipMapCount > 0) ? resTexture.MipMapCount : 1;
+    auto count    = resTexture.SurfaceCount * mipCount;
+
+    // 出力サイズを求める.
+    size_t totalSize = 0;
+    size_t rowCount  = 0;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& src = resTexture.pResources[i];
+        if (src.pPixels == nullptr || src.Width == 0 || src.Height == 0)
+        {
+            ELOG("Error : Invalid SubResource. index = %u", i);
+            return false;
+        }
+
+        auto blockWide = (src.Width  + 3) / 4;
+        auto blockHigh = (src.Height + 3) / 4;
+        totalSize += size_t(blockWide) * blockHigh * blockSize;
+        rowCount  += blockHigh;
+    }
+
+    auto pResources = new (std::nothrow) SubResource[count];
+    if (pResources == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    auto pPixelData = new (std::nothrow) uint8_t[totalSize];
+    if (pPixelData == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        delete[] pResources;
+        return false;
+    }
+
+    std::vector<BlockRowTask> tasks;
+    tasks.reserve(rowCount);
+
+    size_t offset = 0;
+    for(auto i=0u; i<count; ++i)
+    {
+        auto& src = resTexture.pResources[i];
+        auto& dst = pResources[i];
+
+        auto blockWide = (src.Width  + 3) / 4;
+        auto blockHigh = (src.Height + 3) / 4;
+
+        dst.Width      = src.Width;
+        dst.Height     = src.Height;
+        dst.MipIndex   = src.MipIndex;
+        dst.Pitch      = blockWide * blockSize;
+        dst.SlicePitch = dst.Pitch * blockHigh;
+        dst.pPixels    = pPixelData + offset;
+
+        for(auto y=0u; y<blockHigh; ++y)
+        {
+            BlockRowTask task;
+            task.pSrc   = &src;
+            task.pDst   = dst.pPixels + size_t(y) * dst.Pitch;
+            task.BlockY = y;
+            tasks.push_back(task);
+        }
+
+        offset += dst.SlicePitch;
+    }
+
+    ParallelFor(0, tasks.size(), 0, [&](size_t index)
+    { EncodeBlockRow(tasks[index], layout, texelSize, format, quality, blockSize); });
+
+    // 元のデータを破棄して差し替える.
+    resTexture.Dispose();
+    resTexture.pResources = pResources;
+    resTexture.pPixelData = pPixelData;
+    resTexture.Format     = dstFormat;
+
+    return true;
+}
+
+} // namespace asdx
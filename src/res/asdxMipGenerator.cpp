@@ -0,0 +1,750 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMipGenerator.cpp
+// Desc : Mip Map Generator.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <res/asdxMipGenerator.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxMath.h>
+#include <fnd/asdxParallel.h>
+#include <dxgiformat.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define ASDX_MIP_SSE2   (1)
+#endif
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const float kKaiserRadius = 3.0f;    // カイザーフィルタの半径(出力テクセル単位).
+static const float kKaiserAlpha  = 4.0f;    // カイザー窓の形状パラメータ.
+
+///////////////////////////////////////////////////////////////////////////////
+// COMPONENT_TYPE enum
+///////////////////////////////////////////////////////////////////////////////
+enum COMPONENT_TYPE
+{
+    COMPONENT_TYPE_UNORM8,      // 8bit 正規化整数.
+    COMPONENT_TYPE_UNORM16,     // 16bit 正規化整数.
+    COMPONENT_TYPE_FLOAT16,     // 16bit 浮動小数点.
+    COMPONENT_TYPE_FLOAT32,     // 32bit 浮動小数点.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// FormatInfo structure
+///////////////////////////////////////////////////////////////////////////////
+struct FormatInfo
+{
+    COMPONENT_TYPE  Type;           // 成分の型.
+    uint32_t        ChannelCount;   // 格納されている成分数.
+    uint8_t         Channel[4];     // 格納順の成分に対応する RGBA の番号.
+    bool            IsSRGB;         // RGB が sRGB で格納されているかどうか.
+    bool            HasAlpha;       // アルファを持つかどうか.
+    uint32_t        TexelSize;      // 1テクセル当たりのバイト数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SRGBTable structure
+///////////////////////////////////////////////////////////////////////////////
+struct SRGBTable
+{
+    float   ToLinear [256];     // sRGB から線形への変換値.
+    float   Threshold[255];     // 線形から sRGB へ丸める際の境界値.
+
+    //-------------------------------------------------------------------------
+    //      コンストラクタです.
+    //-------------------------------------------------------------------------
+    SRGBTable()
+    {
+        for(auto i=0; i<256; ++i)
+        { ToLinear[i] = float(Decode(i / 255.0)); }
+
+        // 境界値より大きければ次のコードに丸める.
+        for(auto i=0; i<255; ++i)
+        { Threshold[i] = float(Decode((i + 0.5) / 255.0)); }
+    }
+
+    //-------------------------------------------------------------------------
+    //      sRGB を線形に変換します.
+    //-------------------------------------------------------------------------
+    static double Decode(double value)
+    {
+        return (value <= 0.04045)
+            ? value / 12.92
+            : pow((value + 0.055) / 1.055, 2.4);
+    }
+};
+
+//-----------------------------------------------------------------------------
+//      sRGB 変換テーブルを取得します.
+//-----------------------------------------------------------------------------
+const SRGBTable& GetSRGBTable()
+{
+    static const SRGBTable table;
+    return table;
+}
+
+//-----------------------------------------------------------------------------
+//      線形の値を 8bit の sRGB に変換します.
+//-----------------------------------------------------------------------------
+inline uint8_t LinearToSRGB8(const SRGBTable& table, float value)
+{
+    auto lo = 0;
+    auto hi = 255;
+    while (lo < hi)
+    {
+        auto mid = (lo + hi) >> 1;
+        if (table.Threshold[mid] < value)
+        { lo = mid + 1; }
+        else
+        { hi = mid; }
+    }
+    return uint8_t(lo);
+}
+
+//-----------------------------------------------------------------------------
+//      フォーマット情報を設定します.
+//-----------------------------------------------------------------------------
+inline void SetFormatInfo
+(
+    COMPONENT_TYPE  type,
+    uint32_t        channelCount,
+    uint8_t         r,
+    uint8_t         g,
+    uint8_t         b,
+    uint8_t         a,
+    bool            isSRGB,
+    bool            hasAlpha,
+    uint32_t        texelSize,
+    FormatInfo&     info
+)
+{
+    info.Type         = type;
+    info.ChannelCount = channelCount;
+    info.Channel[0]   = r;
+    info.Channel[1]   = g;
+    info.Channel[2]   = b;
+    info.Channel[3]   = a;
+    info.IsSRGB       = isSRGB;
+    info.HasAlpha     = hasAlpha;
+    info.TexelSize    = texelSize;
+}
+
+//-----------------------------------------------------------------------------
+//      フォーマット情報を取得します.
+//-----------------------------------------------------------------------------
+bool GetFormatInfo(uint32_t format, FormatInfo& info)
+{
+    switch(format)
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:        SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 0, 1, 2, 3, false, true,   4, info); break;
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:   SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 0, 1, 2, 3, true,  true,   4, info); break;
+    case DXGI_FORMAT_B8G8R8A8_UNORM:        SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 2, 1, 0, 3, false, true,   4, info); break;
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:   SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 2, 1, 0, 3, true,  true,   4, info); break;
+    case DXGI_FORMAT_B8G8R8X8_UNORM:        SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 2, 1, 0, 3, false, false,  4, info); break;
+    case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:   SetFormatInfo(COMPONENT_TYPE_UNORM8,  4, 2, 1, 0, 3, true,  false,  4, info); break;
+    case DXGI_FORMAT_R8G8_UNORM:            SetFormatInfo(COMPONENT_TYPE_UNORM8,  2, 0, 1, 0, 0, false, false,  2, info); break;
+    case DXGI_FORMAT_R8_UNORM:              SetFormatInfo(COMPONENT_TYPE_UNORM8,  1, 0, 0, 0, 0, false, false,  1, info); break;
+    case DXGI_FORMAT_A8_UNORM:              SetFormatInfo(COMPONENT_TYPE_UNORM8,  1, 3, 0, 0, 0, false, true,   1, info); break;
+    case DXGI_FORMAT_R16G16B16A16_UNORM:    SetFormatInfo(COMPONENT_TYPE_UNORM16, 4, 0, 1, 2, 3, false, true,   8, info); break;
+    case DXGI_FORMAT_R16_UNORM:             SetFormatInfo(COMPONENT_TYPE_UNORM16, 1, 0, 0, 0, 0, false, false,  2, info); break;
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:    SetFormatInfo(COMPONENT_TYPE_FLOAT16, 4, 0, 1, 2, 3, false, true,   8, info); break;
+    case DXGI_FORMAT_R16G16_FLOAT:          SetFormatInfo(COMPONENT_TYPE_FLOAT16, 2, 0, 1, 0, 0, false, false,  4, info); break;
+    case DXGI_FORMAT_R16_FLOAT:             SetFormatInfo(COMPONENT_TYPE_FLOAT16, 1, 0, 0, 0, 0, false, false,  2, info); break;
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:    SetFormatInfo(COMPONENT_TYPE_FLOAT32, 4, 0, 1, 2, 3, false, true,  16, info); break;
+    case DXGI_FORMAT_R32G32B32_FLOAT:       SetFormatInfo(COMPONENT_TYPE_FLOAT32, 3, 0, 1, 2, 0, false, false, 12, info); break;
+    case DXGI_FORMAT_R32G32_FLOAT:          SetFormatInfo(COMPONENT_TYPE_FLOAT32, 2, 0, 1, 0, 0, false, false,  8, info); break;
+    case DXGI_FORMAT_R32_FLOAT:             SetFormatInfo(COMPONENT_TYPE_FLOAT32, 1, 0, 0, 0, 0, false, false,  4, info); break;
+
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      1行分のテクセルを RGBA の浮動小数点に展開します.
+//-----------------------------------------------------------------------------
+void DecodeRow(const uint8_t* pSrc, uint32_t width, const FormatInfo& info, float* pScratch, float* pDst)
+{
+    auto count = size_t(width) * info.ChannelCount;
+
+    // 格納順のまま浮動小数点に変換する.
+    switch(info.Type)
+    {
+    case COMPONENT_TYPE_UNORM8:
+        for(size_t i=0; i<count; ++i)
+        { pScratch[i] = float(pSrc[i]) * (1.0f / 255.0f); }
+        break;
+
+    case COMPONENT_TYPE_UNORM16:
+        {
+            auto pValue = reinterpret_cast<const uint16_t*>(pSrc);
+            for(size_t i=0; i<count; ++i)
+            { pScratch[i] = float(pValue[i]) * (1.0f / 65535.0f); }
+        }
+        break;
+
+    case COMPONENT_TYPE_FLOAT16:
+        asdx::ConvertF16ToF32(reinterpret_cast<const asdx::half*>(pSrc), pScratch, count);
+        break;
+
+    case COMPONENT_TYPE_FLOAT32:
+        memcpy(pScratch, pSrc, sizeof(float) * count);
+        break;
+    }
+
+    auto& table = GetSRGBTable();
+
+    for(auto x=0u; x<width; ++x)
+    {
+        auto pTexel = pDst + x * 4;
+        pTexel[0] = pTexel[1] = pTexel[2] = 0.0f;
+        pTexel[3] = 1.0f;
+
+        for(auto c=0u; c<info.ChannelCount; ++c)
+        {
+            auto ch = info.Channel[c];
+            if (info.IsSRGB && ch < 3)
+            { pTexel[ch] = table.ToLinear[pSrc[x * info.ChannelCount + c]]; }
+            else
+            { pTexel[ch] = pScratch[x * info.ChannelCount + c]; }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      RGBA の浮動小数点を1行分のテクセルに変換します.
+//-----------------------------------------------------------------------------
+void EncodeRow(const float* pSrc, uint32_t width, const FormatInfo& info, float alphaScale, float* pScratch, uint8_t* pDst)
+{
+    auto count = size_t(width) * info.ChannelCount;
+    auto& table = GetSRGBTable();
+
+    // 格納順に並べ替える.
+    for(auto x=0u; x<width; ++x)
+    {
+        auto pTexel = pSrc + x * 4;
+        for(auto c=0u; c<info.ChannelCount; ++c)
+        {
+            auto ch = info.Channel[c];
+            auto v  = pTexel[ch];
+            if (ch == 3)
+            {
+                if (!info.HasAlpha)
+                { v = 1.0f; }
+                else if (alphaScale != 1.0f)
+                { v = std::min(v * alphaScale, 1.0f); }
+            }
+            pScratch[x * info.ChannelCount + c] = v;
+        }
+    }
+
+    switch(info.Type)
+    {
+    case COMPONENT_TYPE_UNORM8:
+        for(size_t i=0; i<count; i+=info.ChannelCount)
+        {
+            for(auto c=0u; c<info.ChannelCount; ++c)
+            {
+                auto v = pScratch[i + c];
+                if (info.IsSRGB && info.Channel[c] < 3)
+                { pDst[i + c] = LinearToSRGB8(table, v); }
+                else
+                { pDst[i + c] = uint8_t(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); }
+            }
+        }
+        break;
+
+    case COMPONENT_TYPE_UNORM16:
+        {
+            auto pValue = reinterpret_cast<uint16_t*>(pDst);
+            for(size_t i=0; i<count; ++i)
+            { pValue[i] = uint16_t(std::min(std::max(pScratch[i], 0.0f), 1.0f) * 65535.0f + 0.5f); }
+        }
+        break;
+
+    case COMPONENT_TYPE_FLOAT16:
+        asdx::ConvertF32ToF16(pScratch, reinterpret_cast<asdx::half*>(pDst), count);
+        break;
+
+    case COMPONENT_TYPE_FLOAT32:
+        memcpy(pDst, pScratch, sizeof(float) * count);
+        break;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// FilterKernel structure
+///////////////////////////////////////////////////////////////////////////////
+struct FilterKernel
+{
+    uint32_t                TapCount;   // 出力1テクセル当たりのタップ数.
+    std::vector<uint32_t>   Index;      // 入力テクセルの番号(端はクランプ済み).
+    std::vector<float>      Weight;     // 正規化した重み.
+};
+
+//-----------------------------------------------------------------------------
+//      第1種変形ベッセル関数(0次)を求めます.
+//-----------------------------------------------------------------------------
+double BesselI0(double x)
+{
+    auto sum  = 1.0;
+    auto term = 1.0;
+    auto half = x * 0.5;
+    for(auto k=1; k<32; ++k)
+    {
+        auto t = half / k;
+        term *= t * t;
+        sum  += term;
+        if (term < sum * 1e-12)
+        { break; }
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+//      カイザー窓付き sinc の重みを求めます.
+//-----------------------------------------------------------------------------
+float KaiserWeight(double x)
+{
+    auto r = fabs(x) / kKaiserRadius;
+    if (r >= 1.0)
+    { return 0.0f; }
+
+    auto px   = double(asdx::F_PI) * x;
+    auto sinc = (fabs(x) < 1e-6) ? 1.0 : sin(px) / px;
+    return float(sinc * BesselI0(kKaiserAlpha * sqrt(1.0 - r * r)) / BesselI0(kKaiserAlpha));
+}
+
+//-----------------------------------------------------------------------------
+//      1軸分の縮小カーネルを構築します.
+//-----------------------------------------------------------------------------
+void BuildKernel(uint32_t srcSize, uint32_t dstSize, asdx::MIP_FILTER filter, FilterKernel& kernel)
+{
+    auto scale   = double(srcSize) / double(dstSize);
+    auto support = (filter == asdx::MIP_FILTER_KAISER) ? kKaiserRadius * scale : 0.5 * scale;
+
+    kernel.TapCount = uint32_t(ceil(support * 2.0)) + 1;
+    kernel.Index .resize(size_t(dstSize) * kernel.TapCount);
+    kernel.Weight.resize(size_t(dstSize) * kernel.TapCount);
+
+    for(auto x=0u; x<dstSize; ++x)
+    {
+        auto center = (x + 0.5) * scale;
+        auto first  = int(floor(center - support));
+        auto pIndex  = &kernel.Index [size_t(x) * kernel.TapCount];
+        auto pWeight = &kernel.Weight[size_t(x) * kernel.TapCount];
+
+        auto sum = 0.0f;
+        for(auto t=0u; t<kernel.TapCount; ++t)
+        {
+            auto s = first + int(t);
+
+            float w;
+            if (filter == asdx::MIP_FILTER_KAISER)
+            { w = KaiserWeight((s + 0.5 - center) / scale); }
+            else
+            {
+                // 出力テクセルが覆う範囲との重なりを重みとする.
+                auto lo = std::max(double(s),     center - support);
+                auto hi = std::min(double(s + 1), center + support);
+                w = float(std::max(hi - lo, 0.0));
+            }
+
+            pIndex [t] = uint32_t(std::min(std::max(s, 0), int(srcSize) - 1));
+            pWeight[t] = w;
+            sum += w;
+        }
+
+        for(auto t=0u; t<kernel.TapCount; ++t)
+        { pWeight[t] /= sum; }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      1行を横方向に縮小します.
+//-----------------------------------------------------------------------------
+void FilterRow(const float* pSrc, const FilterKernel& kernel, uint32_t dstWidth, float* pDst)
+{
+    for(auto x=0u; x<dstWidth; ++x)
+    {
+        auto pIndex  = &kernel.Index [size_t(x) * kernel.TapCount];
+        auto pWeight = &kernel.Weight[size_t(x) * kernel.TapCount];
+
+    #if ASDX_MIP_SSE2
+        auto acc = _mm_setzero_ps();
+        for(auto t=0u; t<kernel.TapCount; ++t)
+        {
+            auto texel = _mm_loadu_ps(pSrc + size_t(pIndex[t]) * 4);
+            acc = _mm_add_ps(acc, _mm_mul_ps(texel, _mm_set1_ps(pWeight[t])));
+        }
+        _mm_storeu_ps(pDst + size_t(x) * 4, acc);
+    #else
+        float acc[4] = {};
+        for(auto t=0u; t<kernel.TapCount; ++t)
+        {
+            auto pTexel = pSrc + size_t(pIndex[t]) * 4;
+            for(auto c=0; c<4; ++c)
+            { acc[c] += pTexel[c] * pWeight[t]; }
+        }
+        memcpy(pDst + size_t(x) * 4, acc, sizeof(acc));
+    #endif
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      横方向に縮小済みの行から縦方向に縮小した1行を求めます.
+//-----------------------------------------------------------------------------
+void FilterColumn(const float* pSrc, uint32_t width, const uint32_t* pIndex, const float* pWeight, uint32_t tapCount, float* pDst)
+{
+    auto count = size_t(width) * 4;
+    memset(pDst, 0, sizeof(float) * count);
+
+    for(auto t=0u; t<tapCount; ++t)
+    {
+        if (pWeight[t] == 0.0f)
+        { continue; }
+
+        auto pRow = pSrc + size_t(pIndex[t]) * count;
+
+    #if ASDX_MIP_SSE2
+        auto w = _mm_set1_ps(pWeight[t]);
+        for(size_t i=0; i<count; i+=4)
+        {
+            auto acc = _mm_loadu_ps(pDst + i);
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(pRow + i), w));
+            _mm_storeu_ps(pDst + i, acc);
+        }
+    #else
+        for(size_t i=0; i<count; ++i)
+        { pDst[i] += pRow[i] * pWeight[t]; }
+    #endif
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      アルファテストの通過率がミップレベル0と一致するアルファの倍率を求めます.
+//-----------------------------------------------------------------------------
+float CalcAlphaScale(const std::vector<float>& level, float coverage, float alphaReference)
+{
+    auto count = level.size() / 4;
+    if (count == 0)
+    { return 1.0f; }
+
+    std::vector<float> alpha(count);
+    for(size_t i=0; i<count; ++i)
+    { alpha[i] = level[i * 4 + 3]; }
+
+    // above 番目に大きいアルファを境界の候補とする.
+    auto above = std::min(size_t(coverage * float(count) + 0.5f), count);
+    auto k     = count - std::max(above, size_t(1));
+    std::nth_element(alpha.begin(), alpha.begin() + k, alpha.end());
+    auto pivot = alpha[k];
+
+    // 同じ値のテクセルは分けられないので，境界を含めるか除くかの近い方を選ぶ.
+    size_t greater = 0;
+    size_t equal   = 0;
+    auto   upper   = FLT_MAX;
+    auto   lower   = 0.0f;
+    for(auto value : alpha)
+    {
+        if (value > pivot)
+        {
+            greater++;
+            upper = std::min(upper, value);
+        }
+        else if (value == pivot)
+        { equal++; }
+        else
+        { lower = std::max(lower, value); }
+    }
+
+    auto include = (pivot > 0.0f) && (greater + equal - above <= above - std::min(greater, above));
+
+    // 隣り合う値の中間が閾値になるようにする.
+    float threshold;
+    if (include)
+    { threshold = (pivot + lower) * 0.5f; }
+    else if (greater > 0)
+    { threshold = (pivot + upper) * 0.5f; }
+    else
+    { threshold = pivot * 1.5f; }
+
+    return (threshold > 0.0f) ? alphaReference / threshold : 1.0f;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MipContext structure
+///////////////////////////////////////////////////////////////////////////////
+struct MipContext
+{
+    FormatInfo          Info;               // フォーマット情報.
+    asdx::MIP_FILTER    Filter;             // 縮小フィルタ.
+    float               AlphaReference;     // アルファテストの閾値(0 以下で無効).
+};
+
+//-----------------------------------------------------------------------------
+//      1サーフェイス分のミップマップを生成します.
+//-----------------------------------------------------------------------------
+void GenerateSurface
+(
+    const MipContext&           context,
+    const asdx::SubResource&    src,
+    uint32_t                    mipCount,
+    asdx::SubResource*          pDst
+)
+{
+    auto& info = context.Info;
+    auto  useCoverage = context.AlphaReference > 0.0f && info.HasAlpha;
+
+    // ミップレベル0はそのままコピーする.
+    {
+        auto rowSize = size_t(src.Width) * info.TexelSize;
+        for(auto y=0u; y<src.Height; ++y)
+        { memcpy(pDst[0].pPixels + y * pDst[0].Pitch, src.pPixels + size_t(y) * src.Pitch, rowSize); }
+    }
+
+    std::atomic<uint64_t> covered(0);
+
+    std::vector<float> prevLevel;
+    std::vector<float> currLevel;
+    std::vector<float> temp;
+
+    auto coverage = 0.0f;
+
+    for(auto mip=1u; mip<mipCount; ++mip)
+    {
+        auto srcW = pDst[mip - 1].Width;
+        auto srcH = pDst[mip - 1].Height;
+        auto dstW = pDst[mip].Width;
+        auto dstH = pDst[mip].Height;
+
+        FilterKernel kernelX;
+        FilterKernel kernelY;
+        BuildKernel(srcW, dstW, context.Filter, kernelX);
+        BuildKernel(srcH, dstH, context.Filter, kernelY);
+
+        // 横方向の縮小. ミップレベル0は元のテクセルから直接展開する.
+        temp.resize(size_t(dstW) * srcH * 4);
+        asdx::ParallelForRange(0, srcH, 0, [&](size_t begin, size_t end)
+        {
+            std::vector<float> row;
+            std::vector<float> scratch;
+            if (mip == 1)
+            {
+                row    .resize(size_t(srcW) * 4);
+                scratch.resize(size_t(srcW) * info.ChannelCount);
+            }
+
+            uint64_t count = 0;
+            for(auto y=begin; y<end; ++y)
+            {
+                const float* pRow = nullptr;
+                if (mip == 1)
+                {
+                    DecodeRow(src.pPixels + y * src.Pitch, srcW, info, scratch.data(), row.data());
+                    pRow = row.data();
+
+                    if (useCoverage)
+                    {
+                        for(auto x=0u; x<srcW; ++x)
+                        { count += (pRow[x * 4 + 3] > context.AlphaReference) ? 1 : 0; }
+                    }
+                }
+                else
+                { pRow = prevLevel.data() + y * srcW * 4; }
+
+                FilterRow(pRow, kernelX, dstW, temp.data() + y * dstW * 4);
+            }
+
+            if (count > 0)
+            { covered.fetch_add(count); }
+        });
+
+        if (mip == 1 && useCoverage)
+        { coverage = float(double(covered.load()) / (double(srcW) * srcH)); }
+
+        // 縦方向の縮小.
+        currLevel.resize(size_t(dstW) * dstH * 4);
+        asdx::ParallelFor(0, dstH, 0, [&](size_t y)
+        {
+            FilterColumn(
+                temp.data(),
+                dstW,
+                &kernelY.Index [y * kernelY.TapCount],
+                &kernelY.Weight[y * kernelY.TapCount],
+                kernelY.TapCount,
+                currLevel.data() + y * dstW * 4);
+        });
+
+        auto alphaScale = (useCoverage) ? CalcAlphaScale(currLevel, coverage, context.AlphaReference) : 1.0f;
+
+        // カイザーフィルタの負のローブで浮動小数点の色が負にならないようにする.
+        // UNORM は格納時にクランプされる. 次のレベルもクランプ後の値から求める.
+        auto clampColor = context.Filter == asdx::MIP_FILTER_KAISER
+                       && (info.Type == COMPONENT_TYPE_FLOAT16 || info.Type == COMPONENT_TYPE_FLOAT32);
+
+        // 格納フォーマットに変換する. 次のレベルは補正前の値から求める.
+        auto& dst = pDst[mip];
+        asdx::ParallelForRange(0, dstH, 0, [&](size_t begin, size_t end)
+        {
+            std::vector<float> scratch(size_t(dstW) * info.ChannelCount);
+            for(auto y=begin; y<end; ++y)
+            {
+                if (clampColor)
+                {
+                    auto pRow = currLevel.data() + y * dstW * 4;
+                    for(auto x=0u; x<dstW; ++x)
+                    {
+                        pRow[x * 4 + 0] = std::max(pRow[x * 4 + 0], 0.0f);
+                        pRow[x * 4 + 1] = std::max(pRow[x * 4 + 1], 0.0f);
+                        pRow[x * 4 + 2] = std::max(pRow[x * 4 + 2], 0.0f);
+                    }
+                }
+
+                EncodeRow(
+                    currLevel.data() + y * dstW * 4,
+                    dstW,
+                    info,
+                    alphaScale,
+                    scratch.data(),
+                    dst.pPixels + y * dst.Pitch);
+            }
+        });
+
+        std::swap(prevLevel, currLevel);
+    }
+}
+
+} // namespace /* anonymous */
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      ミップマップ生成に対応したフォーマットかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsMipMapSupportedFormat(uint32_t format)
+{
+    FormatInfo info;
+    return GetFormatInfo(format, info);
+}
+
+//-----------------------------------------------------------------------------
+//      リソーステクスチャのミップマップを生成します.
+//-----------------------------------------------------------------------------
+bool GenerateMipMaps(ResTexture& resTexture, MIP_FILTER filter, float alphaReference)
+{
+    if (resTexture.pResources == nullptr || resTexture.Width == 0 || resTexture.Height == 0)
+    {
+        ELOG("Error : Invalid Argument.");
+        return false;
+    }
+
+    if (resTexture.Dimension == TEXTURE_DIMENSION_3D)
+    {
+        ELOG("Error : Volume Texture is not supported.");
+        return false;
+    }
+
+    MipContext context;
+    context.Filter         = filter;
+    context.AlphaReference = alphaReference;
+
+    if (!GetFormatInfo(resTexture.Format, context.Info))
+    {
+        ELOG("Error : Unsupported Format. format = %u", resTexture.Format);
+        return false;
+    }
+
+    auto srcMipCount = (resTexture.MipMapCount > 0) ? resTexture.MipMapCount : 1;
+    auto surfaceCount = (resTexture.SurfaceCount > 0) ? resTexture.SurfaceCount : 1;
+
+    // 1x1 までのミップレベル数を求める.
+    auto mipCount = 1u;
+    for(auto size = std::max(resTexture.Width, resTexture.Height); size > 1; size >>= 1)
+    { mipCount++; }
+
+    // 出力サイズを求める.
+    size_t totalSize = 0;
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        auto& src = resTexture.pResources[i * srcMipCount];
+        if (src.pPixels == nullptr || src.Width != resTexture.Width || src.Height != resTexture.Height)
+        {
+            ELOG("Error : Invalid SubResource. index = %u", i * srcMipCount);
+            return false;
+        }
+
+        for(auto mip=0u; mip<mipCount; ++mip)
+        {
+            auto w = std::max(resTexture.Width  >> mip, 1u);
+            auto h = std::max(resTexture.Height >> mip, 1u);
+            totalSize += size_t(w) * h * context.Info.TexelSize;
+        }
+    }
+
+    auto count = surfaceCount * mipCount;
+    auto pResources = new (std::nothrow) SubResource[count];
+    if (pResources == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        return false;
+    }
+
+    auto pPixelData = new (std::nothrow) uint8_t[totalSize];
+    if (pPixelData == nullptr)
+    {
+        ELOG("Error : Out of Memory.");
+        delete[] pResources;
+        return false;
+    }
+
+    size_t offset = 0;
+    for(auto i=0u; i<surfaceCount; ++i)
+    {
+        for(auto mip=0u; mip<mipCount; ++mip)
+        {
+            auto& dst = pResources[i * mipCount + mip];
+            dst.Width      = std::max(resTexture.Width  >> mip, 1u);
+            dst.Height     = std::max(resTexture.Height >> mip, 1u);
+            dst.MipIndex   = mip;
+            dst.Pitch      = dst.Width * context.Info.TexelSize;
+            dst.SlicePitch = dst.Pitch * dst.Height;
+            dst.pPixels    = pPixelData + offset;
+            offset += dst.SlicePitch;
+        }
+    }
+
+    // 各レベルは前のレベルに依存するので，サーフェイスは順に処理してレベル内を並列化する.
+    for(auto i=0u; i<surfaceCount; ++i)
+    { GenerateSurface(context, resTexture.pResources[i * srcMipCount], mipCount, pResources + i * mipCount); }
+
+    // 元のデータを破棄して差し替える.
+    resTexture.Dispose();
+    resTexture.pResources   = pResources;
+    resTexture.pPixelData   = pPixelData;
+    resTexture.MipMapCount  = mipCount;
+    resTexture.SurfaceCount = surfaceCount;
+
+    return true;
+}
+
+} // namespace asdx
@@ -0,0 +1,927 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxResBvh.cpp
+// Desc : Bounding Volume Hierarchy for CPU Ray Queries.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <res/asdxResBvh.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxParallel.h>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #include <emmintrin.h>
+    #define ASDX_BVH_SSE2   (1)
+#endif
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kBinCount             = 16;           // SAH 評価に用いる最大ビン数.
+static const uint32_t kParallelSubtreeSize  = 1u << 14;     // これ未満の部分木は個別のタスクとして構築する.
+static const uint32_t kParallelBinningSize  = 1u << 16;     // これ以上の節はビン分割を並列に行う.
+static const uint32_t kMaxSahDepth          = 32;           // これより深い節は中央値で分割する.
+static const float    kTraversalCost        = 1.0f;         // 節を辿るコスト.
+static const float    kIntersectCost        = 1.0f;         // 三角形との交差判定コスト.
+static const float    kMinDirection         = 1e-20f;       // 逆数を取る際の方向成分の最小値.
+
+///////////////////////////////////////////////////////////////////////////////
+// NodeBounds structure
+///////////////////////////////////////////////////////////////////////////////
+struct NodeBounds
+{
+    asdx::BoundingBox   Box;        // 三角形を包むボックス.
+    asdx::BoundingBox   Center;     // 重心を包むボックス.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BinSet structure
+///////////////////////////////////////////////////////////////////////////////
+struct BinSet
+{
+    asdx::BoundingBox   Box  [3][kBinCount];    // ビンごとのボックス.
+    uint32_t            Count[3][kBinCount];    // ビンごとの三角形数.
+    uint32_t            BinCount;               // 使用するビン数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// BuildPrimitive structure
+///////////////////////////////////////////////////////////////////////////////
+struct BuildPrimitive
+{
+    asdx::BoundingBox   Box;        // 三角形を包むボックス.
+    asdx::Vector3       Center;     // 重心.
+    uint32_t            Index;      // 三角形番号.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SubtreeTask structure
+///////////////////////////////////////////////////////////////////////////////
+struct SubtreeTask
+{
+    uint32_t    NodeIndex;  // 部分木のルートを格納する節番号.
+    uint32_t    Begin;      // 開始番号.
+    uint32_t    End;        // 終了番号.
+    uint32_t    Depth;      // 深さ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// RayData structure
+///////////////////////////////////////////////////////////////////////////////
+struct RayData
+{
+#if defined(ASDX_BVH_SSE2)
+    __m128          Origin;     // 始点.
+    __m128          InvDir;     // 方向の逆数.
+#else
+    asdx::Vector3   Origin;     // 始点.
+    asdx::Vector3   InvDir;     // 方向の逆数.
+#endif
+    float           TMin;       // 最小距離.
+};
+
+//-----------------------------------------------------------------------------
+//      空のボックスを生成します.
+//-----------------------------------------------------------------------------
+inline asdx::BoundingBox EmptyBox()
+{
+    asdx::BoundingBox result;
+    result.Min = asdx::Vector3( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    result.Max = asdx::Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      ボックスを点を含むように拡張します.
+//-----------------------------------------------------------------------------
+inline void Grow(asdx::BoundingBox& box, const asdx::Vector3& point)
+{
+    box.Min = asdx::Vector3::Min(box.Min, point);
+    box.Max = asdx::Vector3::Max(box.Max, point);
+}
+
+//-----------------------------------------------------------------------------
+//      ボックスを別のボックスを含むように拡張します.
+//-----------------------------------------------------------------------------
+inline void Grow(asdx::BoundingBox& box, const asdx::BoundingBox& value)
+{
+    box.Min = asdx::Vector3::Min(box.Min, value.Min);
+    box.Max = asdx::Vector3::Max(box.Max, value.Max);
+}
+
+//-----------------------------------------------------------------------------
+//      表面積の半分を求めます.
+//-----------------------------------------------------------------------------
+inline float HalfArea(const asdx::BoundingBox& box)
+{
+    if (box.Max.x < box.Min.x)
+    { return 0.0f; }
+
+    auto d = box.Max - box.Min;
+    return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+//-----------------------------------------------------------------------------
+//      重心が属するビン番号を求めます.
+//-----------------------------------------------------------------------------
+inline uint32_t GetBinIndex(float value, float minValue, float scale, uint32_t binCount)
+{
+    auto index = int32_t((value - minValue) * scale);
+    return uint32_t(asdx::Clamp(index, 0, int32_t(binCount - 1)));
+}
+
+//-----------------------------------------------------------------------------
+//      範囲内の三角形のボックスと重心のボックスを求めます.
+//-----------------------------------------------------------------------------
+NodeBounds CalcNodeBounds(const BuildPrimitive* pPrimitives, uint32_t begin, uint32_t end, bool parallel)
+{
+    NodeBounds identity;
+    identity.Box    = EmptyBox();
+    identity.Center = EmptyBox();
+
+    auto func = [&](size_t b, size_t e, NodeBounds value)
+    {
+        for(auto i=b; i<e; ++i)
+        {
+            Grow(value.Box,    pPrimitives[i].Box);
+            Grow(value.Center, pPrimitives[i].Center);
+        }
+        return value;
+    };
+
+    if (!parallel)
+    { return func(begin, end, identity); }
+
+    return asdx::ParallelReduce(size_t(begin), size_t(end), 4096, identity, func,
+        [](NodeBounds lhs, const NodeBounds& rhs)
+        {
+            Grow(lhs.Box,    rhs.Box);
+            Grow(lhs.Center, rhs.Center);
+            return lhs;
+        });
+}
+
+//-----------------------------------------------------------------------------
+//      ビンを初期化します.
+//-----------------------------------------------------------------------------
+inline void ResetBins(BinSet& bins, uint32_t binCount)
+{
+    bins.BinCount = binCount;
+    for(auto axis=0; axis<3; ++axis)
+    {
+        for(auto i=0u; i<binCount; ++i)
+        {
+            bins.Box  [axis][i] = EmptyBox();
+            bins.Count[axis][i] = 0;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      範囲内の三角形をビンに加算します.
+//-----------------------------------------------------------------------------
+inline void AccumulateBins
+(
+    const BuildPrimitive*       pPrimitives,
+    size_t                      begin,
+    size_t                      end,
+    const asdx::Vector3&        minValue,
+    const float*                scale,
+    BinSet&                     bins
+)
+{
+    for(auto i=begin; i<end; ++i)
+    {
+        const auto& prim = pPrimitives[i];
+        for(auto axis=0; axis<3; ++axis)
+        {
+            auto bin = GetBinIndex(prim.Center[axis], minValue[axis], scale[axis], bins.BinCount);
+            Grow(bins.Box[axis][bin], prim.Box);
+            bins.Count[axis][bin]++;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      範囲内の三角形をビンに振り分けます.
+//-----------------------------------------------------------------------------
+void BinPrimitives
+(
+    const BuildPrimitive*       pPrimitives,
+    uint32_t                    begin,
+    uint32_t                    end,
+    const asdx::BoundingBox&    centerBox,
+    bool                        parallel,
+    BinSet&                     result
+)
+{
+    // 小さな節ではビン数を減らして評価コストを抑える.
+    auto binCount = asdx::Min(end - begin, kBinCount);
+    auto extent   = centerBox.Max - centerBox.Min;
+
+    float scale[3];
+    for(auto axis=0; axis<3; ++axis)
+    { scale[axis] = (extent[axis] > 0.0f) ? float(binCount) / extent[axis] : 0.0f; }
+
+    ResetBins(result, binCount);
+    if (!parallel)
+    {
+        AccumulateBins(pPrimitives, begin, end, centerBox.Min, scale, result);
+        return;
+    }
+
+    // ビンはサイズが大きいので，並列化は大きな節に限る.
+    result = asdx::ParallelReduce(size_t(begin), size_t(end), 4096, result,
+        [&](size_t b, size_t e, BinSet value)
+        {
+            AccumulateBins(pPrimitives, b, e, centerBox.Min, scale, value);
+            return value;
+        },
+        [](BinSet lhs, const BinSet& rhs)
+        {
+            for(auto axis=0; axis<3; ++axis)
+            {
+                for(auto i=0u; i<lhs.BinCount; ++i)
+                {
+                    Grow(lhs.Box[axis][i], rhs.Box[axis][i]);
+                    lhs.Count[axis][i] += rhs.Count[axis][i];
+                }
+            }
+            return lhs;
+        });
+}
+
+//-----------------------------------------------------------------------------
+//      SAH が最小となる分割を求めます.
+//-----------------------------------------------------------------------------
+bool FindSahSplit
+(
+    const BinSet&   bins,
+    float           parentArea,
+    uint32_t&       bestAxis,
+    uint32_t&       bestBin,
+    float&          bestCost
+)
+{
+    bestCost = FLT_MAX;
+    auto found = false;
+
+    for(auto axis=0u; axis<3; ++axis)
+    {
+        float    rightArea [kBinCount];
+        uint32_t rightCount[kBinCount];
+
+        auto box   = EmptyBox();
+        auto count = 0u;
+        for(auto i=bins.BinCount - 1; i>0; --i)
+        {
+            Grow(box, bins.Box[axis][i]);
+            count += bins.Count[axis][i];
+            rightArea [i] = HalfArea(box);
+            rightCount[i] = count;
+        }
+
+        box   = EmptyBox();
+        count = 0;
+        for(auto i=0u; i<bins.BinCount - 1; ++i)
+        {
+            Grow(box, bins.Box[axis][i]);
+            count += bins.Count[axis][i];
+
+            if (count == 0 || rightCount[i + 1] == 0)
+            { continue; }
+
+            auto cost = kTraversalCost + kIntersectCost
+                * (HalfArea(box) * float(count) + rightArea[i + 1] * float(rightCount[i + 1])) / parentArea;
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestBin  = i;
+                found    = true;
+            }
+        }
+    }
+
+    return found;
+}
+
+//-----------------------------------------------------------------------------
+//      重心の中央値で分割します.
+//-----------------------------------------------------------------------------
+uint32_t SplitMedian(BuildPrimitive* pPrimitives, uint32_t begin, uint32_t end, const NodeBounds& bounds, uint32_t& axis)
+{
+    auto extent = bounds.Center.Max - bounds.Center.Min;
+    axis = 0;
+    if (extent.y > extent[axis]) { axis = 1; }
+    if (extent.z > extent[axis]) { axis = 2; }
+
+    auto mid = begin + (end - begin) / 2;
+    std::nth_element(
+        pPrimitives + begin,
+        pPrimitives + mid,
+        pPrimitives + end,
+        [&](const BuildPrimitive& lhs, const BuildPrimitive& rhs)
+        { return lhs.Center[axis] < rhs.Center[axis]; });
+
+    return mid;
+}
+
+//-----------------------------------------------------------------------------
+//      節を構築します.
+//-----------------------------------------------------------------------------
+void BuildNode
+(
+    BuildPrimitive*             pPrimitives,
+    std::vector<asdx::BvhNode>& nodes,
+    uint32_t                    nodeIndex,
+    uint32_t                    begin,
+    uint32_t                    end,
+    uint32_t                    depth,
+    std::vector<SubtreeTask>*   pTasks
+)
+{
+    auto count  = end - begin;
+    auto top    = (pTasks != nullptr);
+    auto bounds = CalcNodeBounds(pPrimitives, begin, end, top && count >= kParallelBinningSize);
+
+    nodes[nodeIndex].Min = bounds.Box.Min;
+    nodes[nodeIndex].Max = bounds.Box.Max;
+
+    // 小さな部分木は後でまとめて並列に構築する.
+    if (top && count < kParallelSubtreeSize)
+    {
+        pTasks->push_back({ nodeIndex, begin, end, depth });
+        return;
+    }
+
+    auto     leaf = (count <= 1);
+    uint32_t axis = 0;
+    uint32_t mid  = begin;
+
+    if (!leaf && depth < kMaxSahDepth)
+    {
+        BinSet bins;
+        BinPrimitives(pPrimitives, begin, end, bounds.Center, top && count >= kParallelBinningSize, bins);
+
+        uint32_t bin  = 0;
+        float    cost = FLT_MAX;
+        if (FindSahSplit(bins, HalfArea(bounds.Box), axis, bin, cost))
+        {
+            // 分割しない方が安い場合は葉にする.
+            if (count <= asdx::ResBvh::kMaxLeafSize && cost >= float(count) * kIntersectCost)
+            { leaf = true; }
+            else
+            {
+                auto minValue = bounds.Center.Min[axis];
+                auto scale    = float(bins.BinCount) / (bounds.Center.Max[axis] - minValue);
+
+                auto ptr = std::partition(
+                    pPrimitives + begin,
+                    pPrimitives + end,
+                    [&](const BuildPrimitive& prim)
+                    { return GetBinIndex(prim.Center[axis], minValue, scale, bins.BinCount) <= bin; });
+                mid = uint32_t(ptr - pPrimitives);
+            }
+        }
+    }
+
+    // SAH で分割できない場合は中央値で分割する.
+    if (!leaf && (mid == begin || mid == end))
+    {
+        if (count <= asdx::ResBvh::kMaxLeafSize)
+        { leaf = true; }
+        else
+        { mid = SplitMedian(pPrimitives, begin, end, bounds, axis); }
+    }
+
+    if (leaf)
+    {
+        nodes[nodeIndex].Offset = begin;
+        nodes[nodeIndex].Count  = uint16_t(count);
+        nodes[nodeIndex].Axis   = 0;
+        return;
+    }
+
+    auto left = uint32_t(nodes.size());
+    nodes.resize(nodes.size() + 2);
+
+    nodes[nodeIndex].Offset = left;
+    nodes[nodeIndex].Count  = 0;
+    nodes[nodeIndex].Axis   = uint16_t(axis);
+
+    BuildNode(pPrimitives, nodes, left + 0, begin, mid, depth + 1, pTasks);
+    BuildNode(pPrimitives, nodes, left + 1, mid,   end, depth + 1, pTasks);
+}
+
+//-----------------------------------------------------------------------------
+//      方向成分の逆数を求めます.
+//-----------------------------------------------------------------------------
+inline float SafeInverse(float value)
+{
+    if (fabsf(value) > kMinDirection)
+    { return 1.0f / value; }
+
+    return (value >= 0.0f) ? 1.0f / kMinDirection : -1.0f / kMinDirection;
+}
+
+//-----------------------------------------------------------------------------
+//      走査用のレイデータを設定します.
+//-----------------------------------------------------------------------------
+inline void SetupRay(const asdx::BvhRay& ray, RayData& result)
+{
+    auto ix = SafeInverse(ray.Direction.x);
+    auto iy = SafeInverse(ray.Direction.y);
+    auto iz = SafeInverse(ray.Direction.z);
+
+#if defined(ASDX_BVH_SSE2)
+    result.Origin = _mm_setr_ps(ray.Origin.x, ray.Origin.y, ray.Origin.z, 0.0f);
+    result.InvDir = _mm_setr_ps(ix, iy, iz, 0.0f);
+#else
+    result.Origin = ray.Origin;
+    result.InvDir = asdx::Vector3(ix, iy, iz);
+#endif
+    result.TMin = ray.TMin;
+}
+
+//-----------------------------------------------------------------------------
+//      レイとボックスの交差判定を行います.
+//-----------------------------------------------------------------------------
+inline bool IntersectBox(const asdx::BvhNode& node, const RayData& ray, float tmax, float& tnear)
+{
+#if defined(ASDX_BVH_SSE2)
+    // w 成分には Offset/Count が入っているのでマスクしてから計算する.
+    auto mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    auto bmin = _mm_and_ps(_mm_loadu_ps(&node.Min.x), mask);
+    auto bmax = _mm_and_ps(_mm_loadu_ps(&node.Max.x), mask);
+
+    auto t0 = _mm_mul_ps(_mm_sub_ps(bmin, ray.Origin), ray.InvDir);
+    auto t1 = _mm_mul_ps(_mm_sub_ps(bmax, ray.Origin), ray.InvDir);
+    auto tn = _mm_min_ps(t0, t1);
+    auto tf = _mm_max_ps(t0, t1);
+
+    // w 成分は 0 なので，遠方側にだけ tmax を入れておく.
+    tf = _mm_or_ps(tf, _mm_andnot_ps(mask, _mm_set1_ps(tmax)));
+
+    tn = _mm_max_ps(tn, _mm_shuffle_ps(tn, tn, _MM_SHUFFLE(2, 3, 0, 1)));
+    tn = _mm_max_ps(tn, _mm_shuffle_ps(tn, tn, _MM_SHUFFLE(1, 0, 3, 2)));
+    tf = _mm_min_ps(tf, _mm_shuffle_ps(tf, tf, _MM_SHUFFLE(2, 3, 0, 1)));
+    tf = _mm_min_ps(tf, _mm_shuffle_ps(tf, tf, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    tnear = asdx::Max(_mm_cvtss_f32(tn), ray.TMin);
+    return tnear <= _mm_cvtss_f32(tf);
+#else
+    auto t0 = (node.Min - ray.Origin);
+    auto t1 = (node.Max - ray.Origin);
+
+    auto tfar = tmax;
+    tnear = ray.TMin;
+    for(auto axis=0; axis<3; ++axis)
+    {
+        auto a = t0[axis] * ray.InvDir[axis];
+        auto b = t1[axis] * ray.InvDir[axis];
+        tnear = asdx::Max(tnear, asdx::Min(a, b));
+        tfar  = asdx::Min(tfar,  asdx::Max(a, b));
+    }
+
+    return tnear <= tfar;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//      レイと三角形の交差判定を行います.
+//-----------------------------------------------------------------------------
+inline bool IntersectTriangle
+(
+    const asdx::BvhTriangle&    tri,
+    const asdx::BvhRay&         ray,
+    float                       tmax,
+    float&                      t,
+    float&                      u,
+    float&                      v
+)
+{
+    // Möller-Trumbore.
+    auto p   = asdx::Vector3::Cross(ray.Direction, tri.E2);
+    auto det = asdx::Vector3::Dot(tri.E1, p);
+    if (fabsf(det) <= FLT_MIN)
+    { return false; }
+
+    auto invDet = 1.0f / det;
+    auto s = ray.Origin - tri.P0;
+
+    u = asdx::Vector3::Dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f)
+    { return false; }
+
+    auto q = asdx::Vector3::Cross(s, tri.E1);
+    v = asdx::Vector3::Dot(ray.Direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f)
+    { return false; }
+
+    t = asdx::Vector3::Dot(tri.E2, q) * invDet;
+    return (ray.TMin <= t && t < tmax);
+}
+
+//-----------------------------------------------------------------------------
+//      三角形を生成します.
+//-----------------------------------------------------------------------------
+inline asdx::BvhTriangle MakeTriangle
+(
+    const asdx::Vector3&    p0,
+    const asdx::Vector3&    p1,
+    const asdx::Vector3&    p2,
+    uint32_t                primitiveId
+)
+{
+    asdx::BvhTriangle result;
+    result.P0          = p0;
+    result.E1          = p1 - p0;
+    result.E2          = p2 - p0;
+    result.PrimitiveId = primitiveId;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュの三角形を追加します.
+//-----------------------------------------------------------------------------
+bool AppendTriangles(const asdx::ResMesh& mesh, std::vector<asdx::BvhTriangle>& triangles)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto faceCount   = mesh.VertexIndices.size() / 3;
+    auto base        = triangles.size();
+    triangles.resize(base + faceCount);
+
+    for(size_t i=0; i<faceCount; ++i)
+    {
+        auto i0 = mesh.VertexIndices[i * 3 + 0];
+        auto i1 = mesh.VertexIndices[i * 3 + 1];
+        auto i2 = mesh.VertexIndices[i * 3 + 2];
+
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        {
+            ELOGA("Error : Invalid Vertex Index. triangle = %zu", i);
+            return false;
+        }
+
+        triangles[base + i] = MakeTriangle(
+            mesh.Positions[i0],
+            mesh.Positions[i1],
+            mesh.Positions[i2],
+            uint32_t(base + i));
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+namespace asdx {
+
+///////////////////////////////////////////////////////////////////////////////
+// ResBvh class
+///////////////////////////////////////////////////////////////////////////////
+
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+ResBvh::ResBvh()
+{ /* DO_NOTHING */ }
+
+//-----------------------------------------------------------------------------
+//      メッシュの三角形から構築します.
+//-----------------------------------------------------------------------------
+bool ResBvh::Build(const ResMesh& mesh)
+{
+    Dispose();
+
+    std::vector<BvhTriangle> triangles;
+    if (!AppendTriangles(mesh, triangles))
+    { return false; }
+
+    m_MeshOffsets.push_back(0);
+
+    return BuildTree(triangles);
+}
+
+//-----------------------------------------------------------------------------
+//      モデルの全メッシュの三角形から構築します.
+//-----------------------------------------------------------------------------
+bool ResBvh::Build(const ResModel& model)
+{
+    Dispose();
+
+    std::vector<BvhTriangle> triangles;
+    m_MeshOffsets.reserve(model.Meshes.size());
+
+    for(const auto& mesh : model.Meshes)
+    {
+        m_MeshOffsets.push_back(uint32_t(triangles.size()));
+        if (!AppendTriangles(mesh, triangles))
+        {
+            Dispose();
+            return false;
+        }
+    }
+
+    return BuildTree(triangles);
+}
+
+//-----------------------------------------------------------------------------
+//      破棄処理を行います.
+//-----------------------------------------------------------------------------
+void ResBvh::Dispose()
+{
+    m_Nodes      .clear();
+    m_Triangles  .clear();
+    m_MeshOffsets.clear();
+
+    m_Nodes      .shrink_to_fit();
+    m_Triangles  .shrink_to_fit();
+    m_MeshOffsets.shrink_to_fit();
+}
+
+//-----------------------------------------------------------------------------
+//      木構造を構築します.
+//-----------------------------------------------------------------------------
+bool ResBvh::BuildTree(const std::vector<BvhTriangle>& triangles)
+{
+    if (triangles.empty())
+    {
+        ELOG("Error : Triangle is empty.");
+        Dispose();
+        return false;
+    }
+
+    if (triangles.size() >= UINT32_MAX)
+    {
+        ELOG("Error : Too many triangles. count = %zu", triangles.size());
+        Dispose();
+        return false;
+    }
+
+    auto count = uint32_t(triangles.size());
+
+    std::vector<BuildPrimitive> primitives(count);
+
+    ParallelFor(0, count, 0, [&](size_t i)
+    {
+        const auto& tri = triangles[i];
+        auto p1 = tri.P0 + tri.E1;
+        auto p2 = tri.P0 + tri.E2;
+
+        auto& prim = primitives[i];
+        prim.Box.Min = Vector3::Min(tri.P0, Vector3::Min(p1, p2));
+        prim.Box.Max = Vector3::Max(tri.P0, Vector3::Max(p1, p2));
+        prim.Center  = (prim.Box.Min + prim.Box.Max) * 0.5f;
+        prim.Index   = uint32_t(i);
+    });
+
+    // 上位の節は大きな範囲を並列に処理しながら構築し，
+    // 残りの部分木はタスクごとに独立して構築する.
+    std::vector<SubtreeTask> tasks;
+    m_Nodes.reserve(count * 2 / kMaxLeafSize + 1);
+    m_Nodes.resize(1);
+    BuildNode(primitives.data(), m_Nodes, 0, 0, count, 0, &tasks);
+
+    std::vector<std::vector<BvhNode>> subtrees(tasks.size());
+    ParallelFor(0, tasks.size(), 1, [&](size_t i)
+    {
+        const auto& task = tasks[i];
+        subtrees[i].reserve((task.End - task.Begin) * 2 / kMaxLeafSize + 1);
+        subtrees[i].resize(1);
+        BuildNode(primitives.data(), subtrees[i], 0, task.Begin, task.End, task.Depth, nullptr);
+    });
+
+    // 部分木を連結する. 部分木のルートは予約済みの節に置き，残りを末尾に追加する.
+    for(size_t i=0; i<tasks.size(); ++i)
+    {
+        const auto& subtree = subtrees[i];
+        auto base = uint32_t(m_Nodes.size()) - 1;
+
+        for(size_t j=0; j<subtree.size(); ++j)
+        {
+            auto node = subtree[j];
+            if (node.Count == 0)
+            { node.Offset += base; }
+
+            if (j == 0)
+            { m_Nodes[tasks[i].NodeIndex] = node; }
+            else
+            { m_Nodes.push_back(node); }
+        }
+    }
+
+    m_Nodes.shrink_to_fit();
+
+    // 葉の順に三角形を並び替えておく.
+    m_Triangles.resize(count);
+    ParallelFor(0, count, 0, [&](size_t i)
+    { m_Triangles[i] = triangles[primitives[i].Index]; });
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      三角形番号をメッシュ番号とメッシュ内の番号に変換します.
+//-----------------------------------------------------------------------------
+void ResBvh::ResolveHit(BvhHit& hit) const
+{
+    auto itr = std::upper_bound(m_MeshOffsets.begin(), m_MeshOffsets.end(), hit.TriangleId);
+    hit.MeshId      = uint32_t(itr - m_MeshOffsets.begin()) - 1;
+    hit.TriangleId -= m_MeshOffsets[hit.MeshId];
+}
+
+//-----------------------------------------------------------------------------
+//      最も近い交差を求めます.
+//-----------------------------------------------------------------------------
+bool ResBvh::Intersect(const BvhRay& ray, BvhHit& hit) const
+{
+    hit = BvhHit();
+    if (m_Nodes.empty())
+    { return false; }
+
+    RayData data;
+    SetupRay(ray, data);
+
+    auto  tmax  = ray.TMax;
+    float tnear = 0.0f;
+    if (!IntersectBox(m_Nodes[0], data, tmax, tnear))
+    { return false; }
+
+    uint32_t stack   [kStackSize];
+    float    distance[kStackSize];
+    uint32_t top   = 0;
+    uint32_t index = 0;
+
+    for(;;)
+    {
+        const auto& node = m_Nodes[index];
+        if (node.Count > 0)
+        {
+            for(auto i=0u; i<node.Count; ++i)
+            {
+                const auto& tri = m_Triangles[node.Offset + i];
+                float t, u, v;
+                if (IntersectTriangle(tri, ray, tmax, t, u, v))
+                {
+                    tmax           = t;
+                    hit.Distance   = t;
+                    hit.U          = u;
+                    hit.V          = v;
+                    hit.TriangleId = tri.PrimitiveId;
+                }
+            }
+        }
+        else
+        {
+            float t0, t1;
+            auto hit0 = IntersectBox(m_Nodes[node.Offset + 0], data, tmax, t0);
+            auto hit1 = IntersectBox(m_Nodes[node.Offset + 1], data, tmax, t1);
+
+            if (hit0 && hit1)
+            {
+                // 近い方を先に辿る.
+                assert(top < kStackSize);
+                auto nearFirst = (t0 <= t1);
+                stack   [top] = node.Offset + (nearFirst ? 1 : 0);
+                distance[top] = nearFirst ? t1 : t0;
+                top++;
+                index = node.Offset + (nearFirst ? 0 : 1);
+                continue;
+            }
+            else if (hit0)
+            {
+                index = node.Offset + 0;
+                continue;
+            }
+            else if (hit1)
+            {
+                index = node.Offset + 1;
+                continue;
+            }
+        }
+
+        // 既に見つかった交差より遠いものは辿らない.
+        while(top > 0 && distance[top - 1] > tmax)
+        { top--; }
+
+        if (top == 0)
+        { break; }
+
+        index = stack[--top];
+    }
+
+    if (hit.TriangleId == UINT32_MAX)
+    { return false; }
+
+    ResolveHit(hit);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      いずれかの三角形と交差するかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool ResBvh::Occluded(const BvhRay& ray) const
+{
+    if (m_Nodes.empty())
+    { return false; }
+
+    RayData data;
+    SetupRay(ray, data);
+
+    uint32_t stack[kStackSize];
+    uint32_t top = 0;
+    stack[top++] = 0;
+
+    while(top > 0)
+    {
+        const auto& node = m_Nodes[stack[--top]];
+
+        float tnear;
+        if (!IntersectBox(node, data, ray.TMax, tnear))
+        { continue; }
+
+        if (node.Count > 0)
+        {
+            for(auto i=0u; i<node.Count; ++i)
+            {
+                float t, u, v;
+                if (IntersectTriangle(m_Triangles[node.Offset + i], ray, ray.TMax, t, u, v))
+                { return true; }
+            }
+        }
+        else
+        {
+            assert(top + 2 <= kStackSize);
+            stack[top++] = node.Offset + 1;
+            stack[top++] = node.Offset + 0;
+        }
+    }
+
+    return false;
+}
+
+//-----------------------------------------------------------------------------
+//      複数のレイについて最も近い交差を並列に求めます.
+//-----------------------------------------------------------------------------
+void ResBvh::Intersect(const BvhRay* pRays, uint32_t count, BvhHit* pHits) const
+{
+    assert(count == 0 || (pRays != nullptr && pHits != nullptr));
+    ParallelFor(0, count, 64, [&](size_t i)
+    { Intersect(pRays[i], pHits[i]); });
+}
+
+//-----------------------------------------------------------------------------
+//      複数のレイについて遮蔽判定を並列に行います.
+//-----------------------------------------------------------------------------
+void ResBvh::Occluded(const BvhRay* pRays, uint32_t count, bool* pResults) const
+{
+    assert(count == 0 || (pRays != nullptr && pResults != nullptr));
+    ParallelFor(0, count, 64, [&](size_t i)
+    { pResults[i] = Occluded(pRays[i]); });
+}
+
+//-----------------------------------------------------------------------------
+//      全体のバウンディングボックスを取得します.
+//-----------------------------------------------------------------------------
+BoundingBox ResBvh::GetBounds() const
+{
+    if (m_Nodes.empty())
+    { return BoundingBox{ Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 0.0f, 0.0f) }; }
+
+    return BoundingBox{ m_Nodes[0].Min, m_Nodes[0].Max };
+}
+
+//-----------------------------------------------------------------------------
+//      ノード数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t ResBvh::GetNodeCount() const
+{ return uint32_t(m_Nodes.size()); }
+
+//-----------------------------------------------------------------------------
+//      ノードを取得します.
+//-----------------------------------------------------------------------------
+const BvhNode* ResBvh::GetNodes() const
+{ return m_Nodes.data(); }
+
+//-----------------------------------------------------------------------------
+//      三角形数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t ResBvh::GetTriangleCount() const
+{ return uint32_t(m_Triangles.size()); }
+
+//-----------------------------------------------------------------------------
+//      葉の順に並び替えた三角形を取得します.
+//-----------------------------------------------------------------------------
+const BvhTriangle* ResBvh::GetTriangles() const
+{ return m_Triangles.data(); }
+
+} // namespace asdx
@@ -10,6 +10,12 @@
 #include <res/asdxResModel.h>
 #include <fnd/asdxLogger.h>
 #include <fnd/asdxMisc.h>
+#include <fnd/asdxParallel.h>
+#include <fnd/asdxMappedFile.h>
+#include <meshoptimizer.h>
+#include <cstdio>
+#include <cassert>
+#include <cfloat>
 #include <fstream>
 #include <algorithm>
 #include <tuple>
@@ -39,172 +45,1873 @@ struct IndexOBJ
     uint32_t    U;      //!< テクスチャ座標.
 };
 
+///////////////////////////////////////////////////////////////////////////////
+// CommandOBJ structure
+///////////////////////////////////////////////////////////////////////////////
+struct CommandOBJ
+{
+    enum TYPE
+    {
+        GROUP,      //!< g.
+        USEMTL,     //!< usemtl.
+        MTLLIB,     //!< mtllib.
+    };
+
+    TYPE        Type;           //!< コマンドの種類.
+    std::string Name;           //!< 引数.
+    uint32_t    IndexOffset;    //!< コマンド出現時点のチャンク内頂点インデックス数.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// ChunkOBJ structure
+///////////////////////////////////////////////////////////////////////////////
+struct ChunkOBJ
+{
+    const char*                 pBegin  = nullptr;  //!< チャンク先頭.
+    const char*                 pEnd    = nullptr;  //!< チャンク終端(含みません).
+    std::vector<asdx::Vector3>  Positions;          //!< 位置座標.
+    std::vector<asdx::Vector3>  Normals;            //!< 法線ベクトル.
+    std::vector<asdx::Vector2>  TexCoords;          //!< テクスチャ座標.
+    std::vector<IndexOBJ>       Indices;            //!< 頂点インデックス.
+    std::vector<uint32_t>       RelativeSlots;      //!< チャンク先頭からの相対値で格納したインデックス (要素番号 * 3 + 属性番号).
+    std::vector<CommandOBJ>     Commands;           //!< コマンド.
+};
 
 //-----------------------------------------------------------------------------
-//      法線ベクトルを計算します.
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const size_t kMinChunkSizeOBJ = 256 * 1024;  // 並列パースする際の最小チャンクサイズ.
+static const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+//-----------------------------------------------------------------------------
+//      数字かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsDigit(char c)
+{ return uint32_t(c - '0') < 10u; }
+
+//-----------------------------------------------------------------------------
+//      空白文字かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsSpace(char c)
+{ return c == ' ' || c == '\t'; }
+
 //-----------------------------------------------------------------------------
-void CalcNormals(asdx::ResMesh& mesh)
+//      行内の空白を読み飛ばします.
+//-----------------------------------------------------------------------------
+inline void SkipSpace(const char*& ptr, const char* end)
 {
-    auto vertexCount = mesh.Positions.size();
-    std::vector<asdx::Vector3> normals;
-    normals.resize(vertexCount);
+    while(ptr < end && IsSpace(*ptr))
+    { ++ptr; }
+}
+
+//-----------------------------------------------------------------------------
+//      次の行の先頭まで読み飛ばします.
+//-----------------------------------------------------------------------------
+inline void SkipLine(const char*& ptr, const char* end)
+{
+    auto pos = static_cast<const char*>(memchr(ptr, '\n', size_t(end - ptr)));
+    ptr = (pos != nullptr) ? pos + 1 : end;
+}
+
+//-----------------------------------------------------------------------------
+//      キーワードに一致するかどうかチェックし，一致した場合は読み進めます.
+//-----------------------------------------------------------------------------
+inline bool MatchKeyword(const char*& ptr, const char* end, const char* keyword, size_t length)
+{
+    if (size_t(end - ptr) <= length)
+    { return false; }
 
-    // 法線データ初期化.
-    for(size_t i=0; i<vertexCount; ++i)
+    if (memcmp(ptr, keyword, length) != 0 || !IsSpace(ptr[length]))
+    { return false; }
+
+    ptr += length;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      整数をパースします.
+//-----------------------------------------------------------------------------
+inline bool ParseInt(const char*& ptr, const char* end, int32_t& result)
+{
+    auto p = ptr;
+
+    auto negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
     {
-        normals[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
+        negative = (*p == '-');
+        ++p;
     }
 
-    auto indexCount = mesh.VertexIndices.size();
-    for(size_t i=0; i<indexCount; i+=3)
+    if (p >= end || !IsDigit(*p))
+    { return false; }
+
+    int64_t value = 0;
+    for(; p < end && IsDigit(*p); ++p)
     {
-        auto i0 = mesh.VertexIndices[i + 0];
-        auto i1 = mesh.VertexIndices[i + 1];
-        auto i2 = mesh.VertexIndices[i + 2];
+        if (value < INT32_MAX)
+        { value = value * 10 + (*p - '0'); }
+    }
 
-        const auto& p0 = mesh.Positions[i0];
-        const auto& p1 = mesh.Positions[i1];
-        const auto& p2 = mesh.Positions[i2];
+    if (value > INT32_MAX)
+    { value = INT32_MAX; }
+
+    result = int32_t(negative ? -value : value);
+    ptr    = p;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      浮動小数をパースします.
+//-----------------------------------------------------------------------------
+inline bool ParseFloat(const char*& ptr, const char* end, float& result)
+{
+    auto p = ptr;
+
+    auto negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    // 仮数部は上位19桁まで保持し，残りは指数に繰り込む.
+    uint64_t mantissa = 0;
+    int32_t  digits   = 0;
+    int32_t  exponent = 0;
+    auto     found    = false;
+
+    for(; p < end && IsDigit(*p); ++p)
+    {
+        found = true;
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+            { digits++; }
+        }
+        else
+        { exponent++; }
+    }
+
+    if (p < end && *p == '.')
+    {
+        ++p;
+        for(; p < end && IsDigit(*p); ++p)
+        {
+            found = true;
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                { digits++; }
+                exponent--;
+            }
+        }
+    }
+
+    if (!found)
+    { return false; }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        auto q = p + 1;
+        int32_t e = 0;
+        if (ParseInt(q, end, e))
+        {
+            exponent += (e < -1000) ? -1000 : (e > 1000) ? 1000 : e;
+            p = q;
+        }
+    }
+
+    auto value = double(mantissa);
+    if (mantissa != 0)
+    {
+        if (exponent < 0)
+        {
+            for(; exponent < -22; exponent += 22)
+            { value /= kPow10[22]; }
+            value /= kPow10[-exponent];
+        }
+        else
+        {
+            for(; exponent > 22; exponent -= 22)
+            { value *= kPow10[22]; }
+            value *= kPow10[exponent];
+        }
+    }
+
+    result = float(negative ? -value : value);
+    ptr    = p;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      空白で区切られた名前をパースします.
+//-----------------------------------------------------------------------------
+inline std::string ParseName(const char*& ptr, const char* end)
+{
+    SkipSpace(ptr, end);
+
+    auto begin = ptr;
+    while(ptr < end && !IsSpace(*ptr) && *ptr != '\r' && *ptr != '\n')
+    { ++ptr; }
+
+    return std::string(begin, ptr);
+}
+
+//-----------------------------------------------------------------------------
+//      OBJのインデックスを0始まりに変換します.
+//-----------------------------------------------------------------------------
+inline uint32_t ResolveIndex(int32_t value, size_t localCount, bool& relative)
+{
+    // 負値は直前の要素からの相対指定. チャンク先頭からの相対値にしておき，マージ時に確定させる.
+    if (value < 0)
+    {
+        relative = true;
+        return uint32_t(int64_t(localCount) + value);
+    }
+
+    relative = false;
+    return (value > 0) ? uint32_t(value - 1) : UINT32_MAX;
+}
+
+//-----------------------------------------------------------------------------
+//      面を構成する頂点をパースします.
+//-----------------------------------------------------------------------------
+inline bool ParseFaceVertex(const char*& ptr, const char* end, const ChunkOBJ& chunk, IndexOBJ& index, uint32_t& relativeMask)
+{
+    int32_t p = 0;
+    int32_t t = 0;
+    int32_t n = 0;
+
+    if (!ParseInt(ptr, end, p))
+    { return false; }
 
-        // エッジ.
-        auto e0 = p1 - p0;
-        auto e1 = p2 - p0;
+    if (ptr < end && *ptr == '/')
+    {
+        ++ptr;
 
-        // 面法線を算出.
-        auto fn = asdx::Vector3::Cross(e0, e1);
-        fn = asdx::Vector3::SafeNormalize(fn, fn);
+        // テクスチャ座標インデックス.
+        if (ptr < end && *ptr != '/')
+        { ParseInt(ptr, end, t); }
 
-        // 面法線を加算.
-        normals[i0] += fn;
-        normals[i1] += fn;
-        normals[i2] += fn;
+        // 法線インデックス.
+        if (ptr < end && *ptr == '/')
+        {
+            ++ptr;
+            ParseInt(ptr, end, n);
+        }
     }
 
-    // 加算した法線を正規化し，頂点法線を求める.
-    for(size_t i=0; i<vertexCount; ++i)
+    bool rp, rn, rt;
+    index.P = ResolveIndex(p, chunk.Positions.size(), rp);
+    index.N = ResolveIndex(n, chunk.Normals  .size(), rn);
+    index.U = ResolveIndex(t, chunk.TexCoords.size(), rt);
+
+    relativeMask = (rp ? 0x1 : 0) | (rn ? 0x2 : 0) | (rt ? 0x4 : 0);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      面の頂点インデックスを追加します.
+//-----------------------------------------------------------------------------
+inline void PushIndex(ChunkOBJ& chunk, const IndexOBJ& index, uint32_t relativeMask)
+{
+    if (relativeMask != 0)
     {
-        normals[i] = asdx::Vector3::SafeNormalize(normals[i], normals[i]);
+        auto slot = uint32_t(chunk.Indices.size() * 3);
+        for(auto i=0u; i<3; ++i)
+        {
+            if (relativeMask & (1u << i))
+            { chunk.RelativeSlots.push_back(slot + i); }
+        }
     }
 
-    const auto SMOOTHING_ANGLE = 59.7f;
-    auto cosSmooth = cosf(asdx::ToDegree(SMOOTHING_ANGLE));
+    chunk.Indices.push_back(index);
+}
+
+//-----------------------------------------------------------------------------
+//      チャンクをパースします.
+//-----------------------------------------------------------------------------
+void ParseChunkOBJ(ChunkOBJ& chunk)
+{
+    auto ptr = chunk.pBegin;
+    auto end = chunk.pEnd;
 
-    // スムージング処理.
-    for(size_t i=0; i<indexCount; i+=3)
+    while(ptr < end)
     {
-        auto i0 = mesh.VertexIndices[i + 0];
-        auto i1 = mesh.VertexIndices[i + 1];
-        auto i2 = mesh.VertexIndices[i + 2];
+        SkipSpace(ptr, end);
+        if (ptr >= end)
+        { break; }
 
-        const auto& p0 = mesh.Positions[i0];
-        const auto& p1 = mesh.Positions[i1];
-        const auto& p2 = mesh.Positions[i2];
+        if (ptr[0] == 'v')
+        {
+            if (MatchKeyword(ptr, end, "v", 1))
+            {
+                asdx::Vector3 v(0.0f, 0.0f, 0.0f);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, v.x);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, v.y);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, v.z);
+                chunk.Positions.push_back(v);
+            }
+            else if (MatchKeyword(ptr, end, "vt", 2))
+            {
+                asdx::Vector2 vt(0.0f, 0.0f);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, vt.x);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, vt.y);
+                chunk.TexCoords.push_back(vt);
+            }
+            else if (MatchKeyword(ptr, end, "vn", 2))
+            {
+                asdx::Vector3 vn(0.0f, 0.0f, 0.0f);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, vn.x);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, vn.y);
+                SkipSpace(ptr, end); ParseFloat(ptr, end, vn.z);
+                chunk.Normals.push_back(vn);
+            }
+        }
+        else if (MatchKeyword(ptr, end, "f", 1))
+        {
+            // 多角形は扇状に三角形分割する.
+            IndexOBJ first = {}, prev = {}, curr = {};
+            uint32_t firstMask = 0, prevMask = 0, currMask = 0;
+            uint32_t count = 0;
+
+            for(;;)
+            {
+                SkipSpace(ptr, end);
+                if (!ParseFaceVertex(ptr, end, chunk, curr, currMask))
+                { break; }
+
+                if (count == 0)
+                {
+                    first     = curr;
+                    firstMask = currMask;
+                }
+                else if (count >= 2)
+                {
+                    PushIndex(chunk, first, firstMask);
+                    PushIndex(chunk, prev,  prevMask);
+                    PushIndex(chunk, curr,  currMask);
+                }
+
+                prev     = curr;
+                prevMask = currMask;
+                count++;
+            }
+        }
+        else if (MatchKeyword(ptr, end, "g", 1))
+        {
+            CommandOBJ cmd = { CommandOBJ::GROUP, ParseName(ptr, end), uint32_t(chunk.Indices.size()) };
+            chunk.Commands.emplace_back(cmd);
+        }
+        else if (MatchKeyword(ptr, end, "usemtl", 6))
+        {
+            CommandOBJ cmd = { CommandOBJ::USEMTL, ParseName(ptr, end), uint32_t(chunk.Indices.size()) };
+            chunk.Commands.emplace_back(cmd);
+        }
+        else if (MatchKeyword(ptr, end, "mtllib", 6))
+        {
+            CommandOBJ cmd = { CommandOBJ::MTLLIB, ParseName(ptr, end), uint32_t(chunk.Indices.size()) };
+            chunk.Commands.emplace_back(cmd);
+        }
+
+        SkipLine(ptr, end);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを行単位のチャンクに分割します.
+//-----------------------------------------------------------------------------
+void SplitChunksOBJ(const char* data, size_t size, size_t count, std::vector<ChunkOBJ>& chunks)
+{
+    auto end = data + size;
+    auto ptr = data;
+
+    chunks.resize(count);
+    for(size_t i=0; i<count; ++i)
+    {
+        auto next = (i + 1 == count) ? end : data + size * (i + 1) / count;
+        if (next < ptr)
+        { next = ptr; }
+
+        // 行の途中で分割しないよう，次の行頭まで進める.
+        if (next < end && next > data && next[-1] != '\n')
+        { SkipLine(next, end); }
+
+        chunks[i].pBegin = ptr;
+        chunks[i].pEnd   = next;
+        ptr = next;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+// 共有スレッドプールで隣接情報を構築して頂点ごとに集める最小ワーカー数(呼び出しスレッドを含む).
+// 並列構築の総処理量は直接加算の約 1.6 倍なので，これ未満の場合は面の順に直接加算する.
+// 分岐点は test/res/asdxVertexFaceAdjacencyBench.cpp で計測する.
+static const size_t kMinAdjacencyWorkers = 3;
+
+// 面数を数えるチャンクの最大数. チャンクごとに頂点数分のカウンタを持つので上限を設ける.
+static const size_t kMaxAdjacencyChunks = 8;
+
+// 1チャンクあたりの最小面数.
+static const size_t kMinAdjacencyChunkFaces = 16 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+// VertexFaceAdjacency structure
+///////////////////////////////////////////////////////////////////////////////
+struct VertexFaceAdjacency
+{
+    std::vector<uint32_t>   Offsets;    // 頂点ごとの開始位置 (頂点数 + 1 個).
+    std::vector<uint32_t>   Faces;      // 頂点を共有する面番号 (昇順).
+};
+
+//-----------------------------------------------------------------------------
+//      ワーカー数を取得します.
+//-----------------------------------------------------------------------------
+inline size_t GetWorkerCount(asdx::IThreadPool* pThreadPool)
+{ return (pThreadPool != nullptr) ? size_t(pThreadPool->GetThreadCount()) + 1 : 1; }
+
+//-----------------------------------------------------------------------------
+//      頂点から面への隣接情報を CSR 形式で並列に構築します.
+//-----------------------------------------------------------------------------
+void BuildVertexFaceAdjacency
+(
+    asdx::IThreadPool*              pThreadPool,
+    const std::vector<uint32_t>&    indices,
+    size_t                          vertexCount,
+    VertexFaceAdjacency&            result
+)
+{
+    auto faceCount  = indices.size() / 3;
+    auto chunkCount = std::min(GetWorkerCount(pThreadPool), kMaxAdjacencyChunks);
+    chunkCount = std::max<size_t>(1, std::min(chunkCount, faceCount / kMinAdjacencyChunkFaces));
+
+    // 面を連続したチャンクに分け，チャンクごとに頂点の面数を数える.
+    // 各チャンクは自分のカウンタにしか書き込まないので，アトミック操作は不要.
+    std::vector<uint32_t> counts(chunkCount * vertexCount, 0);
+    asdx::ParallelFor(pThreadPool, 0, chunkCount, 1, [&](size_t c)
+    {
+        auto begin  = faceCount * c       / chunkCount;
+        auto end    = faceCount * (c + 1) / chunkCount;
+        auto pCount = counts.data() + c * vertexCount;
+
+        for(auto i=begin * 3; i<end * 3; ++i)
+        {
+            auto index = indices[i];
+            if (index < vertexCount)
+            { pCount[index]++; }
+        }
+    });
+
+    // 頂点ごとの面数を合計する.
+    result.Offsets.resize(vertexCount + 1);
+    result.Offsets[0] = 0;
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
+    {
+        uint32_t sum = 0;
+        for(size_t c=0; c<chunkCount; ++c)
+        { sum += counts[c * vertexCount + i]; }
+        result.Offsets[i + 1] = sum;
+    });
+
+    // 累積和を取る. ブロックごとの合計を求めてから，ブロック内を並列に累積する.
+    auto blockCount = chunkCount;
+    std::vector<uint32_t> blockSums(blockCount + 1, 0);
+    asdx::ParallelFor(pThreadPool, 0, blockCount, 1, [&](size_t b)
+    {
+        auto begin = 1 + vertexCount * b       / blockCount;
+        auto end   = 1 + vertexCount * (b + 1) / blockCount;
+
+        uint32_t sum = 0;
+        for(auto i=begin; i<end; ++i)
+        { sum += result.Offsets[i]; }
+        blockSums[b + 1] = sum;
+    });
+
+    for(size_t b=0; b<blockCount; ++b)
+    { blockSums[b + 1] += blockSums[b]; }
+
+    asdx::ParallelFor(pThreadPool, 0, blockCount, 1, [&](size_t b)
+    {
+        auto begin = 1 + vertexCount * b       / blockCount;
+        auto end   = 1 + vertexCount * (b + 1) / blockCount;
+
+        auto sum = blockSums[b];
+        for(auto i=begin; i<end; ++i)
+        {
+            sum += result.Offsets[i];
+            result.Offsets[i] = sum;
+        }
+    });
+
+    // チャンクごとの書き込み開始位置に置き換える.
+    // 前のチャンクほど前に詰めるので，頂点ごとの面番号は昇順になる.
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
+    {
+        auto pos = result.Offsets[i];
+        for(size_t c=0; c<chunkCount; ++c)
+        {
+            auto count = counts[c * vertexCount + i];
+            counts[c * vertexCount + i] = pos;
+            pos += count;
+        }
+    });
 
-        // エッジ.
-        auto e0 = p1 - p0;
-        auto e1 = p2 - p0;
+    // 面番号を詰める.
+    result.Faces.resize(result.Offsets[vertexCount]);
+    asdx::ParallelFor(pThreadPool, 0, chunkCount, 1, [&](size_t c)
+    {
+        auto begin   = faceCount * c       / chunkCount;
+        auto end     = faceCount * (c + 1) / chunkCount;
+        auto pCursor = counts.data() + c * vertexCount;
 
-        // 面法線を算出.
-        auto fn = asdx::Vector3::Cross(e0, e1);
-        fn = asdx::Vector3::SafeNormalize(fn, fn);
+        for(auto i=begin; i<end; ++i)
+        {
+            for(auto j=0; j<3; ++j)
+            {
+                auto index = indices[i * 3 + j];
+                if (index < vertexCount)
+                { result.Faces[pCursor[index]++] = uint32_t(i); }
+            }
+        }
+    });
+}
 
-        // 頂点法線と面法線のなす角度を算出.
-        auto c0 = asdx::Vector3::Dot(normals[i0], fn);
-        auto c1 = asdx::Vector3::Dot(normals[i1], fn);
-        auto c2 = asdx::Vector3::Dot(normals[i2], fn);
+//-----------------------------------------------------------------------------
+//      面ごとの値を頂点ごとに面番号の昇順で合計します.
+//-----------------------------------------------------------------------------
+void AccumulateFaceValues
+(
+    asdx::IThreadPool*                  pThreadPool,
+    const std::vector<uint32_t>&        indices,
+    size_t                              vertexCount,
+    const std::vector<asdx::Vector3>&   faceValues,
+    std::vector<asdx::Vector3>&         sums,
+    std::vector<uint32_t>*              pLastFaces
+)
+{
+    // スレッドプールが無い場合は隣接情報を作らずに直接加算する.
+    // どちらの経路でも加算順は面番号の昇順なので，結果はビット単位で一致する.
+    sums.assign(vertexCount, asdx::Vector3(0.0f, 0.0f, 0.0f));
+    if (pLastFaces != nullptr)
+    { pLastFaces->assign(vertexCount, UINT32_MAX); }
+
+    auto faceCount = faceValues.size();
+    if (pThreadPool == nullptr)
+    {
+        for(size_t i=0; i<faceCount; ++i)
+        {
+            for(auto j=0; j<3; ++j)
+            {
+                auto index = indices[i * 3 + j];
+                if (index >= vertexCount)
+                { continue; }
 
-        // スムージング処理.
-        mesh.Normals[i0] = (c0 >= cosSmooth) ? normals[i0] : fn;
-        mesh.Normals[i1] = (c1 >= cosSmooth) ? normals[i1] : fn;
-        mesh.Normals[i2] = (c2 >= cosSmooth) ? normals[i2] : fn;
+                sums[index] += faceValues[i];
+                if (pLastFaces != nullptr)
+                { (*pLastFaces)[index] = uint32_t(i); }
+            }
+        }
+        return;
     }
 
-    normals.clear();
+    VertexFaceAdjacency adjacency;
+    BuildVertexFaceAdjacency(pThreadPool, indices, vertexCount, adjacency);
+
+    // 頂点ごとに隣接面から集めるので，書き込みが競合しない.
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
+    {
+        auto begin = adjacency.Offsets[i];
+        auto end   = adjacency.Offsets[i + 1];
+
+        for(auto j=begin; j<end; ++j)
+        { sums[i] += faceValues[adjacency.Faces[j]]; }
+
+        if (pLastFaces != nullptr && begin != end)
+        { (*pLastFaces)[i] = adjacency.Faces[end - 1]; }
+    });
 }
 
 //-----------------------------------------------------------------------------
 //      接線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcTangentsRoughly(asdx::ResMesh& mesh)
+void CalcTangentsRoughly(asdx::IThreadPool* pThreadPool, asdx::ResMesh& mesh)
 {
     auto vertexCount = mesh.Positions.size();
     mesh.Tangents.resize(vertexCount);
-    for(size_t i=0; i<vertexCount; ++i)
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
     {
         asdx::Vector3 T, B;
         asdx::CalcONB(mesh.Normals[i], T, B);
         mesh.Tangents[i] = T;
-    }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      法線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcNormalsImpl
+(
+    asdx::ResMesh&      mesh,
+    float               smoothingAngle,
+    asdx::IThreadPool*  pThreadPool,
+    bool                useAdjacency
+)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto faceCount   = mesh.VertexIndices.size() / 3;
+    mesh.Normals.resize(vertexCount);
+
+    // 面法線を1度だけ計算しておく.
+    std::vector<asdx::Vector3> faceNormals(faceCount);
+    asdx::ParallelFor(pThreadPool, 0, faceCount, 0, [&](size_t i)
+    {
+        auto i0 = mesh.VertexIndices[i * 3 + 0];
+        auto i1 = mesh.VertexIndices[i * 3 + 1];
+        auto i2 = mesh.VertexIndices[i * 3 + 2];
+
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        {
+            faceNormals[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
+            return;
+        }
+
+        const auto& p0 = mesh.Positions[i0];
+        const auto& p1 = mesh.Positions[i1];
+        const auto& p2 = mesh.Positions[i2];
+
+        auto fn = asdx::Vector3::Cross(p1 - p0, p2 - p0);
+        faceNormals[i] = asdx::Vector3::SafeNormalize(fn, fn);
+    });
+
+    std::vector<asdx::Vector3>  sums;
+    std::vector<uint32_t> lastFaces;
+    AccumulateFaceValues(useAdjacency ? pThreadPool : nullptr, mesh.VertexIndices, vertexCount, faceNormals, sums, &lastFaces);
+
+    auto cosSmooth = cosf(asdx::ToRadian(smoothingAngle));
+
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
+    {
+        if (lastFaces[i] == UINT32_MAX)
+        {
+            mesh.Normals[i] = asdx::Vector3(0.0f, 0.0f, 1.0f);
+            return;
+        }
+
+        auto normal = asdx::Vector3::SafeNormalize(sums[i], sums[i]);
+
+        // 最後に参照する面となす角が大きい場合は面法線を使う.
+        const auto& fn = faceNormals[lastFaces[i]];
+        mesh.Normals[i] = (asdx::Vector3::Dot(normal, fn) >= cosSmooth) ? normal : fn;
+    });
 }
 
+
 //-----------------------------------------------------------------------------
 //      接線ベクトルを計算します.
 //-----------------------------------------------------------------------------
-void CalcTangents(asdx::ResMesh& resource)
+void CalcTangentsImpl(asdx::ResMesh& mesh, asdx::IThreadPool* pThreadPool, bool useAdjacency)
 {
+    auto vertexCount = mesh.Positions.size();
+    if (mesh.Normals.size() != vertexCount)
+    { CalcNormalsImpl(mesh, 59.7f, pThreadPool, useAdjacency); }
+
     // テクスチャ座標が無い場合は接線ベクトルをきちんと計算できないので，
     // 雑に計算する.
-    if (resource.TexCoords[0].empty())
+    if (mesh.TexCoords[0].size() != vertexCount)
     {
-        CalcTangentsRoughly(resource);
+        CalcTangentsRoughly(pThreadPool, mesh);
         return;
     }
 
-    auto vertexCount = resource.Positions.size();
-    resource.Tangents.resize(vertexCount);
-
-    // 接線ベクトルを初期化.
-    for(size_t i=0; i<vertexCount; ++i)
-    {
-        resource.Tangents[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
-    }
+    auto faceCount = mesh.VertexIndices.size() / 3;
+    mesh.Tangents.resize(vertexCount);
 
-    auto indexCount = resource.VertexIndices.size();
-    for(size_t i=0; i<indexCount - 3; i+=3)
+    // 面ごとの接線を1度だけ計算しておく.
+    std::vector<asdx::Vector3> faceTangents(faceCount);
+    asdx::ParallelFor(pThreadPool, 0, faceCount, 0, [&](size_t i)
     {
-        auto i0 = resource.VertexIndices[i + 0];
-        auto i1 = resource.VertexIndices[i + 1];
-        auto i2 = resource.VertexIndices[i + 2];
+        auto i0 = mesh.VertexIndices[i * 3 + 0];
+        auto i1 = mesh.VertexIndices[i * 3 + 1];
+        auto i2 = mesh.VertexIndices[i * 3 + 2];
 
-        const auto& p0 = resource.Positions[i0];
-        const auto& p1 = resource.Positions[i1];
-        const auto& p2 = resource.Positions[i2];
+        faceTangents[i] = asdx::Vector3(0.0f, 0.0f, 0.0f);
+        if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+        { return; }
 
-        const auto& t0 = resource.TexCoords[0][i0];
-        const auto& t1 = resource.TexCoords[0][i1];
-        const auto& t2 = resource.TexCoords[0][i2];
+        const auto& t0 = mesh.TexCoords[0][i0];
+        const auto& t1 = mesh.TexCoords[0][i1];
+        const auto& t2 = mesh.TexCoords[0][i2];
 
-        auto e1 = p1 - p0;
-        auto e2 = p2 - p0;
+        auto x1 = t1.x - t0.x;
+        auto x2 = t2.x - t0.x;
+        auto y1 = t1.y - t0.y;
+        auto y2 = t2.y - t0.y;
 
-        float x1 = t1.x - t0.x;
-        float x2 = t2.x - t0.x;
+        // テクスチャ座標が縮退している場合は寄与させない.
+        auto det = x1 * y2 - x2 * y1;
+        if (fabsf(det) <= FLT_MIN)
+        { return; }
 
-        float y1 = t1.y - t0.y;
-        float y2 = t2.y - t0.y;
+        auto e1 = mesh.Positions[i1] - mesh.Positions[i0];
+        auto e2 = mesh.Positions[i2] - mesh.Positions[i0];
+        faceTangents[i] = (e1 * y2 - e2 * y1) * (1.0f / det);
+    });
 
-        float r = 1.0f / (x1 * y2 - x2 * y1);
+    std::vector<asdx::Vector3> sums;
+    AccumulateFaceValues(useAdjacency ? pThreadPool : nullptr, mesh.VertexIndices, vertexCount, faceTangents, sums, nullptr);
 
-        asdx::Vector3 T = (e1 * y2 - e2 * y1) * r;
+    asdx::ParallelFor(pThreadPool, 0, vertexCount, 0, [&](size_t i)
+    {
+        const auto& a = sums[i];
 
-        resource.Tangents[i0] += T;
-        resource.Tangents[i1] += T;
-        resource.Tangents[i2] += T;
-    }
+        // Reject = a - b * Dot(a, b);
+        const auto& b = mesh.Normals[i];
+        auto T = a - b * asdx::Vector3::Dot(a, b);
+        if (asdx::Vector3::Dot(T, T) > FLT_MIN)
+        {
+            mesh.Tangents[i] = asdx::Vector3::Normalize(T);
+        }
+        else
+        {
+            asdx::Vector3 B;
+            asdx::CalcONB(b, mesh.Tangents[i], B);
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+//      頂点ストリームをリマップします.
+//-----------------------------------------------------------------------------
+template<typename T>
+void RemapVertexStream
+(
+    std::vector<T>&                 stream,
+    size_t                          elementsPerVertex,
+    size_t                          vertexCount,
+    size_t                          uniqueCount,
+    const std::vector<uint32_t>&    remap
+)
+{
+    if (stream.size() != vertexCount * elementsPerVertex)
+    { return; }
+
+    std::vector<T> result(uniqueCount * elementsPerVertex);
+    meshopt_remapVertexBuffer(
+        result.data(),
+        stream.data(),
+        vertexCount,
+        sizeof(T) * elementsPerVertex,
+        remap.data());
+
+    stream.swap(result);
+}
+
+//-----------------------------------------------------------------------------
+//      頂点ストリームを登録します.
+//-----------------------------------------------------------------------------
+template<typename T>
+void AddVertexStream
+(
+    std::vector<meshopt_Stream>&    streams,
+    const std::vector<T>&           stream,
+    size_t                          elementsPerVertex,
+    size_t                          vertexCount
+)
+{
+    if (stream.empty() || stream.size() != vertexCount * elementsPerVertex)
+    { return; }
+
+    meshopt_Stream item = { stream.data(), sizeof(T) * elementsPerVertex, sizeof(T) * elementsPerVertex };
+    streams.push_back(item);
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュの頂点ストリームを取得します.
+//-----------------------------------------------------------------------------
+void GetVertexStreams(const asdx::ResMesh& mesh, std::vector<meshopt_Stream>& streams)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto boneCount   = size_t(mesh.BoneInfluenceCount);
+
+    AddVertexStream(streams, mesh.Positions, 1, vertexCount);
+    AddVertexStream(streams, mesh.Normals,   1, vertexCount);
+    AddVertexStream(streams, mesh.Tangents,  1, vertexCount);
+    for(auto i=0u; i<asdx::ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    { AddVertexStream(streams, mesh.TexCoords[i], 1, vertexCount); }
+    AddVertexStream(streams, mesh.Colors, 1, vertexCount);
+    if (boneCount > 0)
+    {
+        AddVertexStream(streams, mesh.BoneIndices, boneCount, vertexCount);
+        AddVertexStream(streams, mesh.BoneWeights, boneCount, vertexCount);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュの全頂点ストリームをリマップします.
+//-----------------------------------------------------------------------------
+void RemapVertices(asdx::ResMesh& mesh, size_t uniqueCount, const std::vector<uint32_t>& remap)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto boneCount   = size_t(mesh.BoneInfluenceCount);
+
+    RemapVertexStream(mesh.Positions, 1, vertexCount, uniqueCount, remap);
+    RemapVertexStream(mesh.Normals,   1, vertexCount, uniqueCount, remap);
+    RemapVertexStream(mesh.Tangents,  1, vertexCount, uniqueCount, remap);
+    for(auto i=0u; i<asdx::ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    { RemapVertexStream(mesh.TexCoords[i], 1, vertexCount, uniqueCount, remap); }
+    RemapVertexStream(mesh.Colors, 1, vertexCount, uniqueCount, remap);
+    if (boneCount > 0)
+    {
+        RemapVertexStream(mesh.BoneIndices, boneCount, vertexCount, uniqueCount, remap);
+        RemapVertexStream(mesh.BoneWeights, boneCount, vertexCount, uniqueCount, remap);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      インデックスが三角形リストとして有効かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsValidTriangleList(const asdx::ResMesh& mesh)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.VertexIndices.size();
+    if ((indexCount % 3) != 0)
+    {
+        ELOGA("Error : Invalid Index Count. name = %s, count = %zu", mesh.Name.c_str(), indexCount);
+        return false;
+    }
+
+    for(size_t i=0; i<indexCount; ++i)
+    {
+        if (mesh.VertexIndices[i] >= vertexCount)
+        {
+            ELOGA("Error : Index Out of Range. name = %s, index = %u, vertexCount = %zu",
+                mesh.Name.c_str(), mesh.VertexIndices[i], vertexCount);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットを破棄します.
+//-----------------------------------------------------------------------------
+void ClearMeshlets(asdx::ResMesh& mesh)
+{
+    mesh.Meshlets           .clear();
+    mesh.UniqueVertexIndices.clear();
+    mesh.PrimitiveIndices   .clear();
+    mesh.MeshletBounds      .clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// STREAM_AMDL enum
+///////////////////////////////////////////////////////////////////////////////
+enum STREAM_AMDL
+{
+    STREAM_AMDL_POSITION = 0,           //!< 位置座標.
+    STREAM_AMDL_NORMAL,                 //!< 法線ベクトル.
+    STREAM_AMDL_TANGENT,                //!< 接線ベクトル.
+    STREAM_AMDL_TEXCOORD0,              //!< テクスチャ座標0.
+    STREAM_AMDL_TEXCOORD1,              //!< テクスチャ座標1.
+    STREAM_AMDL_TEXCOORD2,              //!< テクスチャ座標2.
+    STREAM_AMDL_TEXCOORD3,              //!< テクスチャ座標3.
+    STREAM_AMDL_COLOR,                  //!< 頂点カラー.
+    STREAM_AMDL_BONE_INDEX,             //!< ボーン番号.
+    STREAM_AMDL_BONE_WEIGHT,            //!< ボーン重み.
+    STREAM_AMDL_VERTEX_INDEX,           //!< 頂点番号.
+    STREAM_AMDL_MESHLET,                //!< メッシュレット.
+    STREAM_AMDL_UNIQUE_VERTEX_INDEX,    //!< メッシュレット毎の頂点番号.
+    STREAM_AMDL_PRIMITIVE_INDEX,        //!< パックされた三角形.
+    STREAM_AMDL_MESHLET_BOUNDS,         //!< メッシュレットのバウンディング.
+    STREAM_AMDL_COUNT,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// HeaderAMDL structure
+///////////////////////////////////////////////////////////////////////////////
+struct HeaderAMDL
+{
+    uint32_t    Magic;              //!< ファイル識別子.
+    uint32_t    Version;            //!< ファイルバージョン.
+    uint32_t    MeshCount;          //!< メッシュ数.
+    uint32_t    LodCount;           //!< LOD数.
+    uint32_t    MaterialCount;      //!< マテリアル数.
+    uint32_t    Reserved;           //!< 予約領域.
+    uint64_t    MeshOffset;         //!< メッシュテーブルへのオフセット.
+    uint64_t    LodOffset;          //!< LOD範囲テーブルへのオフセット.
+    uint64_t    MaterialOffset;     //!< マテリアル名オフセットテーブルへのオフセット.
+    uint64_t    FileSize;           //!< ファイルサイズ.
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// MeshAMDL structure
+///////////////////////////////////////////////////////////////////////////////
+struct MeshAMDL
+{
+    uint64_t    NameOffset;                         //!< メッシュ名へのオフセット.
+    uint32_t    MaterialId;                         //!< マテリアルID.
+    uint32_t    BoneInfluenceCount;                 //!< 影響するボーン数.
+    uint32_t    VertexCount;                        //!< 頂点数.
+    uint32_t    IndexCount;                         //!< 頂点インデックス数.
+    uint32_t    MeshletCount;                       //!< メッシュレット数.
+    uint32_t    UniqueVertexIndexCount;             //!< メッシュレット毎の頂点番号の数.
+    uint32_t    PrimitiveCount;                     //!< メッシュレットのプリミティブ数.
+    uint32_t    Reserved;                           //!< 予約領域.
+    uint64_t    StreamOffset[STREAM_AMDL_COUNT];    //!< ストリームへのオフセット (無い場合は 0).
+};
+
+static_assert(sizeof(HeaderAMDL)             == 56, "Invalid HeaderAMDL Size.");
+static_assert(sizeof(MeshAMDL)               == 40 + 8 * STREAM_AMDL_COUNT, "Invalid MeshAMDL Size.");
+static_assert(sizeof(asdx::ResLodRange)      == 12, "Invalid ResLodRange Size.");
+static_assert(sizeof(asdx::ResMeshlet)       == 16, "Invalid ResMeshlet Size.");
+static_assert(sizeof(asdx::ResMeshletBounds) == 44, "Invalid ResMeshletBounds Size.");
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint64_t kStreamAlignmentAMDL = 16;            // ストリームのアライメント.
+static const size_t   kValidateGrainAMDL   = 64 * 1024;     // インデックス検証を並列化する際の最小チャンクサイズ.
+
+//-----------------------------------------------------------------------------
+//      ストリームのバイト数を取得します.
+//-----------------------------------------------------------------------------
+uint64_t GetStreamSizeAMDL(const MeshAMDL& mesh, uint32_t stream)
+{
+    auto vertexCount = uint64_t(mesh.VertexCount);
+    auto boneCount   = uint64_t(mesh.BoneInfluenceCount);
+
+    switch(stream)
+    {
+    case STREAM_AMDL_POSITION:
+    case STREAM_AMDL_NORMAL:
+    case STREAM_AMDL_TANGENT:
+        return vertexCount * sizeof(asdx::Vector3);
+
+    case STREAM_AMDL_TEXCOORD0:
+    case STREAM_AMDL_TEXCOORD1:
+    case STREAM_AMDL_TEXCOORD2:
+    case STREAM_AMDL_TEXCOORD3:
+        return vertexCount * sizeof(asdx::Vector2);
+
+    case STREAM_AMDL_COLOR:
+        return vertexCount * sizeof(asdx::Vector4);
+
+    case STREAM_AMDL_BONE_INDEX:
+        return vertexCount * boneCount * sizeof(uint16_t);
+
+    case STREAM_AMDL_BONE_WEIGHT:
+        return vertexCount * boneCount * sizeof(float);
+
+    case STREAM_AMDL_VERTEX_INDEX:
+        return uint64_t(mesh.IndexCount) * sizeof(uint32_t);
+
+    case STREAM_AMDL_MESHLET:
+        return uint64_t(mesh.MeshletCount) * sizeof(asdx::ResMeshlet);
+
+    case STREAM_AMDL_UNIQUE_VERTEX_INDEX:
+        return uint64_t(mesh.UniqueVertexIndexCount) * sizeof(uint32_t);
+
+    case STREAM_AMDL_PRIMITIVE_INDEX:
+        return uint64_t(mesh.PrimitiveCount) * sizeof(uint32_t);
+
+    case STREAM_AMDL_MESHLET_BOUNDS:
+        return uint64_t(mesh.MeshletCount) * sizeof(asdx::ResMeshletBounds);
+    }
+
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BlobWriter class
+///////////////////////////////////////////////////////////////////////////////
+class BlobWriter
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      指定アライメントまで0で埋めます.
+    //-------------------------------------------------------------------------
+    void Align(uint64_t alignment)
+    {
+        auto size = (m_Buffer.size() + alignment - 1) / alignment * alignment;
+        m_Buffer.resize(size_t(size), 0);
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      領域を確保します.
+    //!
+    //! @return     確保した領域へのオフセットを返却します.
+    //-------------------------------------------------------------------------
+    uint64_t Reserve(size_t size, uint64_t alignment)
+    {
+        Align(alignment);
+        auto offset = uint64_t(m_Buffer.size());
+        m_Buffer.resize(m_Buffer.size() + size, 0);
+        return offset;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      データを書き込みます.
+    //!
+    //! @return     書き込んだ位置へのオフセットを返却します. サイズが 0 の場合は 0 を返却します.
+    //-------------------------------------------------------------------------
+    uint64_t Write(const void* data, size_t size, uint64_t alignment)
+    {
+        if (size == 0)
+        { return 0; }
+
+        auto offset = Reserve(size, alignment);
+        memcpy(m_Buffer.data() + offset, data, size);
+        return offset;
+    }
+
+    //-------------------------------------------------------------------------
+    //! @brief      文字列を書き込みます.
+    //-------------------------------------------------------------------------
+    uint64_t WriteString(const std::string& value)
+    { return Write(value.c_str(), value.size() + 1, 1); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      指定位置のデータを取得します.
+    //-------------------------------------------------------------------------
+    template<typename T>
+    T* At(uint64_t offset)
+    { return reinterpret_cast<T*>(m_Buffer.data() + offset); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      バッファを取得します.
+    //-------------------------------------------------------------------------
+    const std::vector<uint8_t>& GetBuffer() const
+    { return m_Buffer; }
+
+private:
+    std::vector<uint8_t>    m_Buffer;
+};
+
+//-----------------------------------------------------------------------------
+//      ストリームを書き込みます.
+//-----------------------------------------------------------------------------
+template<typename T>
+uint64_t WriteStreamAMDL(BlobWriter& writer, const std::vector<T>& stream, uint64_t expectSize)
+{
+    // 要素数が合わないストリームは出力しない.
+    if (stream.empty() || stream.size() * sizeof(T) != expectSize)
+    { return 0; }
+
+    return writer.Write(stream.data(), size_t(expectSize), kStreamAlignmentAMDL);
+}
+
+//-----------------------------------------------------------------------------
+//      AMDL形式のバイナリを構築します.
+//-----------------------------------------------------------------------------
+void BuildAMDL(const asdx::ResModel& model, BlobWriter& writer)
+{
+    auto headerOffset = writer.Reserve(sizeof(HeaderAMDL), 8);
+    auto meshOffset   = writer.Reserve(sizeof(MeshAMDL) * model.Meshes.size(), 8);
+    auto lodOffset    = writer.Write(model.LodRanges.data(), sizeof(asdx::ResLodRange) * model.LodRanges.size(), 8);
+    auto matOffset    = writer.Reserve(sizeof(uint64_t) * model.Materials.size(), 8);
+
+    for(size_t i=0; i<model.Materials.size(); ++i)
+    {
+        auto offset = writer.WriteString(model.Materials[i]);
+        *writer.At<uint64_t>(matOffset + i * sizeof(uint64_t)) = offset;
+    }
+
+    for(size_t i=0; i<model.Meshes.size(); ++i)
+    {
+        const auto& src = model.Meshes[i];
+
+        MeshAMDL dst = {};
+        dst.NameOffset              = writer.WriteString(src.Name);
+        dst.MaterialId              = src.MaterialId;
+        dst.BoneInfluenceCount      = src.BoneInfluenceCount;
+        dst.VertexCount             = uint32_t(src.Positions.size());
+        dst.IndexCount              = uint32_t(src.VertexIndices.size());
+        dst.MeshletCount            = uint32_t(src.Meshlets.size());
+        dst.UniqueVertexIndexCount  = uint32_t(src.UniqueVertexIndices.size());
+        dst.PrimitiveCount          = uint32_t(src.PrimitiveIndices.size());
+
+        if (src.MeshletBounds.size() != src.Meshlets.size())
+        { dst.MeshletCount = 0; }
+
+        auto& offsets = dst.StreamOffset;
+        offsets[STREAM_AMDL_POSITION]   = WriteStreamAMDL(writer, src.Positions, GetStreamSizeAMDL(dst, STREAM_AMDL_POSITION));
+        offsets[STREAM_AMDL_NORMAL]     = WriteStreamAMDL(writer, src.Normals,   GetStreamSizeAMDL(dst, STREAM_AMDL_NORMAL));
+        offsets[STREAM_AMDL_TANGENT]    = WriteStreamAMDL(writer, src.Tangents,  GetStreamSizeAMDL(dst, STREAM_AMDL_TANGENT));
+        for(auto j=0u; j<asdx::ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        {
+            auto stream = STREAM_AMDL_TEXCOORD0 + j;
+            offsets[stream] = WriteStreamAMDL(writer, src.TexCoords[j], GetStreamSizeAMDL(dst, stream));
+        }
+        offsets[STREAM_AMDL_COLOR]                  = WriteStreamAMDL(writer, src.Colors,              GetStreamSizeAMDL(dst, STREAM_AMDL_COLOR));
+        offsets[STREAM_AMDL_BONE_INDEX]             = WriteStreamAMDL(writer, src.BoneIndices,         GetStreamSizeAMDL(dst, STREAM_AMDL_BONE_INDEX));
+        offsets[STREAM_AMDL_BONE_WEIGHT]            = WriteStreamAMDL(writer, src.BoneWeights,         GetStreamSizeAMDL(dst, STREAM_AMDL_BONE_WEIGHT));
+        offsets[STREAM_AMDL_VERTEX_INDEX]           = WriteStreamAMDL(writer, src.VertexIndices,       GetStreamSizeAMDL(dst, STREAM_AMDL_VERTEX_INDEX));
+        offsets[STREAM_AMDL_MESHLET]                = WriteStreamAMDL(writer, src.Meshlets,            GetStreamSizeAMDL(dst, STREAM_AMDL_MESHLET));
+        offsets[STREAM_AMDL_UNIQUE_VERTEX_INDEX]    = WriteStreamAMDL(writer, src.UniqueVertexIndices, GetStreamSizeAMDL(dst, STREAM_AMDL_UNIQUE_VERTEX_INDEX));
+        offsets[STREAM_AMDL_PRIMITIVE_INDEX]        = WriteStreamAMDL(writer, src.PrimitiveIndices,    GetStreamSizeAMDL(dst, STREAM_AMDL_PRIMITIVE_INDEX));
+        offsets[STREAM_AMDL_MESHLET_BOUNDS]         = WriteStreamAMDL(writer, src.MeshletBounds,       GetStreamSizeAMDL(dst, STREAM_AMDL_MESHLET_BOUNDS));
+
+        *writer.At<MeshAMDL>(meshOffset + i * sizeof(MeshAMDL)) = dst;
+    }
+
+    writer.Align(kStreamAlignmentAMDL);
+
+    auto& header = *writer.At<HeaderAMDL>(headerOffset);
+    header.Magic            = asdx::CookedModel::kMagic;
+    header.Version          = asdx::CookedModel::kVersion;
+    header.MeshCount        = uint32_t(model.Meshes.size());
+    header.LodCount         = uint32_t(model.LodRanges.size());
+    header.MaterialCount    = uint32_t(model.Materials.size());
+    header.Reserved         = 0;
+    header.MeshOffset       = meshOffset;
+    header.LodOffset        = lodOffset;
+    header.MaterialOffset   = matOffset;
+    header.FileSize         = writer.GetBuffer().size();
+}
+
+//-----------------------------------------------------------------------------
+//      AMDL形式でファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteAMDL(const asdx::ResModel& model, FILE* pFile)
+{
+    BlobWriter writer;
+    BuildAMDL(model, writer);
+
+    auto& buffer = writer.GetBuffer();
+    auto size = fwrite(buffer.data(), 1, buffer.size(), pFile);
+    fclose(pFile);
+
+    if (size != buffer.size())
+    {
+        ELOGA("Error : File Write Failed.");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイル内の範囲かどうかチェックします.
+//-----------------------------------------------------------------------------
+inline bool IsInRangeAMDL(uint64_t offset, uint64_t size, uint64_t fileSize)
+{ return offset <= fileSize && size <= fileSize - offset; }
+
+//-----------------------------------------------------------------------------
+//      インデックスが全て上限未満かどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsValidIndicesAMDL(const uint32_t* pIndices, size_t count, uint32_t limit)
+{
+    return asdx::ParallelReduce(size_t(0), count, kValidateGrainAMDL, true,
+        [&](size_t begin, size_t end, bool value)
+        {
+            // 早期終了せずに全要素を見てベクトル化しやすくする.
+            auto invalid = false;
+            for(auto i=begin; i<end; ++i)
+            { invalid |= (pIndices[i] >= limit); }
+
+            return value && !invalid;
+        },
+        [](bool lhs, bool rhs) { return lhs && rhs; });
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットの範囲とプリミティブのインデックスが正しいかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsValidMeshletsAMDL
+(
+    const asdx::ResMeshlet* pMeshlets,
+    uint32_t                meshletCount,
+    uint32_t                uniqueVertexIndexCount,
+    const uint32_t*         pPrimitiveIndices,
+    uint32_t                primitiveCount
+)
+{
+    return asdx::ParallelReduce(size_t(0), size_t(meshletCount), 0, true,
+        [&](size_t begin, size_t end, bool value)
+        {
+            for(auto i=begin; i<end && value; ++i)
+            {
+                auto& meshlet = pMeshlets[i];
+                if (uint64_t(meshlet.VertexOffset)    + meshlet.VertexCount    > uniqueVertexIndexCount
+                 || uint64_t(meshlet.PrimitiveOffset) + meshlet.PrimitiveCount > primitiveCount)
+                { return false; }
+
+                // 三角形の頂点番号はメッシュレットの頂点リスト内を指す.
+                auto invalid = false;
+                auto prims   = pPrimitiveIndices + meshlet.PrimitiveOffset;
+                for(auto j=0u; j<meshlet.PrimitiveCount; ++j)
+                {
+                    auto prim = prims[j];
+                    invalid |= ((prim         & 0x3FF) >= meshlet.VertexCount);
+                    invalid |= (((prim >> 10) & 0x3FF) >= meshlet.VertexCount);
+                    invalid |= (((prim >> 20) & 0x3FF) >= meshlet.VertexCount);
+                }
+
+                value = !invalid;
+            }
+
+            return value;
+        },
+        [](bool lhs, bool rhs) { return lhs && rhs; });
+}
+
+//-----------------------------------------------------------------------------
+//      SNORM16 形式に変換します.
+//-----------------------------------------------------------------------------
+inline int16_t ToSnorm16(float value)
+{ return int16_t(lroundf(asdx::Clamp(value, -1.0f, 1.0f) * 32767.0f)); }
+
+//-----------------------------------------------------------------------------
+//      SNORM16 形式を展開します.
+//-----------------------------------------------------------------------------
+inline float FromSnorm16(int16_t value)
+{ return asdx::Max(float(value) / 32767.0f, -1.0f); }
+
+//-----------------------------------------------------------------------------
+//      2要素の SNORM16 形式を展開します.
+//-----------------------------------------------------------------------------
+inline asdx::Vector2 UnpackSnorm16x2(uint32_t value)
+{
+    return asdx::Vector2(
+        FromSnorm16(int16_t(value & 0xffff)),
+        FromSnorm16(int16_t(value >> 16)));
+}
+
+//-----------------------------------------------------------------------------
+//      単位ベクトルを八面体マッピングして2要素の SNORM16 形式に変換します.
+//-----------------------------------------------------------------------------
+uint32_t EncodeOctahedralSnorm16(const asdx::Vector3& value)
+{
+    auto n   = asdx::Vector3::SafeNormalize(value, asdx::Vector3(0.0f, 0.0f, 1.0f));
+    auto oct = asdx::EncodeOctahedral(n);
+
+    // 量子化後の4近傍から最も角度誤差が小さいものを選ぶ.
+    auto bx = floorf(asdx::Clamp(oct.x, -1.0f, 1.0f) * 32767.0f);
+    auto by = floorf(asdx::Clamp(oct.y, -1.0f, 1.0f) * 32767.0f);
+
+    uint32_t best    = 0;
+    auto     bestDot = -2.0f;
+    for(auto i=0; i<4; ++i)
+    {
+        auto qx = asdx::Clamp(bx + float(i & 1),  -32767.0f, 32767.0f);
+        auto qy = asdx::Clamp(by + float(i >> 1), -32767.0f, 32767.0f);
+
+        auto packed = uint32_t(uint16_t(int16_t(qx))) | (uint32_t(uint16_t(int16_t(qy))) << 16);
+        auto dot    = asdx::Vector3::Dot(n, asdx::DecodeOctahedral(UnpackSnorm16x2(packed)));
+        if (dot > bestDot)
+        {
+            best    = packed;
+            bestDot = dot;
+        }
+    }
+
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+//      2つのベクトルのなす角を度単位で求めます.
+//-----------------------------------------------------------------------------
+inline float CalcAngleError(const asdx::Vector3& a, const asdx::Vector3& b)
+{
+    auto n = asdx::Vector3::SafeNormalize(a, asdx::Vector3(0.0f, 0.0f, 1.0f));
+    auto c = asdx::Clamp(asdx::Vector3::Dot(n, b), -1.0f, 1.0f);
+    return asdx::ToDegree(acosf(c));
+}
+
+} // namespace
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      重複頂点を統合し，インデックスバッファを生成します.
+//-----------------------------------------------------------------------------
+void WeldVertices(ResMesh& mesh)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.VertexIndices.size();
+    if (vertexCount == 0 || indexCount == 0)
+    { return; }
+
+    ClearMeshlets(mesh);
+
+    // 全属性が一致する頂点のみを統合する.
+    std::vector<meshopt_Stream> streams;
+    GetVertexStreams(mesh, streams);
+
+    std::vector<uint32_t> remap(vertexCount);
+    auto uniqueCount = meshopt_generateVertexRemapMulti(
+        remap.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        vertexCount,
+        streams.data(),
+        streams.size());
+
+    meshopt_remapIndexBuffer(
+        mesh.VertexIndices.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        remap.data());
+
+    if (uniqueCount != vertexCount)
+    { RemapVertices(mesh, uniqueCount, remap); }
+}
+
+//-----------------------------------------------------------------------------
+//      法線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcNormals(ResMesh& mesh, float smoothingAngle)
+{
+    auto pThreadPool = GetSharedThreadPool();
+    CalcNormalsImpl(mesh, smoothingAngle, pThreadPool, GetWorkerCount(pThreadPool) >= kMinAdjacencyWorkers);
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドプールを指定して法線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcNormals(ResMesh& mesh, float smoothingAngle, IThreadPool* pThreadPool)
+{ CalcNormalsImpl(mesh, smoothingAngle, pThreadPool, pThreadPool != nullptr); }
+
+//-----------------------------------------------------------------------------
+//      接線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcTangents(ResMesh& mesh)
+{
+    auto pThreadPool = GetSharedThreadPool();
+    CalcTangentsImpl(mesh, pThreadPool, GetWorkerCount(pThreadPool) >= kMinAdjacencyWorkers);
+}
+
+//-----------------------------------------------------------------------------
+//      スレッドプールを指定して接線ベクトルを計算します.
+//-----------------------------------------------------------------------------
+void CalcTangents(ResMesh& mesh, IThreadPool* pThreadPool)
+{ CalcTangentsImpl(mesh, pThreadPool, pThreadPool != nullptr); }
+
+//-----------------------------------------------------------------------------
+//      メッシュの統計情報を求めます.
+//-----------------------------------------------------------------------------
+void AnalyzeMesh(const ResMesh& mesh, ResMeshStatistics& result)
+{
+    result = ResMeshStatistics();
+
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.VertexIndices.size();
+    if (vertexCount == 0 || indexCount == 0)
+    { return; }
+
+    if (!IsValidTriangleList(mesh))
+    { return; }
+
+    std::vector<meshopt_Stream> streams;
+    GetVertexStreams(mesh, streams);
+
+    size_t vertexSize = 0;
+    for(auto& stream : streams)
+    { vertexSize += stream.size; }
+
+    auto vcache = meshopt_analyzeVertexCache(
+        mesh.VertexIndices.data(),
+        indexCount,
+        vertexCount,
+        ResMeshStatistics::kVertexCacheSize,
+        0,
+        0);
+
+    auto overdraw = meshopt_analyzeOverdraw(
+        mesh.VertexIndices.data(),
+        indexCount,
+        &mesh.Positions[0].x,
+        vertexCount,
+        sizeof(asdx::Vector3));
+
+    auto vfetch = meshopt_analyzeVertexFetch(
+        mesh.VertexIndices.data(),
+        indexCount,
+        vertexCount,
+        vertexSize);
+
+    result.ACMR      = vcache.acmr;
+    result.ATVR      = vcache.atvr;
+    result.Overdraw  = overdraw.overdraw;
+    result.Overfetch = vfetch.overfetch;
+}
+
+//-----------------------------------------------------------------------------
+//      描画用にメッシュを最適化します.
+//-----------------------------------------------------------------------------
+void OptimizeMesh(ResMesh& mesh, float overdrawThreshold)
+{
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.VertexIndices.size();
+    if (vertexCount == 0 || indexCount == 0)
+    { return; }
+
+    if (!IsValidTriangleList(mesh))
+    { return; }
+
+    ClearMeshlets(mesh);
+
+    // 頂点キャッシュ最適化.
+    std::vector<uint32_t> indices(indexCount);
+    meshopt_optimizeVertexCache(
+        indices.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        vertexCount);
+
+    // キャッシュ効率を閾値まで落とすことを許容して，オーバードローを削減.
+    meshopt_optimizeOverdraw(
+        mesh.VertexIndices.data(),
+        indices.data(),
+        indexCount,
+        &mesh.Positions[0].x,
+        vertexCount,
+        sizeof(asdx::Vector3),
+        overdrawThreshold);
+
+    // 頂点フェッチ最適化. 参照されていない頂点はここで取り除かれる.
+    std::vector<uint32_t> remap(vertexCount);
+    auto uniqueCount = meshopt_optimizeVertexFetchRemap(
+        remap.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        vertexCount);
+
+    meshopt_remapIndexBuffer(
+        mesh.VertexIndices.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        remap.data());
+
+    RemapVertices(mesh, uniqueCount, remap);
+}
+
+//-----------------------------------------------------------------------------
+//      頂点属性を量子化します.
+//-----------------------------------------------------------------------------
+void QuantizeMesh(const ResMesh& mesh, ResQuantizedMesh& result, ResQuantizationError* pError)
+{
+    result = ResQuantizedMesh();
+    if (pError != nullptr)
+    { *pError = ResQuantizationError(); }
+
+    auto vertexCount = mesh.Positions.size();
+    if (vertexCount == 0)
+    { return; }
+
+    // 位置座標はバウンディングボックスに対する相対値にする.
+    auto minPos = mesh.Positions[0];
+    auto maxPos = mesh.Positions[0];
+    for(size_t i=1; i<vertexCount; ++i)
+    {
+        minPos = Vector3::Min(minPos, mesh.Positions[i]);
+        maxPos = Vector3::Max(maxPos, mesh.Positions[i]);
+    }
+
+    auto extent = maxPos - minPos;
+    result.PositionScale = extent / 65535.0f;
+    result.PositionBias  = minPos;
+
+    Vector3 invExtent(
+        (extent.x > 0.0f) ? 65535.0f / extent.x : 0.0f,
+        (extent.y > 0.0f) ? 65535.0f / extent.y : 0.0f,
+        (extent.z > 0.0f) ? 65535.0f / extent.z : 0.0f);
+
+    auto hasNormals  = (mesh.Normals .size() == vertexCount);
+    auto hasTangents = (mesh.Tangents.size() == vertexCount);
+    auto hasColors   = (mesh.Colors  .size() == vertexCount);
+
+    result.Positions.resize(vertexCount * 4);
+    if (hasNormals)  { result.Normals .resize(vertexCount); }
+    if (hasTangents) { result.Tangents.resize(vertexCount); }
+    if (hasColors)   { result.Colors  .resize(vertexCount); }
+
+    ParallelFor(0, vertexCount, 0, [&](size_t i)
+    {
+        auto p = mesh.Positions[i] - minPos;
+        p.x *= invExtent.x;
+        p.y *= invExtent.y;
+        p.z *= invExtent.z;
+        result.Positions[i * 4 + 0] = uint16_t(lroundf(Clamp(p.x, 0.0f, 65535.0f)));
+        result.Positions[i * 4 + 1] = uint16_t(lroundf(Clamp(p.y, 0.0f, 65535.0f)));
+        result.Positions[i * 4 + 2] = uint16_t(lroundf(Clamp(p.z, 0.0f, 65535.0f)));
+        result.Positions[i * 4 + 3] = 0;
+
+        if (hasNormals)
+        { result.Normals[i] = EncodeOctahedralSnorm16(mesh.Normals[i]); }
+
+        if (hasTangents)
+        { result.Tangents[i] = EncodeOctahedralSnorm16(mesh.Tangents[i]); }
+
+        if (hasColors)
+        { result.Colors[i] = EncodeUnorm4(mesh.Colors[i]); }
+    });
+
+    for(auto i=0u; i<ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    {
+        if (mesh.TexCoords[i].size() != vertexCount)
+        { continue; }
+
+        result.TexCoords[i].resize(vertexCount);
+        ConvertF32ToF16(&mesh.TexCoords[i][0].x, &result.TexCoords[i][0].x, vertexCount * 2);
+    }
+
+    if (pError == nullptr)
+    { return; }
+
+    // 展開して誤差を求める.
+    auto& error = *pError;
+    error = ParallelReduce(size_t(0), vertexCount, size_t(0), ResQuantizationError(),
+        [&](size_t begin, size_t end, ResQuantizationError value)
+        {
+            for(auto i=begin; i<end; ++i)
+            {
+                Vector3 q(
+                    float(result.Positions[i * 4 + 0]) * result.PositionScale.x,
+                    float(result.Positions[i * 4 + 1]) * result.PositionScale.y,
+                    float(result.Positions[i * 4 + 2]) * result.PositionScale.z);
+                auto d = q + result.PositionBias - mesh.Positions[i];
+                value.Position = Max(value.Position, Max(fabsf(d.x), Max(fabsf(d.y), fabsf(d.z))));
+
+                if (hasNormals)
+                {
+                    auto n = DecodeOctahedral(UnpackSnorm16x2(result.Normals[i]));
+                    value.Normal = Max(value.Normal, CalcAngleError(mesh.Normals[i], n));
+                }
+
+                if (hasTangents)
+                {
+                    auto t = DecodeOctahedral(UnpackSnorm16x2(result.Tangents[i]));
+                    value.Tangent = Max(value.Tangent, CalcAngleError(mesh.Tangents[i], t));
+                }
+
+                for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+                {
+                    if (result.TexCoords[j].empty())
+                    { continue; }
+
+                    auto t = DecodeHalf2(result.TexCoords[j][i]) - mesh.TexCoords[j][i];
+                    value.TexCoord = Max(value.TexCoord, Max(fabsf(t.x), fabsf(t.y)));
+                }
+
+                if (hasColors)
+                {
+                    auto c = DecodeUnorm4(result.Colors[i]) - Vector4::Saturate(mesh.Colors[i]);
+                    value.Color = Max(value.Color, Max(Max(fabsf(c.x), fabsf(c.y)), Max(fabsf(c.z), fabsf(c.w))));
+                }
+            }
+            return value;
+        },
+        [](const ResQuantizationError& lhs, const ResQuantizationError& rhs)
+        {
+            ResQuantizationError value;
+            value.Position = Max(lhs.Position, rhs.Position);
+            value.Normal   = Max(lhs.Normal,   rhs.Normal);
+            value.Tangent  = Max(lhs.Tangent,  rhs.Tangent);
+            value.TexCoord = Max(lhs.TexCoord, rhs.TexCoord);
+            value.Color    = Max(lhs.Color,    rhs.Color);
+            return value;
+        });
+
+    // 頂点あたりのサイズ.
+    size_t srcSize = sizeof(Vector3);
+    size_t dstSize = sizeof(uint16_t) * 4;
+    if (hasNormals)  { srcSize += sizeof(Vector3); dstSize += sizeof(uint32_t); }
+    if (hasTangents) { srcSize += sizeof(Vector3); dstSize += sizeof(uint32_t); }
+    if (hasColors)   { srcSize += sizeof(Vector4); dstSize += sizeof(uint32_t); }
+    for(auto i=0u; i<ResMesh::MAX_TEXCOORD_LAYERS; ++i)
+    {
+        if (result.TexCoords[i].empty())
+        { continue; }
+
+        srcSize += sizeof(Vector2);
+        dstSize += sizeof(Half2);
+    }
+
+    error.SourceBytes    = srcSize * vertexCount;
+    error.QuantizedBytes = dstSize * vertexCount;
+}
+
+//-----------------------------------------------------------------------------
+//      メッシュレットを生成します.
+//-----------------------------------------------------------------------------
+bool BuildMeshlets
+(
+    ResMesh&    mesh,
+    uint32_t    maxVertices,
+    uint32_t    maxPrimitives,
+    float       coneWeight
+)
+{
+    ClearMeshlets(mesh);
+
+    auto vertexCount = mesh.Positions.size();
+    auto indexCount  = mesh.VertexIndices.size();
+    if (vertexCount == 0 || indexCount == 0 || !IsValidTriangleList(mesh))
+    {
+        ELOGA("Error : Invalid Mesh. name = %s", mesh.Name.c_str());
+        return false;
+    }
+
+    maxPrimitives &= ~0x3u;
+    if (maxVertices < 3 || maxVertices > 255 || maxPrimitives < 4 || maxPrimitives > 512)
+    {
+        ELOGA("Error : Invalid Argument. maxVertices = %u, maxPrimitives = %u", maxVertices, maxPrimitives);
+        return false;
+    }
+
+    auto maxMeshlets = meshopt_buildMeshletsBound(indexCount, maxVertices, maxPrimitives);
+
+    std::vector<meshopt_Meshlet> meshlets (maxMeshlets);
+    std::vector<uint32_t>        vertices (maxMeshlets * maxVertices);
+    std::vector<uint8_t>         triangles(maxMeshlets * maxPrimitives * 3);
+
+    auto meshletCount = meshopt_buildMeshlets(
+        meshlets.data(),
+        vertices.data(),
+        triangles.data(),
+        mesh.VertexIndices.data(),
+        indexCount,
+        &mesh.Positions[0].x,
+        vertexCount,
+        sizeof(asdx::Vector3),
+        maxVertices,
+        maxPrimitives,
+        coneWeight);
+
+    if (meshletCount == 0)
+    { return false; }
+
+    auto& last = meshlets[meshletCount - 1];
+
+    mesh.Meshlets     .resize(meshletCount);
+    mesh.MeshletBounds.resize(meshletCount);
+    mesh.UniqueVertexIndices.assign(vertices.begin(), vertices.begin() + last.vertex_offset + last.vertex_count);
+    mesh.PrimitiveIndices   .reserve(indexCount / 3);
+
+    for(size_t i=0; i<meshletCount; ++i)
+    {
+        const auto& src = meshlets[i];
+
+        auto& dst = mesh.Meshlets[i];
+        dst.VertexOffset    = src.vertex_offset;
+        dst.VertexCount     = src.vertex_count;
+        dst.PrimitiveOffset = uint32_t(mesh.PrimitiveIndices.size());
+        dst.PrimitiveCount  = src.triangle_count;
+
+        // 三角形を 10:10:10 にパックする.
+        auto tri = &triangles[src.triangle_offset];
+        for(auto j=0u; j<src.triangle_count; ++j, tri += 3)
+        { mesh.PrimitiveIndices.push_back(uint32_t(tri[0]) | (uint32_t(tri[1]) << 10) | (uint32_t(tri[2]) << 20)); }
+
+        auto bounds = meshopt_computeMeshletBounds(
+            &vertices[src.vertex_offset],
+            &triangles[src.triangle_offset],
+            src.triangle_count,
+            &mesh.Positions[0].x,
+            vertexCount,
+            sizeof(asdx::Vector3));
+
+        auto& dstBounds = mesh.MeshletBounds[i];
+        dstBounds.Center     = asdx::Vector3(bounds.center[0], bounds.center[1], bounds.center[2]);
+        dstBounds.Radius     = bounds.radius;
+        dstBounds.ConeApex   = asdx::Vector3(bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2]);
+        dstBounds.ConeCutoff = bounds.cone_cutoff;
+        dstBounds.ConeAxis   = asdx::Vector3(bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2]);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      LODチェインを生成します.
+//-----------------------------------------------------------------------------
+void GenerateLods(ResModel& model, const ResLodSettings& settings)
+{
+    // LOD0 のみ残す.
+    if (!model.LodRanges.empty())
+    {
+        auto& lod0 = model.LodRanges[0];
+        std::vector<ResMesh> meshes(
+            std::make_move_iterator(model.Meshes.begin() + lod0.Offset),
+            std::make_move_iterator(model.Meshes.begin() + lod0.Offset + lod0.Count));
+        model.Meshes.swap(meshes);
+        model.LodRanges.clear();
+    }
+
+    auto meshCount = model.Meshes.size();
+    if (meshCount == 0)
+    { return; }
+
+    auto lodCount = (settings.LodCount > 0) ? settings.LodCount : 1;
+
+    // メッシュ毎に並列に簡略化する. 簡略化できなかった段は1つ前の段をそのまま使う.
+    std::vector<std::vector<ResMesh>>   lods  (meshCount);
+    std::vector<std::vector<float>>     errors(meshCount);
+    std::vector<std::vector<bool>>      reduced(meshCount);
+
+    ParallelFor(0, meshCount, 1, [&](size_t i)
+    {
+        const auto& src = model.Meshes[i];
+        auto indexCount  = src.VertexIndices.size();
+        auto vertexCount = src.Positions.size();
+
+        lods   [i].resize(lodCount - 1);
+        errors [i].resize(lodCount - 1, 0.0f);
+        reduced[i].resize(lodCount - 1, false);
+
+        if (indexCount == 0 || vertexCount == 0 || !IsValidTriangleList(src))
+        {
+            for(auto& lod : lods[i])
+            { lod = src; }
+            return;
+        }
+
+        auto scale = meshopt_simplifyScale(&src.Positions[0].x, vertexCount, sizeof(asdx::Vector3));
+
+        std::vector<uint32_t> indices(indexCount);
+        auto prevCount = indexCount;
+        auto prevError = 0.0f;
+        auto ratio     = 1.0f;
+
+        for(auto l=1u; l<lodCount; ++l)
+        {
+            auto& dst = lods[i][l - 1];
+            ratio *= settings.Ratio;
+
+            auto target = size_t(float(indexCount) * ratio) / 3 * 3;
+            auto error  = 0.0f;
+
+            // 誤差の累積を避けるため，常に LOD0 から簡略化する.
+            auto count = meshopt_simplify(
+                indices.data(),
+                src.VertexIndices.data(),
+                indexCount,
+                &src.Positions[0].x,
+                vertexCount,
+                sizeof(asdx::Vector3),
+                target,
+                settings.TargetError,
+                &error);
+
+            if (settings.Sloppy && count > target)
+            {
+                count = meshopt_simplifySloppy(
+                    indices.data(),
+                    src.VertexIndices.data(),
+                    indexCount,
+                    &src.Positions[0].x,
+                    vertexCount,
+                    sizeof(asdx::Vector3),
+                    target,
+                    settings.TargetError,
+                    &error);
+            }
+
+            if (count == 0 || count >= prevCount)
+            {
+                dst = (l == 1) ? src : lods[i][l - 2];
+                errors[i][l - 1] = prevError;
+                continue;
+            }
+
+            dst.Name               = src.Name + "_lod" + std::to_string(l);
+            dst.MaterialId         = src.MaterialId;
+            dst.BoneInfluenceCount = src.BoneInfluenceCount;
+            dst.Positions          = src.Positions;
+            dst.Normals            = src.Normals;
+            dst.Tangents           = src.Tangents;
+            for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+            { dst.TexCoords[j] = src.TexCoords[j]; }
+            dst.Colors             = src.Colors;
+            dst.BoneIndices        = src.BoneIndices;
+            dst.BoneWeights        = src.BoneWeights;
+            dst.VertexIndices.assign(indices.begin(), indices.begin() + count);
+
+            // 参照されなくなった頂点はここで取り除かれる.
+            OptimizeMesh(dst);
+
+            prevCount = count;
+            prevError = (error * scale > prevError) ? error * scale : prevError;
+
+            errors [i][l - 1] = prevError;
+            reduced[i][l - 1] = true;
+        }
+    });
+
+    // 全てのメッシュが簡略化できなくなった段以降は破棄する.
+    auto validCount = 1u;
+    for(auto l=1u; l<lodCount; ++l)
+    {
+        auto any = false;
+        for(size_t i=0; i<meshCount; ++i)
+        { any |= reduced[i][l - 1]; }
+
+        if (!any)
+        { break; }
+
+        validCount = l + 1;
+    }
+
+    model.Meshes.reserve(meshCount * validCount);
+    model.LodRanges.resize(validCount);
+    model.LodRanges[0].Offset = 0;
+    model.LodRanges[0].Count  = uint32_t(meshCount);
+    model.LodRanges[0].Error  = 0.0f;
+
+    for(auto l=1u; l<validCount; ++l)
+    {
+        auto& range = model.LodRanges[l];
+        range.Offset = uint32_t(model.Meshes.size());
+        range.Count  = uint32_t(meshCount);
+        range.Error  = 0.0f;
+
+        for(size_t i=0; i<meshCount; ++i)
+        {
+            range.Error = (errors[i][l - 1] > range.Error) ? errors[i][l - 1] : range.Error;
+            model.Meshes.emplace_back(std::move(lods[i][l - 1]));
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      画面上での誤差からLOD番号を選択します.
+//-----------------------------------------------------------------------------
+uint32_t SelectLod
+(
+    const ResModel& model,
+    float           distance,
+    float           fovY,
+    float           screenHeight,
+    float           threshold
+)
+{
+    if (model.LodRanges.size() <= 1)
+    { return 0; }
+
+    // モデル空間での誤差をピクセル単位に変換する係数.
+    auto scale = screenHeight / (2.0f * tanf(fovY * 0.5f));
+    auto dist  = (distance > F_EPSILON) ? distance : F_EPSILON;
 
-    for(size_t i=0; i<vertexCount; ++i)
+    auto count = uint32_t(model.LodRanges.size());
+    for(auto l=count - 1; l>0; --l)
     {
-        // Reject = a - b * Dot(a, b);
-        const auto& a = resource.Tangents[i];
-        const auto& b = resource.Normals[i];
-        auto T = a - b * asdx::Vector3::Dot(a, b);
-        resource.Tangents[i] = asdx::Vector3::SafeNormalize(T, T);
+        if (model.LodRanges[l].Error * scale / dist <= threshold)
+        { return l; }
     }
-}
-
-} // namespace
 
-namespace asdx {
+    return 0;
+}
 
 //-----------------------------------------------------------------------------
 //      MTLファイルからマテリアルをロードします.
@@ -316,299 +2023,655 @@ bool LoadFromMTL(const char* path, ResModel& model)
 //-----------------------------------------------------------------------------
 //      OBJファイルからモデルをロードします.
 //-----------------------------------------------------------------------------
-bool LoadFromOBJ(std::ifstream& stream, const std::string& directory, ResModel& model)
+bool LoadFromOBJ(const char* path, ResModel& model)
 {
-    if (!stream.is_open())
+    MappedFile file;
+    if (!file.OpenA(path))
     {
-        ELOGA("Error : File Open Failed.");
+        ELOGA("Error : File Open Failed. path = %s", path);
         return false;
     }
 
-    const uint32_t BUFFER_LENGTH = 2048;
-    char buf[BUFFER_LENGTH] = {};
-    std::string group;
+    auto directory = asdx::GetDirectoryPathA(path);
+    auto data      = reinterpret_cast<const char*>(file.GetData());
+    auto size      = file.GetSize();
+
+    // チャンクに分割して並列にパースする.
+    auto pThreadPool = GetSharedThreadPool();
+    auto workers     = (pThreadPool != nullptr) ? size_t(pThreadPool->GetThreadCount()) + 1 : 1;
+    auto chunkCount  = size / kMinChunkSizeOBJ;
+    if (chunkCount > workers * 4)
+    { chunkCount = workers * 4; }
+    if (chunkCount < 1)
+    { chunkCount = 1; }
+
+    std::vector<ChunkOBJ> chunks;
+    SplitChunksOBJ(data, size, chunkCount, chunks);
+
+    ParallelFor(pThreadPool, 0, chunks.size(), 1, [&](size_t i)
+    {
+        ParseChunkOBJ(chunks[i]);
+    });
 
-    uint32_t faceIndex = 0;
-    uint32_t faceCount = 0;
+    // 各チャンクの格納先オフセットを求める.
+    std::vector<uint32_t> positionBase (chunks.size());
+    std::vector<uint32_t> normalBase   (chunks.size());
+    std::vector<uint32_t> texcoordBase (chunks.size());
+    std::vector<uint32_t> indexBase    (chunks.size());
 
-    std::vector<asdx::Vector3>      positions;
-    std::vector<asdx::Vector3>      normals;
-    std::vector<asdx::Vector2>      texcoords;
-    std::vector<IndexOBJ>           indices;
+    size_t positionCount = 0;
+    size_t normalCount   = 0;
+    size_t texcoordCount = 0;
+    size_t indexCount    = 0;
+
+    for(size_t i=0; i<chunks.size(); ++i)
+    {
+        positionBase[i] = uint32_t(positionCount);
+        normalBase  [i] = uint32_t(normalCount);
+        texcoordBase[i] = uint32_t(texcoordCount);
+        indexBase   [i] = uint32_t(indexCount);
+
+        positionCount += chunks[i].Positions.size();
+        normalCount   += chunks[i].Normals  .size();
+        texcoordCount += chunks[i].TexCoords.size();
+        indexCount    += chunks[i].Indices  .size();
+    }
+
+    if (indexCount > UINT32_MAX || positionCount > UINT32_MAX)
+    {
+        ELOGA("Error : Too Many Elements. path = %s", path);
+        return false;
+    }
+
+    // マージ.
+    std::vector<asdx::Vector3>      positions(positionCount);
+    std::vector<asdx::Vector3>      normals  (normalCount);
+    std::vector<asdx::Vector2>      texcoords(texcoordCount);
+    std::vector<IndexOBJ>           indices  (indexCount);
     std::vector<SubsetOBJ>          subsets;
     std::map<std::string, uint32_t> materials;
 
-    for(;;)
+    ParallelFor(pThreadPool, 0, chunks.size(), 1, [&](size_t i)
     {
-        stream >> buf;
-        if (!stream || stream.eof())
-            break;
+        auto& chunk = chunks[i];
 
-        if (0 == strcmp(buf, "#"))
-        {
-            /* DO_NOTHING */
-        }
-        else if (0 == strcmp(buf, "v"))
-        {
-            asdx::Vector3 v;
-            stream >> v.x >> v.y >> v.z;
-            positions.push_back(v);
-        }
-        else if (0 == strcmp(buf, "vt"))
-        {
-            asdx::Vector2 vt;
-            stream >> vt.x >> vt.y;
-            texcoords.push_back(vt);
-        }
-        else if (0 == strcmp(buf, "vn"))
-        {
-            asdx::Vector3 vn;
-            stream >> vn.x >> vn.y >> vn.z;
-            normals.push_back(vn);
-        }
-        else if (0 == strcmp(buf, "g"))
+        std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + positionBase[i]);
+        std::copy(chunk.Normals  .begin(), chunk.Normals  .end(), normals  .begin() + normalBase  [i]);
+        std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texcoords.begin() + texcoordBase[i]);
+        std::copy(chunk.Indices  .begin(), chunk.Indices  .end(), indices  .begin() + indexBase   [i]);
+
+        // 相対指定のインデックスを確定させる.
+        auto dst = indices.data() + indexBase[i];
+        for(auto slot : chunk.RelativeSlots)
         {
-            stream >> group;
+            auto& index = dst[slot / 3];
+            switch(slot % 3)
+            {
+            case 0: index.P += positionBase[i]; break;
+            case 1: index.N += normalBase  [i]; break;
+            case 2: index.U += texcoordBase[i]; break;
+            }
         }
-        else if (0 == strcmp(buf, "f"))
-        {
-            uint32_t ip, it, in;
-            uint32_t p[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
-            uint32_t t[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
-            uint32_t n[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
 
-            uint32_t count = 0;
-            uint32_t index = 0;
-
-            faceIndex++;
-            faceCount++;
+        // 不要になったメモリを解放.
+        chunk.Positions    .clear(); chunk.Positions    .shrink_to_fit();
+        chunk.Normals      .clear(); chunk.Normals      .shrink_to_fit();
+        chunk.TexCoords    .clear(); chunk.TexCoords    .shrink_to_fit();
+        chunk.Indices      .clear(); chunk.Indices      .shrink_to_fit();
+        chunk.RelativeSlots.clear(); chunk.RelativeSlots.shrink_to_fit();
+    });
 
-            for(auto i=0; i<4; ++i)
+    // コマンドはファイル順に処理する.
+    std::string group;
+    for(size_t i=0; i<chunks.size(); ++i)
+    {
+        for(auto& cmd : chunks[i].Commands)
+        {
+            switch(cmd.Type)
             {
-                count++;
+            case CommandOBJ::GROUP:
+                { group = cmd.Name; }
+                break;
 
-                // 位置座標インデックス.
-                stream >> ip;
-                p[i] = ip - 1;
-
-                if ('/' == stream.peek())
+            case CommandOBJ::MTLLIB:
                 {
-                    stream.ignore();
+                    if (cmd.Name.empty())
+                    { break; }
 
-                    // テクスチャ座標インデックス.
-                    if ('/' != stream.peek())
+                    auto mtlPath = directory + "/" + cmd.Name;
+                    if (!LoadFromMTL(mtlPath.c_str(), model))
                     {
-                        stream >> it;
-                        t[i] = it - 1;
+                        ELOGA("Error : Material Load Failed.");
+                        return false;
                     }
 
-                    // 法線インデックス.
-                    if ('/' == stream.peek())
-                    {
-                        stream.ignore();
-
-                        stream >> in;
-                        n[i] = in - 1;
-                    }
+                    // MaterialId検索マップ構築.
+                    for(size_t j=0; j<model.Materials.size(); ++j)
+                    { materials[model.Materials[j]] = uint32_t(j); }
                 }
+                break;
 
-                if (count <= 3)
+            case CommandOBJ::USEMTL:
                 {
-                    IndexOBJ f0 = { p[i], t[i], n[i] };
-                    indices.push_back(f0);
-                }
-
-                if ('\n' == stream.peek() || '\r' == stream.peek())
-                    break;
-            }
+                    SubsetOBJ subset = {};
 
-            // 四角形.
-            if (count > 3 && p[3] != UINT32_MAX)
-            {
-                assert(count == 4);
+                    auto itr = materials.find(cmd.Name);
+                    if (itr != materials.end())
+                    { subset.MaterialId = itr->second; }
 
-                faceIndex++;
-                faceCount++;
+                    if (group.empty())
+                    { group = "group" + std::to_string(subsets.size()); }
 
-                IndexOBJ f0 = { p[2], t[2], n[2] };
-                IndexOBJ f1 = { p[3], t[3], n[3] };
-                IndexOBJ f2 = { p[0], t[0], n[0] };
+                    subset.MeshName   = group;
+                    subset.IndexStart = indexBase[i] + cmd.IndexOffset;
+                    subsets.push_back(subset);
 
-                indices.push_back(f0);
-                indices.push_back(f1);
-                indices.push_back(f2);
+                    group.clear();
+                }
+                break;
             }
         }
-        else if (0 == strcmp(buf, "mtllib"))
+    }
+
+    chunks.clear();
+    file.Close();
+
+    // usemtl より前に定義された面.
+    if (indexCount > 0 && (subsets.empty() || subsets.front().IndexStart > 0))
+    {
+        SubsetOBJ subset = {};
+        subset.MeshName   = "default";
+        subset.IndexStart = 0;
+        subsets.insert(subsets.begin(), subset);
+    }
+
+    for(size_t i=0; i<subsets.size(); ++i)
+    {
+        auto next = (i + 1 < subsets.size()) ? subsets[i + 1].IndexStart : uint32_t(indexCount);
+        subsets[i].IndexCount = next - subsets[i].IndexStart;
+    }
+
+    subsets.erase(
+        std::remove_if(subsets.begin(), subsets.end(),
+            [](const SubsetOBJ& subset) { return subset.IndexCount == 0; }),
+        subsets.end());
+
+    std::stable_sort(subsets.begin(), subsets.end(),
+        [](const SubsetOBJ& lhs, const SubsetOBJ& rhs)
         {
-            std::string path;
-            stream >> path;
-            if (!path.empty())
-            {
-                path = directory + "/" + path;
+            return std::tie(lhs.MaterialId, lhs.IndexStart)
+                 < std::tie(rhs.MaterialId, rhs.IndexStart);
+        });
 
-                if (!LoadFromMTL(path.c_str(), model))
+    // マテリアル毎にメッシュを構築する.
+    size_t subsetIndex = 0;
+    uint32_t meshId = 0;
+    while(subsetIndex < subsets.size())
+    {
+        auto matId = subsets[subsetIndex].MaterialId;
+
+        size_t vertexCount = 0;
+        auto last = subsetIndex;
+        for(; last < subsets.size() && subsets[last].MaterialId == matId; ++last)
+        { vertexCount += subsets[last].IndexCount; }
+
+        asdx::ResMesh dstMesh;
+        dstMesh.Name       = std::string("mesh") + std::to_string(meshId);
+        dstMesh.MaterialId = matId;
+        dstMesh.Positions    .resize(vertexCount);
+        dstMesh.Normals      .resize(vertexCount);
+        dstMesh.VertexIndices.resize(vertexCount);
+        if (!texcoords.empty())
+        { dstMesh.TexCoords[0].resize(vertexCount); }
+
+        // 法線が欠けている頂点がある場合は再計算する.
+        auto calcNormals = normals.empty();
+        uint32_t vertId  = 0;
+
+        for(; subsetIndex < last; ++subsetIndex)
+        {
+            auto& subset = subsets[subsetIndex];
+            for(size_t j=0; j<subset.IndexCount; ++j)
+            {
+                auto& index = indices[subset.IndexStart + j];
+                if (index.P >= positions.size())
                 {
-                    ELOGA("Error : Material Load Failed.");
+                    ELOGA("Error : Invalid Vertex Index. path = %s", path);
                     return false;
                 }
 
-                // MaterialId検索マップ構築.
-                for(size_t i=0; i<model.Materials.size(); ++i)
-                { materials[model.Materials[i]] = uint32_t(i); }
+                dstMesh.Positions[vertId] = positions[index.P];
+
+                if (index.N < normals.size())
+                { dstMesh.Normals[vertId] = normals[index.N]; }
+                else
+                { calcNormals = true; }
+
+                if (!texcoords.empty())
+                {
+                    dstMesh.TexCoords[0][vertId] = (index.U < texcoords.size())
+                        ? texcoords[index.U]
+                        : asdx::Vector2(0.0f, 0.0f);
+                }
+
+                dstMesh.VertexIndices[vertId] = vertId;
+                vertId++;
             }
         }
-        else if (0 == strcmp(buf, "usemtl"))
-        {
-            SubsetOBJ subset = {};
 
-            std::string materialName;
-            stream >> materialName;
-
-            auto itr = materials.find(materialName);
-            if (itr != materials.end())
-            { subset.MaterialId = itr->second; }
+        // 面の頂点ごとに展開されているので，重複頂点を統合する.
+        if (calcNormals)
+        {
+            dstMesh.Normals.clear();
+            WeldVertices(dstMesh);
+            CalcNormals(dstMesh);
+        }
+        else
+        { WeldVertices(dstMesh); }
 
-            if (group.empty())
-            { group = "group" + std::to_string(subsets.size()); }
+        dstMesh.Positions    .shrink_to_fit();
+        dstMesh.Normals      .shrink_to_fit();
+        dstMesh.TexCoords[0] .shrink_to_fit();
 
-            subset.MeshName   = group;
-            subset.IndexStart = faceIndex * 3;
+        model.Meshes.emplace_back(std::move(dstMesh));
+        meshId++;
+    }
 
-            auto index = subsets.size() - 1;
-            subsets.push_back(subset);
+    model.Meshes.shrink_to_fit();
 
-            group.clear();
+    return true;
+}
 
-            if (subsets.size() > 1)
-            {
-                subsets[index].IndexCount = faceCount * 3;
-                faceCount = 0;
-            }
-        }
+//-----------------------------------------------------------------------------
+//      ファイルからリソースモデルを生成します.
+//-----------------------------------------------------------------------------
+bool ResModel::LoadFromFileA(const char* filename, bool optimize)
+{
+    auto ext = asdx::GetExtA(filename);
 
-        stream.ignore(BUFFER_LENGTH, '\n');
+    if (ext == "obj")
+    {
+        if (!LoadFromOBJ(filename, *this))
+        { return false; }
     }
+    else if (ext == "amdl")
+    {
+        CookedModel cooked;
+        if (!cooked.LoadA(filename))
+        { return false; }
 
-    if (subsets.size() > 0)
+        cooked.CopyTo(*this);
+    }
+    else
     {
-        auto index = subsets.size();
-        subsets[index - 1].IndexCount = faceCount * 3;
+        return false;
     }
 
-    stream.close();
-
-    std::stable_sort(subsets.begin(), subsets.end(),
-        [](const SubsetOBJ& lhs, const SubsetOBJ& rhs)
+    if (optimize)
+    {
+        ParallelFor(0, Meshes.size(), 1, [&](size_t i)
         {
-            return std::tie(lhs.MaterialId, lhs.IndexStart)
-                 < std::tie(rhs.MaterialId, rhs.IndexStart);
+            OptimizeMesh(Meshes[i]);
         });
+    }
 
-    uint32_t matId  = UINT32_MAX;
-    uint32_t vertId = 0;
-    uint32_t meshId = 0;
+    return true;
+}
 
-    asdx::ResMesh dstMesh;
+//-----------------------------------------------------------------------------
+//      ファイルからリソースモデルを生成します.
+//-----------------------------------------------------------------------------
+bool ResModel::LoadFromFileW(const wchar_t* filename, bool optimize)
+{
+    auto filenameA = asdx::ToStringA(filename);
+    return LoadFromFileA(filenameA.c_str(), optimize);
+}
 
-    for(size_t i=0; i<subsets.size(); ++i)
+//-----------------------------------------------------------------------------
+//      バイナリ形式でファイルに保存します.
+//-----------------------------------------------------------------------------
+bool ResModel::SaveToFileA(const char* filename) const
+{
+    FILE* pFile;
+    auto err = fopen_s(&pFile, filename, "wb");
+    if (err != 0)
     {
-        auto& subset = subsets[i];
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
 
-        if (matId != subset.MaterialId)
-        {
-            if (matId != UINT32_MAX)
-            {
-                if (!normals.empty())
-                { CalcNormals(dstMesh); }
+    return WriteAMDL(*this, pFile);
+}
 
-                dstMesh.Positions    .shrink_to_fit();
-                dstMesh.Normals      .shrink_to_fit();
-                dstMesh.TexCoords[0] .shrink_to_fit();
-                dstMesh.VertexIndices.shrink_to_fit();
+//-----------------------------------------------------------------------------
+//      バイナリ形式でファイルに保存します.
+//-----------------------------------------------------------------------------
+bool ResModel::SaveToFileW(const wchar_t* filename) const
+{
+    FILE* pFile;
+    auto err = _wfopen_s(&pFile, filename, L"wb");
+    if (err != 0)
+    {
+        ELOGW("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
 
-                model.Meshes.emplace_back(dstMesh);
+    return WriteAMDL(*this, pFile);
+}
 
-                dstMesh = asdx::ResMesh();
-                vertId = 0;
-            }
+///////////////////////////////////////////////////////////////////////////////
+// CookedModel class
+///////////////////////////////////////////////////////////////////////////////
 
-            dstMesh.Name       = std::string("mesh") + std::to_string(meshId);
-            dstMesh.MaterialId = subset.MaterialId;
+//-----------------------------------------------------------------------------
+//      コンストラクタです.
+//-----------------------------------------------------------------------------
+CookedModel::CookedModel()
+: m_pLodRanges  (nullptr)
+, m_LodCount    (0)
+{ /* DO_NOTHING */ }
 
-            meshId++;
-            matId = subset.MaterialId;
-        }
+//-----------------------------------------------------------------------------
+//      デストラクタです.
+//-----------------------------------------------------------------------------
+CookedModel::~CookedModel()
+{ Close(); }
 
-        for(size_t j=0; j<subset.IndexCount; ++j)
-        {
-            auto id = subset.IndexStart + j;
-            auto& index = indices[id];
+//-----------------------------------------------------------------------------
+//      ファイルをメモリにマップして読み込みます.
+//-----------------------------------------------------------------------------
+bool CookedModel::LoadA(const char* filename)
+{
+    Close();
 
-            dstMesh.Positions[vertId] = positions[index.P];
+    if (!m_File.OpenA(filename))
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
 
-            if (!normals.empty())
-            { dstMesh.Normals[vertId] = normals[index.N]; }
+    if (!Parse())
+    {
+        ELOGA("Error : Invalid File. path = %s", filename);
+        Close();
+        return false;
+    }
 
-            if (!texcoords.empty())
-            { dstMesh.TexCoords[0][vertId] = texcoords[index.U]; }
+    return true;
+}
 
-            dstMesh.VertexIndices.push_back(vertId);
+//-----------------------------------------------------------------------------
+//      ファイルをメモリにマップして読み込みます.
+//-----------------------------------------------------------------------------
+bool CookedModel::LoadW(const wchar_t* filename)
+{
+    Close();
 
-            vertId++;
-        }
+    if (!m_File.OpenW(filename))
+    {
+        ELOGW("Error : File Open Failed. path = %s", filename);
+        return false;
     }
 
-    if (matId != UINT32_MAX)
+    if (!Parse())
     {
-        if (normals.empty())
-        { CalcNormals(dstMesh); }
+        ELOGW("Error : Invalid File. path = %s", filename);
+        Close();
+        return false;
+    }
 
-        dstMesh.Positions    .shrink_to_fit();
-        dstMesh.Normals      .shrink_to_fit();
-        dstMesh.TexCoords[0] .shrink_to_fit();
-        dstMesh.VertexIndices.shrink_to_fit();
+    return true;
+}
 
-        model.Meshes.emplace_back(dstMesh);
-    }
+//-----------------------------------------------------------------------------
+//      ファイルを閉じます.
+//-----------------------------------------------------------------------------
+void CookedModel::Close()
+{
+    m_Meshes   .clear();
+    m_Materials.clear();
+    m_pLodRanges = nullptr;
+    m_LodCount   = 0;
+    m_File.Close();
+}
 
-    model.Meshes.shrink_to_fit();
+//-----------------------------------------------------------------------------
+//      メッシュ数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t CookedModel::GetMeshCount() const
+{ return uint32_t(m_Meshes.size()); }
+
+//-----------------------------------------------------------------------------
+//      メッシュを取得します.
+//-----------------------------------------------------------------------------
+const ResMeshView& CookedModel::GetMesh(uint32_t index) const
+{
+    assert(index < m_Meshes.size());
+    return m_Meshes[index];
+}
 
-    positions.clear();
-    normals  .clear();
-    texcoords.clear();
-    indices  .clear();
-    subsets  .clear();
+//-----------------------------------------------------------------------------
+//      LOD数を取得します.
+//-----------------------------------------------------------------------------
+uint32_t CookedModel::GetLodCount() const
+{ return m_LodCount; }
 
-    return true;
+//-----------------------------------------------------------------------------
+//      LOD範囲を取得します.
+//-----------------------------------------------------------------------------
+const ResLodRange& CookedModel::GetLodRange(uint32_t index) const
+{
+    assert(index < m_LodCount);
+    return m_pLodRanges[index];
 }
 
 //-----------------------------------------------------------------------------
-//      ファイルからリソースモデルを生成します.
+//      マテリアル数を取得します.
 //-----------------------------------------------------------------------------
-bool ResModel::LoadFromFileA(const char* filename)
+uint32_t CookedModel::GetMaterialCount() const
+{ return uint32_t(m_Materials.size()); }
+
+//-----------------------------------------------------------------------------
+//      マテリアル名を取得します.
+//-----------------------------------------------------------------------------
+const char* CookedModel::GetMaterialName(uint32_t index) const
 {
-    std::ifstream stream;
-    stream.open(filename, std::ios::in);
+    assert(index < m_Materials.size());
+    return m_Materials[index];
+}
 
-    auto directory = asdx::GetDirectoryPathA(filename);
-    auto ext = asdx::GetExtA(filename);
+//-----------------------------------------------------------------------------
+//      モデルリソースにコピーします.
+//-----------------------------------------------------------------------------
+void CookedModel::CopyTo(ResModel& model) const
+{
+    model.Meshes.resize(m_Meshes.size());
+    model.LodRanges.assign(m_pLodRanges, m_pLodRanges + m_LodCount);
+    model.Materials.assign(m_Materials.begin(), m_Materials.end());
 
-    if (ext == "obj")
+    ParallelFor(0, m_Meshes.size(), 1, [&](size_t i)
     {
-        return LoadFromOBJ(stream, directory, *this);
-    }
+        const auto& src = m_Meshes[i];
+        auto& dst = model.Meshes[i];
+
+        auto vertexCount = size_t(src.VertexCount);
+        auto boneCount   = size_t(src.BoneInfluenceCount) * vertexCount;
+
+        dst.Name               = src.Name;
+        dst.MaterialId         = src.MaterialId;
+        dst.BoneInfluenceCount = src.BoneInfluenceCount;
+
+        dst.Positions.assign(src.pPositions, src.pPositions + vertexCount);
+        if (src.pNormals  != nullptr) { dst.Normals .assign(src.pNormals,  src.pNormals  + vertexCount); }
+        if (src.pTangents != nullptr) { dst.Tangents.assign(src.pTangents, src.pTangents + vertexCount); }
+        for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        {
+            if (src.pTexCoords[j] != nullptr)
+            { dst.TexCoords[j].assign(src.pTexCoords[j], src.pTexCoords[j] + vertexCount); }
+        }
+        if (src.pColors      != nullptr) { dst.Colors     .assign(src.pColors,      src.pColors      + vertexCount); }
+        if (src.pBoneIndices != nullptr) { dst.BoneIndices.assign(src.pBoneIndices, src.pBoneIndices + boneCount); }
+        if (src.pBoneWeights != nullptr) { dst.BoneWeights.assign(src.pBoneWeights, src.pBoneWeights + boneCount); }
 
-    return false;
+        dst.VertexIndices.assign(src.pVertexIndices, src.pVertexIndices + src.IndexCount);
+
+        if (src.pMeshlets != nullptr)
+        {
+            dst.Meshlets           .assign(src.pMeshlets,            src.pMeshlets            + src.MeshletCount);
+            dst.UniqueVertexIndices.assign(src.pUniqueVertexIndices, src.pUniqueVertexIndices + src.UniqueVertexIndexCount);
+            dst.PrimitiveIndices   .assign(src.pPrimitiveIndices,    src.pPrimitiveIndices    + src.PrimitiveCount);
+            dst.MeshletBounds      .assign(src.pMeshletBounds,       src.pMeshletBounds       + src.MeshletCount);
+        }
+    });
 }
 
 //-----------------------------------------------------------------------------
-//      ファイルからリソースモデルを生成します.
+//      マップされたデータを解析します.
 //-----------------------------------------------------------------------------
-bool ResModel::LoadFromFileW(const wchar_t* filename)
+bool CookedModel::Parse()
 {
-    auto filenameA = asdx::ToStringA(filename);
-    return LoadFromFileA(filenameA.c_str());
+    auto data     = m_File.GetData();
+    auto fileSize = uint64_t(m_File.GetSize());
+
+    if (data == nullptr || fileSize < sizeof(HeaderAMDL))
+    { return false; }
+
+    auto& header = *reinterpret_cast<const HeaderAMDL*>(data);
+    if (header.Magic != kMagic)
+    {
+        ELOGA("Error : Invalid Magic.");
+        return false;
+    }
+
+    if (header.Version != kVersion)
+    {
+        ELOGA("Error : Unsupported Version. version = %u", header.Version);
+        return false;
+    }
+
+    if (header.FileSize != fileSize)
+    {
+        ELOGA("Error : File Size Mismatch.");
+        return false;
+    }
+
+    if (!IsInRangeAMDL(header.MeshOffset,     uint64_t(header.MeshCount)     * sizeof(MeshAMDL),    fileSize)
+     || !IsInRangeAMDL(header.LodOffset,      uint64_t(header.LodCount)      * sizeof(ResLodRange), fileSize)
+     || !IsInRangeAMDL(header.MaterialOffset, uint64_t(header.MaterialCount) * sizeof(uint64_t),    fileSize)
+     || (header.MeshOffset % 8) != 0
+     || (header.LodOffset  % 8) != 0
+     || (header.MaterialOffset % 8) != 0)
+    { return false; }
+
+    // 文字列が範囲内で終端されているか確認しつつ取得する.
+    auto getString = [&](uint64_t offset) -> const char*
+    {
+        if (offset >= fileSize)
+        { return nullptr; }
+
+        auto ptr = reinterpret_cast<const char*>(data + offset);
+        if (memchr(ptr, '\0', size_t(fileSize - offset)) == nullptr)
+        { return nullptr; }
+
+        return ptr;
+    };
+
+    m_Materials.resize(header.MaterialCount);
+    auto matOffsets = reinterpret_cast<const uint64_t*>(data + header.MaterialOffset);
+    for(auto i=0u; i<header.MaterialCount; ++i)
+    {
+        m_Materials[i] = getString(matOffsets[i]);
+        if (m_Materials[i] == nullptr)
+        { return false; }
+    }
+
+    m_pLodRanges = reinterpret_cast<const ResLodRange*>(data + header.LodOffset);
+    m_LodCount   = header.LodCount;
+    for(auto i=0u; i<m_LodCount; ++i)
+    {
+        auto& range = m_pLodRanges[i];
+        if (uint64_t(range.Offset) + range.Count > header.MeshCount)
+        { return false; }
+    }
+
+    m_Meshes.resize(header.MeshCount);
+    auto meshes = reinterpret_cast<const MeshAMDL*>(data + header.MeshOffset);
+    for(auto i=0u; i<header.MeshCount; ++i)
+    {
+        const auto& src = meshes[i];
+        auto& dst = m_Meshes[i];
+
+        const void* streams[STREAM_AMDL_COUNT] = {};
+        for(auto j=0u; j<STREAM_AMDL_COUNT; ++j)
+        {
+            auto offset = src.StreamOffset[j];
+            if (offset == 0)
+            { continue; }
+
+            if ((offset % kStreamAlignmentAMDL) != 0 || !IsInRangeAMDL(offset, GetStreamSizeAMDL(src, j), fileSize))
+            { return false; }
+
+            streams[j] = data + offset;
+        }
+
+        // 必須ストリームの確認.
+        if ((src.VertexCount > 0 && streams[STREAM_AMDL_POSITION]     == nullptr)
+         || (src.IndexCount  > 0 && streams[STREAM_AMDL_VERTEX_INDEX] == nullptr))
+        { return false; }
+
+        auto hasMeshlets = src.MeshletCount > 0
+                        && streams[STREAM_AMDL_MESHLET]             != nullptr
+                        && streams[STREAM_AMDL_UNIQUE_VERTEX_INDEX] != nullptr
+                        && streams[STREAM_AMDL_PRIMITIVE_INDEX]     != nullptr
+                        && streams[STREAM_AMDL_MESHLET_BOUNDS]      != nullptr;
+
+        dst.Name                    = getString(src.NameOffset);
+        dst.MaterialId              = src.MaterialId;
+        dst.BoneInfluenceCount      = src.BoneInfluenceCount;
+        dst.VertexCount             = src.VertexCount;
+        dst.IndexCount              = src.IndexCount;
+        dst.MeshletCount            = hasMeshlets ? src.MeshletCount           : 0;
+        dst.UniqueVertexIndexCount  = hasMeshlets ? src.UniqueVertexIndexCount : 0;
+        dst.PrimitiveCount          = hasMeshlets ? src.PrimitiveCount         : 0;
+
+        if (dst.Name == nullptr)
+        { return false; }
+
+        dst.pPositions = static_cast<const Vector3*>(streams[STREAM_AMDL_POSITION]);
+        dst.pNormals   = static_cast<const Vector3*>(streams[STREAM_AMDL_NORMAL]);
+        dst.pTangents  = static_cast<const Vector3*>(streams[STREAM_AMDL_TANGENT]);
+        for(auto j=0u; j<ResMesh::MAX_TEXCOORD_LAYERS; ++j)
+        { dst.pTexCoords[j] = static_cast<const Vector2*>(streams[STREAM_AMDL_TEXCOORD0 + j]); }
+        dst.pColors        = static_cast<const Vector4*> (streams[STREAM_AMDL_COLOR]);
+        dst.pBoneIndices   = static_cast<const uint16_t*>(streams[STREAM_AMDL_BONE_INDEX]);
+        dst.pBoneWeights   = static_cast<const float*>   (streams[STREAM_AMDL_BONE_WEIGHT]);
+        dst.pVertexIndices = static_cast<const uint32_t*>(streams[STREAM_AMDL_VERTEX_INDEX]);
+
+        dst.pMeshlets            = hasMeshlets ? static_cast<const ResMeshlet*>      (streams[STREAM_AMDL_MESHLET])             : nullptr;
+        dst.pUniqueVertexIndices = hasMeshlets ? static_cast<const uint32_t*>        (streams[STREAM_AMDL_UNIQUE_VERTEX_INDEX]) : nullptr;
+        dst.pPrimitiveIndices    = hasMeshlets ? static_cast<const uint32_t*>        (streams[STREAM_AMDL_PRIMITIVE_INDEX])     : nullptr;
+        dst.pMeshletBounds       = hasMeshlets ? static_cast<const ResMeshletBounds*>(streams[STREAM_AMDL_MESHLET_BOUNDS])      : nullptr;
+
+        // インデックスが頂点ストリームの範囲外を指していないか確認する.
+        if (!IsValidIndicesAMDL(dst.pVertexIndices, dst.IndexCount, dst.VertexCount))
+        {
+            ELOGA("Error : Vertex Index Out of Range. mesh = %s", dst.Name);
+            return false;
+        }
+
+        if (hasMeshlets)
+        {
+            if (!IsValidIndicesAMDL(dst.pUniqueVertexIndices, dst.UniqueVertexIndexCount, dst.VertexCount)
+             || !IsValidMeshletsAMDL(dst.pMeshlets, dst.MeshletCount, dst.UniqueVertexIndexCount, dst.pPrimitiveIndices, dst.PrimitiveCount))
+            {
+                ELOGA("Error : Meshlet Index Out of Range. mesh = %s", dst.Name);
+                return false;
+            }
+        }
+    }
+
+    return true;
 }
 
+
 } // namespace asdx
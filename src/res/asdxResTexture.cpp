@@ -15,8 +15,21 @@
 #include <wincodec.h>
 #include <wrl/client.h>
 #include <res/asdxResTexture.h>
+#include <fnd/asdxMappedFile.h>
 #include <fnd/asdxLogger.h>
 #include <fnd/asdxMath.h>
+#include <fnd/asdxParallel.h>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define ASDX_TEXTURE_SSE2   (1)
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define ASDX_TARGET_SSSE3
+    #else
+        #define ASDX_TARGET_SSSE3   __attribute__((target("ssse3")))
+    #endif
+#endif
 
 
 //-------------------------------------------------------------------------------------------------
@@ -102,6 +115,12 @@ static const unsigned int FOURCC_A32B32G32R32F  = 0x00000074;
 static const unsigned int FOURCC_CxV8U8         = 0x00000075;
 static const unsigned int FOURCC_Q8W8V8U8       = 0x0000003f;
 
+// DX10 拡張ヘッダ.
+static const unsigned int DDS_DIMENSION_TEXTURE1D   = 2;            // D3D10_RESOURCE_DIMENSION_TEXTURE1D
+static const unsigned int DDS_DIMENSION_TEXTURE2D   = 3;            // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+static const unsigned int DDS_DIMENSION_TEXTURE3D   = 4;            // D3D10_RESOURCE_DIMENSION_TEXTURE3D
+static const unsigned int DDS_MISC_TEXTURECUBE      = 0x00000004;   // D3D10_RESOURCE_MISC_TEXTURECUBE
+
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // NATIVE_TEXTURE_FORMAT enum
@@ -128,6 +147,14 @@ enum NATIVE_TEXTURE_FORMAT
     NATIVE_TEXTURE_FORMAT_R32_FLOAT,
     NATIVE_TEXTURE_FORMAT_G32R32_FLOAT,
     NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT,
+    NATIVE_TEXTURE_FORMAT_BC6H,
+    NATIVE_TEXTURE_FORMAT_BC7,
+    NATIVE_TEXTURE_FORMAT_R16,
+    NATIVE_TEXTURE_FORMAT_A16B16G16R16,
+    NATIVE_TEXTURE_FORMAT_B32G32R32_FLOAT,
+    NATIVE_TEXTURE_FORMAT_A2B10G10R10,
+    NATIVE_TEXTURE_FORMAT_A1R5G5B5,
+    NATIVE_TEXTURE_FORMAT_R5G6B5,
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -201,6 +228,19 @@ typedef struct __DDSurfaceDesc
 } DDSurfaceDesc;
 
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// DDSHeaderDX10 structure
+///////////////////////////////////////////////////////////////////////////////////////////////////
+typedef struct __DDSHeaderDX10
+{
+    unsigned int    dxgiFormat;
+    unsigned int    resourceDimension;
+    unsigned int    miscFlag;
+    unsigned int    arraySize;
+    unsigned int    miscFlags2;
+} DDSHeaderDX10;
+
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // WIC Pixel Format Translation Data
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -359,6 +399,54 @@ inline RGBE Vec3ToRGBE( const asdx::Vector3& val )
     return result;
 }
 
+//------------------------------------------------------------------------------------------
+//      RGBE形式の配列をRGBA形式のfloat配列に変換します(アルファは1).
+//------------------------------------------------------------------------------------------
+void RGBEToFloat4( const RGBE* pSrc, size_t count, float* pDst )
+{
+    size_t i = 0;
+
+#if defined(ASDX_TEXTURE_SSE2)
+    // 2^(e - 136) を 2^((e >> 1) - 68) * 2^(e - (e >> 1) - 68) に分けて，
+    // 非正規化数とオーバーフローを避ける. 1回目の乗算は誤差が出ないので RGBEToVec3() と同じ結果になる.
+    const auto zero  = _mm_setzero_si128();
+    const auto bias  = _mm_set1_epi32( 127 - 68 );
+    const auto maskA = _mm_castsi128_ps( _mm_setr_epi32( 0, 0, 0, -1 ) );
+    const auto one   = _mm_set1_ps( 1.0f );
+
+    for( ; i + 4 <= count; i += 4 )
+    {
+        auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i ) );
+        __m128i w[2] = { _mm_unpacklo_epi8( v, zero ), _mm_unpackhi_epi8( v, zero ) };
+
+        for( auto j=0; j<4; ++j )
+        {
+            auto p  = ( j & 1 ) ? _mm_unpackhi_epi16( w[ j >> 1 ], zero ) : _mm_unpacklo_epi16( w[ j >> 1 ], zero );
+            auto e  = _mm_shuffle_epi32( p, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            auto e0 = _mm_srli_epi32( e, 1 );
+            auto e1 = _mm_sub_epi32( e, e0 );
+            auto f0 = _mm_castsi128_ps( _mm_slli_epi32( _mm_add_epi32( e0, bias ), 23 ) );
+            auto f1 = _mm_castsi128_ps( _mm_slli_epi32( _mm_add_epi32( e1, bias ), 23 ) );
+            auto c  = _mm_mul_ps( _mm_mul_ps( _mm_cvtepi32_ps( p ), f0 ), f1 );
+
+            // 指数が 0 の場合は黒.
+            c = _mm_andnot_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( e, zero ) ), c );
+            c = _mm_or_ps( _mm_andnot_ps( maskA, c ), _mm_and_ps( maskA, one ) );
+            _mm_storeu_ps( pDst + ( i + j ) * 4, c );
+        }
+    }
+#endif
+
+    for( ; i<count; ++i )
+    {
+        auto pix = RGBEToVec3( pSrc[i] );
+        pDst[ i * 4 + 0 ] = pix.x;
+        pDst[ i * 4 + 1 ] = pix.y;
+        pDst[ i * 4 + 2 ] = pix.z;
+        pDst[ i * 4 + 3 ] = 1.0f;
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 // Global Variables.
 //-------------------------------------------------------------------------------------------------
@@ -629,6 +717,211 @@ bool CheckMask
     return false;
 }
 
+//-------------------------------------------------------------------------------------------------
+//      DXGIフォーマットからネイティブフォーマットを取得します.
+//-------------------------------------------------------------------------------------------------
+bool GetNativeFormat( unsigned int dxgiFormat, unsigned int& nativeFormat )
+{
+    switch( dxgiFormat )
+    {
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+    case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_ABGR_8888; }
+        break;
+
+    // DX10拡張ヘッダでは DXGI フォーマットのまま読み書きするので，並びの補正が不要な方を返す.
+    case DXGI_FORMAT_B8G8R8A8_UNORM:
+    case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_ABGR_8888; }
+        break;
+
+    case DXGI_FORMAT_B8G8R8X8_UNORM:
+    case DXGI_FORMAT_B8G8R8X8_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_XBGR_8888; }
+        break;
+
+    case DXGI_FORMAT_R8_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R8; }
+        break;
+
+    case DXGI_FORMAT_R16_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R16; }
+        break;
+
+    case DXGI_FORMAT_R16G16B16A16_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A16B16G16R16; }
+        break;
+
+    case DXGI_FORMAT_R32G32B32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_B32G32R32_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R10G10B10A2_UNORM:
+    case DXGI_FORMAT_R10G10B10_XR_BIAS_A2_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A2B10G10R10; }
+        break;
+
+    case DXGI_FORMAT_B5G5R5A1_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A1R5G5B5; }
+        break;
+
+    case DXGI_FORMAT_B5G6R5_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R5G6B5; }
+        break;
+
+    case DXGI_FORMAT_A8_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A8; }
+        break;
+
+    case DXGI_FORMAT_R8G8_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_L8A8; }
+        break;
+
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC1; }
+        break;
+
+    case DXGI_FORMAT_BC2_UNORM:
+    case DXGI_FORMAT_BC2_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC2; }
+        break;
+
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC3; }
+        break;
+
+    case DXGI_FORMAT_BC4_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC4U; }
+        break;
+
+    case DXGI_FORMAT_BC4_SNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC4S; }
+        break;
+
+    case DXGI_FORMAT_BC5_UNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC5U; }
+        break;
+
+    case DXGI_FORMAT_BC5_SNORM:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC5S; }
+        break;
+
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC6H_SF16:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC6H; }
+        break;
+
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_BC7; }
+        break;
+
+    case DXGI_FORMAT_R16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R16_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R16G16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_G16R16_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R16G16B16A16_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_R32_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R32G32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_G32R32_FLOAT; }
+        break;
+
+    case DXGI_FORMAT_R32G32B32A32_FLOAT:
+        { nativeFormat = NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT; }
+        break;
+
+    default:
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DX10拡張ヘッダを解析します.
+//-------------------------------------------------------------------------------------------------
+bool ParseDDSHeaderDX10( const DDSHeaderDX10& header, asdx::ResTexture& resTexture, unsigned int& nativeFormat )
+{
+    if ( !GetNativeFormat( header.dxgiFormat, nativeFormat ) )
+    { return false; }
+
+    resTexture.Format = header.dxgiFormat;
+
+    auto arraySize = ( header.arraySize > 0 ) ? header.arraySize : 1;
+
+    switch( header.resourceDimension )
+    {
+    case DDS_DIMENSION_TEXTURE1D:
+        {
+            resTexture.Dimension    = asdx::TEXTURE_DIMENSION_1D;
+            resTexture.SurfaceCount = arraySize;
+        }
+        break;
+
+    case DDS_DIMENSION_TEXTURE2D:
+        {
+            if ( header.miscFlag & DDS_MISC_TEXTURECUBE )
+            {
+                resTexture.Dimension    = asdx::TEXTURE_DIMENSION_CUBE;
+                resTexture.SurfaceCount = arraySize * 6;
+                resTexture.Depth        = 1;
+            }
+            else
+            {
+                resTexture.Dimension    = asdx::TEXTURE_DIMENSION_2D;
+                resTexture.SurfaceCount = arraySize;
+            }
+        }
+        break;
+
+    case DDS_DIMENSION_TEXTURE3D:
+        {
+            resTexture.Dimension = asdx::TEXTURE_DIMENSION_3D;
+        }
+        break;
+
+    default:
+        { return false; }
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ブロック圧縮フォーマットかどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsBlockCompressed( unsigned int nativeFormat )
+{
+    switch( nativeFormat )
+    {
+    case NATIVE_TEXTURE_FORMAT_BC1:
+    case NATIVE_TEXTURE_FORMAT_BC2:
+    case NATIVE_TEXTURE_FORMAT_BC3:
+    case NATIVE_TEXTURE_FORMAT_BC4U:
+    case NATIVE_TEXTURE_FORMAT_BC4S:
+    case NATIVE_TEXTURE_FORMAT_BC5U:
+    case NATIVE_TEXTURE_FORMAT_BC5S:
+    case NATIVE_TEXTURE_FORMAT_BC6H:
+    case NATIVE_TEXTURE_FORMAT_BC7:
+        { return true; }
+
+    default:
+        { return false; }
+    }
+}
+
 size_t GetBitPerPixel( unsigned int format )
 {
     switch( format )
@@ -637,10 +930,16 @@ size_t GetBitPerPixel( unsigned int format )
     case NATIVE_TEXTURE_FORMAT_A8:
         { return 8; }
 
+    case NATIVE_TEXTURE_FORMAT_L8A8:
+    case NATIVE_TEXTURE_FORMAT_A1R5G5B5:
+    case NATIVE_TEXTURE_FORMAT_R5G6B5:
+        { return 16; }
+
     case NATIVE_TEXTURE_FORMAT_ARGB_8888:
     case NATIVE_TEXTURE_FORMAT_ABGR_8888:
     case NATIVE_TEXTURE_FORMAT_XRGB_8888:
     case NATIVE_TEXTURE_FORMAT_XBGR_8888:
+    case NATIVE_TEXTURE_FORMAT_A2B10G10R10:
         { return 32; }
 
     case NATIVE_TEXTURE_FORMAT_BC1:
@@ -652,15 +951,19 @@ size_t GetBitPerPixel( unsigned int format )
     case NATIVE_TEXTURE_FORMAT_BC3:
     case NATIVE_TEXTURE_FORMAT_BC5U:
     case NATIVE_TEXTURE_FORMAT_BC5S:
+    case NATIVE_TEXTURE_FORMAT_BC6H:
+    case NATIVE_TEXTURE_FORMAT_BC7:
         { return 8; }
 
     case NATIVE_TEXTURE_FORMAT_R16_FLOAT:
+    case NATIVE_TEXTURE_FORMAT_R16:
         { return 16; }
 
     case NATIVE_TEXTURE_FORMAT_G16R16_FLOAT:
         { return 32; }
 
     case NATIVE_TEXTURE_FORMAT_A16B16G16R16_FLOAT:
+    case NATIVE_TEXTURE_FORMAT_A16B16G16R16:
         { return 64; }
 
     case NATIVE_TEXTURE_FORMAT_R32_FLOAT:
@@ -669,6 +972,9 @@ size_t GetBitPerPixel( unsigned int format )
     case NATIVE_TEXTURE_FORMAT_G32R32_FLOAT:
         { return 64; }
 
+    case NATIVE_TEXTURE_FORMAT_B32G32R32_FLOAT:
+        { return 96; }
+
     case NATIVE_TEXTURE_FORMAT_A32B32G32R32_FLOAT:
         { return 128; }
 
@@ -741,327 +1047,346 @@ std::string GetExtA( const char* filePath )
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8Bitインデックスカラー形式を解析します.
+//! @brief      Targaのピクセル変換関数です.
 //!
-//! @param[in]      pColorMap       カラーマップです.
+//! @param[in]      pSrc        変換元のピクセルデータです.
+//! @param[in]      count       変換するピクセル数です.
+//! @param[out]     pDst        変換先のピクセルデータです.
+//! @param[in]      pPalette    RGBAに展開済みのカラーパレットです(インデックスカラー以外では未使用).
 //-------------------------------------------------------------------------------------------------
-void Parse8Bits( FILE* pFile, uint32_t size, uint8_t* pColorMap, uint8_t* pPixels )
+typedef void (*TgaConvertFunc)( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* pPalette );
+
+#if defined(ASDX_TEXTURE_SSE2)
+//-------------------------------------------------------------------------------------------------
+//! @brief      SSSE3命令が使用可能かどうかチェックします.
+//-------------------------------------------------------------------------------------------------
+bool IsSupportedSSSE3()
 {
-    uint8_t color = 0;
-    for( uint32_t i=0; i<size; ++i )
-    {
-        color = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 2 ] = pColorMap[ color * 3 + 0 ];
-        pPixels[ i * 4 + 1 ] = pColorMap[ color * 3 + 1 ];
-        pPixels[ i * 4 + 0 ] = pColorMap[ color * 3 + 2 ];
-        pPixels[ i * 4 + 3 ] = 255;
-    }
+#if defined(__SSSE3__) || (defined(_MSC_VER) && defined(__AVX__))
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return ( info[2] & ( 1 << 9 ) ) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
+#endif
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16Bitフルカラー形式を解析します.
+//! @brief      SSSE3命令が使用可能かどうかを取得します.
 //-------------------------------------------------------------------------------------------------
-void Parse16Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool UseSSSE3()
 {
-    for( uint32_t i=0; i<size; ++i )
-    {
-        uint16_t color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
-        pPixels[ i * 4 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-        pPixels[ i * 4 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-        pPixels[ i * 4 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-        pPixels[ i * 4 + 3 ] = 255;
-    }
+    static const bool s_Supported = IsSupportedSSSE3();
+    return s_Supported;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24Bitフルカラー形式を解析します.
+//! @brief      BGRの並びをRGBAに展開します(SSSE3).
+//!
+//! @return     変換したピクセル数を返却します.
 //-------------------------------------------------------------------------------------------------
-void Parse24Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+ASDX_TARGET_SSSE3
+uint32_t ConvertBGRToRGBASSSE3( const uint8_t* pSrc, uint32_t count, uint8_t* pDst )
 {
-    for( uint32_t i=0; i<size; ++i )
+    // 12byte(4ピクセル)を16byteに並び替え, アルファを埋める.
+    const auto shuffle = _mm_setr_epi8( 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1 );
+    const auto alpha   = _mm_set1_epi32( int( 0xFF000000 ) );
+
+    // 16byte読み込むので末尾の4byteを超えないようにする.
+    uint32_t i = 0;
+    for( ; i + 6 <= count; i += 4 )
     {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = 255;
+        auto v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i * 3 ) );
+        v = _mm_or_si128( _mm_shuffle_epi8( v, shuffle ), alpha );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst + i * 4 ), v );
     }
+    return i;
 }
+#endif//ASDX_TEXTURE_SSE2
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32Bitフルカラー形式を解析します.
+//! @brief      8Bitインデックスカラーを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse32Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertIndex8( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* pPalette )
 {
-    for( uint32_t i=0; i<size; ++i )
-    {
-        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 4 + 3 ] = (uint8_t)fgetc( pFile );
-    }
+    for( uint32_t i=0; i<count; ++i )
+    { memcpy( pDst + i * 4, pPalette + pSrc[ i ] * 4, 4 ); }
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief     8Bitグレースケール形式を解析します.
+//! @brief      16Bitフルカラー(X1R5G5B5)をRGBAに変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertBGR555( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* )
 {
-    for( uint32_t i=0; i<size; ++i )
+    for( uint32_t i=0; i<count; ++i )
     {
-        pPixels[ i ] = (uint8_t)fgetc( pFile );
+        uint16_t color = uint16_t( pSrc[ i * 2 + 0 ] | ( pSrc[ i * 2 + 1 ] << 8 ) );
+        pDst[ i * 4 + 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
+        pDst[ i * 4 + 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
+        pDst[ i * 4 + 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
+        pDst[ i * 4 + 3 ] = 255;
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16Bitグレースケール形式を解析します.
+//! @brief      24Bitフルカラー(BGR)をRGBAに変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScale( FILE* pFile, uint32_t size, uint8_t* pPixels )
+void ConvertBGR( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* )
 {
-    for( uint32_t i=0; i<size; ++i )
+    uint32_t i = 0;
+
+#if defined(ASDX_TEXTURE_SSE2)
+    if ( UseSSSE3() )
+    { i = ConvertBGRToRGBASSSE3( pSrc, count, pDst ); }
+#endif
+
+    for( ; i<count; ++i )
     {
-        pPixels[ i * 2 + 0 ] = (uint8_t)fgetc( pFile );
-        pPixels[ i * 2 + 1 ] = (uint8_t)fgetc( pFile );
+        pDst[ i * 4 + 0 ] = pSrc[ i * 3 + 2 ];
+        pDst[ i * 4 + 1 ] = pSrc[ i * 3 + 1 ];
+        pDst[ i * 4 + 2 ] = pSrc[ i * 3 + 0 ];
+        pDst[ i * 4 + 3 ] = 255;
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮インデックスカラー形式を解析します.
-//!
-//! @param[in]  pColorMap       カラーマップです.
+//! @brief      32Bitフルカラー(BGRA)をRGBAに変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse8BitsRLE( FILE* pFile, uint8_t* pColorMap, uint32_t size, uint8_t* pPixels )
+void ConvertBGRA( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* )
 {
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
+    uint32_t i = 0;
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
+#if defined(ASDX_TEXTURE_SSE2)
+    // G, A はそのままで, R と B の入った16bitの上位と下位を入れ替える.
+    const auto maskGA = _mm_set1_epi32( int( 0xFF00FF00 ) );
+    for( ; i + 4 <= count; i += 4 )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                color = (uint8_t)fgetc( pFile );
+        auto v  = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pSrc + i * 4 ) );
+        auto ga = _mm_and_si128( v, maskGA );
+        auto rb = _mm_andnot_si128( maskGA, v );
+        rb = _mm_shufflehi_epi16( _mm_shufflelo_epi16( rb, 0xB1 ), 0xB1 );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( pDst + i * 4 ), _mm_or_si128( ga, rb ) );
+    }
+#endif
 
-                ptr[ 0 ] = pColorMap[ color * 3 + 2 ];
-                ptr[ 1 ] = pColorMap[ color * 3 + 1 ];
-                ptr[ 2 ] = pColorMap[ color * 3 + 0 ];
-                ptr[ 3 ] = 255;
-            }
-        }
+    for( ; i<count; ++i )
+    {
+        pDst[ i * 4 + 0 ] = pSrc[ i * 4 + 2 ];
+        pDst[ i * 4 + 1 ] = pSrc[ i * 4 + 1 ];
+        pDst[ i * 4 + 2 ] = pSrc[ i * 4 + 0 ];
+        pDst[ i * 4 + 3 ] = pSrc[ i * 4 + 3 ];
     }
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮フルカラー形式を解析します.
+//! @brief      8Bitグレースケールを変換します.
 //-------------------------------------------------------------------------------------------------
-void Parse16BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
-{
-    uint32_t count  = 0;
-    uint16_t color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixels;
+void ConvertGray8( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* )
+{ memcpy( pDst, pSrc, count ); }
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+//-------------------------------------------------------------------------------------------------
+//! @brief      16Bitグレースケール(輝度とアルファ)を変換します.
+//-------------------------------------------------------------------------------------------------
+void ConvertGray16( const uint8_t* pSrc, uint32_t count, uint8_t* pDst, const uint8_t* )
+{ memcpy( pDst, pSrc, count * 2 ); }
 
-        if ( header & 0x80 )
-        {
-            color = fgetc( pFile ) + ( fgetc( pFile ) << 8 ); 
+//-------------------------------------------------------------------------------------------------
+//! @brief      非圧縮のピクセルデータを解析します.
+//!
+//! @param[in]      pSrc        ピクセルデータの先頭です.
+//! @param[in]      pEnd        バッファの終端です.
+//! @param[in]      width       画像の横幅です.
+//! @param[in]      height      画像の縦幅です.
+//! @param[in]      srcBytes    変換元の1ピクセル当たりのバイト数です.
+//! @param[in]      dstBytes    変換先の1ピクセル当たりのバイト数です.
+//! @param[in]      convert     ピクセル変換関数です.
+//! @param[in]      pPalette    カラーパレットです.
+//! @param[out]     pPixels     変換先のピクセルデータです.
+//! @retval true    解析に成功.
+//! @retval false   データが不足しています.
+//-------------------------------------------------------------------------------------------------
+bool ParseTgaRaw
+(
+    const uint8_t*  pSrc,
+    const uint8_t*  pEnd,
+    uint32_t        width,
+    uint32_t        height,
+    uint32_t        srcBytes,
+    uint32_t        dstBytes,
+    TgaConvertFunc  convert,
+    const uint8_t*  pPalette,
+    uint8_t*        pPixels
+)
+{
+    auto srcPitch = size_t( width ) * srcBytes;
+    auto dstPitch = size_t( width ) * dstBytes;
 
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
-        }
-        else
-        {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                color = fgetc( pFile ) + ( fgetc( pFile ) << 8 );
+    if ( size_t( pEnd - pSrc ) < srcPitch * height )
+    { return false; }
 
-                ptr[ 0 ] = (uint8_t)(( ( color & 0x7C00 ) >> 10 ) << 3);
-                ptr[ 1 ] = (uint8_t)(( ( color & 0x03E0 ) >>  5 ) << 3);
-                ptr[ 2 ] = (uint8_t)(( ( color & 0x001F ) >>  0 ) << 3);
-                ptr[ 3 ] = 255;
-            }
-        }
-    }
+    // 行単位で独立しているので並列に変換する.
+    asdx::ParallelFor( 0, height, 0, [&]( size_t y )
+    { convert( pSrc + srcPitch * y, width, pPixels + dstPitch * y, pPalette ); });
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      24BitRLE圧縮フルカラー形式を解析します.
+//! @brief      RLE圧縮されたピクセルデータを解析します.
+//!
+//! @param[in]      pSrc        ピクセルデータの先頭です.
+//! @param[in]      pEnd        バッファの終端です.
+//! @param[in]      count       画像のピクセル数です.
+//! @param[in]      srcBytes    変換元の1ピクセル当たりのバイト数です.
+//! @param[in]      dstBytes    変換先の1ピクセル当たりのバイト数です.
+//! @param[in]      convert     ピクセル変換関数です.
+//! @param[in]      pPalette    カラーパレットです.
+//! @param[out]     pPixels     変換先のピクセルデータです.
+//! @retval true    解析に成功.
+//! @retval false   データが不足しています.
 //-------------------------------------------------------------------------------------------------
-void Parse24BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool ParseTgaRLE
+(
+    const uint8_t*  pSrc,
+    const uint8_t*  pEnd,
+    size_t          count,
+    uint32_t        srcBytes,
+    uint32_t        dstBytes,
+    TgaConvertFunc  convert,
+    const uint8_t*  pPalette,
+    uint8_t*        pPixels
+)
 {
-    uint32_t count    = 0;
-    uint8_t  color[3] = { 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
+    size_t  pos = 0;
+    uint8_t color[ 4 ];
 
-    while( ptr < pPixels + size )   // size = width * height * 3.
+    while( pos < count )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        if ( pSrc >= pEnd )
+        { return false; }
 
+        // パケットヘッダ.
+        auto header = *pSrc++;
+        auto num    = asdx::Min<size_t>( 1 + ( header & 0x7F ), count - pos );
+        auto ptr    = pPixels + pos * dstBytes;
+
+        // 繰り返しパケット.
         if ( header & 0x80 )
         {
-            fread( color, sizeof(uint8_t), 3, pFile );
+            if ( size_t( pEnd - pSrc ) < srcBytes )
+            { return false; }
 
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = 255;
-            }
+            convert( pSrc, 1, color, pPalette );
+            pSrc += srcBytes;
+
+            for( size_t i=0; i<num; ++i, ptr += dstBytes )
+            { memcpy( ptr, color, dstBytes ); }
         }
+        // 非圧縮パケット.
         else
         {
-            //for( uint32_t i=0; i<count; ++i, ptr+=3 )
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = 255;
-            }
+            if ( size_t( pEnd - pSrc ) < num * srcBytes )
+            { return false; }
+
+            convert( pSrc, uint32_t( num ), ptr, pPalette );
+            pSrc += num * srcBytes;
         }
+
+        pos += num;
     }
+
+    return true;
 }
 
 //-------------------------------------------------------------------------------------------------
-//! @brief      32BitRLE圧縮フルカラー形式を解析します.
+//! @brief      TGAヘッダとして妥当かどうかチェックします.
+//!
+//! @param[in]      pBinary     バイナリです.
+//! @param[in]      bufferSize  バッファサイズです.
+//! @retval true    TGAとして解釈できます.
+//! @retval false   TGAではありません.
+//! @note       TGA 1.0 形式はフッターを持たないため，画像形式・ビットの深さ・
+//!             データサイズがバッファに収まるかどうかで判定します.
 //-------------------------------------------------------------------------------------------------
-void Parse32BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+bool IsTgaHeader( const uint8_t* pBinary, size_t bufferSize )
 {
-    uint32_t count    = 0;
-    uint8_t  color[4] = { 0, 0, 0, 0 };
-    uint8_t  header   = 0;
-    uint8_t* ptr      = pPixels;
+    if ( pBinary == nullptr || bufferSize < sizeof(TGA_HEADER) )
+    { return false; }
 
-    while( ptr < pPixels + size )   // size = width * height * 4.
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+    TGA_HEADER header;
+    memcpy( &header, pBinary, sizeof(header) );
 
-        if ( header & 0x80 )
+    if ( header.HasColorMap > 1 )
+    { return false; }
+
+    if ( header.Width == 0 || header.Height == 0 )
+    { return false; }
+
+    // 画像形式とビットの深さをチェック.
+    uint32_t srcBytes = 0;
+    switch( header.Format )
+    {
+    case TGA_FORMAT_INDEXCOLOR:
+    case TGA_FORMAT_RLE_INDEXCOLOR:
         {
-            fread( color, sizeof(uint8_t), 4, pFile );
+            if ( header.HasColorMap && header.BitPerPixel == 8 )
+            { srcBytes = 1; }
+        }
+        break;
 
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 0 ] = color[ 2 ];
-                ptr[ 1 ] = color[ 1 ];
-                ptr[ 2 ] = color[ 0 ];
-                ptr[ 3 ] = color[ 3 ];
-            }
+    case TGA_FORMAT_FULLCOLOR:
+    case TGA_FORMAT_RLE_FULLCOLOR:
+        {
+            if ( header.BitPerPixel == 15
+              || header.BitPerPixel == 16
+              || header.BitPerPixel == 24
+              || header.BitPerPixel == 32 )
+            { srcBytes = ( header.BitPerPixel + 7 ) >> 3; }
         }
-        else
+        break;
+
+    case TGA_FORMAT_GRAYSCALE:
+    case TGA_FORMAT_RLE_GRAYSCALE:
         {
-            for( uint32_t i=0; i<count; ++i, ptr+=4 )
-            {
-                ptr[ 2 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 3 ] = (uint8_t)fgetc( pFile );
-            }
+            if ( header.BitPerPixel == 8 || header.BitPerPixel == 16 )
+            { srcBytes = header.BitPerPixel >> 3; }
         }
+        break;
     }
-}
 
-//-------------------------------------------------------------------------------------------------
-//! @brief      8BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse8BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
+    if ( srcBytes == 0 )
+    { return false; }
 
-    while( ptr < pPixles + size ) // size = width * height
+    // ヘッダ・IDフィールド・カラーマップ.
+    auto size = sizeof(TGA_HEADER) + size_t( header.IdFieldLength );
+    if ( header.HasColorMap )
     {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
-
-        if ( header & 0x80 )
+        switch( header.ColorMapEntrySize )
         {
-            color = (uint8_t)fgetc( pFile );
+        case 15:
+        case 16:
+        case 24:
+        case 32:
+            break;
 
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = color; }
+        default:
+            return false;
         }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr++ )
-            { (*ptr) = (uint8_t)fgetc( pFile ); }
-        }
-    }
-}
-
-//-------------------------------------------------------------------------------------------------
-//! @brief      16BitRLE圧縮グレースケール形式を解析します.
-//-------------------------------------------------------------------------------------------------
-void Parse16BitsGrayScaleRLE( FILE* pFile, uint32_t size, uint8_t* pPixles )
-{
-    uint32_t count  = 0;
-    uint8_t  color  = 0;
-    uint8_t  alpha  = 0;
-    uint8_t  header = 0;
-    uint8_t* ptr    = pPixles;
 
-    while( ptr < pPixles + size ) // size = width * height * 2
-    {
-        header = (uint8_t)fgetc( pFile );
-        count = 1 + ( header & 0x7F );
+        size += size_t( header.ColorMapLength ) * ( ( header.ColorMapEntrySize + 7 ) >> 3 );
+    }
 
-        if ( header & 0x80 )
-        {
-            color = (uint8_t)fgetc( pFile );
-            alpha = (uint8_t)fgetc( pFile );
+    // ピクセルデータ. RLEは128ピクセル毎に1パケットとした場合の最小サイズで見積もる.
+    auto count = size_t( header.Width ) * header.Height;
+    if ( header.Format >= TGA_FORMAT_RLE_INDEXCOLOR )
+    { size += ( ( count + 127 ) / 128 ) * ( 1 + srcBytes ); }
+    else
+    { size += count * srcBytes; }
 
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = color;
-                ptr[ 1 ] = alpha;
-            }
-        }
-        else
-        {
-            for( uint32_t i=0; i<count; ++i, ptr+=2 )
-            {
-                ptr[ 0 ] = (uint8_t)fgetc( pFile );
-                ptr[ 1 ] = (uint8_t)fgetc( pFile );
-            }
-        }
-    }
+    return size <= bufferSize;
 }
 
 } // namespace /* anonymous */
@@ -1901,6 +2226,9 @@ bool CreateResTextureFromDDSFile(FILE* pFile, asdx::ResTexture& resTexture)
 
             case FOURCC_DX10:
                 {
+                    DDSHeaderDX10 ext = {};
+                    if ( fread( &ext, sizeof( ext ), 1, pFile ) == 1 )
+                    { isSupportFormat = ParseDDSHeaderDX10( ext, resTexture, nativeFormat ); }
                 }
                 break;
 
@@ -2167,14 +2495,15 @@ bool CreateResTextureFromDDSFile(FILE* pFile, asdx::ResTexture& resTexture)
         case NATIVE_TEXTURE_FORMAT_ARGB_8888:
         case NATIVE_TEXTURE_FORMAT_XRGB_8888:
         {
-            for( size_t i=0; i<pixelSize; i+=4 )
+            asdx::ParallelFor( 0, pixelSize / 4, 0, [&]( size_t index )
             {
                 // BGRA -> RGBA
+                auto i = index * 4;
                 unsigned char R = pPixelData[ i + 0 ];
                 unsigned char B = pPixelData[ i + 2 ];
                 pPixelData[ i + 0 ] = B;
                 pPixelData[ i + 2 ] = R;
-            }
+            });
         }
         break;
     }
@@ -2204,13 +2533,7 @@ bool CreateResTextureFromDDSFile(FILE* pFile, asdx::ResTexture& resTexture)
             size_t numBytes = 0;
 
             // ブロック圧縮フォーマットの場合.
-            if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC2 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC3 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5S ) )
+            if ( IsBlockCompressed( nativeFormat ) )
             {
                 size_t bcPerBlock = 0;
                 size_t blockWide  = 0;
@@ -2261,20 +2584,21 @@ bool CreateResTextureFromDDSFile(FILE* pFile, asdx::ResTexture& resTexture)
             resTexture.pResources[ idx ].MipIndex   = uint32_t( j );
             resTexture.pResources[ idx ].Pitch      = uint32_t( rowBytes );
             resTexture.pResources[ idx ].SlicePitch = uint32_t( numBytes );
-            resTexture.pResources[ idx ].pPixels    = new uint8_t [ numBytes ];
 
-            // NULLチェック.
-            if ( resTexture.pResources[ i ].pPixels == nullptr )
+            // 範囲チェック.
+            if ( offset + numBytes > pixelSize )
             {
                 // エラーログ出力.
-                ELOG( "Error : Memory Allocate Failed." );
+                ELOG( "Error : Out of Range." );
 
                 // 異常終了.
+                SafeDeleteArray( resTexture.pResources );
+                delete [] pPixelData;
                 return false;
             }
 
-            // ピクセルデータをコピー.
-            std::memcpy( resTexture.pResources[ idx ].pPixels, pPixelData + offset, numBytes );
+            // 一括読み込みしたピクセルデータを直接参照する.
+            resTexture.pResources[ idx ].pPixels    = pPixelData + offset;
 
             // オフセットをカウントアップ.
             offset += numBytes;
@@ -2294,9 +2618,8 @@ bool CreateResTextureFromDDSFile(FILE* pFile, asdx::ResTexture& resTexture)
         }
     }
 
-    // 不要になったメモリを解放.
-    delete [] pPixelData;
-    pPixelData = nullptr;
+    // ピクセルデータの所有権をリソーステクスチャに移す.
+    resTexture.pPixelData = pPixelData;
 
     // 正常終了.
     return true;
@@ -2335,9 +2658,10 @@ bool CreateResTextureFromDDSFileW(const wchar_t* filename, asdx::ResTexture& res
 }
 
 //-------------------------------------------------------------------------------------------------
-//      DDSからリソーステクスチャを生成します.
+//      DDSのバイナリからリソーステクスチャを生成します.
+//      copy が false の場合はサブリソースがバイナリを直接参照します.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize, asdx::ResTexture& resTexture)
+bool CreateResTextureFromDDSBinary(const uint8_t* pBinary, size_t bufferSize, asdx::ResTexture& resTexture, bool copy)
 {
     uint32_t    width  = 0;
     uint32_t    height = 0;
@@ -2364,7 +2688,7 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
     }
 
     uint8_t* pCur = (uint8_t*)pBinary + sizeof(char) * 4;
-    uint32_t offset = sizeof(char) * 4;
+    size_t offset = sizeof(char) * 4;
     if ( offset > bufferSize )
     {
         ELOG( "Error : Out of Range." );
@@ -2526,6 +2850,14 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
 
             case FOURCC_DX10:
                 {
+                    if ( offset + sizeof(DDSHeaderDX10) <= bufferSize )
+                    {
+                        DDSHeaderDX10 ext = {};
+                        memcpy( &ext, pCur, sizeof( ext ) );
+                        pCur   += sizeof( ext );
+                        offset += sizeof( ext );
+                        isSupportFormat = ParseDDSHeaderDX10( ext, resTexture, nativeFormat );
+                    }
                 }
                 break;
 
@@ -2748,38 +3080,44 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
     // ピクセルデータのサイズを算出.
     size_t pixelSize = bufferSize - offset;
 
-    // ピクセルデータのメモリを確保.
-    unsigned char* pPixelData = new unsigned char [pixelSize];
+    // BGRAの並びを補正する場合は書き換えが必要なのでコピーする.
+    auto swizzle = ( nativeFormat == NATIVE_TEXTURE_FORMAT_ARGB_8888 )
+                || ( nativeFormat == NATIVE_TEXTURE_FORMAT_XRGB_8888 );
 
-    // NULLチェック.
-    if ( pPixelData == nullptr )
+    unsigned char* pPixelData = pCur;
+    if ( copy || swizzle )
     {
-        // エラーログ出力.
-        ELOG( "Error : Memory Allocate Failed." );
+        // ピクセルデータのメモリを確保.
+        pPixelData = new (std::nothrow) unsigned char [pixelSize];
 
-        // 異常終了.
-        return false;
-    }
+        // NULLチェック.
+        if ( pPixelData == nullptr )
+        {
+            // エラーログ出力.
+            ELOG( "Error : Memory Allocate Failed." );
 
-    memcpy( pPixelData, pCur, sizeof(unsigned char) * pixelSize );
+            // 異常終了.
+            return false;
+        }
 
-    // リトルエンディアンなのでピクセルの並びを補正.
-    switch( nativeFormat )
-    {
-        // 一括読み込みでくるっているので修正.
-        case NATIVE_TEXTURE_FORMAT_ARGB_8888:
-        case NATIVE_TEXTURE_FORMAT_XRGB_8888:
+        memcpy( pPixelData, pCur, sizeof(unsigned char) * pixelSize );
+
+        // リトルエンディアンなのでピクセルの並びを補正.
+        if ( swizzle )
         {
-            for( size_t i=0; i<pixelSize; i+=4 )
+            asdx::ParallelFor( 0, pixelSize / 4, 0, [&]( size_t index )
             {
                 // BGRA -> RGBA
+                auto i = index * 4;
                 unsigned char R = pPixelData[ i + 0 ];
                 unsigned char B = pPixelData[ i + 2 ];
                 pPixelData[ i + 0 ] = B;
                 pPixelData[ i + 2 ] = R;
-            }
+            });
         }
-        break;
+
+        // サブリソースは一括確保したメモリを参照する.
+        resTexture.pPixelData = pPixelData;
     }
 
     size_t byteOffset = 0;
@@ -2807,13 +3145,7 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
             size_t numBytes = 0;
 
             // ブロック圧縮フォーマットの場合.
-            if ( ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC1 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC2 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC3 )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC4S )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5U )
-              || ( nativeFormat == NATIVE_TEXTURE_FORMAT_BC5S ) )
+            if ( IsBlockCompressed( nativeFormat ) )
             {
                 size_t bcPerBlock = 0;
                 size_t blockWide  = 0;
@@ -2859,6 +3191,19 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
             resTexture.pResources[ idx ].MipIndex   = uint32_t( j );
             resTexture.pResources[ idx ].Pitch      = uint32_t( rowBytes );
             resTexture.pResources[ idx ].SlicePitch = uint32_t( numBytes );
+
+            // 範囲チェック.
+            if ( byteOffset + numBytes > pixelSize )
+            {
+                // エラーログ出力.
+                ELOG( "Error : Out of Range." );
+
+                // 異常終了.
+                SafeDeleteArray( resTexture.pResources );
+                SafeDeleteArray( resTexture.pPixelData );
+                return false;
+            }
+
             resTexture.pResources[ idx ].pPixels    = pPixelData + byteOffset;
 
             // オフセットをカウントアップ.
@@ -2884,162 +3229,222 @@ bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize,
 }
 
 //-------------------------------------------------------------------------------------------------
-//      Targaファイルからリソーステクスチャを生成します.
+//      DDSからリソーステクスチャを生成します.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
+bool CreateResTextureFromDDSMemory(const uint8_t* pBinary, uint32_t bufferSize, asdx::ResTexture& resTexture)
 {
-    // フッターを読み込み.
-    TGA_FOOTER footer;
-    long offset = sizeof(footer);
-    fseek( pFile, -offset, SEEK_END );
-    fread( &footer, sizeof(footer), 1, pFile );
+    // 呼び出し側のバッファの寿命は保証されないのでコピーする.
+    return CreateResTextureFromDDSBinary( pBinary, bufferSize, resTexture, true );
+}
 
-    // ファイルマジックをチェック.
-    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 )
+//-------------------------------------------------------------------------------------------------
+//      メモリマップしたDDSファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSMappedFile(asdx::MappedFile* pMappedFile, asdx::ResTexture& resTexture)
+{
+    if ( !CreateResTextureFromDDSBinary( pMappedFile->GetData(), pMappedFile->GetSize(), resTexture, false ) )
     {
-        ELOG( "Error : Invalid File Format." );
-        fclose( pFile );
+        delete pMappedFile;
         return false;
     }
 
-    // 拡張データがある場合は読み込み.
-    if ( footer.OffsetExt != 0 )
+    // 並びの補正でコピーした場合はマップは不要.
+    if ( resTexture.pPixelData != nullptr )
     {
-        TGA_EXTENSION extension;
-
-        fseek( pFile, footer.OffsetExt, SEEK_SET );
-        fread( &extension, sizeof(extension), 1, pFile );
+        delete pMappedFile;
+        return true;
     }
 
-    // ディベロッパーエリアがある場合.
-    if ( footer.OffsetDev != 0 )
+    // マップの寿命はリソーステクスチャが管理する.
+    resTexture.pMappedFile = pMappedFile;
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルをメモリマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSMappedFileA(const char* filename, asdx::ResTexture& resTexture)
+{
+    auto pMappedFile = new (std::nothrow) asdx::MappedFile();
+    if ( pMappedFile == nullptr )
     {
-        /* NOT IMPLEMENT */
+        ELOG( "Error : Out of Memory." );
+        return false;
     }
 
-    // ファイル先頭に戻す.
-    fseek( pFile, 0, SEEK_SET );
+    if ( !pMappedFile->OpenA( filename ) )
+    {
+        delete pMappedFile;
+        return false;
+    }
 
-    // ヘッダデータを読み込む.
-    TGA_HEADER header;
-    fread( &header, sizeof(header), 1, pFile );
+    return CreateResTextureFromDDSMappedFile( pMappedFile, resTexture );
+}
 
-    // フォーマット判定.
-    uint32_t bytePerPixel = 0;
-    switch( header.Format )
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルをメモリマップしてリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromDDSMappedFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
+{
+    auto pMappedFile = new (std::nothrow) asdx::MappedFile();
+    if ( pMappedFile == nullptr )
     {
-    // 該当なし.
-    case TGA_FORMAT_NONE:
-        {
-            ELOG( "Error : Invalid Format." );
-            fclose( pFile );
-            return false;
-        }
-        break;
+        ELOG( "Error : Out of Memory." );
+        return false;
+    }
 
-    // グレースケール
-    case TGA_FORMAT_GRAYSCALE:
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        { 
-            if ( header.BitPerPixel == 8 )
-            { bytePerPixel = 1; }
-            else
-            { bytePerPixel = 2; }
-        }
-        break;
+    if ( !pMappedFile->OpenW( filename ) )
+    {
+        delete pMappedFile;
+        return false;
+    }
 
-    // カラー.
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_FULLCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            if ( header.BitPerPixel <= 24 )
-            { bytePerPixel = 3; }
-            else
-            { bytePerPixel = 4; }
-        }
-        break;
+    return CreateResTextureFromDDSMappedFile( pMappedFile, resTexture );
+}
 
-    // 上記以外.
-    default:
-        {
-            ELOG( "Error : Unsupported Format." );
-            fclose( pFile );
-            return false;
-        }
-        break;
+//-------------------------------------------------------------------------------------------------
+//      リソーステクスチャをDDSファイルに書き出します.
+//-------------------------------------------------------------------------------------------------
+bool WriteResTextureToDDS(FILE* pFile, const asdx::ResTexture& resTexture)
+{
+    if ( resTexture.pResources == nullptr )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
     }
 
-    // IDフィールドサイズ分だけオフセットを移動させる.
-    if (header.IdFieldLength != 0)
+    unsigned int nativeFormat = 0;
+    if ( !GetNativeFormat( resTexture.Format, nativeFormat ) )
     {
-        fseek(pFile, header.IdFieldLength, SEEK_CUR);
+        ELOG( "Error : Unsupported Format. format = %u", resTexture.Format );
+        return false;
     }
 
-    // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
-    auto bpp = (bytePerPixel == 3) ? 4 : bytePerPixel;
+    auto compressed = IsBlockCompressed( nativeFormat );
+    auto mipCount   = ( resTexture.MipMapCount > 0 ) ? resTexture.MipMapCount : 1;
+    auto isCube     = ( resTexture.Dimension == TEXTURE_DIMENSION_CUBE );
+    auto isVolume   = ( resTexture.Dimension == TEXTURE_DIMENSION_3D );
+
+    DDSurfaceDesc ddsd = {};
+    ddsd.size         = sizeof( ddsd );
+    ddsd.flags        = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT;
+    ddsd.flags       |= ( compressed ) ? DDSD_LINEARSIZE : DDSD_PITCH;
+    ddsd.height       = ( resTexture.Height > 0 ) ? resTexture.Height : 1;
+    ddsd.width        = resTexture.Width;
+    ddsd.pitch        = ( compressed ) ? resTexture.pResources[0].SlicePitch : resTexture.pResources[0].Pitch;
+    ddsd.mipMapLevels = mipCount;
+    ddsd.caps         = DDSCAPS_TEXTURE;
+
+    ddsd.pixelFormat.size   = sizeof( ddsd.pixelFormat );
+    ddsd.pixelFormat.flags  = DDPF_FOURCC;
+    ddsd.pixelFormat.fourCC = FOURCC_DX10;
+
+    if ( mipCount > 1 )
+    { ddsd.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP; }
+
+    if ( isCube )
+    {
+        ddsd.caps  |= DDSCAPS_COMPLEX;
+        ddsd.caps2 |= DDSCAPS2_CUBEMAP
+                    | DDSCAPS2_CUBEMAP_POSITIVE_X | DDSCAPS2_CUBEMAP_NEGATIVE_X
+                    | DDSCAPS2_CUBEMAP_POSITIVE_Y | DDSCAPS2_CUBEMAP_NEGATIVE_Y
+                    | DDSCAPS2_CUBEMAP_POSITIVE_Z | DDSCAPS2_CUBEMAP_NEGATIVE_Z;
+    }
+    else if ( isVolume )
+    {
+        ddsd.flags |= DDSD_DEPTH;
+        ddsd.depth  = resTexture.Depth;
+        ddsd.caps  |= DDSCAPS_COMPLEX;
+        ddsd.caps2 |= DDSCAPS2_VOLUME;
+    }
 
-    // ピクセルサイズを決定してメモリを確保.
-    auto size = header.Width * header.Height * bpp;
-    auto pPixels = new (std::nothrow) uint8_t [ size ];
-    if ( pPixels == nullptr )
+    DDSHeaderDX10 ext = {};
+    ext.dxgiFormat        = resTexture.Format;
+    ext.resourceDimension = ( resTexture.Dimension == TEXTURE_DIMENSION_1D ) ? DDS_DIMENSION_TEXTURE1D
+                          : ( isVolume ) ? DDS_DIMENSION_TEXTURE3D : DDS_DIMENSION_TEXTURE2D;
+    ext.miscFlag          = ( isCube ) ? DDS_MISC_TEXTURECUBE : 0;
+    ext.arraySize         = ( isCube ) ? resTexture.SurfaceCount / 6 : ( isVolume ) ? 1 : resTexture.SurfaceCount;
+
+    const char magic[4] = { 'D', 'D', 'S', ' ' };
+    if ( fwrite( magic, sizeof(magic), 1, pFile ) != 1
+      || fwrite( &ddsd, sizeof(ddsd), 1, pFile ) != 1
+      || fwrite( &ext, sizeof(ext), 1, pFile ) != 1 )
     {
-        ELOG( "Error : Out Of Memory." );
-        fclose( pFile );
+        ELOG( "Error : Write Failed." );
         return false;
     }
 
-    // カラーマップを持つかチェック.
-    uint8_t* pColorMap = nullptr;
-    if ( header.HasColorMap )
+    // サーフェイス毎にミップレベル順で書き出す.
+    for( uint32_t i=0; i<resTexture.SurfaceCount * mipCount; ++i )
     {
-        // カラーマップサイズを算出.
-        uint32_t colorMapSize = header.ColorMapEntry * ( header.ColorMapEntrySize >> 3 );
-
-        // メモリを確保.
-        pColorMap = new (std::nothrow) uint8_t [ colorMapSize ];
-        if ( pColorMap == nullptr )
+        auto& res = resTexture.pResources[i];
+        if ( fwrite( res.pPixels, sizeof(uint8_t), res.SlicePitch, pFile ) != res.SlicePitch )
         {
-            ELOG( "Error : Out Of Memory." );
-            delete[] pPixels;
-            pPixels = nullptr;
-            fclose( pFile );
+            ELOG( "Error : Write Failed." );
             return false;
         }
+    }
 
-        // がばっと読み込む.
-        fread( pColorMap, sizeof(uint8_t), colorMapSize, pFile );
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Targaのバイナリからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAMemory(const uint8_t* pBinary, size_t bufferSize, asdx::ResTexture& resTexture)
+{
+    if ( pBinary == nullptr || bufferSize < sizeof(TGA_HEADER) )
+    {
+        ELOG( "Error : Invalid Argument." );
+        return false;
     }
 
-    // 幅・高さ・ビットの深さ・ハッシュキーを設定.
-    auto width       = header.Width;
-    auto height      = header.Height;
-    auto format      = static_cast<TGA_FORMAT_TYPE>( header.Format );
-   
-    // フォーマットに合わせてピクセルデータを解析する.
+    // ヘッダデータを読み込む.
+    TGA_HEADER header;
+    memcpy( &header, pBinary, sizeof(header) );
+
+    // フォーマット判定.
+    uint32_t        srcBytes = 0;
+    uint32_t        dstBytes = 0;
+    DXGI_FORMAT     format   = DXGI_FORMAT_UNKNOWN;
+    TgaConvertFunc  convert  = nullptr;
     switch( header.Format )
     {
     // パレット.
     case TGA_FORMAT_INDEXCOLOR:
-        { Parse8Bits( pFile, width * height, pColorMap, pPixels ); }
+    case TGA_FORMAT_RLE_INDEXCOLOR:
+        {
+            if ( header.BitPerPixel == 8 && header.HasColorMap )
+            {
+                srcBytes = 1;
+                dstBytes = 4;
+                format   = DXGI_FORMAT_R8G8B8A8_UNORM;
+                convert  = ConvertIndex8;
+            }
+        }
         break;
 
     // フルカラー.
     case TGA_FORMAT_FULLCOLOR:
+    case TGA_FORMAT_RLE_FULLCOLOR:
         {
+            // RGBのみはテクスチャがサポートされないので，強制的にRGBAにする.
+            dstBytes = 4;
+            format   = DXGI_FORMAT_R8G8B8A8_UNORM;
+
             switch( header.BitPerPixel )
             {
+            case 15:
             case 16:
-                { Parse16Bits( pFile, width * height, pPixels ); }
+                { srcBytes = 2; convert = ConvertBGR555; }
                 break;
 
             case 24:
-                { Parse24Bits( pFile, width * height, pPixels ); }
+                { srcBytes = 3; convert = ConvertBGR; }
                 break;
 
             case 32:
-                { Parse32Bits( pFile, width * height, pPixels ); }
+                { srcBytes = 4; convert = ConvertBGRA; }
                 break;
             }
         }
@@ -3047,128 +3452,130 @@ bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
 
     // グレースケール.
     case TGA_FORMAT_GRAYSCALE:
+    case TGA_FORMAT_RLE_GRAYSCALE:
         {
             if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScale( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScale( pFile, width * height, pPixels ); }
+            {
+                srcBytes = 1;
+                dstBytes = 1;
+                format   = DXGI_FORMAT_R8_UNORM;
+                convert  = ConvertGray8;
+            }
+            else if ( header.BitPerPixel == 16 )
+            {
+                srcBytes = 2;
+                dstBytes = 2;
+                format   = DXGI_FORMAT_R8G8_UNORM;
+                convert  = ConvertGray16;
+            }
         }
         break;
+    }
 
-    // パレットRLE圧縮.
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-        { Parse8BitsRLE( pFile, pColorMap, width * height * 3, pPixels ); }
-        break;
+    if ( convert == nullptr )
+    {
+        ELOG( "Error : Unsupported Format. format = %u, bitPerPixel = %u", header.Format, header.BitPerPixel );
+        return false;
+    }
 
-    // フルカラーRLE圧縮.
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        {
-            switch( header.BitPerPixel )
-            {
-            case 16:
-                { Parse16BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
+    if ( header.Width == 0 || header.Height == 0 )
+    {
+        ELOG( "Error : Invalid Size." );
+        return false;
+    }
 
-            case 24:
-                { Parse24BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
+    // IDフィールドサイズ分だけオフセットを移動させる.
+    auto pCur = pBinary + sizeof(header) + header.IdFieldLength;
+    auto pEnd = pBinary + bufferSize;
 
-            case 32:
-                { Parse32BitsRLE( pFile, width * height * 4, pPixels ); }
-                break;
-            }
+    // カラーマップを持つかチェック.
+    uint8_t palette[ 256 * 4 ] = {};
+    if ( header.HasColorMap )
+    {
+        // カラーマップサイズを算出.
+        uint32_t entryBytes   = ( header.ColorMapEntrySize + 7 ) >> 3;
+        size_t   colorMapSize = size_t( header.ColorMapLength ) * entryBytes;
+        if ( pCur > pEnd || size_t( pEnd - pCur ) < colorMapSize )
+        {
+            ELOG( "Error : Out of Range." );
+            return false;
         }
-        break;
 
-    // グレースケールRLE圧縮.
-    case TGA_FORMAT_RLE_GRAYSCALE:
+        // インデックスカラーの場合はRGBAに展開しておく.
+        if ( convert == ConvertIndex8 )
         {
-            if ( header.BitPerPixel == 8 )
-            { Parse8BitsGrayScaleRLE( pFile, width * height, pPixels ); }
-            else
-            { Parse16BitsGrayScaleRLE( pFile, width * height * 2, pPixels ); }
+            TgaConvertFunc convertEntry = nullptr;
+            switch( entryBytes )
+            {
+            case 2: { convertEntry = ConvertBGR555; } break;
+            case 3: { convertEntry = ConvertBGR;    } break;
+            case 4: { convertEntry = ConvertBGRA;   } break;
+            }
+
+            if ( convertEntry == nullptr || header.ColorMapEntry >= 256 )
+            {
+                ELOG( "Error : Unsupported Color Map. entrySize = %u", header.ColorMapEntrySize );
+                return false;
+            }
+
+            auto count = Min<uint32_t>( header.ColorMapLength, 256 - header.ColorMapEntry );
+            convertEntry( pCur, count, palette + header.ColorMapEntry * 4, nullptr );
         }
-        break;
+
+        pCur += colorMapSize;
     }
 
-    // 不要なメモリを解放.
-    if (pColorMap != nullptr)
+    if ( pCur > pEnd )
     {
-        delete[] pColorMap;
-        pColorMap = nullptr;
+        ELOG( "Error : Out of Range." );
+        return false;
     }
 
-    // ファイルを閉じる.
-    fclose( pFile );
+    // ピクセルサイズを決定してメモリを確保.
+    uint32_t width  = header.Width;
+    uint32_t height = header.Height;
+    auto pPixels = new (std::nothrow) uint8_t [ size_t( width ) * height * dstBytes ];
+    if ( pPixels == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
+        return false;
+    }
+
+    // フォーマットに合わせてピクセルデータを解析する.
+    bool result = ( header.Format >= TGA_FORMAT_RLE_INDEXCOLOR )
+        ? ParseTgaRLE( pCur, pEnd, size_t( width ) * height, srcBytes, dstBytes, convert, palette, pPixels )
+        : ParseTgaRaw( pCur, pEnd, width, height, srcBytes, dstBytes, convert, palette, pPixels );
+    if ( !result )
+    {
+        ELOG( "Error : Out of Range." );
+        delete[] pPixels;
+        return false;
+    }
 
-    auto surface = new SubResource();
+    auto surface = new (std::nothrow) SubResource();
     if (surface == nullptr)
     {
         ELOG("Error : Out of Memory.");
+        delete[] pPixels;
         return false;
     }
 
     surface->Width      = width;
     surface->Height     = height;
     surface->MipIndex   = 0;
-    surface->Pitch      = width * bpp;
-    surface->SlicePitch = width * height * bpp;
+    surface->Pitch      = width * dstBytes;
+    surface->SlicePitch = width * height * dstBytes;
     surface->pPixels    = pPixels;
 
     resTexture.Dimension    = TEXTURE_DIMENSION_2D;
     resTexture.Width        = width;
     resTexture.Height       = height;
     resTexture.Depth        = 1;
+    resTexture.Format       = format;
     resTexture.SurfaceCount = 1;
     resTexture.MipMapCount  = 1;
     resTexture.pResources   = surface;
 
-    switch(format)
-    {
-    case TGA_FORMAT_NONE:
-        resTexture.Format = DXGI_FORMAT_UNKNOWN;
-        break;
-
-    case TGA_FORMAT_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_FULLCOLOR:
-        resTexture.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        break;
-
-    case TGA_FORMAT_RLE_GRAYSCALE:
-        resTexture.Format = DXGI_FORMAT_R8_UNORM;
-        break;
-
-    case TGA_FORMAT_INDEXCOLOR:
-    case TGA_FORMAT_RLE_INDEXCOLOR:
-        {
-            switch (bytePerPixel)
-            {
-            case 1:
-                { resTexture.Format = DXGI_FORMAT_R8_UNORM; }
-                break;
-
-            case 2:
-                { resTexture.Format = DXGI_FORMAT_B5G5R5A1_UNORM; }
-                break;
-
-            default:
-                {
-                    ELOG("Error : Unknown Format. bytePerPixel = %u", bytePerPixel );
-                    assert(false);
-                    return false;
-                }
-            }
-        }
-        break;
-    }
-
     // 正常終了.
     return true;
 }
@@ -3176,12 +3583,47 @@ bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
 //-------------------------------------------------------------------------------------------------
 //      Targaファイルからリソーステクスチャを生成します.
 //-------------------------------------------------------------------------------------------------
-bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTexture)
+bool CreateResTextureFromTGAFile(FILE* pFile, asdx::ResTexture& resTexture)
 {
-    FILE* pFile = nullptr;
-    auto err = fopen_s(&pFile, filename, "rb");
-    if (err != 0)
-    {
+    // ファイルサイズを取得.
+    fseek( pFile, 0, SEEK_END );
+    auto size = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
+
+    if ( size <= 0 )
+    {
+        ELOG( "Error : Invalid File Size." );
+        fclose( pFile );
+        return false;
+    }
+
+    // 一括で読み込む.
+    auto pBinary = new (std::nothrow) uint8_t [ size ];
+    if ( pBinary == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
+        fclose( pFile );
+        return false;
+    }
+
+    auto readSize = fread( pBinary, sizeof(uint8_t), size_t( size ), pFile );
+    fclose( pFile );
+
+    auto result = CreateResTextureFromTGAMemory( pBinary, readSize, resTexture );
+    delete[] pBinary;
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します.
+//-------------------------------------------------------------------------------------------------
+bool CreateResTextureFromTGAFileA(const char* filename, asdx::ResTexture& resTexture)
+{
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, filename, "rb");
+    if (err != 0)
+    {
         ELOGA("Error : File Open Failed. path = %s", filename);
         return false;
     }
@@ -3206,20 +3648,47 @@ bool CreateResTextureFromTGAFileW(const wchar_t* filename, asdx::ResTexture& res
 }
 
 //------------------------------------------------------------------------------------------
-//      HDRファイルのヘッダを読み込みします.
+//      HDRのヘッダを解析します.
 //------------------------------------------------------------------------------------------
-bool ReadHdrHeader( FILE* pFile, int32_t& width, int32_t& height, float& gamma, float& exposure )
+bool ParseHdrHeader
+(
+    const uint8_t*  pBinary,
+    size_t          bufferSize,
+    int32_t&        width,
+    int32_t&        height,
+    float&          gamma,
+    float&          exposure,
+    size_t&         offset
+)
 {
-    char buf[ 256 ];
-    fread( buf, sizeof(char), 2, pFile );
-
-    if ( buf[0] != '#' || buf[1] != '?' )
+    if ( bufferSize < 2 || pBinary[0] != '#' || pBinary[1] != '?' )
     { return false; }
 
+    char   buf[ 256 ];
+    size_t pos = 2;
+
+    // 改行までの1行を読み取る.
+    auto readLine = [&]()
+    {
+        if ( pos >= bufferSize )
+        { return false; }
+
+        size_t n = 0;
+        while( pos < bufferSize && n < sizeof(buf) - 1 )
+        {
+            auto c = char( pBinary[ pos++ ] );
+            buf[ n++ ] = c;
+            if ( c == '\n' )
+            { break; }
+        }
+        buf[ n ] = '\0';
+        return true;
+    };
+
     auto valid = false;
     for( ;; )
     {
-        if ( fgets( buf, 256, pFile ) == nullptr )
+        if ( !readLine() )
         { break; }
 
         if ( buf[0] == '\n' )
@@ -3230,191 +3699,267 @@ bool ReadHdrHeader( FILE* pFile, int32_t& width, int32_t& height, float& gamma,
         {
             auto g = 1.0f;
             auto e = 1.0f;
-            if ( sscanf_s( buf, "GAMMA=%f\n", &g ) != 0 ) 
+            if ( sscanf_s( buf, "GAMMA=%f\n", &g ) == 1 )
             { gamma = g; }
-            else if ( sscanf_s( buf, "EXPOSURE=%f\n", &e ) != 0 )
+            else if ( sscanf_s( buf, "EXPOSURE=%f\n", &e ) == 1 )
             { exposure = e; }
             else if ( strcmp( buf, "FORMAT=32-bit_rle_rgbe\n" ) == 0 )
             { valid = true; }
         }
     }
 
-    if ( !valid )
+    if ( !valid || !readLine() )
     { return false; }
 
-    if ( fgets( buf, 256, pFile ) != nullptr )
-    {
-        auto w = 0;
-        auto h = 0;
-        if ( sscanf_s( buf, "-Y %d +X %d\n", &h, &w ) != 0 )
-        {
-            width = w;
-            height = h;
-        }
-        else if ( sscanf_s( buf, "+X %d -Y %d\n", &w, &h ) != 0 )
-        {
-            width = w;
-            height = h;
-        }
-        else
-        { return false; }
-    }
+    auto w = 0;
+    auto h = 0;
+    if ( sscanf_s( buf, "-Y %d +X %d\n", &h, &w ) != 2
+      && sscanf_s( buf, "+X %d -Y %d\n", &w, &h ) != 2 )
+    { return false; }
+
+    if ( w <= 0 || h <= 0 )
+    { return false; }
+
+    width  = w;
+    height = h;
+    offset = pos;
 
     return true;
 }
 
 //------------------------------------------------------------------------------------------
-//      旧形式のカラーを読み取ります.
+//      新形式のRLE圧縮スキャンラインかどうかチェックします.
 //------------------------------------------------------------------------------------------
-bool ReadOldColors( FILE* pFile, RGBE* pLine, int32_t count )
+bool IsHdrRLEScanline( const uint8_t* pSrc, const uint8_t* pEnd, int32_t count )
 {
-    auto shift = 0;
-    while( 0 < count )
+    if ( count < 8 || 0x7fff < count || pEnd - pSrc < 4 )
+    { return false; }
+
+    return ( pSrc[0] == 2 ) && ( pSrc[1] == 2 ) && ( ( pSrc[2] & 0x80 ) == 0 );
+}
+
+//------------------------------------------------------------------------------------------
+//      旧形式のスキャンラインを解析します.
+//
+//      次のスキャンラインの先頭を返却します. 不正なデータの場合は nullptr を返却します.
+//------------------------------------------------------------------------------------------
+const uint8_t* DecodeHdrOldScanline( const uint8_t* pSrc, const uint8_t* pEnd, RGBE* pLine, int32_t count )
+{
+    int32_t  x     = 0;
+    uint32_t shift = 0;
+    while( x < count )
     {
-        pLine[0].r = getc( pFile );
-        pLine[0].g = getc( pFile );
-        pLine[0].b = getc( pFile );
-        pLine[0].e = getc( pFile );
+        if ( pEnd - pSrc < 4 )
+        { return nullptr; }
 
-        if ( feof( pFile ) || ferror( pFile ) )
-            return false;
+        RGBE color;
+        memcpy( &color, pSrc, sizeof(color) );
+        pSrc += sizeof(color);
 
-        if ( pLine[0].r == 1
-          && pLine[0].g == 1
-          && pLine[0].b == 1 )
+        // 直前の画素の繰り返し.
+        if ( color.r == 1 && color.g == 1 && color.b == 1 )
         {
-            for( auto i=pLine[0].e << shift; i > 0; i-- )
-            {
-                pLine[0].r = pLine[-1].r;
-                pLine[0].g = pLine[-1].g;
-                pLine[0].b = pLine[-1].b;
-                pLine[0].e = pLine[-1].e;
-                pLine++;
-                count--;
-            }
+            if ( x == 0 || shift > 16 )
+            { return nullptr; }
+
+            auto run = int32_t( color.e ) << shift;
+            if ( run > count - x )
+            { return nullptr; }
+
+            for( auto i=0; i<run; ++i, ++x )
+            { pLine[x] = pLine[x - 1]; }
+
             shift += 8;
         }
         else
         {
-            pLine++;
-            count--;
+            pLine[x++] = color;
             shift = 0;
         }
     }
 
-    return true;
+    return pSrc;
 }
 
 //------------------------------------------------------------------------------------------
-//      カラーを読み取ります.
+//      スキャンラインを解析します.
+//
+//      次のスキャンラインの先頭を返却します. 不正なデータの場合は nullptr を返却します.
 //------------------------------------------------------------------------------------------
-bool ReadColor( FILE* pFile, RGBE* pLine, int32_t count )
+const uint8_t* DecodeHdrScanline( const uint8_t* pSrc, const uint8_t* pEnd, RGBE* pLine, int32_t count )
 {
-    if ( count < 8 || 0x7fff < count )
-    { return ReadOldColors( pFile, pLine, count ); }
+    if ( !IsHdrRLEScanline( pSrc, pEnd, count ) )
+    { return DecodeHdrOldScanline( pSrc, pEnd, pLine, count ); }
 
-    auto i = getc( pFile );
-    if ( i == EOF )
-        return false;
+    if ( ( pSrc[2] << 8 | pSrc[3] ) != count )
+    { return nullptr; }
 
-    if ( i != 2 )
-    {
-        ungetc( i, pFile );
-        return ReadOldColors( pFile, pLine, count );
-    }
+    pSrc += 4;
 
-    pLine[0].g = getc( pFile );
-    pLine[0].b = getc( pFile );
-
-    if ( ( i = getc( pFile ) ) == EOF )
-        return false;
-
-    if ( pLine[0].g != 2 || pLine[0].b & 128 )
+    // チャンネルごとにRLE圧縮されている.
+    for( auto i=0; i<4; ++i )
     {
-        pLine[0].r = 2;
-        pLine[0].e = i;
-        return ReadOldColors( pFile, pLine + 1, count -1 );
-    }
-
-    if ( ( pLine[0].b << 8 | i ) != count )
-        return false;
-
-    for( i=0; i<4; ++i )
-    {
-        for( auto j=0; j<count; )
+        for( auto x=0; x<count; )
         {
-            auto code = getc( pFile );
-            if ( code == EOF )
-                return false;
+            if ( pSrc >= pEnd )
+            { return nullptr; }
 
+            int32_t code = *pSrc++;
             if ( 128 < code )
             {
                 code &= 127;
-                auto val = getc( pFile );
+                if ( pSrc >= pEnd || code > count - x )
+                { return nullptr; }
+
+                auto val = *pSrc++;
                 while( code-- )
-                { pLine[j++].v[i] = val; }
+                { pLine[x++].v[i] = val; }
             }
             else
             {
+                if ( code == 0 || code > count - x || pEnd - pSrc < code )
+                { return nullptr; }
+
                 while( code-- )
-                { pLine[j++].v[i] = getc( pFile ); }
+                { pLine[x++].v[i] = *pSrc++; }
             }
         }
     }
 
-    return ( feof( pFile ) ? false : true );
+    return pSrc;
 }
 
 //------------------------------------------------------------------------------------------
-//      HDRデータを読み取ります.
+//      スキャンラインを読み飛ばします.
+//
+//      新形式のRLE圧縮はランの長さだけを辿り，旧形式は pWork に展開して読み飛ばします.
 //------------------------------------------------------------------------------------------
-bool ReadHdrData( FILE* pFile, const int32_t width, const int32_t height, float** ppPixels )
+const uint8_t* SkipHdrScanline( const uint8_t* pSrc, const uint8_t* pEnd, RGBE* pWork, int32_t count )
 {
-    auto pLines = new(std::nothrow) RGBE [ width * height ];
-    if ( pLines == nullptr )
-    { return false; }
+    if ( !IsHdrRLEScanline( pSrc, pEnd, count ) )
+    { return DecodeHdrOldScanline( pSrc, pEnd, pWork, count ); }
 
-    auto pixels = new (std::nothrow) float [ width * height * 4 ];
-    if ( pixels == nullptr )
-    { return false; }
+    if ( ( pSrc[2] << 8 | pSrc[3] ) != count )
+    { return nullptr; }
 
-    for( auto y=0; y<height; ++y )
+    pSrc += 4;
+
+    for( auto i=0; i<4; ++i )
     {
-        if ( !ReadColor( pFile, pLines, width ) )
+        for( auto x=0; x<count; )
         {
-            SafeDeleteArray( pLines );
-            SafeDeleteArray( pixels );
-            return false;
+            if ( pSrc >= pEnd )
+            { return nullptr; }
+
+            int32_t code = *pSrc++;
+            int32_t run  = ( 128 < code ) ? ( code & 127 ) : code;
+            int32_t size = ( 128 < code ) ? 1 : code;
+
+            if ( run == 0 || run > count - x || pEnd - pSrc < size )
+            { return nullptr; }
+
+            pSrc += size;
+            x    += run;
         }
+    }
+
+    return pSrc;
+}
 
-        for( auto x =0; x < width; x++ )
+//------------------------------------------------------------------------------------------
+//      HDRのピクセルデータを解析します.
+//------------------------------------------------------------------------------------------
+bool DecodeHdrPixels
+(
+    const uint8_t*  pSrc,
+    const uint8_t*  pEnd,
+    int32_t         width,
+    int32_t         height,
+    uint8_t**       ppPixels
+)
+{
+    auto pScanlines = new (std::nothrow) const uint8_t* [ height ];
+    auto pWork      = new (std::nothrow) RGBE [ width ];
+    if ( pScanlines == nullptr || pWork == nullptr )
+    {
+        SafeDeleteArray( pScanlines );
+        SafeDeleteArray( pWork );
+        return false;
+    }
+
+    // 各スキャンラインの開始位置を求める.
+    auto pCur = pSrc;
+    for( auto y=0; y<height && pCur != nullptr; ++y )
+    {
+        pScanlines[y] = pCur;
+        pCur = SkipHdrScanline( pCur, pEnd, pWork, width );
+    }
+    SafeDeleteArray( pWork );
+
+    if ( pCur == nullptr )
+    {
+        SafeDeleteArray( pScanlines );
+        return false;
+    }
+
+    // R16G16B16A16_FLOAT で格納する.
+    auto pitch  = size_t( width ) * 4;
+    auto pixels = new (std::nothrow) uint8_t [ pitch * height * sizeof(asdx::half) ];
+    if ( pixels == nullptr )
+    {
+        SafeDeleteArray( pScanlines );
+        return false;
+    }
+
+    auto pDst = reinterpret_cast<asdx::half*>( pixels );
+
+    // 開始位置が分かったのでスキャンラインごとに並列に展開する.
+    auto result = ParallelReduce( 0, height, 4, true,
+        [&]( size_t begin, size_t end, bool value )
         {
-            auto pix = RGBEToVec3( pLines[x] );
-            auto idx = ( x * 4 ) + ( y * width *  4 );
-            pixels[idx + 0] = pix.x;
-            pixels[idx + 1] = pix.y;
-            pixels[idx + 2] = pix.z;
-            pixels[idx + 3] = 1.0f;
-        }
+            // 1ライン分の作業領域.
+            auto pLine = new (std::nothrow) RGBE [ width ];
+            auto pRow  = new (std::nothrow) float [ pitch ];
+            if ( pLine == nullptr || pRow == nullptr )
+            {
+                SafeDeleteArray( pLine );
+                SafeDeleteArray( pRow );
+                return false;
+            }
+
+            for( auto y=begin; y<end && value; ++y )
+            {
+                value = DecodeHdrScanline( pScanlines[y], pEnd, pLine, width ) != nullptr;
+                RGBEToFloat4( pLine, width, pRow );
+                ConvertF32ToF16( pRow, pDst + y * pitch, pitch );
+            }
+
+            SafeDeleteArray( pLine );
+            SafeDeleteArray( pRow );
+            return value;
+        },
+        []( bool lhs, bool rhs ) { return lhs && rhs; });
+
+    SafeDeleteArray( pScanlines );
+
+    if ( !result )
+    {
+        SafeDeleteArray( pixels );
+        return false;
     }
 
-    SafeDeleteArray( pLines );
     (*ppPixels) = pixels;
-
     return true;
 }
 
 //------------------------------------------------------------------------------------------
-//      HDRファイルからデータをロードします.
+//      HDRのバイナリからリソーステクスチャを生成します.
 //------------------------------------------------------------------------------------------
-bool CreateResTextureFromHDRFileA( const char* filename, asdx::ResTexture& resTexture)
+bool CreateResTextureFromHDRMemory( const uint8_t* pBinary, size_t bufferSize, asdx::ResTexture& resTexture )
 {
-    FILE* pFile = nullptr;
-
-    auto err = fopen_s( &pFile, filename, "rb" );
-    if ( err != 0 )
+    if ( pBinary == nullptr || bufferSize == 0 )
     {
-        ELOGA( "Error : LoadFromHDR() Failed. File Open Failed. filename = %s", filename );
+        ELOG( "Error : Invalid Argument." );
         return false;
     }
 
@@ -3422,86 +3967,114 @@ bool CreateResTextureFromHDRFileA( const char* filename, asdx::ResTexture& resTe
     int32_t height   = 0;
     float   gamma    = 1.0f;
     float   exposure = 1.0f;
-    if ( !ReadHdrHeader(pFile, width, height, gamma, exposure) )
+    size_t  offset   = 0;
+    if ( !ParseHdrHeader( pBinary, bufferSize, width, height, gamma, exposure, offset ) )
+    {
+        ELOG( "Error : LoadFromHDR() Failed. Header Read Failed." );
+        return false;
+    }
+
+    uint8_t* pPixels = nullptr;
+    if ( !DecodeHdrPixels( pBinary + offset, pBinary + bufferSize, width, height, &pPixels ) )
     {
-        ELOGA( "Error : LoadFromHDR() Failed. Header Read Failed. filename = %s", filename );
-        fclose(pFile);
+        ELOG( "Error : LoadFromHDR() Failed. Data Read Failed." );
         return false;
     }
 
+    auto surface = new (std::nothrow) SubResource();
+    if ( surface == nullptr )
+    {
+        ELOG( "Error : Out of Memory." );
+        SafeDeleteArray( pPixels );
+        return false;
+    }
+
+    surface->Width      = uint32_t(width);
+    surface->Height     = uint32_t(height);
+    surface->MipIndex   = 0;
+    surface->Pitch      = width * sizeof(asdx::half) * 4;
+    surface->SlicePitch = surface->Pitch * height;
+    surface->pPixels    = pPixels;
+
     resTexture.Dimension    = TEXTURE_DIMENSION_2D;
     resTexture.Width        = uint32_t(width);
     resTexture.Height       = uint32_t(height);
     resTexture.Depth        = 0;
-    resTexture.Format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    resTexture.Format       = DXGI_FORMAT_R16G16B16A16_FLOAT;
     resTexture.MipMapCount  = 1;
     resTexture.SurfaceCount = 1;
-    resTexture.pResources   = new SubResource[1];
+    resTexture.pResources   = surface;
 
-    resTexture.pResources[0].Width      = uint32_t(width);
-    resTexture.pResources[0].Height     = uint32_t(height);
-    resTexture.pResources[0].Pitch      = width * sizeof(float) * 4;
-    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+    return true;
+}
 
-    if ( !ReadHdrData(pFile, width, height, reinterpret_cast<float**>(&resTexture.pResources[0].pPixels)) )
+//------------------------------------------------------------------------------------------
+//      HDRファイルからデータをロードします.
+//------------------------------------------------------------------------------------------
+bool CreateResTextureFromHDRFile( FILE* pFile, asdx::ResTexture& resTexture )
+{
+    // ファイルサイズを取得.
+    fseek( pFile, 0, SEEK_END );
+    auto size = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
+
+    if ( size <= 0 )
     {
-        ELOGA( "Error : LoadFromHDR() Failed. Data Read Failed. filename = %s", filename );
-        fclose(pFile);
+        ELOG( "Error : Invalid File Size." );
+        fclose( pFile );
         return false;
     }
 
-    fclose(pFile);
-    return true;
+    // 一括で読み込む.
+    auto pBinary = new (std::nothrow) uint8_t [ size ];
+    if ( pBinary == nullptr )
+    {
+        ELOG( "Error : Out Of Memory." );
+        fclose( pFile );
+        return false;
+    }
+
+    auto readSize = fread( pBinary, sizeof(uint8_t), size_t( size ), pFile );
+    fclose( pFile );
+
+    auto result = CreateResTextureFromHDRMemory( pBinary, readSize, resTexture );
+    delete[] pBinary;
+
+    return result;
 }
 
 //------------------------------------------------------------------------------------------
 //      HDRファイルからデータをロードします.
 //------------------------------------------------------------------------------------------
-bool CreateResTextureFromHDRFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
+bool CreateResTextureFromHDRFileA( const char* filename, asdx::ResTexture& resTexture)
 {
     FILE* pFile = nullptr;
 
-    auto err = _wfopen_s(&pFile, filename, L"rb" );
+    auto err = fopen_s( &pFile, filename, "rb" );
     if ( err != 0 )
     {
-        ELOGW( "Error : LoadFromHDR() Failed. File Open Failed. filename = %s", filename );
-        return false;
-    }
-
-    int32_t width    = 0;
-    int32_t height   = 0;
-    float   gamma    = 1.0f;
-    float   exposure = 1.0f;
-    if ( !ReadHdrHeader(pFile, width, height, gamma, exposure) )
-    {
-        ELOGW( "Error : LoadFromHDR() Failed. Header Read Failed. filename = %s", filename );
-        fclose(pFile);
+        ELOGA( "Error : LoadFromHDR() Failed. File Open Failed. filename = %s", filename );
         return false;
     }
 
-    resTexture.Dimension    = TEXTURE_DIMENSION_2D;
-    resTexture.Width        = uint32_t(width);
-    resTexture.Height       = uint32_t(height);
-    resTexture.Depth        = 0;
-    resTexture.Format       = DXGI_FORMAT_R32G32B32A32_FLOAT;
-    resTexture.MipMapCount  = 1;
-    resTexture.SurfaceCount = 1;
-    resTexture.pResources   = new SubResource[1];
+    return CreateResTextureFromHDRFile( pFile, resTexture );
+}
 
-    resTexture.pResources[0].Width      = uint32_t(width);
-    resTexture.pResources[0].Height     = uint32_t(height);
-    resTexture.pResources[0].Pitch      = width * sizeof(float) * 4;
-    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+//------------------------------------------------------------------------------------------
+//      HDRファイルからデータをロードします.
+//------------------------------------------------------------------------------------------
+bool CreateResTextureFromHDRFileW(const wchar_t* filename, asdx::ResTexture& resTexture)
+{
+    FILE* pFile = nullptr;
 
-    if ( !ReadHdrData(pFile, width, height, reinterpret_cast<float**>(&resTexture.pResources[0].pPixels)) )
+    auto err = _wfopen_s(&pFile, filename, L"rb" );
+    if ( err != 0 )
     {
-        ELOGW( "Error : LoadFromHDR() Failed. Data Read Failed. filename = %s", filename );
-        fclose(pFile);
+        ELOGW( "Error : LoadFromHDR() Failed. File Open Failed. filename = %s", filename );
         return false;
     }
 
-    fclose(pFile);
-    return true;
+    return CreateResTextureFromHDRFile( pFile, resTexture );
 }
 
 
@@ -3576,6 +4149,23 @@ bool CreateResTextureFromMemory(const uint8_t* pBinary, uint32_t bufferSize, asd
     if ( isDDS )
     { return CreateResTextureFromDDSMemory( pBinary, bufferSize, resTexture ); }
 
+    // HDRはマジックで判定する.
+    if ( pBinary[0] == '#' && pBinary[1] == '?' )
+    { return CreateResTextureFromHDRMemory( pBinary, bufferSize, resTexture ); }
+
+    // TGAはフッターのタグで判定する.
+    if ( bufferSize >= sizeof(TGA_FOOTER) )
+    {
+        auto pTag = pBinary + bufferSize - sizeof(TGA_FOOTER::Tag);
+        if ( memcmp( pTag, "TRUEVISION-XFILE.", sizeof(TGA_FOOTER::Tag) ) == 0 )
+        { return CreateResTextureFromTGAMemory( pBinary, bufferSize, resTexture ); }
+    }
+
+    // フッターが無い TGA 1.0 形式はヘッダの内容で判定する.
+    // BMP, PNG, JPG, GIF, TIFF のマジックはカラーマップ有無が 0 か 1 にならないので誤判定しない.
+    if ( IsTgaHeader( pBinary, bufferSize ) )
+    { return CreateResTextureFromTGAMemory( pBinary, bufferSize, resTexture ); }
+
     return CreateResTextureFromWICMemory( pBinary, bufferSize, resTexture );
 }
 
@@ -3602,5 +4192,139 @@ bool ResTexture::LoadFromFileW(const wchar_t* filename)
 bool ResTexture::LoadFromMemory(const uint8_t* pBuffer, uint32_t bufferSize)
 { return CreateResTextureFromMemory( pBuffer, bufferSize, (*this) ); }
 
+//-------------------------------------------------------------------------------------------------
+//      ファイルをメモリマップしてテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::MapFromFileA(const char* filename)
+{
+    if ( filename == nullptr )
+    {
+        ELOGA( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto ext = GetExtA( filename );
+
+    if ( ext == "dds" )
+    { return CreateResTextureFromDDSMappedFileA( filename, (*this) ); }
+    else if ( ext == "tga" )
+    {
+        // デコード結果は別途確保するので，マップはデコード中のみ保持する.
+        MappedFile file;
+        if ( !file.OpenA( filename ) )
+        { return false; }
+
+        return CreateResTextureFromTGAMemory( file.GetData(), file.GetSize(), (*this) );
+    }
+    else if ( ext == "hdr" )
+    {
+        MappedFile file;
+        if ( !file.OpenA( filename ) )
+        { return false; }
+
+        return CreateResTextureFromHDRMemory( file.GetData(), file.GetSize(), (*this) );
+    }
+
+    return CreateResTextureFromFileA( filename, (*this) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      ファイルをメモリマップしてテクスチャリソースを生成します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::MapFromFileW(const wchar_t* filename)
+{
+    if ( filename == nullptr )
+    {
+        ELOGW( "Error : Invalid Argument." );
+        return false;
+    }
+
+    auto ext = GetExtW( filename );
+
+    if ( ext == L"dds" )
+    { return CreateResTextureFromDDSMappedFileW( filename, (*this) ); }
+    else if ( ext == L"tga" )
+    {
+        // デコード結果は別途確保するので，マップはデコード中のみ保持する.
+        MappedFile file;
+        if ( !file.OpenW( filename ) )
+        { return false; }
+
+        return CreateResTextureFromTGAMemory( file.GetData(), file.GetSize(), (*this) );
+    }
+    else if ( ext == L"hdr" )
+    {
+        MappedFile file;
+        if ( !file.OpenW( filename ) )
+        { return false; }
+
+        return CreateResTextureFromHDRMemory( file.GetData(), file.GetSize(), (*this) );
+    }
+
+    return CreateResTextureFromFileW( filename, (*this) );
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToDDSA(const char* filename) const
+{
+    FILE* pFile = nullptr;
+    auto err = fopen_s(&pFile, filename, "wb");
+    if (err != 0)
+    {
+        ELOGA("Error : File Open Failed. path = %s", filename);
+        return false;
+    }
+
+    auto result = WriteResTextureToDDS(pFile, (*this));
+    fclose(pFile);
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      DDSファイルに保存します.
+//-------------------------------------------------------------------------------------------------
+bool ResTexture::SaveToDDSW(const wchar_t* filename) const
+{
+    FILE* pFile = nullptr;
+    auto err = _wfopen_s(&pFile, filename, L"wb");
+    if (err != 0)
+    {
+        ELOGW("Error : File Open Failed. path = %ls", filename);
+        return false;
+    }
+
+    auto result = WriteResTextureToDDS(pFile, (*this));
+    fclose(pFile);
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+//      解放処理を行います.
+//-------------------------------------------------------------------------------------------------
+void ResTexture::Dispose()
+{
+    // 一括確保したメモリやマップを参照している場合は個別に解放しない.
+    if ( pResources != nullptr && pPixelData == nullptr && pMappedFile == nullptr )
+    {
+        uint32_t mipCount = ( MipMapCount > 0 ) ? MipMapCount : 1;
+
+        for( uint32_t i=0; i<SurfaceCount * mipCount; ++i )
+        { pResources[i].Release(); }
+    }
+
+    SafeDeleteArray( pResources );
+    SafeDeleteArray( pPixelData );
+
+    if ( pMappedFile != nullptr )
+    {
+        delete pMappedFile;
+        pMappedFile = nullptr;
+    }
+}
+
 
 } // namespace asdx
@@ -0,0 +1,308 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTextureCache.cpp
+// Desc : Texture Cook Cache.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <Windows.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <res/asdxTextureCache.h>
+#include <fnd/asdxHash.h>
+#include <fnd/asdxLogger.h>
+#include <fnd/asdxMappedFile.h>
+#include <fnd/asdxMisc.h>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+// デコーダ・ミップマップ生成・エンコーダの出力が変わる場合は値を上げて古いキャッシュを無効化します.
+static const uint32_t kCookVersion = 1;
+
+//-----------------------------------------------------------------------------
+//      キャッシュファイル名を生成します.
+//-----------------------------------------------------------------------------
+void MakeCacheFileName(uint64_t key, char (&name)[32])
+{ sprintf_s(name, "%016llx.dds", static_cast<unsigned long long>(key)); }
+
+//-----------------------------------------------------------------------------
+//      オプションに従ってテクスチャをクックします.
+//-----------------------------------------------------------------------------
+bool CookTexture(const asdx::TextureCookOption& option, asdx::ResTexture& resTexture)
+{
+    // ソースに適用できない処理は飛ばして，そのまま返却する.
+    // 飛ばすかどうかはソースの内容だけで決まるので，結果はキャッシュして構わない.
+    auto complete = true;
+
+    if (option.GenerateMipMaps)
+    {
+        if (resTexture.MipMapCount > 1)
+        { /* 既存のミップマップをそのまま使う. */ }
+        else if (resTexture.Dimension == asdx::TEXTURE_DIMENSION_3D
+             || !asdx::IsMipMapSupportedFormat(resTexture.Format))
+        { WLOG("Warning : Skip Mip Map Generation. format = %u", resTexture.Format); }
+        else if (!asdx::GenerateMipMaps(resTexture, option.MipFilter, option.AlphaReference))
+        {
+            WLOG("Warning : GenerateMipMaps() Failed.");
+            complete = false;
+        }
+    }
+
+    if (option.Compress)
+    {
+        // 浮動小数点のソースは BC6H でしか圧縮できない.
+        auto format = option.Format;
+        if (asdx::IsCompressibleFormat(resTexture.Format, asdx::BC_FORMAT_BC6H))
+        { format = asdx::BC_FORMAT_BC6H; }
+
+        if (resTexture.Dimension == asdx::TEXTURE_DIMENSION_3D
+         || !asdx::IsCompressibleFormat(resTexture.Format, format))
+        { WLOG("Warning : Skip Block Compression. format = %u", resTexture.Format); }
+        else if (!asdx::CompressResTexture(resTexture, format, option.Quality))
+        {
+            WLOG("Warning : CompressResTexture() Failed.");
+            complete = false;
+        }
+    }
+
+    return complete;
+}
+
+//-----------------------------------------------------------------------------
+//      途中のディレクトリを含めてディレクトリを生成します.
+//-----------------------------------------------------------------------------
+bool CreateDirectoriesA(const char* path)
+{
+    std::string dir = path;
+    for(size_t i=1; i<=dir.size(); ++i)
+    {
+        if (i < dir.size() && dir[i] != '\\' && dir[i] != '/')
+        { continue; }
+
+        // ドライブ名はスキップ.
+        auto sub = dir.substr(0, i);
+        if (sub.back() == ':' || asdx::IsExistFolderPathA(sub.c_str()))
+        { continue; }
+
+        CreateDirectoryA(sub.c_str(), nullptr);
+    }
+
+    return asdx::IsExistFolderPathA(path);
+}
+
+//-----------------------------------------------------------------------------
+//      途中のディレクトリを含めてディレクトリを生成します.
+//-----------------------------------------------------------------------------
+bool CreateDirectoriesW(const wchar_t* path)
+{
+    std::wstring dir = path;
+    for(size_t i=1; i<=dir.size(); ++i)
+    {
+        if (i < dir.size() && dir[i] != L'\\' && dir[i] != L'/')
+        { continue; }
+
+        // ドライブ名はスキップ.
+        auto sub = dir.substr(0, i);
+        if (sub.back() == L':' || asdx::IsExistFolderPathW(sub.c_str()))
+        { continue; }
+
+        CreateDirectoryW(sub.c_str(), nullptr);
+    }
+
+    return asdx::IsExistFolderPathW(path);
+}
+
+} // namespace
+
+
+namespace asdx {
+
+//-----------------------------------------------------------------------------
+//      クック済みテクスチャのキャッシュキーを計算します.
+//-----------------------------------------------------------------------------
+uint64_t CalcTextureCookKey(const void* pSource, size_t size, const TextureCookOption& option)
+{
+    // 結果に影響しないオプションは 0 にそろえて，同じ出力のキーが分かれないようにする.
+    uint32_t alphaRef = 0;
+    if (option.GenerateMipMaps && option.AlphaReference > 0.0f)
+    { memcpy(&alphaRef, &option.AlphaReference, sizeof(alphaRef)); }
+
+    // パディングを含めないよう固定長の配列に詰めてからハッシュを取る.
+    const uint32_t params[] = {
+        kCookVersion,
+        option.GenerateMipMaps ? 1u : 0u,
+        option.GenerateMipMaps ? uint32_t(option.MipFilter) : 0u,
+        alphaRef,
+        option.Compress ? 1u : 0u,
+        option.Compress ? uint32_t(option.Format)  : 0u,
+        option.Compress ? uint32_t(option.Quality) : 0u,
+    };
+
+    auto hash = CalcHash64(pSource, size);
+    return CalcHash64(params, sizeof(params), hash);
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュを利用してクック済みテクスチャを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadCookedTextureA
+(
+    const char*                 filename,
+    const char*                 cacheDir,
+    const TextureCookOption&    option,
+    ResTexture&                 resTexture
+)
+{
+    if (filename == nullptr || cacheDir == nullptr)
+    {
+        ELOGA("Error : Invalid Argument.");
+        return false;
+    }
+
+    // 書き込みを共有せずにマップするので，クックが終わるまでソースは変更されない.
+    MappedFile source;
+    if (!source.OpenA(filename))
+    { return false; }
+
+    char name[32];
+    MakeCacheFileName(CalcTextureCookKey(source.GetData(), source.GetSize(), option), name);
+
+    std::string cachePath = cacheDir;
+    if (!cachePath.empty() && cachePath.back() != '\\' && cachePath.back() != '/')
+    { cachePath += '\\'; }
+    cachePath += name;
+
+    // ヒットした場合はマップするだけ.
+    if (IsExistFilePathA(cachePath.c_str()))
+    {
+        if (resTexture.MapFromFileA(cachePath.c_str()))
+        { return true; }
+
+        // 壊れたキャッシュは削除して作り直す.
+        WLOGA("Warning : Broken Cook Cache. path = %s", cachePath.c_str());
+        resTexture.Dispose();
+        resTexture = ResTexture();
+        DeleteFileA(cachePath.c_str());
+    }
+
+    if (!resTexture.MapFromFileA(filename))
+    { return false; }
+
+    // 一時的な失敗で未加工の結果を残さないよう，処理に失敗した場合は保存しない.
+    if (!CookTexture(option, resTexture))
+    {
+        WLOGA("Warning : Cook Failed. Use Source Texture. path = %s", filename);
+        return true;
+    }
+
+    if (!IsExistFolderPathA(cacheDir) && !CreateDirectoriesA(cacheDir))
+    {
+        WLOGA("Warning : Cache Directory Create Failed. path = %s", cacheDir);
+        return true;
+    }
+
+    // 読み込み中の他プロセスに書きかけを見せないよう，一時ファイルに保存してから移動する.
+    char suffix[32];
+    sprintf_s(suffix, ".%lu.%lu.tmp", GetCurrentProcessId(), GetCurrentThreadId());
+    auto tempPath = cachePath + suffix;
+
+    if (!resTexture.SaveToDDSA(tempPath.c_str()))
+    {
+        WLOGA("Warning : Cook Cache Save Failed. path = %s", cachePath.c_str());
+        DeleteFileA(tempPath.c_str());
+        return true;
+    }
+
+    // 既に他プロセスが同じキーを保存していれば内容は同一なので，一時ファイルを破棄する.
+    if (!MoveFileExA(tempPath.c_str(), cachePath.c_str(), 0))
+    { DeleteFileA(tempPath.c_str()); }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      キャッシュを利用してクック済みテクスチャを読み込みます.
+//-----------------------------------------------------------------------------
+bool LoadCookedTextureW
+(
+    const wchar_t*              filename,
+    const wchar_t*              cacheDir,
+    const TextureCookOption&    option,
+    ResTexture&                 resTexture
+)
+{
+    if (filename == nullptr || cacheDir == nullptr)
+    {
+        ELOGW("Error : Invalid Argument.");
+        return false;
+    }
+
+    // 書き込みを共有せずにマップするので，クックが終わるまでソースは変更されない.
+    MappedFile source;
+    if (!source.OpenW(filename))
+    { return false; }
+
+    char name[32];
+    MakeCacheFileName(CalcTextureCookKey(source.GetData(), source.GetSize(), option), name);
+
+    std::wstring cachePath = cacheDir;
+    if (!cachePath.empty() && cachePath.back() != L'\\' && cachePath.back() != L'/')
+    { cachePath += L'\\'; }
+    cachePath += ToStringW(name);
+
+    // ヒットした場合はマップするだけ.
+    if (IsExistFilePathW(cachePath.c_str()))
+    {
+        if (resTexture.MapFromFileW(cachePath.c_str()))
+        { return true; }
+
+        // 壊れたキャッシュは削除して作り直す.
+        WLOGW("Warning : Broken Cook Cache. path = %ls", cachePath.c_str());
+        resTexture.Dispose();
+        resTexture = ResTexture();
+        DeleteFileW(cachePath.c_str());
+    }
+
+    if (!resTexture.MapFromFileW(filename))
+    { return false; }
+
+    // 一時的な失敗で未加工の結果を残さないよう，処理に失敗した場合は保存しない.
+    if (!CookTexture(option, resTexture))
+    {
+        WLOGW("Warning : Cook Failed. Use Source Texture. path = %ls", filename);
+        return true;
+    }
+
+    if (!IsExistFolderPathW(cacheDir) && !CreateDirectoriesW(cacheDir))
+    {
+        WLOGW("Warning : Cache Directory Create Failed. path = %ls", cacheDir);
+        return true;
+    }
+
+    // 読み込み中の他プロセスに書きかけを見せないよう，一時ファイルに保存してから移動する.
+    wchar_t suffix[32];
+    swprintf_s(suffix, L".%lu.%lu.tmp", GetCurrentProcessId(), GetCurrentThreadId());
+    auto tempPath = cachePath + suffix;
+
+    if (!resTexture.SaveToDDSW(tempPath.c_str()))
+    {
+        WLOGW("Warning : Cook Cache Save Failed. path = %ls", cachePath.c_str());
+        DeleteFileW(tempPath.c_str());
+        return true;
+    }
+
+    // 既に他プロセスが同じキーを保存していれば内容は同一なので，一時ファイルを破棄する.
+    if (!MoveFileExW(tempPath.c_str(), cachePath.c_str(), 0))
+    { DeleteFileW(tempPath.c_str()); }
+
+    return true;
+}
+
+} // namespace asdx
@@ -12,6 +12,7 @@
 #include <fnd/asdxFrameHeap.h>
 #include <fnd/asdxHash.h>
 #include <fnd/asdxList.h>
+#include <fnd/asdxObjectPool.h>
 #include <fnd/asdxStack.h>
 #include <fnd/asdxThreadPool.h>
 #include <fnd/asdxLogger.h>
@@ -373,9 +374,19 @@ public:
     void Release()
     {
         Term();
-        delete this;
+
+        if (m_pPool != nullptr)
+        { m_pPool->Delete(this); }
+        else
+        { delete this; }
     }
 
+    //-------------------------------------------------------------------------
+    //! @brief      解放先のプールを設定します.
+    //-------------------------------------------------------------------------
+    void SetPool(ObjectPool<PassResource>* pool)
+    { m_pPool = pool; }
+
     //-------------------------------------------------------------------------
     //! @brief      レンダーターゲットビューを取得します.
     //-------------------------------------------------------------------------
@@ -701,6 +712,7 @@ private:
     bool                    m_Import    = false;
     bool                    m_Stencil   = false;
     RenderPass*             m_Producer  = nullptr;
+    ObjectPool<PassResource>* m_pPool   = nullptr;
 
     //=========================================================================
     // private methods.
@@ -1032,7 +1044,7 @@ public:
     //! @brief      デストラクタです.
     //-------------------------------------------------------------------------
     ~PassResourceRegistry()
-    { /* DO_NOTHING */ }
+    { Clear(); }
 
     //-------------------------------------------------------------------------
     //! @brief      初期化処理を行います.
@@ -1041,6 +1053,9 @@ public:
     {
         m_Capacity   = capacity;
         m_Cache.Clear();
+
+        // 遅延解放中のものを含めて足りる分を先に確保しておく.
+        m_Pool.Reserve(capacity * 2);
     }
 
     //-------------------------------------------------------------------------
@@ -1118,9 +1133,10 @@ private:
     //=========================================================================
     // private variables.
     //=========================================================================
-    Disposer<PassResource>  m_Dispoer;
-    uint32_t                m_Capacity = 0;
-    List<PassResource>      m_Cache;
+    ObjectPool<PassResource>    m_Pool;     // m_Dispoer より先に破棄されないよう先に宣言.
+    Disposer<PassResource>      m_Dispoer;
+    uint32_t                    m_Capacity = 0;
+    List<PassResource>          m_Cache;
 
     //=========================================================================
     // private methods.
@@ -1172,14 +1188,15 @@ private:
     //-------------------------------------------------------------------------
     PassResource* CreateResource(const PassResourceDesc& value, RenderPass* producer)
     {
-        auto resource = new(std::nothrow) PassResource();
+        auto resource = m_Pool.New();
         assert(resource != nullptr);
+        resource->SetPool(&m_Pool);
 
         if (!resource->Init(value, producer))
         {
             ELOG("Error : PassResource::Init() Failed.");
             assert(false);
-            resource->Term();
+            resource->Release();
             return nullptr;
         }
 
@@ -1725,9 +1742,11 @@ bool PassGraph::Init(const PassGraphDesc& desc)
 
     m_MaxPassCount = desc.MaxPassCount;
 
-    // 必要なメモリを計算.
-    auto frameHeapSize = sizeof(RenderPass)   * desc.MaxPassCount
-                       + sizeof(PassResource) * desc.MaxResourceCount;
+    // 必要なメモリを計算(アライメント調整分も含める).
+    // スレッド毎のページの未使用分は他スレッドから使えないので，呼び出しスレッドを含めた分だけ余裕を持たせる.
+    auto frameHeapSize = (sizeof(RenderPass)   + FrameHeap::DEFAULT_ALIGNMENT) * desc.MaxPassCount
+                       + (sizeof(PassResource) + FrameHeap::DEFAULT_ALIGNMENT) * desc.MaxResourceCount
+                       + FrameHeap::DEFAULT_PAGE_SIZE * (size_t(m_ThreadPool->GetThreadCount()) + 1);
 
     if (!m_FrameHeap.Init(frameHeapSize))
     {
@@ -1970,6 +1989,9 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
     auto graphisIndex = 0u;
     auto computeIndex = 0u;
 
+    // このフレームのレンダリングパスの完了カウンター.
+    JobCounter counter;
+
     auto itr = m_PassList.GetHead();
     while(itr != nullptr)
     {
@@ -1999,7 +2021,7 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
         itr->SetCommandList(pCmd);
 
         // スレッド実行.
-        m_ThreadPool->Push(itr);
+        m_ThreadPool->Push(itr, &counter);
 
         // 次が無ければ修正.
         if (!itr->HasNext())
@@ -2010,7 +2032,7 @@ WaitPoint PassGraph::Execute(const WaitPoint& waitPoint)
     }
 
     // レンダリングパスの完了を待機.
-    m_ThreadPool->Wait();
+    m_ThreadPool->Wait(&counter);
 
     // 前フレームのコマンドが完了するまで待機.
     if (waitPoint.IsValid())
@@ -0,0 +1,69 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTest.h
+// Desc : Test Runner.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <chrono>
+
+
+namespace asdx {
+namespace test {
+
+///////////////////////////////////////////////////////////////////////////////
+// Timer class
+///////////////////////////////////////////////////////////////////////////////
+class Timer
+{
+public:
+    //-------------------------------------------------------------------------
+    //! @brief      計測を開始します.
+    //-------------------------------------------------------------------------
+    void Start()
+    { m_Begin = std::chrono::steady_clock::now(); }
+
+    //-------------------------------------------------------------------------
+    //! @brief      計測開始からの経過時間をミリ秒単位で取得します.
+    //-------------------------------------------------------------------------
+    double GetElapsedMsec() const
+    { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Begin).count(); }
+
+private:
+    std::chrono::steady_clock::time_point   m_Begin;
+};
+
+//-----------------------------------------------------------------------------
+//! @brief      関数を指定回数実行し，最短の実行時間をミリ秒単位で返却します.
+//-----------------------------------------------------------------------------
+template<typename Func>
+double MeasureBestMsec(int count, const Func& func)
+{
+    double best = 0.0;
+    for(auto i=0; i<count; ++i)
+    {
+        Timer timer;
+        timer.Start();
+        func();
+        auto msec = timer.GetElapsedMsec();
+        if (i == 0 || msec < best)
+        { best = msec; }
+    }
+    return best;
+}
+
+//-----------------------------------------------------------------------------
+// Test Functions.
+//-----------------------------------------------------------------------------
+bool TestJobGraph();
+bool BenchVertexFaceAdjacency();
+bool TestMathSimd();
+bool BenchTextureDecodeTGA();
+bool BenchTextureDecodeHDR();
+bool BenchOBJLoad();
+
+} // namespace test
+} // namespace asdx
@@ -0,0 +1,96 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTestMain.cpp
+// Desc : Test Runner.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <cstdio>
+#include <cstring>
+
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+// TestEntry structure
+///////////////////////////////////////////////////////////////////////////////
+struct TestEntry
+{
+    const char*     Name;           //!< 名前です.
+    bool            (*Func)();      //!< 実行関数です.
+    bool            Benchmark;      //!< ベンチマークかどうか?
+};
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const TestEntry kEntries[] = {
+    { "JobGraph",                asdx::test::TestJobGraph,                  false },
+    { "VertexFaceAdjacency",     asdx::test::BenchVertexFaceAdjacency,      true  },
+    { "MathSimd",                asdx::test::TestMathSimd,                  false },
+    { "TextureDecodeTGA",        asdx::test::BenchTextureDecodeTGA,         true  },
+    { "TextureDecodeHDR",        asdx::test::BenchTextureDecodeHDR,         true  },
+    { "OBJLoad",                 asdx::test::BenchOBJLoad,                  true  },
+};
+
+} // namespace
+
+
+//-----------------------------------------------------------------------------
+//      メインエントリーポイントです.
+//
+//      引数なしの場合はテストだけを実行します.
+//      "-bench" を指定するとベンチマークも実行し，名前を指定した場合はそれだけを実行します.
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    auto bench = false;
+    auto named = false;
+    for(auto i=1; i<argc; ++i)
+    {
+        if (strcmp(argv[i], "-bench") == 0)
+        { bench = true; }
+        else
+        { named = true; }
+    }
+
+    auto failed = 0;
+    auto count  = 0;
+    for(const auto& entry : kEntries)
+    {
+        auto run = false;
+        if (named)
+        {
+            for(auto i=1; i<argc; ++i)
+            {
+                if (strcmp(argv[i], entry.Name) == 0)
+                { run = true; }
+            }
+        }
+        else
+        { run = !entry.Benchmark || bench; }
+
+        if (!run)
+        { continue; }
+
+        printf("[ RUN    ] %s\n", entry.Name);
+        auto success = entry.Func();
+        printf("[ %s ] %s\n", success ? "    OK" : "FAILED", entry.Name);
+
+        count++;
+        if (!success)
+        { failed++; }
+    }
+
+    if (named && count == 0)
+    {
+        printf("No test matched.\n");
+        return 1;
+    }
+
+    printf("%d / %d passed.\n", count - failed, count);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxJobGraphTest.cpp
+// Desc : JobGraph Regression Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <fnd/asdxJobGraph.h>
+#include <atomic>
+#include <cstdio>
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//      子ジョブを生成した実行の後に AddJob() しても，子ジョブが再実行されないことを確認します.
+//-----------------------------------------------------------------------------
+bool TestJobGraph()
+{
+    asdx::IThreadPool* pThreadPool = nullptr;
+    if (!asdx::CreateThreadPool(4, &pThreadPool))
+    { return false; }
+
+    asdx::JobGraph graph;
+    if (!graph.Init(pThreadPool, 256))
+    {
+        pThreadPool->Release();
+        return false;
+    }
+
+    const int kChildCount = 32;
+    std::atomic<int> rootCount (0);
+    std::atomic<int> childCount(0);
+    std::atomic<int> addedCount(0);
+
+    graph.AddJob("root", [&](asdx::JobGraph* pGraph, asdx::Job* pJob)
+    {
+        rootCount++;
+        for(auto i=0; i<kChildCount; ++i)
+        { pGraph->Spawn(pJob, "child", [&](asdx::JobGraph*, asdx::Job*) { childCount++; }); }
+    });
+
+    graph.Execute();
+    graph.Wait();
+
+    // 実行の合間に追加する.
+    graph.AddJob("added", [&](asdx::JobGraph*, asdx::Job*) { addedCount++; });
+
+    graph.Execute();
+    graph.Wait();
+
+    auto jobCount = graph.GetJobCount();
+
+    graph.Term();
+    pThreadPool->Release();
+
+    bool success = (rootCount  == 2)
+                && (childCount == 2 * kChildCount)
+                && (addedCount == 1)
+                && (jobCount   == 2 + kChildCount);
+
+    printf("root = %d, child = %d, added = %d, jobs = %u\n",
+        rootCount.load(), childCount.load(), addedCount.load(), jobCount);
+
+    return success;
+}
+
+} // namespace test
+} // namespace asdx
@@ -0,0 +1,168 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxMathSimdTest.cpp
+// Desc : Scalar / SIMD Math Comparison Test.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <fnd/asdxMath.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <random>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const int    kIterationCount     = 10000;
+static const float  kInvertTolerance    = 1e-4f;    // 逆行列の残差 |A * A^-1 - I| の許容値.
+
+//-----------------------------------------------------------------------------
+//      ランダムな行列を生成します.
+//-----------------------------------------------------------------------------
+asdx::Matrix CreateRandomMatrix(std::mt19937& random, float scale)
+{
+    std::uniform_real_distribution<float> dist(-scale, scale);
+
+    asdx::Matrix result;
+    auto p = &result._11;
+    for(auto i=0; i<16; ++i)
+    { p[i] = dist(random); }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      正則なランダム行列を生成します.
+//-----------------------------------------------------------------------------
+asdx::Matrix CreateRandomInvertibleMatrix(std::mt19937& random)
+{
+    // 対角優位にして条件数を抑える.
+    auto result = CreateRandomMatrix(random, 1.0f);
+    result._11 += 4.0f;
+    result._22 += 4.0f;
+    result._33 += 4.0f;
+    result._44 += 4.0f;
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      逆行列の残差を求めます.
+//-----------------------------------------------------------------------------
+float CalcInvertResidual(const asdx::Matrix& value, const asdx::Matrix& inverse)
+{
+    auto identity = asdx::Matrix::Multiply(value, inverse);
+    auto p = &identity._11;
+
+    auto residual = 0.0f;
+    for(auto i=0; i<16; ++i)
+    {
+        auto expected = ((i % 5) == 0) ? 1.0f : 0.0f;
+        residual = std::max(residual, fabsf(p[i] - expected));
+    }
+
+    return residual;
+}
+
+} // namespace
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//      スカラー版と SIMD 版の計算結果を比較します.
+//
+//      乗算と変換はビット単位で一致し，逆行列は残差が許容値以内であることを確認します.
+//      スカラー版は ASDX_ENABLE_MATH_SIMD を定義していないこのプロジェクトの Matrix と Vector4 を使います.
+//-----------------------------------------------------------------------------
+bool TestMathSimd()
+{
+#if !defined(ASDX_MATH_SSE2) && !defined(ASDX_MATH_NEON)
+    printf("SIMD is not available on this target. skipped.\n");
+    return true;
+#else
+    std::mt19937 random(12345);
+
+    auto multiplyMismatch  = 0;
+    auto transposeMismatch = 0;
+    auto transformMismatch = 0;
+    auto invertFailure     = 0;
+    auto maxResidualScalar = 0.0f;
+    auto maxResidualSimd   = 0.0f;
+
+    for(auto i=0; i<kIterationCount; ++i)
+    {
+        auto a = CreateRandomMatrix(random, 100.0f);
+        auto b = CreateRandomMatrix(random, 100.0f);
+
+        // 乗算.
+        {
+            auto expected = Matrix::Multiply(a, b);
+            Matrix actual;
+            detail::MultiplySimd(&a._11, &b._11, &actual._11, false);
+            if (memcmp(&expected, &actual, sizeof(Matrix)) != 0)
+            { multiplyMismatch++; }
+        }
+
+        // 乗算して転置.
+        {
+            auto expected = Matrix::MultiplyTranspose(a, b);
+            Matrix actual;
+            detail::MultiplySimd(&a._11, &b._11, &actual._11, true);
+            if (memcmp(&expected, &actual, sizeof(Matrix)) != 0)
+            { transposeMismatch++; }
+        }
+
+        // ベクトルの変換.
+        {
+            auto m = CreateRandomMatrix(random, 100.0f);
+            auto v = Vector4(b._11, b._12, b._13, b._14);
+            auto expected = Vector4::Transform(v, m);
+            Vector4 actual;
+            detail::TransformSimd(&v.x, &m._11, &actual.x);
+            if (memcmp(&expected, &actual, sizeof(Vector4)) != 0)
+            { transformMismatch++; }
+        }
+
+        // 逆行列.
+        {
+            auto m = CreateRandomInvertibleMatrix(random);
+            auto expected = Matrix::Invert(m);
+        #if defined(ASDX_MATH_SSE2)
+            Matrix actual;
+            detail::InvertSimd(&m._11, &actual._11);
+        #else
+            // NEON はスカラー版を使う.
+            auto actual = expected;
+        #endif
+            auto residualScalar = CalcInvertResidual(m, expected);
+            auto residualSimd   = CalcInvertResidual(m, actual);
+            maxResidualScalar = std::max(maxResidualScalar, residualScalar);
+            maxResidualSimd   = std::max(maxResidualSimd,   residualSimd);
+            if (residualSimd > kInvertTolerance)
+            { invertFailure++; }
+        }
+    }
+
+    printf("Multiply mismatch = %d, MultiplyTranspose mismatch = %d, Transform mismatch = %d\n",
+        multiplyMismatch, transposeMismatch, transformMismatch);
+    printf("Invert failure = %d, max residual scalar = %e, simd = %e\n",
+        invertFailure, maxResidualScalar, maxResidualSimd);
+
+    return multiplyMismatch  == 0
+        && transposeMismatch == 0
+        && transformMismatch == 0
+        && invertFailure     == 0;
+#endif
+}
+
+} // namespace test
+} // namespace asdx
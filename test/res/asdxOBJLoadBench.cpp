@@ -0,0 +1,322 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxOBJLoadBench.cpp
+// Desc : OBJ Loader Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <res/asdxResModel.h>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t   kGridSize       = 1025;     // 約210万三角形.
+static const int        kRepeatCount    = 2;
+static const char*      kObjPath        = "asdxOBJLoadBench.obj";
+
+//-----------------------------------------------------------------------------
+//      格子状のメッシュをOBJファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteGridOBJ(const char* path, uint32_t size, size_t& fileSize, size_t& faceCount)
+{
+    FILE* pFile = nullptr;
+    if (fopen_s(&pFile, path, "wb") != 0)
+    { return false; }
+
+    fprintf(pFile, "# asdx OBJ benchmark\n");
+
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        {
+            auto h = 0.01f * float((x * 7 + y * 13) % 17);
+            fprintf(pFile, "v %f %f %f\n", float(x) * 0.125f, h, float(y) * -0.125f);
+        }
+    }
+
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        { fprintf(pFile, "vt %f %f\n", float(x) / float(size - 1), float(y) / float(size - 1)); }
+    }
+
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        { fprintf(pFile, "vn 0.000000 1.000000 0.000000\n"); }
+    }
+
+    fprintf(pFile, "g grid\nusemtl default\n");
+
+    faceCount = 0;
+    for(auto y=0u; y<size - 1; ++y)
+    {
+        for(auto x=0u; x<size - 1; ++x)
+        {
+            auto i0 = y * size + x + 1;
+            auto i1 = i0 + 1;
+            auto i2 = i0 + size;
+            auto i3 = i2 + 1;
+            fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i0, i0, i0, i2, i2, i2, i1, i1, i1);
+            fprintf(pFile, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", i1, i1, i1, i2, i2, i2, i3, i3, i3);
+            faceCount += 2;
+        }
+    }
+
+    fileSize = size_t(ftell(pFile));
+    fclose(pFile);
+
+    return true;
+}
+
+namespace legacy {
+
+///////////////////////////////////////////////////////////////////////////////
+// IndexOBJ structure
+///////////////////////////////////////////////////////////////////////////////
+struct IndexOBJ
+{
+    uint32_t    P;      //!< 位置.
+    uint32_t    N;      //!< 法線.
+    uint32_t    U;      //!< テクスチャ座標.
+};
+
+//-----------------------------------------------------------------------------
+//      OBJファイルからモデルをロードします. (並列パーサー導入前の実装)
+//
+//      パース部分は std::ifstream を使っていた旧実装のままです.
+//      旧実装のメッシュ構築はサイズ未確保の配列に書き込んでいたため，push_back で展開しています.
+//      インデックスの法線とテクスチャ座標の入れ替わりも修正しています.
+//      マテリアルはベンチマークで使わないので省いています.
+//-----------------------------------------------------------------------------
+bool LoadFromOBJ(const char* path, asdx::ResMesh& dstMesh)
+{
+    std::ifstream stream;
+    stream.open(path, std::ios::in);
+    if (!stream.is_open())
+    { return false; }
+
+    const uint32_t BUFFER_LENGTH = 2048;
+    char buf[BUFFER_LENGTH] = {};
+    std::string group;
+
+    std::vector<asdx::Vector3>      positions;
+    std::vector<asdx::Vector3>      normals;
+    std::vector<asdx::Vector2>      texcoords;
+    std::vector<IndexOBJ>           indices;
+
+    for(;;)
+    {
+        stream >> buf;
+        if (!stream || stream.eof())
+            break;
+
+        if (0 == strcmp(buf, "#"))
+        {
+            /* DO_NOTHING */
+        }
+        else if (0 == strcmp(buf, "v"))
+        {
+            asdx::Vector3 v;
+            stream >> v.x >> v.y >> v.z;
+            positions.push_back(v);
+        }
+        else if (0 == strcmp(buf, "vt"))
+        {
+            asdx::Vector2 vt;
+            stream >> vt.x >> vt.y;
+            texcoords.push_back(vt);
+        }
+        else if (0 == strcmp(buf, "vn"))
+        {
+            asdx::Vector3 vn;
+            stream >> vn.x >> vn.y >> vn.z;
+            normals.push_back(vn);
+        }
+        else if (0 == strcmp(buf, "g"))
+        {
+            stream >> group;
+        }
+        else if (0 == strcmp(buf, "f"))
+        {
+            uint32_t ip, it, in;
+            uint32_t p[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+            uint32_t t[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+            uint32_t n[4] = { UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX };
+
+            uint32_t count = 0;
+
+            for(auto i=0; i<4; ++i)
+            {
+                count++;
+
+                // 位置座標インデックス.
+                stream >> ip;
+                p[i] = ip - 1;
+
+                if ('/' == stream.peek())
+                {
+                    stream.ignore();
+
+                    // テクスチャ座標インデックス.
+                    if ('/' != stream.peek())
+                    {
+                        stream >> it;
+                        t[i] = it - 1;
+                    }
+
+                    // 法線インデックス.
+                    if ('/' == stream.peek())
+                    {
+                        stream.ignore();
+
+                        stream >> in;
+                        n[i] = in - 1;
+                    }
+                }
+
+                if (count <= 3)
+                {
+                    IndexOBJ f0 = { p[i], n[i], t[i] };
+                    indices.push_back(f0);
+                }
+
+                if ('\n' == stream.peek() || '\r' == stream.peek())
+                    break;
+            }
+
+            // 四角形.
+            if (count > 3 && p[3] != UINT32_MAX)
+            {
+                assert(count == 4);
+
+                IndexOBJ f0 = { p[2], n[2], t[2] };
+                IndexOBJ f1 = { p[3], n[3], t[3] };
+                IndexOBJ f2 = { p[0], n[0], t[0] };
+
+                indices.push_back(f0);
+                indices.push_back(f1);
+                indices.push_back(f2);
+            }
+        }
+
+        stream.ignore(BUFFER_LENGTH, '\n');
+    }
+
+    stream.close();
+
+    dstMesh = asdx::ResMesh();
+    dstMesh.Positions    .reserve(indices.size());
+    dstMesh.Normals      .reserve(indices.size());
+    dstMesh.TexCoords[0] .reserve(indices.size());
+    dstMesh.VertexIndices.reserve(indices.size());
+
+    uint32_t vertId = 0;
+    for(auto& index : indices)
+    {
+        if (index.P >= positions.size() || index.N >= normals.size() || index.U >= texcoords.size())
+        { return false; }
+
+        dstMesh.Positions    .push_back(positions[index.P]);
+        dstMesh.Normals      .push_back(normals  [index.N]);
+        dstMesh.TexCoords[0] .push_back(texcoords[index.U]);
+        dstMesh.VertexIndices.push_back(vertId++);
+    }
+
+    return true;
+}
+
+} // namespace legacy
+
+//-----------------------------------------------------------------------------
+//      展開した面の頂点位置がビット単位で一致するかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSame(const asdx::ResMesh& expanded, const asdx::ResModel& model)
+{
+    if (model.Meshes.size() != 1)
+    { return false; }
+
+    auto& mesh = model.Meshes[0];
+    if (mesh.VertexIndices.size() != expanded.VertexIndices.size())
+    { return false; }
+
+    for(size_t i=0; i<mesh.VertexIndices.size(); ++i)
+    {
+        auto index = mesh.VertexIndices[i];
+        if (index >= mesh.Positions.size())
+        { return false; }
+
+        if (memcmp(&mesh.Positions[index], &expanded.Positions[i], sizeof(asdx::Vector3)) != 0)
+        { return false; }
+    }
+
+    return true;
+}
+
+} // namespace
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//      OBJの読み込み速度を旧実装と比較します.
+//
+//      旧実装は std::ifstream で1トークンずつ読み込み，新実装はメモリマップした
+//      ファイルをチャンクに分割して並列にパースします. 新実装は重複頂点の統合まで含みます.
+//-----------------------------------------------------------------------------
+bool BenchOBJLoad()
+{
+    size_t fileSize  = 0;
+    size_t faceCount = 0;
+    if (!WriteGridOBJ(kObjPath, kGridSize, fileSize, faceCount))
+    {
+        printf("Error : File Write Failed. path = %s\n", kObjPath);
+        return false;
+    }
+
+    auto mb = double(fileSize) / (1024.0 * 1024.0);
+    printf("faces = %zu, file size = %.1f MB\n", faceCount, mb);
+
+    ResMesh  oldMesh;
+    ResModel newModel;
+    auto oldResult = true;
+    auto newResult = true;
+
+    auto oldMsec = MeasureBestMsec(kRepeatCount, [&]()
+    { oldResult = legacy::LoadFromOBJ(kObjPath, oldMesh); });
+
+    auto newMsec = MeasureBestMsec(kRepeatCount, [&]()
+    {
+        newModel.Dispose();
+        newResult = newModel.LoadFromFileA(kObjPath);
+    });
+
+    auto same = oldResult && newResult
+             && oldMesh.VertexIndices.size() == faceCount * 3
+             && IsSame(oldMesh, newModel);
+
+    printf("old (ifstream) : %8.1f ms (%7.1f MB/s)\n", oldMsec, mb * 1000.0 / oldMsec);
+    printf("new (parallel) : %8.1f ms (%7.1f MB/s), x%5.2f%s\n",
+        newMsec, mb * 1000.0 / newMsec, oldMsec / newMsec, same ? "" : " (MISMATCH)");
+
+    newModel.Dispose();
+    remove(kObjPath);
+
+    return same;
+}
+
+} // namespace test
+} // namespace asdx
@@ -0,0 +1,928 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxTextureDecodeBench.cpp
+// Desc : Texture Decode Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <res/asdxResTexture.h>
+#include <fnd/asdxMath.h>
+#include <dxgiformat.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <random>
+#include <vector>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint16_t   kTgaWidth       = 4096;
+static const uint16_t   kTgaHeight      = 4096;
+static const int        kRepeatCount    = 3;
+static const char*      kTgaPath        = "asdxTextureDecodeBench.tga";
+static const int32_t    kHdrWidth       = 4096;
+static const int32_t    kHdrHeight      = 2048;
+static const char*      kHdrPath        = "asdxTextureDecodeBench.hdr";
+
+///////////////////////////////////////////////////////////////////////////////
+// TGA_HEADER structure
+///////////////////////////////////////////////////////////////////////////////
+#pragma pack( push, 1 )
+struct TGA_HEADER
+{
+    uint8_t  IdFieldLength;
+    uint8_t  HasColorMap;
+    uint8_t  Format;
+    uint16_t ColorMapEntry;
+    uint16_t ColorMapLength;
+    uint8_t  ColorMapEntrySize;
+    uint16_t OffsetX;
+    uint16_t OffsetY;
+    uint16_t Width;
+    uint16_t Height;
+    uint8_t  BitPerPixel;
+    uint8_t  ImageDescriptor;
+};
+#pragma pack( pop )
+
+///////////////////////////////////////////////////////////////////////////////
+// TGA_FOOTER structure
+///////////////////////////////////////////////////////////////////////////////
+#pragma pack( push, 1 )
+struct TGA_FOOTER
+{
+    uint32_t    OffsetExt;
+    uint32_t    OffsetDev;
+    char        Tag[18];
+};
+#pragma pack( pop )
+
+//-----------------------------------------------------------------------------
+//      ベンチマーク用のTGAファイルイメージを生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> CreateTga(uint8_t bitPerPixel, bool rle, bool footer)
+{
+    auto srcBytes = uint32_t(bitPerPixel >> 3);
+    auto count    = size_t(kTgaWidth) * kTgaHeight;
+
+    // 一定長の同色ランとノイズが混ざった画像にする.
+    std::mt19937 random(1234);
+    std::vector<uint8_t> pixels(count * srcBytes);
+    for(size_t i=0; i<count; ++i)
+    {
+        auto noise = (i / 64) % 2 == 0;
+        for(auto c=0u; c<srcBytes; ++c)
+        { pixels[i * srcBytes + c] = noise ? uint8_t(random()) : uint8_t(i / 64 + c * 85); }
+    }
+
+    TGA_HEADER header = {};
+    header.Format       = uint8_t(rle ? 10 : 2);
+    header.Width        = kTgaWidth;
+    header.Height       = kTgaHeight;
+    header.BitPerPixel  = bitPerPixel;
+
+    std::vector<uint8_t> result(sizeof(header));
+    memcpy(result.data(), &header, sizeof(header));
+
+    if (!rle)
+    { result.insert(result.end(), pixels.begin(), pixels.end()); }
+    else
+    {
+        size_t pos = 0;
+        while(pos < count)
+        {
+            auto ptr = &pixels[pos * srcBytes];
+
+            size_t run = 1;
+            while(pos + run < count && run < 128 && memcmp(ptr, ptr + run * srcBytes, srcBytes) == 0)
+            { run++; }
+
+            if (run > 1)
+            {
+                result.push_back(uint8_t(0x80 | (run - 1)));
+                result.insert(result.end(), ptr, ptr + srcBytes);
+            }
+            else
+            {
+                // 次の同色ランの手前までを非圧縮パケットにする.
+                run = 1;
+                while(pos + run < count && run < 128
+                  && memcmp(ptr + (run - 1) * srcBytes, ptr + run * srcBytes, srcBytes) != 0)
+                { run++; }
+
+                result.push_back(uint8_t(run - 1));
+                result.insert(result.end(), ptr, ptr + run * srcBytes);
+            }
+
+            pos += run;
+        }
+    }
+
+    if (footer)
+    {
+        TGA_FOOTER value = {};
+        memcpy(value.Tag, "TRUEVISION-XFILE.", sizeof(value.Tag));
+
+        auto pos = result.size();
+        result.resize(pos + sizeof(value));
+        memcpy(result.data() + pos, &value, sizeof(value));
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      1チャンネル分のスキャンラインをRLE圧縮します.
+//-----------------------------------------------------------------------------
+void EncodeHdrChannel(const uint8_t* pSrc, int32_t count, std::vector<uint8_t>& result)
+{
+    int32_t pos = 0;
+    while(pos < count)
+    {
+        // 4つ以上続く場合は繰り返しにする.
+        int32_t run = 1;
+        while(pos + run < count && run < 127 && pSrc[pos + run] == pSrc[pos])
+        { run++; }
+
+        if (run >= 4)
+        {
+            result.push_back(uint8_t(128 + run));
+            result.push_back(pSrc[pos]);
+            pos += run;
+            continue;
+        }
+
+        // 次の繰り返しの手前までを非圧縮にする.
+        int32_t literal = 0;
+        while(pos + literal < count && literal < 128)
+        {
+            auto i = pos + literal;
+            if (i + 3 < count && pSrc[i] == pSrc[i + 1] && pSrc[i] == pSrc[i + 2] && pSrc[i] == pSrc[i + 3])
+            { break; }
+            literal++;
+        }
+
+        result.push_back(uint8_t(literal));
+        result.insert(result.end(), pSrc + pos, pSrc + pos + literal);
+        pos += literal;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ベンチマーク用のHDRファイルイメージを生成します.
+//-----------------------------------------------------------------------------
+std::vector<uint8_t> CreateHdr(bool rle)
+{
+    char header[256];
+    auto length = snprintf(header, sizeof(header),
+        "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\nEXPOSURE=1.0\n\n-Y %d +X %d\n", kHdrHeight, kHdrWidth);
+
+    std::vector<uint8_t> result(header, header + length);
+
+    // なめらかなグラデーションの空と，ノイズの多い地面を半分ずつにする.
+    std::mt19937 random(5678);
+    std::vector<uint8_t> line(size_t(kHdrWidth) * 4);
+    for(auto y=0; y<kHdrHeight; ++y)
+    {
+        for(auto x=0; x<kHdrWidth; ++x)
+        {
+            auto ptr = &line[size_t(x) * 4];
+            if (y < kHdrHeight / 2)
+            {
+                ptr[0] = uint8_t(128 + (x >> 6));
+                ptr[1] = uint8_t(160 + (y >> 5));
+                ptr[2] = 224;
+                ptr[3] = 129;
+            }
+            else
+            {
+                ptr[0] = uint8_t(128 + (random() & 0x7F));
+                ptr[1] = uint8_t(128 + (random() & 0x7F));
+                ptr[2] = uint8_t(128 + (random() & 0x7F));
+                ptr[3] = uint8_t(126 + (random() & 0x3));
+            }
+        }
+
+        if (!rle)
+        {
+            result.insert(result.end(), line.begin(), line.end());
+            continue;
+        }
+
+        result.push_back(2);
+        result.push_back(2);
+        result.push_back(uint8_t(kHdrWidth >> 8));
+        result.push_back(uint8_t(kHdrWidth & 0xFF));
+
+        std::vector<uint8_t> channel(kHdrWidth);
+        for(auto c=0; c<4; ++c)
+        {
+            for(auto x=0; x<kHdrWidth; ++x)
+            { channel[x] = line[size_t(x) * 4 + c]; }
+
+            EncodeHdrChannel(channel.data(), kHdrWidth, result);
+        }
+    }
+
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルに書き出します.
+//-----------------------------------------------------------------------------
+bool WriteFile(const char* path, const std::vector<uint8_t>& binary)
+{
+    FILE* pFile = nullptr;
+    if (fopen_s(&pFile, path, "wb") != 0)
+    { return false; }
+
+    auto size = fwrite(binary.data(), 1, binary.size(), pFile);
+    fclose(pFile);
+
+    return size == binary.size();
+}
+
+//-----------------------------------------------------------------------------
+//      ファイルを一括で読み込みます.
+//-----------------------------------------------------------------------------
+bool ReadFile(const char* path, std::vector<uint8_t>& binary)
+{
+    FILE* pFile = nullptr;
+    if (fopen_s(&pFile, path, "rb") != 0)
+    { return false; }
+
+    fseek(pFile, 0, SEEK_END);
+    auto size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    binary.resize(size_t(size));
+    auto readSize = fread(binary.data(), 1, binary.size(), pFile);
+    fclose(pFile);
+
+    return readSize == binary.size();
+}
+
+//-----------------------------------------------------------------------------
+//      テクスチャのピクセルデータが一致するかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSame(const asdx::ResTexture& a, const asdx::ResTexture& b)
+{
+    if (a.Width != b.Width || a.Height != b.Height || a.Format != b.Format)
+    { return false; }
+
+    auto& sa = a.pResources[0];
+    auto& sb = b.pResources[0];
+    return sa.SlicePitch == sb.SlicePitch && memcmp(sa.pPixels, sb.pPixels, sa.SlicePitch) == 0;
+}
+
+//-----------------------------------------------------------------------------
+//      スループットを表示します.
+//-----------------------------------------------------------------------------
+void PrintResult(const char* name, size_t fileSize, double oldMsec, double newMsec, bool same)
+{
+    auto mb = double(fileSize) / (1024.0 * 1024.0);
+    printf("%-12s : old %8.1f ms (%7.1f MB/s), new %8.1f ms (%7.1f MB/s), x%5.2f%s\n",
+        name, oldMsec, mb * 1000.0 / oldMsec, newMsec, mb * 1000.0 / newMsec,
+        oldMsec / newMsec, same ? "" : " (MISMATCH)");
+}
+
+namespace legacy {
+
+//-----------------------------------------------------------------------------
+//      24Bitフルカラー形式を解析します. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+void Parse24Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+{
+    for( uint32_t i=0; i<size; ++i )
+    {
+        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 3 ] = 255;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      32Bitフルカラー形式を解析します. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+void Parse32Bits( FILE* pFile, uint32_t size, uint8_t* pPixels )
+{
+    for( uint32_t i=0; i<size; ++i )
+    {
+        pPixels[ i * 4 + 2 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 1 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 0 ] = (uint8_t)fgetc( pFile );
+        pPixels[ i * 4 + 3 ] = (uint8_t)fgetc( pFile );
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      24BitRLE圧縮フルカラー形式を解析します. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+void Parse24BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+{
+    uint32_t count    = 0;
+    uint8_t  color[3] = { 0, 0, 0 };
+    uint8_t  header   = 0;
+    uint8_t* ptr      = pPixels;
+
+    while( ptr < pPixels + size )
+    {
+        header = (uint8_t)fgetc( pFile );
+        count = 1 + ( header & 0x7F );
+
+        if ( header & 0x80 )
+        {
+            fread( color, sizeof(uint8_t), 3, pFile );
+
+            for( uint32_t i=0; i<count; ++i, ptr+=4 )
+            {
+                ptr[ 0 ] = color[ 2 ];
+                ptr[ 1 ] = color[ 1 ];
+                ptr[ 2 ] = color[ 0 ];
+                ptr[ 3 ] = 255;
+            }
+        }
+        else
+        {
+            for( uint32_t i=0; i<count; ++i, ptr+=4 )
+            {
+                ptr[ 2 ] = (uint8_t)fgetc( pFile );
+                ptr[ 1 ] = (uint8_t)fgetc( pFile );
+                ptr[ 0 ] = (uint8_t)fgetc( pFile );
+                ptr[ 3 ] = 255;
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      32BitRLE圧縮フルカラー形式を解析します. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+void Parse32BitsRLE( FILE* pFile, uint32_t size, uint8_t* pPixels )
+{
+    uint32_t count    = 0;
+    uint8_t  color[4] = { 0, 0, 0, 0 };
+    uint8_t  header   = 0;
+    uint8_t* ptr      = pPixels;
+
+    while( ptr < pPixels + size )
+    {
+        header = (uint8_t)fgetc( pFile );
+        count = 1 + ( header & 0x7F );
+
+        if ( header & 0x80 )
+        {
+            fread( color, sizeof(uint8_t), 4, pFile );
+
+            for( uint32_t i=0; i<count; ++i, ptr+=4 )
+            {
+                ptr[ 0 ] = color[ 2 ];
+                ptr[ 1 ] = color[ 1 ];
+                ptr[ 2 ] = color[ 0 ];
+                ptr[ 3 ] = color[ 3 ];
+            }
+        }
+        else
+        {
+            for( uint32_t i=0; i<count; ++i, ptr+=4 )
+            {
+                ptr[ 2 ] = (uint8_t)fgetc( pFile );
+                ptr[ 1 ] = (uint8_t)fgetc( pFile );
+                ptr[ 0 ] = (uint8_t)fgetc( pFile );
+                ptr[ 3 ] = (uint8_t)fgetc( pFile );
+            }
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      Targaファイルからリソーステクスチャを生成します. (メモリデコーダ導入前の実装)
+//
+//      ベンチマークで使うフルカラー形式のみを残しています.
+//-----------------------------------------------------------------------------
+bool CreateResTextureFromTGAFile(const char* path, asdx::ResTexture& resTexture)
+{
+    FILE* pFile = nullptr;
+    if ( fopen_s( &pFile, path, "rb" ) != 0 )
+    { return false; }
+
+    // フッターを読み込み.
+    TGA_FOOTER footer;
+    long offset = sizeof(footer);
+    fseek( pFile, -offset, SEEK_END );
+    fread( &footer, sizeof(footer), 1, pFile );
+
+    // ファイルマジックをチェック.
+    if ( strcmp( footer.Tag, "TRUEVISION-XFILE." ) != 0 )
+    {
+        fclose( pFile );
+        return false;
+    }
+
+    // ファイル先頭に戻す.
+    fseek( pFile, 0, SEEK_SET );
+
+    // ヘッダデータを読み込む.
+    TGA_HEADER header;
+    fread( &header, sizeof(header), 1, pFile );
+
+    if ( header.IdFieldLength != 0 )
+    { fseek( pFile, header.IdFieldLength, SEEK_CUR ); }
+
+    auto width   = header.Width;
+    auto height  = header.Height;
+    auto size    = width * height * 4;
+    auto pPixels = new (std::nothrow) uint8_t [ size ];
+    if ( pPixels == nullptr )
+    {
+        fclose( pFile );
+        return false;
+    }
+
+    switch( header.Format )
+    {
+    case 2:
+        {
+            if ( header.BitPerPixel == 24 )
+            { Parse24Bits( pFile, width * height, pPixels ); }
+            else
+            { Parse32Bits( pFile, width * height, pPixels ); }
+        }
+        break;
+
+    case 10:
+        {
+            if ( header.BitPerPixel == 24 )
+            { Parse24BitsRLE( pFile, width * height * 4, pPixels ); }
+            else
+            { Parse32BitsRLE( pFile, width * height * 4, pPixels ); }
+        }
+        break;
+    }
+
+    fclose( pFile );
+
+    auto surface = new (std::nothrow) asdx::SubResource();
+    if ( surface == nullptr )
+    {
+        delete[] pPixels;
+        return false;
+    }
+
+    surface->Width      = width;
+    surface->Height     = height;
+    surface->MipIndex   = 0;
+    surface->Pitch      = width * 4;
+    surface->SlicePitch = width * height * 4;
+    surface->pPixels    = pPixels;
+
+    resTexture.Dimension    = asdx::TEXTURE_DIMENSION_2D;
+    resTexture.Width        = width;
+    resTexture.Height       = height;
+    resTexture.Depth        = 1;
+    resTexture.Format       = DXGI_FORMAT_R8G8B8A8_UNORM;
+    resTexture.SurfaceCount = 1;
+    resTexture.MipMapCount  = 1;
+    resTexture.pResources   = surface;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RGBE structure
+///////////////////////////////////////////////////////////////////////////////
+struct RGBE
+{
+    union
+    {
+        struct
+        {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+            uint8_t e;
+        };
+        uint8_t v[4];
+    };
+};
+
+//-----------------------------------------------------------------------------
+//      RGBE形式からVector3形式に変換します. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+inline asdx::Vector3 RGBEToVec3( const RGBE& val )
+{
+    asdx::Vector3 result;
+    if ( val.e )
+    {
+        auto f = ldexp( 1.0, static_cast<int>(val.e - (128+8)) );
+        result.x = static_cast<float>( val.r * f );
+        result.y = static_cast<float>( val.g * f );
+        result.z = static_cast<float>( val.b * f );
+    }
+    else
+    {
+        result.x = 0.0f;
+        result.y = 0.0f;
+        result.z = 0.0f;
+    }
+    return result;
+}
+
+//-----------------------------------------------------------------------------
+//      HDRファイルのヘッダを読み込みします. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+bool ReadHdrHeader( FILE* pFile, int32_t& width, int32_t& height, float& gamma, float& exposure )
+{
+    char buf[ 256 ];
+    fread( buf, sizeof(char), 2, pFile );
+
+    if ( buf[0] != '#' || buf[1] != '?' )
+    { return false; }
+
+    auto valid = false;
+    for( ;; )
+    {
+        if ( fgets( buf, 256, pFile ) == nullptr )
+        { break; }
+
+        if ( buf[0] == '\n' )
+        { break; }
+        else if ( buf[0] == '#' )
+        { continue; }
+        else
+        {
+            auto g = 1.0f;
+            auto e = 1.0f;
+            if ( sscanf_s( buf, "GAMMA=%f\n", &g ) != 0 )
+            { gamma = g; }
+            else if ( sscanf_s( buf, "EXPOSURE=%f\n", &e ) != 0 )
+            { exposure = e; }
+            else if ( strcmp( buf, "FORMAT=32-bit_rle_rgbe\n" ) == 0 )
+            { valid = true; }
+        }
+    }
+
+    if ( !valid )
+    { return false; }
+
+    if ( fgets( buf, 256, pFile ) != nullptr )
+    {
+        auto w = 0;
+        auto h = 0;
+        if ( sscanf_s( buf, "-Y %d +X %d\n", &h, &w ) != 0 )
+        {
+            width = w;
+            height = h;
+        }
+        else if ( sscanf_s( buf, "+X %d -Y %d\n", &w, &h ) != 0 )
+        {
+            width = w;
+            height = h;
+        }
+        else
+        { return false; }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      旧形式のカラーを読み取ります. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+bool ReadOldColors( FILE* pFile, RGBE* pLine, int32_t count )
+{
+    auto shift = 0;
+    while( 0 < count )
+    {
+        pLine[0].r = getc( pFile );
+        pLine[0].g = getc( pFile );
+        pLine[0].b = getc( pFile );
+        pLine[0].e = getc( pFile );
+
+        if ( feof( pFile ) || ferror( pFile ) )
+            return false;
+
+        if ( pLine[0].r == 1
+          && pLine[0].g == 1
+          && pLine[0].b == 1 )
+        {
+            for( auto i=pLine[0].e << shift; i > 0; i-- )
+            {
+                pLine[0].r = pLine[-1].r;
+                pLine[0].g = pLine[-1].g;
+                pLine[0].b = pLine[-1].b;
+                pLine[0].e = pLine[-1].e;
+                pLine++;
+                count--;
+            }
+            shift += 8;
+        }
+        else
+        {
+            pLine++;
+            count--;
+            shift = 0;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      カラーを読み取ります. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+bool ReadColor( FILE* pFile, RGBE* pLine, int32_t count )
+{
+    if ( count < 8 || 0x7fff < count )
+    { return ReadOldColors( pFile, pLine, count ); }
+
+    auto i = getc( pFile );
+    if ( i == EOF )
+        return false;
+
+    if ( i != 2 )
+    {
+        ungetc( i, pFile );
+        return ReadOldColors( pFile, pLine, count );
+    }
+
+    pLine[0].g = getc( pFile );
+    pLine[0].b = getc( pFile );
+
+    if ( ( i = getc( pFile ) ) == EOF )
+        return false;
+
+    if ( pLine[0].g != 2 || pLine[0].b & 128 )
+    {
+        pLine[0].r = 2;
+        pLine[0].e = i;
+        return ReadOldColors( pFile, pLine + 1, count -1 );
+    }
+
+    if ( ( pLine[0].b << 8 | i ) != count )
+        return false;
+
+    for( i=0; i<4; ++i )
+    {
+        for( auto j=0; j<count; )
+        {
+            auto code = getc( pFile );
+            if ( code == EOF )
+                return false;
+
+            if ( 128 < code )
+            {
+                code &= 127;
+                auto val = getc( pFile );
+                while( code-- )
+                { pLine[j++].v[i] = val; }
+            }
+            else
+            {
+                while( code-- )
+                { pLine[j++].v[i] = getc( pFile ); }
+            }
+        }
+    }
+
+    return ( feof( pFile ) ? false : true );
+}
+
+//-----------------------------------------------------------------------------
+//      HDRデータを読み取ります. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+bool ReadHdrData( FILE* pFile, const int32_t width, const int32_t height, uint8_t** ppPixels )
+{
+    std::vector<RGBE>  lines( width );
+    std::vector<float> row( width * 4 );
+
+    // R16G16B16A16_FLOAT で格納する.
+    auto pixels = new (std::nothrow) uint8_t [ width * height * 4 * sizeof(asdx::half) ];
+    if ( pixels == nullptr )
+    { return false; }
+
+    auto pDst = reinterpret_cast<asdx::half*>( pixels );
+
+    for( auto y=0; y<height; ++y )
+    {
+        if ( !ReadColor( pFile, lines.data(), width ) )
+        {
+            delete[] pixels;
+            return false;
+        }
+
+        for( auto x =0; x < width; x++ )
+        {
+            auto pix = RGBEToVec3( lines[x] );
+            auto idx = x * 4;
+            row[idx + 0] = pix.x;
+            row[idx + 1] = pix.y;
+            row[idx + 2] = pix.z;
+            row[idx + 3] = 1.0f;
+        }
+
+        asdx::ConvertF32ToF16( row.data(), pDst + y * width * 4, width * 4 );
+    }
+
+    (*ppPixels) = pixels;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+//      HDRファイルからデータをロードします. (メモリデコーダ導入前の実装)
+//-----------------------------------------------------------------------------
+bool CreateResTextureFromHDRFile( const char* path, asdx::ResTexture& resTexture )
+{
+    FILE* pFile = nullptr;
+    if ( fopen_s( &pFile, path, "rb" ) != 0 )
+    { return false; }
+
+    int32_t width    = 0;
+    int32_t height   = 0;
+    float   gamma    = 1.0f;
+    float   exposure = 1.0f;
+    if ( !ReadHdrHeader( pFile, width, height, gamma, exposure ) )
+    {
+        fclose( pFile );
+        return false;
+    }
+
+    resTexture.Dimension    = asdx::TEXTURE_DIMENSION_2D;
+    resTexture.Width        = uint32_t(width);
+    resTexture.Height       = uint32_t(height);
+    resTexture.Depth        = 0;
+    resTexture.Format       = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    resTexture.MipMapCount  = 1;
+    resTexture.SurfaceCount = 1;
+    resTexture.pResources   = new asdx::SubResource[1];
+
+    resTexture.pResources[0].Width      = uint32_t(width);
+    resTexture.pResources[0].Height     = uint32_t(height);
+    resTexture.pResources[0].Pitch      = width * sizeof(asdx::half) * 4;
+    resTexture.pResources[0].SlicePitch = resTexture.pResources[0].Pitch * height;
+
+    auto result = ReadHdrData( pFile, width, height, &resTexture.pResources[0].pPixels );
+    fclose( pFile );
+
+    return result;
+}
+
+} // namespace legacy
+} // namespace
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//      TGAのデコード速度を旧実装と比較します.
+//
+//      旧実装は fgetc で1チャンネルずつ読み込み，新実装はファイルを一括で読み込んでから
+//      CreateResTextureFromTGAMemory() でデコードします. どちらもファイルを開くところから計測します.
+//-----------------------------------------------------------------------------
+bool BenchTextureDecodeTGA()
+{
+    struct Case
+    {
+        const char* Name;
+        uint8_t     BitPerPixel;
+        bool        RLE;
+    };
+
+    const Case kCases[] = {
+        { "raw 24bit", 24, false },
+        { "raw 32bit", 32, false },
+        { "rle 24bit", 24, true  },
+        { "rle 32bit", 32, true  },
+    };
+
+    printf("size = %u x %u\n", kTgaWidth, kTgaHeight);
+
+    auto success = true;
+    for(auto& item : kCases)
+    {
+        auto binary = CreateTga(item.BitPerPixel, item.RLE, true);
+        if (!WriteFile(kTgaPath, binary))
+        {
+            printf("Error : File Write Failed. path = %s\n", kTgaPath);
+            return false;
+        }
+
+        ResTexture oldTexture;
+        ResTexture newTexture;
+        auto oldResult = true;
+        auto newResult = true;
+
+        auto oldMsec = MeasureBestMsec(kRepeatCount, [&]()
+        {
+            oldTexture.Dispose();
+            oldResult = legacy::CreateResTextureFromTGAFile(kTgaPath, oldTexture);
+        });
+
+        auto newMsec = MeasureBestMsec(kRepeatCount, [&]()
+        {
+            newTexture.Dispose();
+            std::vector<uint8_t> file;
+            newResult = ReadFile(kTgaPath, file)
+                     && CreateResTextureFromTGAMemory(file.data(), file.size(), newTexture);
+        });
+
+        auto same = oldResult && newResult && IsSame(oldTexture, newTexture);
+        PrintResult(item.Name, binary.size(), oldMsec, newMsec, same);
+
+        // フッターの無い TGA 1.0 形式もメモリストリームから読み込めること.
+        auto legacyBinary = CreateTga(item.BitPerPixel, item.RLE, false);
+        ResTexture headerOnly;
+        if (!headerOnly.LoadFromMemory(legacyBinary.data(), uint32_t(legacyBinary.size()))
+          || !IsSame(headerOnly, newTexture))
+        {
+            printf("%-12s : TGA 1.0 (no footer) load failed.\n", item.Name);
+            same = false;
+        }
+
+        oldTexture.Dispose();
+        newTexture.Dispose();
+        headerOnly.Dispose();
+
+        success = success && same;
+    }
+
+    remove(kTgaPath);
+    return success;
+}
+
+//-----------------------------------------------------------------------------
+//      HDRのデコード速度を旧実装と比較します.
+//
+//      旧実装は getc で1バイトずつ読み込み，新実装はファイルを一括で読み込んでから
+//      CreateResTextureFromHDRMemory() でデコードします. どちらもファイルを開くところから計測します.
+//-----------------------------------------------------------------------------
+bool BenchTextureDecodeHDR()
+{
+    struct Case
+    {
+        const char* Name;
+        bool        RLE;
+    };
+
+    const Case kCases[] = {
+        { "rle",  true  },
+        { "flat", false },
+    };
+
+    printf("size = %d x %d\n", kHdrWidth, kHdrHeight);
+
+    auto success = true;
+    for(auto& item : kCases)
+    {
+        auto binary = CreateHdr(item.RLE);
+        if (!WriteFile(kHdrPath, binary))
+        {
+            printf("Error : File Write Failed. path = %s\n", kHdrPath);
+            return false;
+        }
+
+        ResTexture oldTexture;
+        ResTexture newTexture;
+        auto oldResult = true;
+        auto newResult = true;
+
+        auto oldMsec = MeasureBestMsec(kRepeatCount, [&]()
+        {
+            oldTexture.Dispose();
+            oldResult = legacy::CreateResTextureFromHDRFile(kHdrPath, oldTexture);
+        });
+
+        auto newMsec = MeasureBestMsec(kRepeatCount, [&]()
+        {
+            newTexture.Dispose();
+            std::vector<uint8_t> file;
+            newResult = ReadFile(kHdrPath, file)
+                     && CreateResTextureFromHDRMemory(file.data(), file.size(), newTexture);
+        });
+
+        auto same = oldResult && newResult && IsSame(oldTexture, newTexture);
+        PrintResult(item.Name, binary.size(), oldMsec, newMsec, same);
+
+        oldTexture.Dispose();
+        newTexture.Dispose();
+
+        success = success && same;
+    }
+
+    remove(kHdrPath);
+    return success;
+}
+
+} // namespace test
+} // namespace asdx
@@ -0,0 +1,128 @@
+﻿//-----------------------------------------------------------------------------
+// File : asdxVertexFaceAdjacencyBench.cpp
+// Desc : Normal / Tangent Generation Benchmark.
+// Copyright(c) Project Asura. All right reserved.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <asdxTest.h>
+#include <res/asdxResModel.h>
+#include <fnd/asdxThreadPool.h>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+
+namespace {
+
+//-----------------------------------------------------------------------------
+// Constant Values.
+//-----------------------------------------------------------------------------
+static const uint32_t kGridSize     = 1582;     // 約500万三角形.
+static const int      kRepeatCount  = 3;
+
+//-----------------------------------------------------------------------------
+//      格子状のメッシュを生成します.
+//-----------------------------------------------------------------------------
+void CreateGrid(uint32_t size, asdx::ResMesh& mesh)
+{
+    mesh.Name = "grid";
+    mesh.Positions   .reserve(size * size);
+    mesh.TexCoords[0].reserve(size * size);
+    for(auto y=0u; y<size; ++y)
+    {
+        for(auto x=0u; x<size; ++x)
+        {
+            auto h = 0.01f * float((x * 7 + y * 13) % 17);
+            mesh.Positions   .push_back(asdx::Vector3(float(x), float(y), h));
+            mesh.TexCoords[0].push_back(asdx::Vector2(float(x) / float(size), float(y) / float(size)));
+        }
+    }
+
+    mesh.VertexIndices.reserve((size - 1) * (size - 1) * 6);
+    for(auto y=0u; y<size - 1; ++y)
+    {
+        for(auto x=0u; x<size - 1; ++x)
+        {
+            auto i0 = y * size + x;
+            auto i1 = i0 + 1;
+            auto i2 = i0 + size;
+            auto i3 = i2 + 1;
+            mesh.VertexIndices.insert(mesh.VertexIndices.end(), { i0, i1, i2, i1, i3, i2 });
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+//      ビット単位で一致するかどうかチェックします.
+//-----------------------------------------------------------------------------
+bool IsSame(const std::vector<asdx::Vector3>& a, const std::vector<asdx::Vector3>& b)
+{ return a.size() == b.size() && memcmp(a.data(), b.data(), a.size() * sizeof(asdx::Vector3)) == 0; }
+
+} // namespace
+
+
+namespace asdx {
+namespace test {
+
+//-----------------------------------------------------------------------------
+//      法線・接線計算をスレッド数ごとに計測します.
+//
+//      nullptr を渡した場合は面の順に直接加算し，スレッドプールを渡した場合は
+//      ワーカー数が kMinAdjacencyWorkers 以上であれば隣接情報を並列構築します.
+//      直接加算より速くなる最小ワーカー数が kMinAdjacencyWorkers の目安です.
+//-----------------------------------------------------------------------------
+bool BenchVertexFaceAdjacency()
+{
+    ResMesh mesh;
+    CreateGrid(kGridSize, mesh);
+    printf("triangles = %zu, vertices = %zu, hardware threads = %u\n",
+        mesh.VertexIndices.size() / 3, mesh.Positions.size(), std::thread::hardware_concurrency());
+
+    // 呼び出しスレッドだけで処理した結果を基準にする.
+    auto baseNormal = MeasureBestMsec(kRepeatCount, [&]() { CalcNormals(mesh, 59.7f, nullptr); });
+    auto baseTangent = MeasureBestMsec(kRepeatCount, [&]() { CalcTangents(mesh, nullptr); });
+    auto normals  = mesh.Normals;
+    auto tangents = mesh.Tangents;
+    printf("workers =  1 : normals %8.1f ms, tangents %8.1f ms\n", baseNormal, baseTangent);
+
+    auto success   = true;
+    auto crossover = 0u;
+    auto maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 2)
+    { maxThreads = 2; }
+
+    for(auto threads=1u; threads<maxThreads; ++threads)
+    {
+        IThreadPool* pThreadPool = nullptr;
+        if (!CreateThreadPool(uint8_t(threads), &pThreadPool))
+        { return false; }
+
+        auto normal  = MeasureBestMsec(kRepeatCount, [&]() { CalcNormals(mesh, 59.7f, pThreadPool); });
+        auto same    = IsSame(normals, mesh.Normals);
+        auto tangent = MeasureBestMsec(kRepeatCount, [&]() { CalcTangents(mesh, pThreadPool); });
+        same = same && IsSame(tangents, mesh.Tangents);
+
+        pThreadPool->Release();
+
+        printf("workers = %2u : normals %8.1f ms, tangents %8.1f ms%s\n",
+            threads + 1, normal, tangent, same ? "" : " (MISMATCH)");
+
+        if (crossover == 0 && normal + tangent < baseNormal + baseTangent)
+        { crossover = threads + 1; }
+
+        success = success && same;
+    }
+
+    if (crossover != 0)
+    { printf("crossover : %u workers\n", crossover); }
+    else
+    { printf("crossover : not reached\n"); }
+
+    return success;
+}
+
+} // namespace test
+} // namespace asdx